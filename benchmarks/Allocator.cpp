@@ -0,0 +1,90 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Arena.h>
+#include <openlib/FlatArray.h>
+#include <openlib/Pool.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t REQUESTS = sizeFromEnv("OPENLIB_BENCH_REQUESTS", 100000);
+const std::size_t ARRAYS_PER_REQUEST = 16;
+const int RUNS = 5;
+
+/*
+ * Simulated request: a handful of short-lived arrays of varying sizes,
+ * filled and summed.
+ */
+template <class Allocator>
+int64_t handleRequest(std::size_t request, const Allocator& allocator) {
+  int64_t sum = 0;
+  for (std::size_t i = 0; i < ARRAYS_PER_REQUEST; i++) {
+    std::size_t size = 16 + ((request * 31 + i * 97) % 1024);
+    openlib::FlatArray<int32_t, Allocator> array(size, openlib::uninitialized, allocator);
+    array.fill(static_cast<int32_t>(i));
+    sum += array[size / 2];
+  }
+  return sum;
+}
+
+} // namespace
+
+TEST(AllocatorBenchmark, requestHandling) {
+  int64_t sum = 0;
+
+  double newDeleteSeconds = bestOf(RUNS, [&]() {
+    std::allocator<int32_t> allocator;
+    for (std::size_t r = 0; r < REQUESTS; r++) {
+      sum += handleRequest(r, allocator);
+    }
+  });
+  reportRate("requests, std::allocator", REQUESTS, newDeleteSeconds);
+
+  openlib::Arena arena;
+  double arenaSeconds = bestOf(RUNS, [&]() {
+    openlib::ArenaAllocator<int32_t> allocator(arena);
+    for (std::size_t r = 0; r < REQUESTS; r++) {
+      sum += handleRequest(r, allocator);
+      arena.reset();
+    }
+  });
+  reportRate("requests, ArenaAllocator", REQUESTS, arenaSeconds);
+
+  openlib::Pool pool;
+  double poolSeconds = bestOf(RUNS, [&]() {
+    openlib::PoolAllocator<int32_t> allocator(pool);
+    for (std::size_t r = 0; r < REQUESTS; r++) {
+      sum += handleRequest(r, allocator);
+    }
+  });
+  reportRate("requests, PoolAllocator", REQUESTS, poolSeconds);
+
+  doNotOptimize(&sum);
+}
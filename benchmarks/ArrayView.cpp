@@ -0,0 +1,68 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <openlib/ArrayView.h>
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t ELEMENTS = sizeFromEnv("OPENLIB_BENCH_ELEMENTS", 1 << 24);
+const std::size_t BATCH = 4096;
+const int RUNS = 5;
+
+} // namespace
+
+TEST(ArrayViewBenchmark, batchSplitting) {
+  openlib::FlatArray<float> array(ELEMENTS);
+  array.fill(1.0f);
+  const double bytes = ELEMENTS * sizeof(float);
+  float total = 0;
+
+  double copySeconds = bestOf(RUNS, [&]() {
+    for (std::size_t offset = 0; offset < ELEMENTS; offset += BATCH) {
+      openlib::FlatArray<float> batch(std::min(BATCH, ELEMENTS - offset), openlib::uninitialized);
+      openlib::kernels::copy(batch.data(), array.data() + offset, batch.size() * sizeof(float));
+      total += openlib::sum(batch);
+    }
+  });
+  reportThroughput("batches by copy", bytes, copySeconds);
+
+  double viewSeconds = bestOf(RUNS, [&]() {
+    openlib::ArraySlice<float> view = array;
+    for (std::size_t offset = 0; offset < ELEMENTS; offset += BATCH) {
+      total += openlib::sum(view.slice(offset, std::min(BATCH, ELEMENTS - offset)));
+    }
+  });
+  reportThroughput("batches by ArraySlice", bytes, viewSeconds);
+
+  doNotOptimize(&total);
+}
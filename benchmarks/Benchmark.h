@@ -0,0 +1,96 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace openlib {
+namespace benchmark {
+
+/**
+ * @brief keep the compiler from optimizing away a result
+ * @param p pointer to the result
+ */
+inline void doNotOptimize(const void* p) {
+  asm volatile("" : : "g"(p) : "memory");
+}
+
+/**
+ * @brief run a function several times and keep the fastest run
+ * @param runs number of times to run the function
+ * @param function function to time
+ * @return the fastest run, in seconds
+ */
+template <class Function>
+double bestOf(int runs, Function function) {
+  double best = 1e300;
+  for (int i = 0; i < runs; i++) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto stop = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    if (seconds < best) {
+      best = seconds;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief print a throughput result
+ * @param name name of the benchmark
+ * @param bytes bytes processed per run
+ * @param seconds time taken per run
+ */
+inline void reportThroughput(const char* name, double bytes, double seconds) {
+  std::printf("%-48s %10.2f GB/s\n", name, bytes / seconds / 1e9);
+}
+
+/**
+ * @brief print a rate result
+ * @param name name of the benchmark
+ * @param operations operations performed per run
+ * @param seconds time taken per run
+ */
+inline void reportRate(const char* name, double operations, double seconds) {
+  std::printf("%-48s %10.2f Mops/s\n", name, operations / seconds / 1e6);
+}
+
+/**
+ * @brief read a benchmark size from the environment
+ * @param name environment variable name
+ * @param fallback value to use when the variable is not set
+ * @return the size
+ */
+inline std::size_t sizeFromEnv(const char* name, std::size_t fallback) {
+  const char* value = std::getenv(name);
+  return value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+} // namespace benchmark
+} // namespace openlib
@@ -0,0 +1,99 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <openlib/BitArray.h>
+#include <openlib/FlatArray.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t BITS = sizeFromEnv("OPENLIB_BENCH_BITS", std::size_t(1) << 28);
+const int RUNS = 3;
+
+} // namespace
+
+TEST(BitArrayBenchmark, countAndIntersect) {
+  openlib::FlatArray<bool> boolsA(BITS);
+  openlib::FlatArray<bool> boolsB(BITS);
+  openlib::BitArray bitsA(BITS);
+  openlib::BitArray bitsB(BITS);
+  std::mt19937_64 engine(7);
+  for (std::size_t i = 0; i < bitsA.wordCount(); i++) {
+    bitsA.data()[i] = engine();
+    bitsB.data()[i] = engine();
+  }
+  for (std::size_t i = 0; i < BITS; i++) {
+    boolsA[i] = bitsA[i];
+    boolsB[i] = bitsB[i];
+  }
+
+  // throughput in bits per second, reported as if each bit were a byte
+  std::size_t boolCount = 0;
+  double boolCountSeconds = bestOf(RUNS, [&]() {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < BITS; i++) {
+      n += boolsA[i];
+    }
+    boolCount = n;
+  });
+  reportThroughput("FlatArray<bool> count (bits)", BITS, boolCountSeconds);
+
+  std::size_t bitCount = 0;
+  double bitCountSeconds = bestOf(RUNS, [&]() { bitCount = bitsA.count(); });
+  reportThroughput("BitArray count (bits)", BITS, bitCountSeconds);
+  EXPECT_EQ(bitCount, boolCount);
+
+  double boolAndSeconds = bestOf(RUNS, [&]() {
+    for (std::size_t i = 0; i < BITS; i++) {
+      boolsA[i] = boolsA[i] && boolsB[i];
+    }
+    doNotOptimize(boolsA.data());
+  });
+  reportThroughput("FlatArray<bool> and (bits)", BITS, boolAndSeconds);
+
+  double bitAndSeconds = bestOf(RUNS, [&]() {
+    bitsA &= bitsB;
+    doNotOptimize(bitsA.data());
+  });
+  reportThroughput("BitArray and (bits)", BITS, bitAndSeconds);
+
+  openlib::BitRankIndex index(bitsA);
+  const std::size_t QUERIES = 1 << 20;
+  std::size_t total = 0;
+  double rankSeconds = bestOf(RUNS, [&]() {
+    std::size_t position = 12345;
+    for (std::size_t i = 0; i < QUERIES; i++) {
+      position = (position * 2654435761u + 1) % BITS;
+      total += index.rank(position);
+    }
+  });
+  doNotOptimize(&total);
+  reportRate("BitRankIndex rank", QUERIES, rankSeconds);
+}
@@ -0,0 +1,76 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+#include <openlib/BufferPool.h>
+#include <openlib/Serializer.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t MESSAGES = sizeFromEnv("OPENLIB_BENCH_MESSAGES", 1 << 20);
+const std::size_t CAPACITY = 4096;
+const int RUNS = 3;
+
+template <class MakeSerializer>
+void writeMessages(MakeSerializer makeSerializer) {
+  for (std::size_t i = 0; i < MESSAGES; i++) {
+    openlib::Serializer serializer = makeSerializer();
+    serializer.putUInt64(i);
+    serializer.putUInt32(static_cast<uint32_t>(i));
+    doNotOptimize(serializer.data());
+  }
+}
+
+} // namespace
+
+TEST(BufferPoolBenchmark, serializerPerMessage) {
+  /*
+   * One short message per Serializer, the way the send path uses them.
+   */
+  double heapSeconds = bestOf(RUNS, [&]() {
+    writeMessages([]() { return openlib::Serializer(CAPACITY); });
+  });
+  reportRate("Serializer(capacity) per message", MESSAGES, heapSeconds);
+
+  double uninitializedSeconds = bestOf(RUNS, [&]() {
+    writeMessages([]() { return openlib::Serializer(CAPACITY, openlib::uninitialized); });
+  });
+  reportRate("Serializer(capacity, uninitialized) per message", MESSAGES, uninitializedSeconds);
+
+  openlib::BufferPool pool;
+  double pooledSeconds = bestOf(RUNS, [&]() {
+    writeMessages([&]() { return openlib::Serializer(CAPACITY, openlib::uninitialized, pool); });
+  });
+  reportRate("Serializer from BufferPool per message", MESSAGES, pooledSeconds);
+
+  auto stats = pool.stats();
+  std::printf("%-50s %9.2f %%, %zu bytes cached\n", "BufferPool hit rate",
+              100 * stats.hitRate(), stats.bytesCached());
+}
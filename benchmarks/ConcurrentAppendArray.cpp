@@ -0,0 +1,97 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/ConcurrentAppendArray.h>
+#include <openlib/FlatArray.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t ELEMENTS = sizeFromEnv("OPENLIB_BENCH_ELEMENTS", 1 << 24);
+const std::size_t MAX_THREADS = sizeFromEnv("OPENLIB_BENCH_THREADS", 64);
+
+// split ELEMENTS appends over threads, returns the wall time
+template <class Producer>
+double timeProducers(std::size_t threads, Producer producer) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      producer(t, ELEMENTS / threads);
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+std::string label(const char* name, std::size_t threads) {
+  return std::string(name) + " x" + std::to_string(threads);
+}
+
+} // namespace
+
+TEST(ConcurrentAppendArrayBenchmark, producerScaling) {
+  for (std::size_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+    openlib::FlatArray<uint64_t> locked(ELEMENTS, openlib::uninitialized);
+    std::size_t lockedCursor = 0;
+    std::mutex lock;
+    double mutexSeconds = timeProducers(threads, [&](std::size_t t, std::size_t count) {
+      for (std::size_t i = 0; i < count; i++) {
+        std::lock_guard<std::mutex> guard(lock);
+        locked[lockedCursor++] = t + i;
+      }
+    });
+    reportRate(label("mutex cursor appends", threads).c_str(), ELEMENTS, mutexSeconds);
+
+    openlib::ConcurrentAppendArray<uint64_t> single(ELEMENTS);
+    double singleSeconds = timeProducers(threads, [&](std::size_t t, std::size_t count) {
+      for (std::size_t i = 0; i < count; i++) {
+        single.append(t + i);
+      }
+    });
+    reportRate(label("ConcurrentAppendArray appends", threads).c_str(), ELEMENTS, singleSeconds);
+
+    openlib::ConcurrentAppendArray<uint64_t> batched(ELEMENTS);
+    double batchedSeconds = timeProducers(threads, [&](std::size_t t, std::size_t count) {
+      auto appender = batched.appender();
+      for (std::size_t i = 0; i < count; i++) {
+        appender.append(t + i);
+      }
+    });
+    reportRate(label("ConcurrentAppendArray batched", threads).c_str(), ELEMENTS, batchedSeconds);
+  }
+}
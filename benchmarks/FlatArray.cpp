@@ -0,0 +1,114 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Array.h>
+#include <openlib/FlatArray.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t ELEMENTS = sizeFromEnv("OPENLIB_BENCH_ELEMENTS", 1 << 24);
+const int RUNS = 10;
+
+/*
+ * Loops live in non-inlined functions taking references, as they would in a
+ * real code base, so the compiler cannot devirtualize Array by seeing the
+ * concrete type at the call site.
+ */
+
+template <class ArrayType>
+__attribute__((noinline)) void copyLoop(ArrayType& dst, const ArrayType& src) {
+  for (std::size_t i = 0; i < src.size(); i++) {
+    dst[i] = src[i];
+  }
+}
+
+template <class ArrayType>
+__attribute__((noinline)) void saxpyLoop(float a, const ArrayType& x, ArrayType& y) {
+  for (std::size_t i = 0; i < x.size(); i++) {
+    y[i] = a * x[i] + y[i];
+  }
+}
+
+} // namespace
+
+TEST(FlatArrayBenchmark, copyLoop) {
+  /*
+   * Element-wise copy loop over FlatArray vs Array vs memcpy. The FlatArray
+   * loop should auto-vectorize and reach memcpy-class throughput; the Array
+   * loop pays a virtual call per element.
+   */
+  openlib::FlatArray<float> flatSrc(ELEMENTS);
+  openlib::FlatArray<float> flatDst(ELEMENTS);
+  openlib::Array<float> arraySrc(ELEMENTS);
+  openlib::Array<float> arrayDst(ELEMENTS);
+  const double bytes = 2.0 * ELEMENTS * sizeof(float);
+
+  double memcpySeconds = bestOf(RUNS, [&]() {
+    std::memcpy(flatDst.data(), flatSrc.data(), ELEMENTS * sizeof(float));
+    doNotOptimize(flatDst.data());
+  });
+  reportThroughput("memcpy", bytes, memcpySeconds);
+
+  double flatSeconds = bestOf(RUNS, [&]() {
+    copyLoop(flatDst, flatSrc);
+    doNotOptimize(flatDst.data());
+  });
+  reportThroughput("FlatArray<float> copy loop", bytes, flatSeconds);
+
+  double arraySeconds = bestOf(RUNS, [&]() {
+    copyLoop(arrayDst, arraySrc);
+    doNotOptimize(arrayDst.data());
+  });
+  reportThroughput("Array<float> copy loop", bytes, arraySeconds);
+}
+
+TEST(FlatArrayBenchmark, scaleLoop) {
+  /*
+   * y[i] = a * x[i] + y[i] over FlatArray vs Array
+   */
+  openlib::FlatArray<float> flatX(ELEMENTS);
+  openlib::FlatArray<float> flatY(ELEMENTS);
+  openlib::Array<float> arrayX(ELEMENTS);
+  openlib::Array<float> arrayY(ELEMENTS);
+  const float a = 1.5f;
+  const double bytes = 3.0 * ELEMENTS * sizeof(float);
+
+  double flatSeconds = bestOf(RUNS, [&]() {
+    saxpyLoop(a, flatX, flatY);
+    doNotOptimize(flatY.data());
+  });
+  reportThroughput("FlatArray<float> saxpy", bytes, flatSeconds);
+
+  double arraySeconds = bestOf(RUNS, [&]() {
+    saxpyLoop(a, arrayX, arrayY);
+    doNotOptimize(arrayY.data());
+  });
+  reportThroughput("Array<float> saxpy", bytes, arraySeconds);
+}
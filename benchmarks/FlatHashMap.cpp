@@ -0,0 +1,100 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/FlatHashMap.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t ELEMENTS = sizeFromEnv("OPENLIB_BENCH_HASH_ELEMENTS", std::size_t(1) << 22);
+const int RUNS = 3;
+
+template <class Map>
+void measure(const char* name, const openlib::FlatArray<uint64_t>& keys,
+             const openlib::FlatArray<uint64_t>& missing) {
+  const std::size_t n = keys.size();
+  std::size_t found = 0;
+
+  double insertSeconds = bestOf(RUNS, [&]() {
+    Map map;
+    for (std::size_t i = 0; i < n; i++) {
+      map[keys[i]] = i;
+    }
+    found += map.size();
+  });
+  reportRate((std::string(name) + " insert").c_str(), n, insertSeconds);
+
+  Map map;
+  for (std::size_t i = 0; i < n; i++) {
+    map[keys[i]] = i;
+  }
+
+  double hitSeconds = bestOf(RUNS, [&]() {
+    for (std::size_t i = 0; i < n; i++) {
+      found += map.find(keys[i])->second;
+    }
+  });
+  reportRate((std::string(name) + " hit").c_str(), n, hitSeconds);
+
+  double missSeconds = bestOf(RUNS, [&]() {
+    for (std::size_t i = 0; i < n; i++) {
+      found += map.count(missing[i]);
+    }
+  });
+  reportRate((std::string(name) + " miss").c_str(), n, missSeconds);
+
+  double eraseSeconds = bestOf(1, [&]() {
+    for (std::size_t i = 0; i < n; i++) {
+      found += map.erase(keys[i]);
+    }
+  });
+  reportRate((std::string(name) + " erase").c_str(), n, eraseSeconds);
+
+  doNotOptimize(&found);
+}
+
+} // namespace
+
+TEST(FlatHashMapBenchmark, againstUnorderedMap) {
+  std::mt19937_64 random(1);
+  openlib::FlatArray<uint64_t> keys(ELEMENTS, openlib::uninitialized);
+  openlib::FlatArray<uint64_t> missing(ELEMENTS, openlib::uninitialized);
+  // even keys are present, odd ones are not
+  for (std::size_t i = 0; i < ELEMENTS; i++) {
+    keys[i] = random() << 1;
+    missing[i] = keys[i] | 1;
+  }
+
+  measure<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", keys, missing);
+  measure<openlib::FlatHashMap<uint64_t, uint64_t>>("FlatHashMap", keys, missing);
+}
@@ -0,0 +1,121 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+using openlib::kernels::Isa;
+
+namespace {
+
+// cache resident by default, so the kernels rather than memory are measured
+const std::size_t ELEMENTS = sizeFromEnv("OPENLIB_BENCH_KERNEL_ELEMENTS", 1 << 13);
+const std::size_t REPEATS = 2000;
+const int RUNS = 5;
+
+template <class Function>
+void runPerIsa(const char* kernel, double bytesPerRepeat, Function function) {
+  Isa previous = openlib::kernels::activeIsa();
+  for (Isa isa : openlib::kernels::supportedIsas()) {
+    openlib::kernels::setIsa(isa);
+    double seconds = bestOf(RUNS, [&]() {
+      for (std::size_t r = 0; r < REPEATS; r++) {
+        function();
+      }
+    });
+    std::string name = std::string(kernel) + ", " + openlib::kernels::isaName(isa);
+    reportThroughput(name.c_str(), bytesPerRepeat * REPEATS, seconds);
+  }
+  openlib::kernels::setIsa(previous);
+}
+
+} // namespace
+
+TEST(KernelsBenchmark, perIsa) {
+  openlib::FlatArray<float> floats(ELEMENTS);
+  openlib::FlatArray<uint32_t> ints(ELEMENTS);
+  openlib::FlatArray<uint32_t> other(ELEMENTS);
+  openlib::fill(floats, 1.0f);
+  openlib::fill(ints, 1u);
+  openlib::fill(other, 1u);
+  const double bytes = ELEMENTS * 4.0;
+
+  runPerIsa("fill uint32", bytes, [&]() {
+    openlib::fill(ints, 1u);
+    doNotOptimize(ints.data());
+  });
+
+  runPerIsa("equal uint32", 2 * bytes, [&]() {
+    bool result = openlib::equal(ints, other);
+    doNotOptimize(&result);
+  });
+
+  runPerIsa("count uint32", bytes, [&]() {
+    std::size_t result = openlib::count(ints, 1u);
+    doNotOptimize(&result);
+  });
+
+  runPerIsa("sum float", bytes, [&]() {
+    float result = openlib::sum(floats);
+    doNotOptimize(&result);
+  });
+
+  runPerIsa("max float", bytes, [&]() {
+    float result = openlib::max(floats);
+    doNotOptimize(&result);
+  });
+
+  runPerIsa("hash uint32", bytes, [&]() {
+    uint64_t result = openlib::hash(ints);
+    doNotOptimize(&result);
+  });
+}
+
+TEST(KernelsBenchmark, hashAgainstStdHash) {
+  const std::string text(ELEMENTS * 4, 'x');
+  std::hash<std::string> hasher;
+  std::size_t result = 0;
+
+  double stdSeconds = bestOf(RUNS, [&]() {
+    for (std::size_t r = 0; r < REPEATS; r++) {
+      result += hasher(text);
+    }
+  });
+  reportThroughput("std::hash<std::string>", double(text.size()) * REPEATS, stdSeconds);
+
+  double hashSeconds = bestOf(RUNS, [&]() {
+    for (std::size_t r = 0; r < REPEATS; r++) {
+      result += openlib::kernels::hash64(text.data(), text.size());
+    }
+  });
+  reportThroughput("kernels::hash64", double(text.size()) * REPEATS, hashSeconds);
+  doNotOptimize(&result);
+}
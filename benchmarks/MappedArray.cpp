@@ -0,0 +1,83 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+#include <openlib/MappedArray.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t ELEMENTS = sizeFromEnv("OPENLIB_BENCH_MAPPED_ELEMENTS", 32 << 20);
+const int RUNS = 3;
+
+} // namespace
+
+TEST(MappedArrayBenchmark, loadTable) {
+  /*
+   * Time until a table is usable: reading the file into a FlatArray vs
+   * mapping it. Also times a full scan of the mapping, which is when its
+   * pages are actually read.
+   */
+  const std::string path = "/tmp/openlib_bench_mapped.bin";
+  {
+    openlib::MappedArray<uint64_t> table(path, ELEMENTS);
+    openlib::fill(table, uint64_t(1));
+  }
+  const double bytes = ELEMENTS * sizeof(uint64_t);
+  uint64_t total = 0;
+
+  double readSeconds = bestOf(RUNS, [&]() {
+    std::ifstream in(path, std::ios::binary);
+    openlib::FlatArray<uint64_t> table(ELEMENTS, openlib::uninitialized);
+    in.read(reinterpret_cast<char*>(table.data()), bytes);
+    total += table[ELEMENTS / 2];
+  });
+  reportThroughput("load by reading into FlatArray", bytes, readSeconds);
+
+  double mapSeconds = bestOf(RUNS, [&]() {
+    openlib::MappedArray<uint64_t> table(path);
+    total += table[ELEMENTS / 2];
+  });
+  reportThroughput("load by mapping", bytes, mapSeconds);
+  std::printf("%-48s %10.3f ms\n", "  time to first lookup", mapSeconds * 1e3);
+
+  double scanSeconds = bestOf(RUNS, [&]() {
+    openlib::MappedArray<uint64_t> table(path);
+    table.advise(openlib::MappedFile::Advice::Sequential);
+    total += openlib::sum(table);
+  });
+  reportThroughput("map and scan", bytes, scanSeconds);
+
+  doNotOptimize(&total);
+  std::remove(path.c_str());
+}
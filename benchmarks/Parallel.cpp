@@ -0,0 +1,110 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/Parallel.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t BYTES = sizeFromEnv("OPENLIB_BENCH_PARALLEL_BYTES", std::size_t(1) << 30);
+const int RUNS = 3;
+
+// 1, 2, 4, ... up to the hardware thread count
+template <class Function>
+void forEachThreadCount(Function function) {
+  const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+  for (std::size_t threads = 1; ; threads *= 2) {
+    threads = std::min(threads, hardware);
+    openlib::ThreadPool pool(threads);
+    openlib::ParallelOptions options;
+    options.pool = &pool;
+    function(threads, options);
+    if (threads == hardware) {
+      break;
+    }
+  }
+}
+
+std::string label(const char* name, std::size_t threads) {
+  return std::string(name) + " x" + std::to_string(threads);
+}
+
+} // namespace
+
+TEST(ParallelBenchmark, fillAndReduce) {
+  const std::size_t elements = BYTES / sizeof(float);
+  openlib::FlatArray<float> array(elements, openlib::uninitialized);
+  float total = 0;
+
+  forEachThreadCount([&](std::size_t threads, const openlib::ParallelOptions& options) {
+    double fillSeconds = bestOf(RUNS, [&]() {
+      openlib::parallelFill(array, 1.0f, options);
+    });
+    reportThroughput(label("parallelFill", threads).c_str(), BYTES, fillSeconds);
+
+    double reduceSeconds = bestOf(RUNS, [&]() {
+      total += openlib::parallelReduce(array, 0.0f, options);
+    });
+    reportThroughput(label("parallelReduce", threads).c_str(), BYTES, reduceSeconds);
+
+    double transformSeconds = bestOf(RUNS, [&]() {
+      openlib::parallelTransform(array, array, [](float value) { return value * 0.5f + 1.0f; },
+                                 options);
+    });
+    reportThroughput(label("parallelTransform", threads).c_str(), BYTES, transformSeconds);
+  });
+
+  doNotOptimize(&total);
+}
+
+TEST(ParallelBenchmark, sort) {
+  // sorting is far slower per byte, keep it to an eighth of the array size
+  const std::size_t elements = BYTES / sizeof(uint32_t) / 8;
+  openlib::FlatArray<uint32_t> source(elements, openlib::uninitialized);
+  openlib::FlatArray<uint32_t> array(elements, openlib::uninitialized);
+  std::mt19937 random(1);
+  for (std::size_t i = 0; i < elements; i++) {
+    source[i] = random();
+  }
+
+  forEachThreadCount([&](std::size_t threads, const openlib::ParallelOptions& options) {
+    double seconds = bestOf(1, [&]() {
+      openlib::copy(array, source);
+      openlib::parallelSort(array, options);
+    });
+    reportRate(label("parallelSort", threads).c_str(), elements, seconds);
+  });
+
+  doNotOptimize(array.data());
+}
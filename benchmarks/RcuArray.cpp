@@ -0,0 +1,124 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/RcuArray.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t ENTRIES = sizeFromEnv("OPENLIB_BENCH_TABLE_ENTRIES", 1 << 16);
+const std::size_t LOOKUPS = sizeFromEnv("OPENLIB_BENCH_LOOKUPS", 1 << 22);
+const std::size_t MAX_READERS = sizeFromEnv("OPENLIB_BENCH_READERS", 64);
+
+openlib::FlatArray<uint32_t> table(uint32_t version) {
+  openlib::FlatArray<uint32_t> result(ENTRIES, openlib::uninitialized);
+  result.fill(version);
+  return result;
+}
+
+// run LOOKUPS lookups on each of readers threads while a writer republishes
+// the table every 100us; returns the wall time of the readers
+template <class Lookup, class Publish>
+double timeReaders(std::size_t readers, Lookup lookup, Publish publish) {
+  std::atomic<bool> done(false);
+  std::thread writer([&]() {
+    for (uint32_t version = 1; !done.load(); version++) {
+      publish(version);
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  });
+
+  std::atomic<uint64_t> sink(0);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < readers; t++) {
+    threads.emplace_back([&, t]() {
+      sink += lookup(t);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto stop = std::chrono::steady_clock::now();
+
+  done = true;
+  writer.join();
+  doNotOptimize(&sink);
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+std::string label(const char* name, std::size_t readers) {
+  return std::string(name) + " x" + std::to_string(readers);
+}
+
+} // namespace
+
+TEST(RcuArrayBenchmark, readerScaling) {
+  for (std::size_t readers = 1; readers <= MAX_READERS; readers *= 4) {
+    openlib::RcuArray<uint32_t> rcu(table(0));
+    double rcuSeconds = timeReaders(readers, [&](std::size_t seed) {
+      auto reader = rcu.reader();
+      uint64_t total = 0;
+      for (std::size_t i = 0; i < LOOKUPS; i++) {
+        auto snapshot = reader.read();
+        total += snapshot[(i * 2654435761u + seed) % snapshot.size()];
+      }
+      return total;
+    }, [&](uint32_t version) {
+      rcu.publish(table(version));
+    });
+    reportRate(label("RcuArray lookups", readers).c_str(), double(readers) * LOOKUPS, rcuSeconds);
+
+    std::mutex lock;
+    openlib::FlatArray<uint32_t>* locked = new openlib::FlatArray<uint32_t>(table(0));
+    double mutexSeconds = timeReaders(readers, [&](std::size_t seed) {
+      uint64_t total = 0;
+      for (std::size_t i = 0; i < LOOKUPS; i++) {
+        std::lock_guard<std::mutex> guard(lock);
+        total += (*locked)[(i * 2654435761u + seed) % locked->size()];
+      }
+      return total;
+    }, [&](uint32_t version) {
+      auto next = new openlib::FlatArray<uint32_t>(table(version));
+      std::lock_guard<std::mutex> guard(lock);
+      std::swap(locked, next);
+      delete next;
+    });
+    delete locked;
+    reportRate(label("mutex lookups", readers).c_str(), double(readers) * LOOKUPS, mutexSeconds);
+  }
+}
@@ -0,0 +1,86 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/SearchIndex.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+// largest index measured, sizes go up from 4K by factors of 16
+const std::size_t MAX_ELEMENTS = sizeFromEnv("OPENLIB_BENCH_SEARCH_ELEMENTS", std::size_t(1) << 26);
+const std::size_t QUERIES = 1 << 22;
+const int RUNS = 3;
+
+std::string label(const char* name, std::size_t elements) {
+  return std::string(name) + " " + std::to_string(elements);
+}
+
+} // namespace
+
+TEST(SearchIndexBenchmark, lowerBound) {
+  std::mt19937 random(1);
+  openlib::FlatArray<uint32_t> keys(QUERIES, openlib::uninitialized);
+  openlib::FlatArray<std::size_t> results(QUERIES, openlib::uninitialized);
+
+  for (std::size_t elements = 4096; elements <= MAX_ELEMENTS; elements *= 16) {
+    openlib::FlatArray<uint32_t> sorted(elements, openlib::uninitialized);
+    for (std::size_t i = 0; i < elements; i++) {
+      sorted[i] = static_cast<uint32_t>(i * 3);
+    }
+    for (auto& key : keys) {
+      key = static_cast<uint32_t>(random() % (elements * 3));
+    }
+    openlib::SearchIndex<uint32_t> index(sorted);
+
+    std::size_t total = 0;
+    double binarySeconds = bestOf(RUNS, [&]() {
+      for (std::size_t i = 0; i < QUERIES; i++) {
+        total += std::lower_bound(sorted.begin(), sorted.end(), keys[i]) - sorted.begin();
+      }
+    });
+    reportRate(label("std::lower_bound", elements).c_str(), QUERIES, binarySeconds);
+
+    double indexSeconds = bestOf(RUNS, [&]() {
+      for (std::size_t i = 0; i < QUERIES; i++) {
+        total += index.lowerBound(keys[i]);
+      }
+    });
+    reportRate(label("SearchIndex::lowerBound", elements).c_str(), QUERIES, indexSeconds);
+
+    double batchSeconds = bestOf(RUNS, [&]() { index.lowerBound(keys, results); });
+    reportRate(label("SearchIndex::lowerBound batched", elements).c_str(), QUERIES, batchSeconds);
+
+    doNotOptimize(&total);
+    doNotOptimize(results.data());
+  }
+}
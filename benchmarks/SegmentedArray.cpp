@@ -0,0 +1,89 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Kernels.h>
+#include <openlib/SegmentedArray.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t ELEMENTS = sizeFromEnv("OPENLIB_BENCH_ELEMENTS", 1 << 24);
+const int RUNS = 5;
+
+} // namespace
+
+TEST(SegmentedArrayBenchmark, appendAndScan) {
+  openlib::SegmentedArray<float> array;
+  std::vector<float> vector;
+
+  double appendSeconds = bestOf(1, [&]() {
+    for (std::size_t i = 0; i < ELEMENTS; i++) {
+      array.push_back(1.0f);
+    }
+  });
+  reportRate("SegmentedArray push_back", ELEMENTS, appendSeconds);
+
+  double vectorAppendSeconds = bestOf(1, [&]() {
+    for (std::size_t i = 0; i < ELEMENTS; i++) {
+      vector.push_back(1.0f);
+    }
+  });
+  reportRate("std::vector push_back", ELEMENTS, vectorAppendSeconds);
+
+  const double bytes = ELEMENTS * sizeof(float);
+  float total = 0;
+
+  double chunkSeconds = bestOf(RUNS, [&]() {
+    array.forEachChunk([&](const float* data, std::size_t count) {
+      total += openlib::kernels::sum(data, count);
+    });
+  });
+  reportThroughput("SegmentedArray forEachChunk sum", bytes, chunkSeconds);
+
+  double indexSeconds = bestOf(RUNS, [&]() {
+    float sum = 0;
+    for (std::size_t i = 0; i < array.size(); i++) {
+      sum += array[i];
+    }
+    total += sum;
+  });
+  reportThroughput("SegmentedArray operator[] sum", bytes, indexSeconds);
+
+  double iteratorSeconds = bestOf(RUNS, [&]() {
+    float sum = 0;
+    for (float value : array) {
+      sum += value;
+    }
+    total += sum;
+  });
+  reportThroughput("SegmentedArray iterator sum", bytes, iteratorSeconds);
+
+  doNotOptimize(&total);
+}
@@ -0,0 +1,318 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Array.h>
+#include <openlib/Deserializer.h>
+#include <openlib/SegmentedSerializer.h>
+#include <openlib/Serializer.h>
+#include <openlib/Writer.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t MESSAGE_BYTES = sizeFromEnv("OPENLIB_BENCH_MESSAGE_BYTES", 8 << 20);
+const int RUNS = 20;
+
+} // namespace
+
+TEST(SerializerBenchmark, constructAndFill) {
+  /*
+   * Construct a large Serializer and write a message into it in 4 KiB
+   * chunks, zeroed vs uninitialized storage.
+   */
+  uint8_t chunk[4096] = {};
+
+  double zeroedSeconds = bestOf(RUNS, [&]() {
+    openlib::Serializer serializer(MESSAGE_BYTES);
+    while (serializer.remaining() >= sizeof(chunk)) {
+      serializer.put(chunk, sizeof(chunk));
+    }
+    doNotOptimize(serializer.data());
+  });
+  reportThroughput("Serializer(capacity) + fill", MESSAGE_BYTES, zeroedSeconds);
+
+  double uninitializedSeconds = bestOf(RUNS, [&]() {
+    openlib::Serializer serializer(MESSAGE_BYTES, openlib::uninitialized);
+    while (serializer.remaining() >= sizeof(chunk)) {
+      serializer.put(chunk, sizeof(chunk));
+    }
+    doNotOptimize(serializer.data());
+  });
+  reportThroughput("Serializer(capacity, uninitialized) + fill", MESSAGE_BYTES, uninitializedSeconds);
+}
+
+TEST(SerializerBenchmark, decodeFields) {
+  /*
+   * Read back a message of mixed integer fields and short strings, copying
+   * the strings vs viewing them in place.
+   */
+  openlib::Serializer serializer(MESSAGE_BYTES);
+  std::size_t records = 0;
+  while (serializer.remaining() >= 32) {
+    serializer.putUInt32(static_cast<uint32_t>(records));
+    serializer.putUInt64(records * 3);
+    serializer.putInt16(-1);
+    serializer.putString("abcdefghijklmn");
+    ++records;
+  }
+
+  double copySeconds = bestOf(RUNS, [&]() {
+    openlib::Deserializer deserializer(serializer.view());
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < records; ++i) {
+      sum += deserializer.getUInt32();
+      sum += deserializer.getUInt64();
+      sum += deserializer.getInt16();
+      sum += deserializer.getString().size();
+    }
+    doNotOptimize(&sum);
+  });
+  reportThroughput("Deserializer get* + getString", serializer.size(), copySeconds);
+
+  double viewSeconds = bestOf(RUNS, [&]() {
+    openlib::Deserializer deserializer(serializer.view());
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < records; ++i) {
+      sum += deserializer.getUInt32();
+      sum += deserializer.getUInt64();
+      sum += deserializer.getInt16();
+      sum += deserializer.getStringView().size();
+    }
+    doNotOptimize(&sum);
+  });
+  reportThroughput("Deserializer get* + getStringView", serializer.size(), viewSeconds);
+}
+
+TEST(SerializerBenchmark, smallFields) {
+  /*
+   * Write records of three small integer fields: through the virtual
+   * Serializer, through Writer::put*, and through one Writer::reserve()
+   * per record followed by unchecked writes.
+   */
+  const std::size_t RECORD_BYTES = sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t);
+  const std::size_t records = MESSAGE_BYTES / RECORD_BYTES;
+  openlib::Serializer serializer(records * RECORD_BYTES);
+
+  // a Serializer cannot be rewound, so give each run its own, pre-faulted
+  std::vector<std::unique_ptr<openlib::Serializer>> outputs;
+  for (int run = 0; run < RUNS; ++run) {
+    outputs.emplace_back(new openlib::Serializer(serializer.capacity()));
+  }
+
+  int run = 0;
+  double virtualSeconds = bestOf(RUNS, [&]() {
+    openlib::Serializer& output = *outputs[run++];
+    for (std::size_t i = 0; i < records; ++i) {
+      output.putUInt32(static_cast<uint32_t>(i));
+      output.putUInt16(static_cast<uint16_t>(i));
+      output.putUInt8(static_cast<uint8_t>(i));
+    }
+    doNotOptimize(output.data());
+  });
+  outputs.clear();
+  reportThroughput("Serializer put* (virtual)", records * RECORD_BYTES, virtualSeconds);
+
+  double checkedSeconds = bestOf(RUNS, [&]() {
+    openlib::Writer writer(serializer.data(), serializer.capacity());
+    for (std::size_t i = 0; i < records; ++i) {
+      writer.putUInt32(static_cast<uint32_t>(i));
+      writer.putUInt16(static_cast<uint16_t>(i));
+      writer.putUInt8(static_cast<uint8_t>(i));
+    }
+    doNotOptimize(writer.data());
+  });
+  reportThroughput("Writer put*", records * RECORD_BYTES, checkedSeconds);
+
+  double reservedSeconds = bestOf(RUNS, [&]() {
+    openlib::Writer writer(serializer.data(), serializer.capacity());
+    for (std::size_t i = 0; i < records; ++i) {
+      writer.reserve(RECORD_BYTES);
+      writer.writeUInt32(static_cast<uint32_t>(i));
+      writer.writeUInt16(static_cast<uint16_t>(i));
+      writer.writeUInt8(static_cast<uint8_t>(i));
+    }
+    doNotOptimize(writer.data());
+  });
+  reportThroughput("Writer reserve + write*", records * RECORD_BYTES, reservedSeconds);
+}
+
+TEST(SerializerBenchmark, growable) {
+  /*
+   * Serialize small messages of unknown size: a Serializer sized for the
+   * worst case vs a SegmentedSerializer growing in 4 KiB segments from the
+   * shared BufferPool, and the cost of flattening the result.
+   */
+  const std::size_t WORST_CASE_BYTES = 1 << 20;
+  const std::size_t MESSAGE_FIELDS = 512;
+  const std::size_t MESSAGES = 2000;
+  const std::size_t messageBytes = MESSAGE_FIELDS * sizeof(uint64_t);
+
+  double fixedSeconds = bestOf(RUNS, [&]() {
+    for (std::size_t m = 0; m < MESSAGES; ++m) {
+      openlib::Serializer message(WORST_CASE_BYTES, openlib::uninitialized,
+                                  openlib::BufferPool::shared());
+      openlib::Writer& writer = message.writer();
+      for (std::size_t i = 0; i < MESSAGE_FIELDS; ++i) {
+        writer.putUInt64(i);
+      }
+      doNotOptimize(message.data());
+    }
+  });
+  reportThroughput("Serializer, worst-case capacity", MESSAGES * messageBytes, fixedSeconds);
+
+  double segmentedSeconds = bestOf(RUNS, [&]() {
+    for (std::size_t m = 0; m < MESSAGES; ++m) {
+      openlib::SegmentedSerializer message;
+      for (std::size_t i = 0; i < MESSAGE_FIELDS; ++i) {
+        message.putUInt64(i);
+      }
+      std::vector<struct iovec> iovecs = message.iovecs();
+      doNotOptimize(iovecs.data());
+    }
+  });
+  reportThroughput("SegmentedSerializer + iovecs", MESSAGES * messageBytes, segmentedSeconds);
+
+  double flattenSeconds = bestOf(RUNS, [&]() {
+    for (std::size_t m = 0; m < MESSAGES; ++m) {
+      openlib::SegmentedSerializer message;
+      for (std::size_t i = 0; i < MESSAGE_FIELDS; ++i) {
+        message.putUInt64(i);
+      }
+      openlib::Array<uint8_t> flat = message.flatten();
+      doNotOptimize(flat.data());
+    }
+  });
+  reportThroughput("SegmentedSerializer + flatten", MESSAGES * messageBytes, flattenSeconds);
+}
+
+TEST(SerializerBenchmark, bulkArrays) {
+  /*
+   * Write and read back an array of int32_t samples one element at a time
+   * vs with the bulk array methods, which byte swap with vector shuffles.
+   */
+  const std::size_t count = MESSAGE_BYTES / sizeof(int32_t);
+  openlib::Array<int32_t> samples(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    samples[i] = static_cast<int32_t>(i * 2654435761u);
+  }
+  openlib::Serializer serializer(MESSAGE_BYTES);
+
+  double elementSeconds = bestOf(RUNS, [&]() {
+    openlib::Writer writer(serializer.data(), serializer.capacity());
+    for (std::size_t i = 0; i < count; ++i) {
+      writer.putInt32(samples[i]);
+    }
+    doNotOptimize(writer.data());
+  });
+  reportThroughput("Writer putInt32 per element", MESSAGE_BYTES, elementSeconds);
+
+  double bulkSeconds = bestOf(RUNS, [&]() {
+    openlib::Writer writer(serializer.data(), serializer.capacity());
+    writer.putInt32Array(samples);
+    doNotOptimize(writer.data());
+  });
+  reportThroughput("Writer putInt32Array", MESSAGE_BYTES, bulkSeconds);
+
+  double virtualSeconds = bestOf(RUNS, [&]() {
+    openlib::Serializer output(MESSAGE_BYTES, openlib::uninitialized);
+    output.putInt32Array(samples);
+    doNotOptimize(output.data());
+  });
+  reportThroughput("Serializer putInt32Array (incl. allocation)", MESSAGE_BYTES, virtualSeconds);
+
+  openlib::Array<int32_t> decoded(count);
+  double readSeconds = bestOf(RUNS, [&]() {
+    openlib::Deserializer deserializer(serializer.data(), MESSAGE_BYTES);
+    for (std::size_t i = 0; i < count; ++i) {
+      decoded[i] = deserializer.getInt32();
+    }
+    doNotOptimize(decoded.data());
+  });
+  reportThroughput("Deserializer getInt32 per element", MESSAGE_BYTES, readSeconds);
+
+  double bulkReadSeconds = bestOf(RUNS, [&]() {
+    openlib::Deserializer deserializer(serializer.data(), MESSAGE_BYTES);
+    deserializer.getInt32Array(decoded);
+    doNotOptimize(decoded.data());
+  });
+  reportThroughput("Deserializer getInt32Array", MESSAGE_BYTES, bulkReadSeconds);
+}
+
+TEST(SerializerBenchmark, byteOrder) {
+  /*
+   * Write and read back records and an int64_t array in the default
+   * big endian integer format vs in native order, which swaps nothing and
+   * turns the bulk paths into memcpy.
+   */
+  const std::size_t count = MESSAGE_BYTES / sizeof(int64_t);
+  openlib::Array<int64_t> samples(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    samples[i] = static_cast<int64_t>(i * 0x9e3779b97f4a7c15ull);
+  }
+  openlib::Array<int64_t> decoded(count);
+  openlib::Array<uint8_t> buffer(MESSAGE_BYTES);
+
+  double bigSeconds = bestOf(RUNS, [&]() {
+    openlib::Writer writer(buffer.data(), buffer.size());
+    for (std::size_t i = 0; i < count; ++i) {
+      writer.putInt64(samples[i]);
+    }
+    doNotOptimize(writer.data());
+  });
+  reportThroughput("Writer putInt64, big endian", MESSAGE_BYTES, bigSeconds);
+
+  double nativeSeconds = bestOf(RUNS, [&]() {
+    openlib::BasicWriter<openlib::NativeEndian> writer(buffer.data(), buffer.size());
+    for (std::size_t i = 0; i < count; ++i) {
+      writer.putInt64(samples[i]);
+    }
+    doNotOptimize(writer.data());
+  });
+  reportThroughput("Writer putInt64, native", MESSAGE_BYTES, nativeSeconds);
+
+  double bigBulkSeconds = bestOf(RUNS, [&]() {
+    openlib::Writer writer(buffer.data(), buffer.size());
+    writer.putInt64Array(samples);
+    openlib::Deserializer deserializer(writer.view());
+    deserializer.getInt64Array(decoded);
+    doNotOptimize(decoded.data());
+  });
+  reportThroughput("putInt64Array + getInt64Array, big endian", 2 * MESSAGE_BYTES, bigBulkSeconds);
+
+  double nativeBulkSeconds = bestOf(RUNS, [&]() {
+    openlib::BasicWriter<openlib::NativeEndian> writer(buffer.data(), buffer.size());
+    writer.putInt64Array(samples);
+    openlib::BasicDeserializer<openlib::NativeEndian> deserializer(writer.view());
+    deserializer.getInt64Array(decoded);
+    doNotOptimize(decoded.data());
+  });
+  reportThroughput("putInt64Array + getInt64Array, native", 2 * MESSAGE_BYTES, nativeBulkSeconds);
+}
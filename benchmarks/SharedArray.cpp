@@ -0,0 +1,78 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/SharedArray.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t ELEMENTS = sizeFromEnv("OPENLIB_BENCH_ELEMENTS", 1 << 24);
+const std::size_t CONSUMERS = 16;
+const int RUNS = 3;
+
+} // namespace
+
+TEST(SharedArrayBenchmark, fanOut) {
+  openlib::FlatArray<uint32_t> table(ELEMENTS);
+  openlib::SharedArray<uint32_t> shared(ELEMENTS);
+  table.fill(1);
+  shared.fill(1);
+
+  // bytes each consumer gets to read, per second of fan-out
+  const double bytes = double(CONSUMERS) * ELEMENTS * sizeof(uint32_t);
+
+  double deepSeconds = bestOf(RUNS, [&]() {
+    std::vector<openlib::FlatArray<uint32_t>> consumers;
+    consumers.reserve(CONSUMERS);
+    for (std::size_t i = 0; i < CONSUMERS; i++) {
+      consumers.emplace_back(table);
+    }
+    doNotOptimize(consumers.data());
+  });
+  reportThroughput("FlatArray fan-out by deep copy", bytes, deepSeconds);
+
+  double sharedSeconds = bestOf(RUNS, [&]() {
+    std::vector<openlib::SharedArray<uint32_t>> consumers;
+    consumers.reserve(CONSUMERS);
+    for (std::size_t i = 0; i < CONSUMERS; i++) {
+      consumers.emplace_back(shared);
+    }
+    doNotOptimize(consumers.data());
+  });
+  reportThroughput("SharedArray fan-out", bytes, sharedSeconds);
+
+  double writeSeconds = bestOf(RUNS, [&]() {
+    std::vector<openlib::SharedArray<uint32_t>> consumers(CONSUMERS, shared);
+    consumers[0].set(0, 2);
+    doNotOptimize(consumers.data());
+  });
+  reportThroughput("SharedArray fan-out, one writer", bytes, writeSeconds);
+}
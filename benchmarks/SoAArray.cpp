@@ -0,0 +1,79 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+#include <openlib/SoAArray.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+const std::size_t ELEMENTS = sizeFromEnv("OPENLIB_BENCH_ELEMENTS", 1 << 24);
+const int RUNS = 5;
+
+struct Record {
+  uint64_t id;
+  float price;
+  uint32_t quantity;
+  uint8_t flags;
+};
+
+__attribute__((noinline)) float sumPrices(const openlib::FlatArray<Record>& records) {
+  float total = 0;
+  for (std::size_t i = 0; i < records.size(); i++) {
+    total += records[i].price;
+  }
+  return total;
+}
+
+} // namespace
+
+TEST(SoAArrayBenchmark, columnScan) {
+  openlib::FlatArray<Record> records(ELEMENTS);
+  openlib::SoAArray<uint64_t, float, uint32_t, uint8_t> columns(ELEMENTS);
+  for (std::size_t i = 0; i < ELEMENTS; i++) {
+    records[i].price = 1.0f;
+  }
+  columns.column<1>().fill(1.0f);
+
+  const double bytes = ELEMENTS * sizeof(float);
+  float total = 0;
+
+  double aosSeconds = bestOf(RUNS, [&]() {
+    total += sumPrices(records);
+  });
+  reportThroughput("array of structs, price scan", bytes, aosSeconds);
+
+  double soaSeconds = bestOf(RUNS, [&]() {
+    total += openlib::sum(columns.column<1>());
+  });
+  reportThroughput("SoAArray, price column scan", bytes, soaSeconds);
+
+  doNotOptimize(&total);
+}
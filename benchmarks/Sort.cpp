@@ -0,0 +1,164 @@
+/****************************************************************************
+Copyright (c) 2018, OpenLib Project
+All rights reserved.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+#include <openlib/Parallel.h>
+#include <openlib/Sort.h>
+
+#include "Benchmark.h"
+
+using namespace openlib::benchmark;
+
+namespace {
+
+// largest size measured, sizes go up from 1K by factors of 32; set to
+// 1073741824 for the full 1K to 1G sweep on a machine with the memory
+const std::size_t MAX_ELEMENTS = sizeFromEnv("OPENLIB_BENCH_SORT_ELEMENTS", std::size_t(1) << 25);
+// small sizes are sorted repeatedly so every measurement covers about this many
+const std::size_t ELEMENTS_PER_RUN = std::size_t(1) << 24;
+const int RUNS = 3;
+
+template <class type>
+type randomValue(std::mt19937_64& random);
+
+template <>
+uint32_t randomValue<uint32_t>(std::mt19937_64& random) {
+  return static_cast<uint32_t>(random());
+}
+
+template <>
+uint64_t randomValue<uint64_t>(std::mt19937_64& random) {
+  return random();
+}
+
+template <>
+float randomValue<float>(std::mt19937_64& random) {
+  return std::normal_distribution<float>(0, 1e6f)(random);
+}
+
+std::string label(const char* name, const char* type, std::size_t elements) {
+  return std::string(name) + " " + type + " " + std::to_string(elements);
+}
+
+template <class type>
+void compareSorts(const char* typeName) {
+  std::mt19937_64 random(1);
+  for (std::size_t elements = 1024; elements <= MAX_ELEMENTS; elements *= 32) {
+    openlib::FlatArray<type> source(elements, openlib::uninitialized);
+    openlib::FlatArray<type> array(elements, openlib::uninitialized);
+    for (auto& value : source) {
+      value = randomValue<type>(random);
+    }
+    const std::size_t repeats = std::max<std::size_t>(1, ELEMENTS_PER_RUN / elements);
+    const double sorted = double(elements) * repeats;
+
+    double stdSeconds = bestOf(RUNS, [&]() {
+      for (std::size_t i = 0; i < repeats; i++) {
+        openlib::copy(array, source);
+        std::sort(array.begin(), array.end());
+      }
+    });
+    reportRate(label("std::sort", typeName, elements).c_str(), sorted, stdSeconds);
+
+    double radixSeconds = bestOf(RUNS, [&]() {
+      for (std::size_t i = 0; i < repeats; i++) {
+        openlib::copy(array, source);
+        openlib::sort(array);
+      }
+    });
+    reportRate(label("openlib::sort", typeName, elements).c_str(), sorted, radixSeconds);
+
+    double parallelSeconds = bestOf(RUNS, [&]() {
+      for (std::size_t i = 0; i < repeats; i++) {
+        openlib::copy(array, source);
+        openlib::parallelSort(array);
+      }
+    });
+    reportRate(label("openlib::parallelSort", typeName, elements).c_str(), sorted,
+               parallelSeconds);
+    doNotOptimize(array.data());
+  }
+}
+
+} // namespace
+
+TEST(SortBenchmark, uint32) {
+  compareSorts<uint32_t>("uint32");
+}
+
+TEST(SortBenchmark, uint64) {
+  compareSorts<uint64_t>("uint64");
+}
+
+TEST(SortBenchmark, float32) {
+  compareSorts<float>("float");
+}
+
+TEST(SortBenchmark, keyValue) {
+  std::mt19937_64 random(2);
+  for (std::size_t elements = 1024; elements <= MAX_ELEMENTS; elements *= 32) {
+    openlib::FlatArray<uint32_t> sourceKeys(elements, openlib::uninitialized);
+    openlib::FlatArray<uint32_t> keys(elements, openlib::uninitialized);
+    openlib::FlatArray<uint32_t> values(elements, openlib::uninitialized);
+    openlib::FlatArray<std::pair<uint32_t, uint32_t>> pairs(elements, openlib::uninitialized);
+    for (auto& key : sourceKeys) {
+      key = static_cast<uint32_t>(random());
+    }
+    const std::size_t repeats = std::max<std::size_t>(1, ELEMENTS_PER_RUN / elements);
+    const double sorted = double(elements) * repeats;
+
+    double stdSeconds = bestOf(RUNS, [&]() {
+      for (std::size_t i = 0; i < repeats; i++) {
+        for (std::size_t j = 0; j < elements; j++) {
+          pairs[j] = std::make_pair(sourceKeys[j], uint32_t(j));
+        }
+        std::stable_sort(pairs.begin(), pairs.end(),
+                         [](const std::pair<uint32_t, uint32_t>& lhs,
+                            const std::pair<uint32_t, uint32_t>& rhs) {
+                           return lhs.first < rhs.first;
+                         });
+      }
+    });
+    reportRate(label("std::stable_sort pairs", "uint32", elements).c_str(), sorted, stdSeconds);
+
+    double radixSeconds = bestOf(RUNS, [&]() {
+      for (std::size_t i = 0; i < repeats; i++) {
+        openlib::copy(keys, sourceKeys);
+        for (std::size_t j = 0; j < elements; j++) {
+          values[j] = uint32_t(j);
+        }
+        openlib::sortByKey(keys, values);
+      }
+    });
+    reportRate(label("openlib::sortByKey", "uint32", elements).c_str(), sorted, radixSeconds);
+    doNotOptimize(pairs.data());
+    doNotOptimize(values.data());
+  }
+}
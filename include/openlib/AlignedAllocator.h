@@ -0,0 +1,287 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace openlib {
+
+constexpr std::size_t CACHE_LINE_BYTES = 64;
+constexpr std::size_t PAGE_BYTES = 4096;
+constexpr std::size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+/**
+ * Standard allocator with a guaranteed alignment
+ *
+ * Storage starts on an alignment boundary and is padded to a multiple of
+ * alignment, so two arrays never share a cache line (no false sharing
+ * between threads working on neighbouring arrays).
+ *
+ * The guaranteed alignment is available at compile time as
+ * AlignedAllocator::alignment, FlatArray exposes it as well.
+ */
+template <class type, std::size_t align = CACHE_LINE_BYTES>
+class AlignedAllocator {
+public:
+  static_assert((align & (align - 1)) == 0, "alignment must be a power of two");
+  static_assert(align >= alignof(type), "alignment must be at least alignof(type)");
+
+  using value_type = type;
+  static constexpr std::size_t alignment = align;
+
+  template <class rebound>
+  struct rebind {
+    using other = AlignedAllocator<rebound, align>;
+  };
+
+  AlignedAllocator() noexcept = default;
+
+  /**
+   * @brief converting constructor
+   */
+  template <class other>
+  AlignedAllocator(const AlignedAllocator<other, align>&) noexcept {}
+
+  /**
+   * @brief allocate storage for n elements
+   */
+  type* allocate(std::size_t n);
+
+  /**
+   * @brief release storage
+   */
+  void deallocate(type* p, std::size_t n) noexcept;
+};
+
+/**
+ * Standard allocator that maps whole pages from the operating system
+ *
+ * Storage is page aligned and comes straight from mmap, bypassing malloc.
+ * Suited to large, long-lived tables.
+ */
+template <class type>
+class PageAllocator {
+public:
+  using value_type = type;
+  static constexpr std::size_t alignment = PAGE_BYTES;
+
+  PageAllocator() noexcept = default;
+
+  /**
+   * @brief converting constructor
+   */
+  template <class other>
+  PageAllocator(const PageAllocator<other>&) noexcept {}
+
+  /**
+   * @brief allocate storage for n elements
+   */
+  type* allocate(std::size_t n);
+
+  /**
+   * @brief release storage
+   */
+  void deallocate(type* p, std::size_t n) noexcept;
+};
+
+/**
+ * Standard allocator backed by transparent huge pages
+ *
+ * Storage is mapped 2 MiB aligned, padded to a multiple of 2 MiB and
+ * advised with MADV_HUGEPAGE, which cuts TLB misses on large random access
+ * tables. Falls back to normal pages when the kernel has transparent huge
+ * pages disabled.
+ */
+template <class type>
+class HugePageAllocator {
+public:
+  using value_type = type;
+  static constexpr std::size_t alignment = HUGE_PAGE_BYTES;
+
+  HugePageAllocator() noexcept = default;
+
+  /**
+   * @brief converting constructor
+   */
+  template <class other>
+  HugePageAllocator(const HugePageAllocator<other>&) noexcept {}
+
+  /**
+   * @brief allocate storage for n elements
+   */
+  type* allocate(std::size_t n);
+
+  /**
+   * @brief release storage
+   */
+  void deallocate(type* p, std::size_t n) noexcept;
+};
+
+/**
+ * Alignment an allocator guarantees for type
+ *
+ * Allocator::alignment when the allocator declares one, alignof(type)
+ * otherwise.
+ */
+template <class type, class Allocator, class = void>
+struct AllocatorAlignment {
+  static constexpr std::size_t value = alignof(type);
+};
+
+template <class type, class Allocator>
+struct AllocatorAlignment<type, Allocator,
+                          typename std::enable_if<(Allocator::alignment > 0)>::type> {
+  static constexpr std::size_t value = Allocator::alignment;
+};
+
+/**
+ * @brief allocate memory with a given alignment
+ * Size is rounded up to a multiple of alignment.
+ * @throws std::bad_alloc
+ */
+void* alignedAllocate(std::size_t bytes, std::size_t alignment);
+
+/**
+ * @brief release memory from alignedAllocate
+ */
+void alignedDeallocate(void* p) noexcept;
+
+/**
+ * @brief map anonymous memory, optionally backed by huge pages
+ * @param bytes number of bytes, rounded up to a page or huge page
+ * @param hugePages align to and advise huge pages
+ * @throws std::bad_alloc
+ */
+void* mapPages(std::size_t bytes, bool hugePages);
+
+/**
+ * @brief release memory from mapPages
+ * @param p pointer returned by mapPages
+ * @param bytes bytes passed to mapPages
+ * @param hugePages value passed to mapPages
+ */
+void unmapPages(void* p, std::size_t bytes, bool hugePages) noexcept;
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, std::size_t align>
+constexpr std::size_t openlib::AlignedAllocator<type, align>::alignment;
+
+template <class type>
+constexpr std::size_t openlib::PageAllocator<type>::alignment;
+
+template <class type>
+constexpr std::size_t openlib::HugePageAllocator<type>::alignment;
+
+template <class type, class Allocator, class enable>
+constexpr std::size_t openlib::AllocatorAlignment<type, Allocator, enable>::value;
+
+template <class type, class Allocator>
+constexpr std::size_t openlib::AllocatorAlignment<
+    type, Allocator, typename std::enable_if<(Allocator::alignment > 0)>::type>::value;
+
+template <class type, std::size_t align>
+type* openlib::AlignedAllocator<type, align>::allocate(std::size_t n) {
+  if (n > std::numeric_limits<std::size_t>::max() / sizeof(type) - align) {
+    throw std::bad_alloc();
+  }
+  return static_cast<type*>(alignedAllocate(n * sizeof(type), align));
+}
+
+template <class type, std::size_t align>
+void openlib::AlignedAllocator<type, align>::deallocate(type* p, std::size_t) noexcept {
+  alignedDeallocate(p);
+}
+
+template <class type>
+type* openlib::PageAllocator<type>::allocate(std::size_t n) {
+  if (n > std::numeric_limits<std::size_t>::max() / sizeof(type) - HUGE_PAGE_BYTES) {
+    throw std::bad_alloc();
+  }
+  return static_cast<type*>(mapPages(n * sizeof(type), false));
+}
+
+template <class type>
+void openlib::PageAllocator<type>::deallocate(type* p, std::size_t n) noexcept {
+  unmapPages(p, n * sizeof(type), false);
+}
+
+template <class type>
+type* openlib::HugePageAllocator<type>::allocate(std::size_t n) {
+  if (n > std::numeric_limits<std::size_t>::max() / sizeof(type) - 2 * HUGE_PAGE_BYTES) {
+    throw std::bad_alloc();
+  }
+  return static_cast<type*>(mapPages(n * sizeof(type), true));
+}
+
+template <class type>
+void openlib::HugePageAllocator<type>::deallocate(type* p, std::size_t n) noexcept {
+  unmapPages(p, n * sizeof(type), true);
+}
+
+/**
+ * @brief equality, stateless allocators are always equal
+ */
+template <class type, class other, std::size_t align>
+inline bool operator==(const openlib::AlignedAllocator<type, align>&,
+                       const openlib::AlignedAllocator<other, align>&) {
+  return true;
+}
+
+template <class type, class other, std::size_t align>
+inline bool operator!=(const openlib::AlignedAllocator<type, align>&,
+                       const openlib::AlignedAllocator<other, align>&) {
+  return false;
+}
+
+template <class type, class other>
+inline bool operator==(const openlib::PageAllocator<type>&, const openlib::PageAllocator<other>&) {
+  return true;
+}
+
+template <class type, class other>
+inline bool operator!=(const openlib::PageAllocator<type>&, const openlib::PageAllocator<other>&) {
+  return false;
+}
+
+template <class type, class other>
+inline bool operator==(const openlib::HugePageAllocator<type>&,
+                       const openlib::HugePageAllocator<other>&) {
+  return true;
+}
+
+template <class type, class other>
+inline bool operator!=(const openlib::HugePageAllocator<type>&,
+                       const openlib::HugePageAllocator<other>&) {
+  return false;
+}
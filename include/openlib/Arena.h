@@ -0,0 +1,219 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#include <openlib/MemoryResource.h>
+
+namespace openlib {
+
+/**
+ * Monotonic arena
+ *
+ * Hands out memory by bumping a pointer through large blocks. Individual
+ * deallocations are ignored; everything is released at once by reset() or
+ * when the Arena is destroyed. Intended for short-lived, per-request data.
+ *
+ * Not thread safe.
+ */
+class Arena final : public MemoryResource {
+public:
+
+  static const std::size_t DEFAULT_BLOCK_SIZE;
+
+  /**
+   * @brief constructor
+   * @param blockSize bytes requested from the system at a time
+   */
+  explicit Arena(const std::size_t& blockSize = DEFAULT_BLOCK_SIZE);
+
+  /**
+   * @brief destructor, releases all memory
+   */
+  ~Arena() override;
+
+  /**
+   * @brief allocate memory
+   * @param bytes number of bytes
+   * @param alignment required alignment, a power of two
+   * @return pointer to the memory
+   */
+  void* allocate(std::size_t bytes, std::size_t alignment) override;
+
+  /**
+   * @brief does nothing, memory is released by reset()
+   */
+  void deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+
+  /**
+   * @brief release every allocation at once
+   * The most recent block is kept for reuse, the rest are returned to the
+   * system. Anything allocated from the Arena must no longer be in use.
+   */
+  void reset();
+
+  /**
+   * @brief bytes handed out since construction or the last reset
+   * @return bytes allocated, including alignment padding
+   */
+  std::size_t allocated() const;
+
+private:
+  struct Block {
+    Block* next;
+    std::size_t size;
+  };
+
+  const std::size_t blockSize;
+  Block* blocks;
+  std::uintptr_t cursor;
+  std::uintptr_t limit;
+  std::size_t bytesAllocated;
+
+  void* allocateFromNewBlock(std::size_t bytes, std::size_t alignment);
+
+  // no copy or assignment
+  Arena(const Arena& other) = delete;
+  Arena& operator=(const Arena& other) = delete;
+};
+
+/**
+ * Standard allocator that takes memory from an Arena
+ *
+ * Calls into the Arena are non-virtual, the common case inlines to a
+ * pointer bump.
+ */
+template <class type>
+class ArenaAllocator {
+public:
+  using value_type = type;
+
+  /**
+   * @brief constructor
+   * @param arena arena to allocate from, must outlive the allocator
+   */
+  ArenaAllocator(Arena& arena) noexcept;
+
+  /**
+   * @brief converting constructor
+   */
+  template <class other>
+  ArenaAllocator(const ArenaAllocator<other>& allocator) noexcept;
+
+  /**
+   * @brief allocate storage for n elements
+   */
+  type* allocate(std::size_t n);
+
+  /**
+   * @brief does nothing, memory is released by Arena::reset()
+   */
+  void deallocate(type* p, std::size_t n) noexcept;
+
+  /**
+   * @brief the underlying arena
+   */
+  Arena& arena() const noexcept;
+
+private:
+  Arena* source;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+inline void* openlib::Arena::allocate(std::size_t bytes, std::size_t alignment) {
+  std::uintptr_t p = (cursor + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+  // limit is 0 only before the first block, where p would be a null pointer
+  if (p < cursor || p > limit || bytes > limit - p || limit == 0) {
+    return allocateFromNewBlock(bytes, alignment);
+  }
+
+  bytesAllocated += p + bytes - cursor;
+  cursor = p + bytes;
+  return reinterpret_cast<void*>(p);
+}
+
+inline void openlib::Arena::deallocate(void*, std::size_t, std::size_t) {
+  // released by reset()
+}
+
+template <class type>
+openlib::ArenaAllocator<type>::ArenaAllocator(Arena& arena) noexcept:
+    source(&arena) {
+
+}
+
+template <class type>
+template <class other>
+openlib::ArenaAllocator<type>::ArenaAllocator(const ArenaAllocator<other>& allocator) noexcept:
+    source(&allocator.arena()) {
+
+}
+
+template <class type>
+type* openlib::ArenaAllocator<type>::allocate(std::size_t n) {
+  if (n > std::numeric_limits<std::size_t>::max() / sizeof(type)) {
+    throw std::bad_alloc();
+  }
+  return static_cast<type*>(source->allocate(n * sizeof(type), alignof(type)));
+}
+
+template <class type>
+void openlib::ArenaAllocator<type>::deallocate(type*, std::size_t) noexcept {
+  // released by Arena::reset()
+}
+
+template <class type>
+openlib::Arena& openlib::ArenaAllocator<type>::arena() const noexcept {
+  return *source;
+}
+
+/**
+ * @brief equality
+ * Allocators are equal when they share an arena
+ */
+template <class type, class other>
+inline bool operator==(const openlib::ArenaAllocator<type>& lhs,
+                       const openlib::ArenaAllocator<other>& rhs) {
+  return &lhs.arena() == &rhs.arena();
+}
+
+/**
+ * @brief inequality
+ */
+template <class type, class other>
+inline bool operator!=(const openlib::ArenaAllocator<type>& lhs,
+                       const openlib::ArenaAllocator<other>& rhs) {
+  return &lhs.arena() != &rhs.arena();
+}
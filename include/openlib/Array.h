@@ -28,30 +28,53 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <memory>
 #include <initializer_list>
 
+#include <openlib/FlatArray.h>
+
 namespace openlib {
 
 /**
  * Dynamically allocated array data structure
  *
  * Elements are guaranteed to stay in the same location in memory.
+ *
+ * Every accessor is virtual so Array can be subclassed. Storage is held in a
+ * FlatArray; use FlatArray directly when the virtual calls get in the way of
+ * inlining and vectorization.
+ *
+ * Storage comes from Allocator, see FlatArray.
  */
-template <class type>
+template <class type, class Allocator = std::allocator<type>>
 class Array {
 public:
 
+  /**
+   * @brief guaranteed alignment of data(), in bytes
+   */
+  static constexpr std::size_t alignment = FlatArray<type, Allocator>::alignment;
+
   /**
    * @brief constructor
    * @param size size of array
+   * @param allocator allocator to take storage from
    */
-  explicit Array(const std::size_t& size);
+  explicit Array(const std::size_t& size, const Allocator& allocator = Allocator());
+
+  /**
+   * @brief constructor, elements are default-initialized
+   * Trivial elements are left uninitialized rather than zeroed.
+   * @param size size of array
+   * @param allocator allocator to take storage from
+   */
+  Array(const std::size_t& size, Uninitialized, const Allocator& allocator = Allocator());
 
   /**
    * @brief constructor
    * Array will be initialized based off of the list.
    * Array will be the size of the list.
    * @param list an initializer list
+   * @param allocator allocator to take storage from
    */
-  Array(const std::initializer_list<type>& list);
+  Array(const std::initializer_list<type>& list, const Allocator& allocator = Allocator());
 
   /**
    * @brief copy constructor
@@ -142,9 +165,20 @@ public:
    */
   virtual const type& operator[](std::size_t position) const;
 
+  /**
+   * @brief Access the non-virtual storage
+   * @return the FlatArray holding the elements
+   */
+  virtual FlatArray<type, Allocator>& flat();
+
+  /**
+   * @brief Access the non-virtual storage, const
+   * @return the FlatArray holding the elements
+   */
+  virtual const FlatArray<type, Allocator>& flat() const;
+
 private:
-  std::unique_ptr<type[]> buffer;
-  const std::size_t bufferSize;
+  FlatArray<type, Allocator> storage;
   
   // no assignment operator
   Array& operator=(const Array& other) = delete;
@@ -156,116 +190,127 @@ private:
 // Definition complete, implemention below
 ///////////////////////////////////////////////////////////////////////////////
 
-template <class type>
-openlib::Array<type>::Array(const std::size_t& size):
-    buffer(std::make_unique<type[]>(size)),
-    bufferSize(size) {
+template <class type, class Allocator>
+constexpr std::size_t openlib::Array<type, Allocator>::alignment;
+
+template <class type, class Allocator>
+openlib::Array<type, Allocator>::Array(const std::size_t& size, const Allocator& allocator):
+    storage(size, allocator) {
 
   // no action needed
 }
 
-template <class type>
-openlib::Array<type>::Array(const std::initializer_list<type>& list):
-    buffer(std::make_unique<type[]>(list.size())),
-    bufferSize(list.size()) {
+template <class type, class Allocator>
+openlib::Array<type, Allocator>::Array(const std::size_t& size, Uninitialized,
+                                       const Allocator& allocator):
+    storage(size, uninitialized, allocator) {
 
-  std::size_t i = 0;
-  for (const auto& e : list) {
-    buffer[i++] = e;
-  }
+  // no action needed
+}
+
+template <class type, class Allocator>
+openlib::Array<type, Allocator>::Array(const std::initializer_list<type>& list,
+                                       const Allocator& allocator):
+    storage(list, allocator) {
+
+  // no action needed
 }
 
-template <class type>
-openlib::Array<type>::Array(const openlib::Array<type>& other):
-    buffer(std::make_unique<type[]>(other.bufferSize)),
-    bufferSize(other.bufferSize) {
+template <class type, class Allocator>
+openlib::Array<type, Allocator>::Array(const openlib::Array<type, Allocator>& other):
+    storage(other.storage) {
 
-  std::size_t i = 0;
-  for (const auto& e : other) {
-    buffer[i++] = e;
-  }
+  // no action needed
 }
 
-template <class type>
-openlib::Array<type>::Array(openlib::Array<type>&& other):
-    buffer(nullptr),
-    bufferSize(other.bufferSize) {
-  buffer.swap(other.buffer);
+template <class type, class Allocator>
+openlib::Array<type, Allocator>::Array(openlib::Array<type, Allocator>&& other):
+    storage(std::move(other.storage)) {
+
+  // no action needed
 }
 
-template <class type>
-openlib::Array<type>::~Array() {
+template <class type, class Allocator>
+openlib::Array<type, Allocator>::~Array() {
   // no action needed
 }
 
-template <class type>
-std::size_t openlib::Array<type>::size() const {
-  return bufferSize;
+template <class type, class Allocator>
+std::size_t openlib::Array<type, Allocator>::size() const {
+  return storage.size();
 }
 
-template <class type>
-type& openlib::Array<type>::at(const std::size_t& position) {
-  return buffer.get()[position];
+template <class type, class Allocator>
+type& openlib::Array<type, Allocator>::at(const std::size_t& position) {
+  return storage.at(position);
 }
 
-template <class type>
-const type& openlib::Array<type>::at(const std::size_t& position) const {
-  return buffer.get()[position];
+template <class type, class Allocator>
+const type& openlib::Array<type, Allocator>::at(const std::size_t& position) const {
+  return storage.at(position);
 }
 
-template <class type>
-type& openlib::Array<type>::front() const {
-  return buffer.get()[0];
+template <class type, class Allocator>
+type& openlib::Array<type, Allocator>::front() const {
+  return storage.front();
 }
 
-template <class type>
-type& openlib::Array<type>::back() const {
-  return buffer.get()[bufferSize - 1];
+template <class type, class Allocator>
+type& openlib::Array<type, Allocator>::back() const {
+  return storage.back();
 }
 
-template <class type>
-type* openlib::Array<type>::data() const {
-  return buffer.get();
+template <class type, class Allocator>
+type* openlib::Array<type, Allocator>::data() const {
+  return storage.data();
 }
 
-template <class type>
-type* openlib::Array<type>::begin() const {
-  return buffer.get();
+template <class type, class Allocator>
+type* openlib::Array<type, Allocator>::begin() const {
+  return storage.begin();
 }
 
-template <class type>
-type* openlib::Array<type>::end() const {
-  return buffer.get() + bufferSize;
+template <class type, class Allocator>
+type* openlib::Array<type, Allocator>::end() const {
+  return storage.end();
 }
 
-template <class type>
-void openlib::Array<type>::fill(const type& value) {
-  for (std::size_t i = 0; i < bufferSize; i++) {
-    buffer.get()[i] = value;
-  }
+template <class type, class Allocator>
+void openlib::Array<type, Allocator>::fill(const type& value) {
+  storage.fill(value);
 }
 
-template <class type>
-openlib::Array<type>::operator type*() const {
+template <class type, class Allocator>
+openlib::Array<type, Allocator>::operator type*() const {
   return data();
 }
 
-template <class type>
-type& openlib::Array<type>::operator[](std::size_t position) {
+template <class type, class Allocator>
+type& openlib::Array<type, Allocator>::operator[](std::size_t position) {
   return at(position);
 }
 
-template <class type>
-const type& openlib::Array<type>::operator[](std::size_t position) const {
+template <class type, class Allocator>
+const type& openlib::Array<type, Allocator>::operator[](std::size_t position) const {
   return at(position);
 }
 
+template <class type, class Allocator>
+openlib::FlatArray<type, Allocator>& openlib::Array<type, Allocator>::flat() {
+  return storage;
+}
+
+template <class type, class Allocator>
+const openlib::FlatArray<type, Allocator>& openlib::Array<type, Allocator>::flat() const {
+  return storage;
+}
+
 /**
  * @brief equality
  * Determined by looking at the location of the underling data's memory location
  */
-template <class type>
-inline bool operator==(const openlib::Array<type> &lhs, const openlib::Array<type> &rhs) {
+template <class type, class Allocator>
+inline bool operator==(const openlib::Array<type, Allocator> &lhs, const openlib::Array<type, Allocator> &rhs) {
   return lhs.data() == rhs.data();
 }
 
@@ -273,8 +318,8 @@ inline bool operator==(const openlib::Array<type> &lhs, const openlib::Array<typ
  * @brief inequality
  * Determined by looking at the location of the underling data's memory location
  */
-template <class type>
-inline bool operator!=(const openlib::Array<type> &lhs, const openlib::Array<type> &rhs) {
+template <class type, class Allocator>
+inline bool operator!=(const openlib::Array<type, Allocator> &lhs, const openlib::Array<type, Allocator> &rhs) {
   return lhs.data() != rhs.data();
 }
 
@@ -282,7 +327,7 @@ inline bool operator!=(const openlib::Array<type> &lhs, const openlib::Array<typ
  * @brief less than
  * Determined by looking at the location of the underling data's memory location
  */
-template <class type>
-inline bool operator<(const openlib::Array<type> &lhs, const openlib::Array<type> &rhs) {
+template <class type, class Allocator>
+inline bool operator<(const openlib::Array<type, Allocator> &lhs, const openlib::Array<type, Allocator> &rhs) {
   return lhs.data() < rhs.data();
 }
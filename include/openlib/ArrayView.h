@@ -0,0 +1,543 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <openlib/Kernels.h>
+
+namespace openlib {
+
+template <class type>
+class StridedView;
+
+template <class type>
+class ArrayView;
+
+namespace detail {
+
+/**
+ * Whether an ArrayView<type> may view an array passed as ArrayType&&
+ *
+ * Views of other views are always fine, they do not own the elements.
+ * Otherwise only read-only views take temporaries, which is safe for
+ * function parameters; a mutable view of a temporary would dangle.
+ */
+template <class type, class ArrayType>
+struct ViewBinds {
+  static const bool value = std::is_lvalue_reference<ArrayType>::value ||
+                            std::is_const<type>::value;
+};
+
+template <class type, class other>
+struct ViewBinds<type, ArrayView<other>> {
+  static const bool value = true;
+};
+
+} // namespace detail
+
+/**
+ * Non-owning view of contiguous elements
+ *
+ * An ArrayView is a pointer and a size, cheap to pass by value. It has the
+ * FlatArray accessor interface, so the kernels and the parallel algorithms
+ * accept it, and slice() / strided() take sub-views without copying.
+ *
+ * Any array with data() and size() converts to an ArrayView implicitly:
+ * FlatArray, Array, StaticArray, SmallArray, MappedArray or another view.
+ * The view does not keep the array alive and must not outlive it.
+ *
+ * ArrayView<const type> (alias ArraySlice<type>) is a read-only view.
+ */
+template <class type>
+class ArrayView final {
+public:
+
+  /**
+   * @brief constructor, an empty view
+   */
+  constexpr ArrayView() noexcept;
+
+  /**
+   * @brief constructor
+   * @param data first element
+   * @param size number of elements
+   */
+  constexpr ArrayView(type* data, std::size_t size) noexcept;
+
+  /**
+   * @brief constructor, view of a whole array
+   * @param array anything with data() and size() whose data() converts to
+   *              type*. Temporaries only bind to ArrayView<const type>.
+   */
+  template <class ArrayType, class = typename std::enable_if<
+      std::is_convertible<decltype(std::declval<ArrayType&>().data()), type*>::value &&
+      detail::ViewBinds<type, typename std::remove_cv<ArrayType>::type>::value>::type>
+  ArrayView(ArrayType&& array) noexcept;
+
+  /**
+   * @brief Number of elements in the view
+   * @return the number of elements in the view
+   */
+  constexpr std::size_t size() const noexcept;
+
+  /**
+   * @brief Whether the view has no elements
+   * @return true if size() == 0
+   */
+  constexpr bool empty() const noexcept;
+
+  /**
+   * @brief Access element at a given position
+   * @return a reference to the element at the given position
+   */
+  constexpr type& at(const std::size_t& position) const noexcept;
+
+  /**
+   * @brief The first element
+   * @return a reference to the first element
+   */
+  constexpr type& front() const noexcept;
+
+  /**
+   * @brief The last element
+   * @return a reference to the last element
+   */
+  constexpr type& back() const noexcept;
+
+  /**
+   * @brief Returns a pointer to the first element
+   * @returns a pointer to the first element
+   */
+  constexpr type* data() const noexcept;
+
+  /**
+   * @brief Get a pointer to the first element
+   * @return a pointer to the first element
+   */
+  constexpr type* begin() const noexcept;
+
+  /**
+   * @brief Get a pointer to one past the last element
+   * @return a pointer to one past the last element
+   */
+  constexpr type* end() const noexcept;
+
+  /**
+   * @brief fill each element of the view with the same value
+   * @param value a value to fill the view with
+   */
+  void fill(const type& value) const;
+
+  /**
+   * @brief view of count elements starting at offset
+   * @throws std::out_of_range if the range is not inside this view
+   */
+  ArrayView slice(std::size_t offset, std::size_t count) const;
+
+  /**
+   * @brief view of the elements from offset to the end
+   * @throws std::out_of_range if offset > size()
+   */
+  ArrayView slice(std::size_t offset) const;
+
+  /**
+   * @brief view of every stride-th element, starting at offset
+   * @throws std::invalid_argument if stride is 0
+   * @throws std::out_of_range if offset > size()
+   */
+  StridedView<type> strided(std::size_t stride, std::size_t offset = 0) const;
+
+  /**
+   * @brief operator[]
+   */
+  constexpr type& operator[](std::size_t position) const noexcept;
+
+private:
+  type* first;
+  std::size_t count;
+};
+
+/**
+ * @brief read-only view
+ */
+template <class type>
+using ArraySlice = ArrayView<const type>;
+
+/**
+ * Non-owning view of every stride-th element
+ *
+ * Element i is data()[i * stride()]. Useful for picking one column out of
+ * interleaved data without copying it. Strided elements are not contiguous,
+ * so there is no data()-based kernel path; iterate or index instead.
+ */
+template <class type>
+class StridedView final {
+public:
+  class Iterator;
+
+  /**
+   * @brief constructor
+   * @param data first element
+   * @param size number of elements in the view
+   * @param stride distance between elements, in elements
+   */
+  constexpr StridedView(type* data, std::size_t size, std::size_t stride) noexcept;
+
+  /**
+   * @brief Number of elements in the view
+   * @return the number of elements in the view
+   */
+  constexpr std::size_t size() const noexcept;
+
+  /**
+   * @brief Distance between elements, in elements
+   * @return the stride
+   */
+  constexpr std::size_t stride() const noexcept;
+
+  /**
+   * @brief Access element at a given position
+   * @return a reference to the element at the given position
+   */
+  constexpr type& at(const std::size_t& position) const noexcept;
+
+  /**
+   * @brief The first element
+   * @return a reference to the first element
+   */
+  constexpr type& front() const noexcept;
+
+  /**
+   * @brief The last element
+   * @return a reference to the last element
+   */
+  constexpr type& back() const noexcept;
+
+  /**
+   * @brief iterator to the first element
+   */
+  Iterator begin() const noexcept;
+
+  /**
+   * @brief iterator to one past the last element
+   */
+  Iterator end() const noexcept;
+
+  /**
+   * @brief fill each element of the view with the same value
+   * @param value a value to fill the view with
+   */
+  void fill(const type& value) const;
+
+  /**
+   * @brief operator[]
+   */
+  constexpr type& operator[](std::size_t position) const noexcept;
+
+  /**
+   * Iterator stepping stride elements at a time
+   */
+  class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::remove_const<type>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = type*;
+    using reference = type&;
+
+    Iterator(type* first, std::size_t position, std::size_t stride);
+
+    reference operator*() const noexcept;
+    pointer operator->() const noexcept;
+    Iterator& operator++() noexcept;
+    Iterator operator++(int) noexcept;
+    bool operator==(const Iterator& other) const noexcept;
+    bool operator!=(const Iterator& other) const noexcept;
+
+  private:
+    // positions are compared rather than pointers, first + position * step
+    // may lie beyond one past the end of the array
+    type* first;
+    std::size_t position;
+    std::size_t step;
+  };
+
+private:
+  type* first;
+  std::size_t count;
+  std::size_t step;
+};
+
+/**
+ * @brief view of the whole array, element type deduced
+ * @param array anything with data() and size()
+ */
+template <class ArrayType>
+auto makeView(ArrayType& array)
+    -> ArrayView<typename std::remove_pointer<decltype(array.data())>::type>;
+
+/**
+ * @brief read-only view of the bytes of an array
+ * @param array anything with data() and size() of trivially copyable elements
+ */
+template <class ArrayType>
+ArrayView<const uint8_t> asBytes(const ArrayType& array) noexcept;
+
+/**
+ * @brief writable view of the bytes of an array
+ * @param array anything with data() and size() of trivially copyable elements
+ */
+template <class ArrayType>
+ArrayView<uint8_t> asWritableBytes(ArrayType& array) noexcept;
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type>
+inline constexpr openlib::ArrayView<type>::ArrayView() noexcept:
+    first(nullptr), count(0) {
+}
+
+template <class type>
+inline constexpr openlib::ArrayView<type>::ArrayView(type* data, std::size_t size) noexcept:
+    first(data), count(size) {
+}
+
+template <class type>
+template <class ArrayType, class>
+inline openlib::ArrayView<type>::ArrayView(ArrayType&& array) noexcept:
+    first(array.data()), count(array.size()) {
+}
+
+template <class type>
+inline constexpr std::size_t openlib::ArrayView<type>::size() const noexcept {
+  return count;
+}
+
+template <class type>
+inline constexpr bool openlib::ArrayView<type>::empty() const noexcept {
+  return count == 0;
+}
+
+template <class type>
+inline constexpr type& openlib::ArrayView<type>::at(const std::size_t& position) const noexcept {
+  return first[position];
+}
+
+template <class type>
+inline constexpr type& openlib::ArrayView<type>::front() const noexcept {
+  return first[0];
+}
+
+template <class type>
+inline constexpr type& openlib::ArrayView<type>::back() const noexcept {
+  return first[count - 1];
+}
+
+template <class type>
+inline constexpr type* openlib::ArrayView<type>::data() const noexcept {
+  return first;
+}
+
+template <class type>
+inline constexpr type* openlib::ArrayView<type>::begin() const noexcept {
+  return first;
+}
+
+template <class type>
+inline constexpr type* openlib::ArrayView<type>::end() const noexcept {
+  return first + count;
+}
+
+template <class type>
+inline void openlib::ArrayView<type>::fill(const type& value) const {
+  kernels::detail::fillArray(first, value, count, std::is_trivially_copyable<type>());
+}
+
+template <class type>
+openlib::ArrayView<type> openlib::ArrayView<type>::slice(std::size_t offset,
+                                                         std::size_t count) const {
+  if (offset > this->count || count > this->count - offset) {
+    throw std::out_of_range("slice is outside of the view");
+  }
+  return ArrayView(first + offset, count);
+}
+
+template <class type>
+openlib::ArrayView<type> openlib::ArrayView<type>::slice(std::size_t offset) const {
+  if (offset > count) {
+    throw std::out_of_range("slice is outside of the view");
+  }
+  return ArrayView(first + offset, count - offset);
+}
+
+template <class type>
+openlib::StridedView<type> openlib::ArrayView<type>::strided(std::size_t stride,
+                                                             std::size_t offset) const {
+  if (stride == 0) {
+    throw std::invalid_argument("stride must be greater than 0");
+  }
+  if (offset > count) {
+    throw std::out_of_range("strided view starts outside of the view");
+  }
+  return StridedView<type>(first + offset, (count - offset + stride - 1) / stride, stride);
+}
+
+template <class type>
+inline constexpr type& openlib::ArrayView<type>::operator[](std::size_t position) const noexcept {
+  return first[position];
+}
+
+template <class type>
+inline constexpr openlib::StridedView<type>::StridedView(type* data, std::size_t size,
+                                                         std::size_t stride) noexcept:
+    first(data), count(size), step(stride) {
+}
+
+template <class type>
+inline constexpr std::size_t openlib::StridedView<type>::size() const noexcept {
+  return count;
+}
+
+template <class type>
+inline constexpr std::size_t openlib::StridedView<type>::stride() const noexcept {
+  return step;
+}
+
+template <class type>
+inline constexpr type& openlib::StridedView<type>::at(const std::size_t& position) const noexcept {
+  return first[position * step];
+}
+
+template <class type>
+inline constexpr type& openlib::StridedView<type>::front() const noexcept {
+  return first[0];
+}
+
+template <class type>
+inline constexpr type& openlib::StridedView<type>::back() const noexcept {
+  return first[(count - 1) * step];
+}
+
+template <class type>
+inline typename openlib::StridedView<type>::Iterator
+openlib::StridedView<type>::begin() const noexcept {
+  return Iterator(first, 0, step);
+}
+
+template <class type>
+inline typename openlib::StridedView<type>::Iterator
+openlib::StridedView<type>::end() const noexcept {
+  return Iterator(first, count, step);
+}
+
+template <class type>
+inline void openlib::StridedView<type>::fill(const type& value) const {
+  for (std::size_t i = 0; i < count; i++) {
+    first[i * step] = value;
+  }
+}
+
+template <class type>
+inline constexpr type& openlib::StridedView<type>::operator[](std::size_t position) const noexcept {
+  return first[position * step];
+}
+
+template <class type>
+inline openlib::StridedView<type>::Iterator::Iterator(type* first, std::size_t position,
+                                                      std::size_t stride):
+    first(first), position(position), step(stride) {
+}
+
+template <class type>
+inline type& openlib::StridedView<type>::Iterator::operator*() const noexcept {
+  return first[position * step];
+}
+
+template <class type>
+inline type* openlib::StridedView<type>::Iterator::operator->() const noexcept {
+  return first + position * step;
+}
+
+template <class type>
+inline typename openlib::StridedView<type>::Iterator&
+openlib::StridedView<type>::Iterator::operator++() noexcept {
+  position++;
+  return *this;
+}
+
+template <class type>
+inline typename openlib::StridedView<type>::Iterator
+openlib::StridedView<type>::Iterator::operator++(int) noexcept {
+  Iterator previous = *this;
+  position++;
+  return previous;
+}
+
+template <class type>
+inline bool openlib::StridedView<type>::Iterator::operator==(const Iterator& other) const noexcept {
+  return first == other.first && position == other.position;
+}
+
+template <class type>
+inline bool openlib::StridedView<type>::Iterator::operator!=(const Iterator& other) const noexcept {
+  return !(*this == other);
+}
+
+template <class ArrayType>
+inline auto openlib::makeView(ArrayType& array)
+    -> ArrayView<typename std::remove_pointer<decltype(array.data())>::type> {
+  return ArrayView<typename std::remove_pointer<decltype(array.data())>::type>(array.data(),
+                                                                              array.size());
+}
+
+template <class ArrayType>
+inline openlib::ArrayView<const uint8_t> openlib::asBytes(const ArrayType& array) noexcept {
+  using type = typename std::remove_pointer<decltype(array.data())>::type;
+  static_assert(std::is_trivially_copyable<type>::value,
+                "asBytes needs trivially copyable elements");
+  return ArrayView<const uint8_t>(reinterpret_cast<const uint8_t*>(array.data()),
+                                  array.size() * sizeof(type));
+}
+
+template <class ArrayType>
+inline openlib::ArrayView<uint8_t> openlib::asWritableBytes(ArrayType& array) noexcept {
+  using type = typename std::remove_pointer<decltype(array.data())>::type;
+  static_assert(std::is_trivially_copyable<type>::value,
+                "asWritableBytes needs trivially copyable elements");
+  static_assert(!std::is_const<type>::value, "asWritableBytes needs writable elements");
+  return ArrayView<uint8_t>(reinterpret_cast<uint8_t*>(array.data()),
+                            array.size() * sizeof(type));
+}
@@ -0,0 +1,298 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <openlib/AlignedAllocator.h>
+#include <openlib/FlatArray.h>
+
+namespace openlib {
+
+/**
+ * Fixed-size array of bits packed into 64-bit words
+ *
+ * Bulk operations work a word at a time and go through the SIMD kernels,
+ * so counting or combining two sets touches 512 bits per AVX-512
+ * instruction instead of one bool per byte. Bits past size() in the last
+ * word are kept clear, so whole-word operations never see stray bits.
+ */
+class BitArray final {
+public:
+  typedef uint64_t Word;
+
+  /**
+   * @brief bits per storage word
+   */
+  static const std::size_t WORD_BITS = 64;
+
+  /**
+   * @brief constructor, every bit clear
+   * @param size number of bits
+   */
+  explicit BitArray(std::size_t size);
+
+  /**
+   * @brief constructor
+   * @param size number of bits
+   * @param value initial value of every bit
+   */
+  BitArray(std::size_t size, bool value);
+
+  /**
+   * @brief copy constructor
+   */
+  BitArray(const BitArray& other);
+
+  /**
+   * @brief move constructor
+   */
+  BitArray(BitArray&& other) noexcept;
+
+  /**
+   * @brief number of bits
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief number of storage words
+   */
+  std::size_t wordCount() const noexcept;
+
+  /**
+   * @brief storage words, bit i is bit i % 64 of word i / 64
+   * Callers writing words must keep bits past size() clear.
+   */
+  Word* data() noexcept;
+  const Word* data() const noexcept;
+
+  /**
+   * @brief value of a bit, unchecked
+   */
+  bool operator[](std::size_t position) const noexcept;
+
+  /**
+   * @brief value of a bit
+   * @throws std::out_of_range if position >= size()
+   */
+  bool test(std::size_t position) const;
+
+  /**
+   * @brief set a bit
+   * @throws std::out_of_range if position >= size()
+   */
+  void set(std::size_t position);
+
+  /**
+   * @brief set a bit to value
+   * @throws std::out_of_range if position >= size()
+   */
+  void set(std::size_t position, bool value);
+
+  /**
+   * @brief clear a bit
+   * @throws std::out_of_range if position >= size()
+   */
+  void reset(std::size_t position);
+
+  /**
+   * @brief invert a bit
+   * @throws std::out_of_range if position >= size()
+   */
+  void flip(std::size_t position);
+
+  /**
+   * @brief set every bit to value
+   */
+  void fill(bool value);
+
+  /**
+   * @brief invert every bit
+   */
+  void flip();
+
+  /**
+   * @brief bitwise operations with an array of the same size
+   * andNot clears every bit set in other.
+   * @throws std::length_error if the sizes differ
+   */
+  BitArray& operator&=(const BitArray& other);
+  BitArray& operator|=(const BitArray& other);
+  BitArray& operator^=(const BitArray& other);
+  BitArray& andNot(const BitArray& other);
+
+  /**
+   * @brief number of set bits
+   */
+  std::size_t count() const;
+
+  /**
+   * @brief whether any, none or all bits are set
+   */
+  bool any() const;
+  bool none() const;
+  bool all() const;
+
+  /**
+   * @brief position of the first set bit
+   * @return position, or size() if no bit is set
+   */
+  std::size_t findFirst() const noexcept;
+
+  /**
+   * @brief position of the first set bit after position
+   * @return position, or size() if no later bit is set
+   */
+  std::size_t findNext(std::size_t position) const noexcept;
+
+  /**
+   * @brief number of set bits before position
+   * Scans the words before position; build a BitRankIndex for repeated
+   * queries on an array that does not change.
+   * @throws std::out_of_range if position > size()
+   */
+  std::size_t rank(std::size_t position) const;
+
+  /**
+   * @brief position of the set bit with the given rank, counting from zero
+   * @return position, or size() if fewer than rank + 1 bits are set
+   */
+  std::size_t select(std::size_t rank) const;
+
+private:
+  std::size_t bits;
+  FlatArray<Word, AlignedAllocator<Word>> words;
+
+  // clears the bits past size() in the last word
+  void clearTail() noexcept;
+  void checkPosition(std::size_t position) const;
+  void checkSize(const BitArray& other) const;
+
+  // no assignment, like FlatArray
+  BitArray& operator=(const BitArray& other) = delete;
+};
+
+/**
+ * Constant-time rank and logarithmic select over a BitArray
+ *
+ * Stores the number of set bits before every 512-bit block, one word per
+ * eight words of bits. The index refers to the array, which must outlive
+ * it and must not change while it is in use.
+ */
+class BitRankIndex final {
+public:
+
+  /**
+   * @brief bits covered by one block count
+   */
+  static const std::size_t BLOCK_BITS = 512;
+
+  /**
+   * @brief constructor
+   * @param bits array to index
+   */
+  explicit BitRankIndex(const BitArray& bits);
+
+  /**
+   * @brief number of set bits before position
+   * @throws std::out_of_range if position > size of the array
+   */
+  std::size_t rank(std::size_t position) const;
+
+  /**
+   * @brief position of the set bit with the given rank, counting from zero
+   * @return position, or the array size if fewer than rank + 1 bits are set
+   */
+  std::size_t select(std::size_t rank) const;
+
+  /**
+   * @brief number of set bits in the array
+   */
+  std::size_t count() const noexcept;
+
+private:
+  const BitArray& bits;
+  // blocks[i] is the number of set bits before block i, plus a final total
+  FlatArray<uint64_t> blocks;
+
+  // no copy or assignment
+  BitRankIndex(const BitRankIndex& other) = delete;
+  BitRankIndex& operator=(const BitRankIndex& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+inline std::size_t openlib::BitArray::size() const noexcept {
+  return bits;
+}
+
+inline std::size_t openlib::BitArray::wordCount() const noexcept {
+  return words.size();
+}
+
+inline openlib::BitArray::Word* openlib::BitArray::data() noexcept {
+  return words.data();
+}
+
+inline const openlib::BitArray::Word* openlib::BitArray::data() const noexcept {
+  return words.data();
+}
+
+inline bool openlib::BitArray::operator[](std::size_t position) const noexcept {
+  return (words.data()[position / WORD_BITS] >> (position % WORD_BITS)) & 1;
+}
+
+inline bool openlib::BitArray::test(std::size_t position) const {
+  checkPosition(position);
+  return (*this)[position];
+}
+
+inline void openlib::BitArray::set(std::size_t position) {
+  checkPosition(position);
+  words.data()[position / WORD_BITS] |= Word(1) << (position % WORD_BITS);
+}
+
+inline void openlib::BitArray::set(std::size_t position, bool value) {
+  checkPosition(position);
+  Word& word = words.data()[position / WORD_BITS];
+  const Word mask = Word(1) << (position % WORD_BITS);
+  word = value ? word | mask : word & ~mask;
+}
+
+inline void openlib::BitArray::reset(std::size_t position) {
+  checkPosition(position);
+  words.data()[position / WORD_BITS] &= ~(Word(1) << (position % WORD_BITS));
+}
+
+inline void openlib::BitArray::flip(std::size_t position) {
+  checkPosition(position);
+  words.data()[position / WORD_BITS] ^= Word(1) << (position % WORD_BITS);
+}
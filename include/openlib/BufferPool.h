@@ -0,0 +1,191 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <openlib/MemoryResource.h>
+
+namespace openlib {
+
+/**
+ * Thread-caching size-class buffer pool
+ *
+ * A thread-safe MemoryResource for buffers that are allocated and freed at
+ * a high rate, such as one Serializer per outgoing message:
+ *
+ *   openlib::Serializer message(4096, openlib::uninitialized, openlib::BufferPool::shared());
+ *
+ * Requests are rounded up to a power of two size class between
+ * MIN_BLOCK_SIZE and MAX_BLOCK_SIZE. Each thread keeps a cache of free
+ * blocks per class, so a thread that frees and reallocates the same sizes
+ * never leaves its own cache. A cache that grows past its limit hands half
+ * of its blocks to a global depot, where other threads pick them up; this
+ * is how buffers freed on a different thread than they were allocated on
+ * get reused. Larger or over-aligned requests go straight to upstream.
+ * Once a thread's caches are gone at thread exit, its later requests, for
+ * example from thread_local destructors, use the depot directly.
+ *
+ * stats() reports hit rates and cached bytes for tuning the Options.
+ */
+class BufferPool final : public MemoryResource {
+public:
+
+  static const std::size_t MIN_BLOCK_SIZE = 64;
+  static const std::size_t MAX_BLOCK_SIZE = 4 * 1024 * 1024;
+  static const std::size_t SIZE_CLASSES = 17;
+
+  /**
+   * Cache limits, per size class
+   *
+   * A limit smaller than one block still caches a single block.
+   */
+  struct Options {
+    /**
+     * @brief bytes each thread may cache per size class
+     */
+    std::size_t threadCacheBytes = 256 * 1024;
+
+    /**
+     * @brief bytes the depot may hold per size class, the rest goes upstream
+     */
+    std::size_t depotBytes = 8 * 1024 * 1024;
+  };
+
+  /**
+   * Counters since the pool was created
+   */
+  struct Stats {
+    uint64_t allocations = 0;    // every allocate() call
+    uint64_t threadHits = 0;     // served from the calling thread's cache
+    uint64_t depotHits = 0;      // served from the depot
+    uint64_t misses = 0;         // pooled size, but allocated upstream
+    uint64_t uncached = 0;       // too large or over-aligned to pool
+    std::size_t threadCacheBytes = 0;
+    std::size_t depotBytes = 0;
+
+    /**
+     * @brief bytes held in thread caches and the depot
+     */
+    std::size_t bytesCached() const noexcept;
+
+    /**
+     * @brief fraction of allocations served without going upstream
+     */
+    double hitRate() const noexcept;
+  };
+
+  /**
+   * @brief constructor
+   * @param upstream where blocks come from, must outlive the pool
+   */
+  explicit BufferPool(MemoryResource& upstream = defaultResource());
+
+  /**
+   * @brief constructor
+   * @param options cache limits
+   * @param upstream where blocks come from, must outlive the pool
+   */
+  explicit BufferPool(const Options& options, MemoryResource& upstream = defaultResource());
+
+  /**
+   * @brief destructor, returns every cached block upstream
+   * No other thread may still be using the pool, and blocks still allocated
+   * from it must not be freed afterwards.
+   */
+  ~BufferPool() override;
+
+  /**
+   * @brief allocate memory, safe from any thread
+   * @param bytes number of bytes
+   * @param alignment required alignment, a power of two
+   * @return pointer to the memory
+   */
+  void* allocate(std::size_t bytes, std::size_t alignment) override;
+
+  /**
+   * @brief return memory to the calling thread's cache, safe from any thread
+   */
+  void deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+
+  /**
+   * @brief return the depot's blocks upstream
+   * Thread caches are left alone, they empty into the depot as they fill
+   * up and when their thread exits.
+   */
+  void trim();
+
+  /**
+   * @brief counters and cached bytes, summed over every thread
+   */
+  Stats stats() const;
+
+  /**
+   * @brief size class index for a request
+   * @param bytes number of bytes
+   * @return size class index, 0 for MIN_BLOCK_SIZE
+   */
+  static std::size_t sizeClass(std::size_t bytes);
+
+  /**
+   * @brief process-wide pool on top of defaultResource()
+   * Never destroyed, so objects with static storage duration may allocate
+   * from it and free into it while the program exits.
+   */
+  static BufferPool& shared();
+
+private:
+  struct State;
+  struct ThreadCache;
+  struct LocalCaches;
+
+  std::shared_ptr<State> state;
+
+  // the calling thread's cache, created on first use, nullptr once the
+  // thread's caches have been destroyed at thread exit
+  ThreadCache* localCache();
+
+  // no copy or assignment
+  BufferPool(const BufferPool& other) = delete;
+  BufferPool& operator=(const BufferPool& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+inline std::size_t openlib::BufferPool::sizeClass(std::size_t bytes) {
+  if (bytes <= MIN_BLOCK_SIZE) {
+    return 0;
+  }
+  // log2 of the smallest power of two >= bytes, relative to MIN_BLOCK_SIZE
+  return 64 - __builtin_clzll(static_cast<unsigned long long>(bytes - 1))
+            - __builtin_ctzll(MIN_BLOCK_SIZE);
+}
@@ -0,0 +1,165 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <openlib/Kernels.h>
+
+namespace openlib {
+
+/**
+ * Byte order policy for Writer, Deserializer, Serializer and
+ * SegmentedSerializer
+ *
+ * A policy converts words between host order and wire order: integers
+ * are swapped if swapsIntegers, floats and doubles if swapsFloats. The
+ * conversion is its own inverse, so writers and readers share it. Use the
+ * names below rather than the flags:
+ *
+ *   BigEndian          every field big endian
+ *   LittleEndian       every field little endian
+ *   NativeEndian       host order, never swaps, for formats only this
+ *                      fleet reads
+ *   BigEndianIntegers  big endian integers, host order floats; the original
+ *                      Serializer format and the default everywhere
+ *
+ * When nothing needs swapping the bulk conversion is a plain memcpy.
+ */
+template <bool swapIntegers, bool swapFloats>
+struct ByteOrder final {
+  static const bool swapsIntegers = swapIntegers;
+  static const bool swapsFloats = swapFloats;
+
+  /**
+   * @brief true if values of type change between host and wire order
+   */
+  template <class type>
+  static constexpr bool swaps() noexcept;
+
+  /**
+   * @brief convert one integer, float or double between host and wire order
+   * @param value value to convert
+   * @return converted value
+   */
+  template <class type>
+  static type convert(type value) noexcept;
+
+  /**
+   * @brief convert count values of type between host and wire order
+   * Neither buffer needs to be aligned. dst may be src, but must not
+   * otherwise overlap it.
+   * @param dst where to put the converted values
+   * @param src values to convert
+   * @param count number of values
+   */
+  template <class type>
+  static void convert(void* dst, const void* src, std::size_t count) noexcept;
+};
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+typedef ByteOrder<false, false> BigEndian;
+typedef ByteOrder<true, true> LittleEndian;
+typedef BigEndian NativeEndian;
+typedef ByteOrder<false, false> BigEndianIntegers;
+#else
+typedef ByteOrder<true, true> BigEndian;
+typedef ByteOrder<false, false> LittleEndian;
+typedef LittleEndian NativeEndian;
+typedef ByteOrder<true, false> BigEndianIntegers;
+#endif
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+namespace openlib {
+namespace detail {
+
+inline uint8_t swapWord(uint8_t value) noexcept { return value; }
+inline uint16_t swapWord(uint16_t value) noexcept { return __builtin_bswap16(value); }
+inline uint32_t swapWord(uint32_t value) noexcept { return __builtin_bswap32(value); }
+inline uint64_t swapWord(uint64_t value) noexcept { return __builtin_bswap64(value); }
+
+template <std::size_t size>
+struct WordOfSize;
+
+template <> struct WordOfSize<1> { typedef uint8_t type; };
+template <> struct WordOfSize<2> { typedef uint16_t type; };
+template <> struct WordOfSize<4> { typedef uint32_t type; };
+template <> struct WordOfSize<8> { typedef uint64_t type; };
+
+} // namespace detail
+} // namespace openlib
+
+template <bool swapIntegers, bool swapFloats>
+const bool openlib::ByteOrder<swapIntegers, swapFloats>::swapsIntegers;
+
+template <bool swapIntegers, bool swapFloats>
+const bool openlib::ByteOrder<swapIntegers, swapFloats>::swapsFloats;
+
+template <bool swapIntegers, bool swapFloats>
+template <class type>
+inline constexpr bool openlib::ByteOrder<swapIntegers, swapFloats>::swaps() noexcept {
+  return sizeof(type) > 1 && (std::is_floating_point<type>::value ? swapFloats : swapIntegers);
+}
+
+template <bool swapIntegers, bool swapFloats>
+template <class type>
+inline type openlib::ByteOrder<swapIntegers, swapFloats>::convert(type value) noexcept {
+  static_assert(std::is_arithmetic<type>::value, "ByteOrder converts integers and floats");
+  if (!swaps<type>()) {
+    return value;
+  }
+  typename detail::WordOfSize<sizeof(type)>::type word;
+  std::memcpy(&word, &value, sizeof(value));
+  word = detail::swapWord(word);
+  std::memcpy(&value, &word, sizeof(value));
+  return value;
+}
+
+template <bool swapIntegers, bool swapFloats>
+template <class type>
+inline void openlib::ByteOrder<swapIntegers, swapFloats>::convert(void* dst, const void* src,
+                                                                  std::size_t count) noexcept {
+  static_assert(std::is_arithmetic<type>::value, "ByteOrder converts integers and floats");
+  if (!swaps<type>()) {
+    if (count != 0 && dst != src) {
+      std::memcpy(dst, src, count * sizeof(type));
+    }
+  } else if (sizeof(type) == 2) {
+    kernels::byteSwap16(dst, src, count);
+  } else if (sizeof(type) == 4) {
+    kernels::byteSwap32(dst, src, count);
+  } else {
+    kernels::byteSwap64(dst, src, count);
+  }
+}
@@ -0,0 +1,353 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include <openlib/AlignedAllocator.h>
+#include <openlib/ArrayView.h>
+#include <openlib/FlatArray.h>
+
+namespace openlib {
+
+/**
+ * Fixed-capacity array that many threads append to without locking
+ *
+ * Storage is a FlatArray allocated up front, so elements never move. An
+ * append claims its index with a single fetch_add on a shared cursor,
+ * writes the element, then marks it ready. Readers see the published
+ * prefix: the longest run of ready elements from index 0, so a reader
+ * never observes a claimed but half-written element.
+ *
+ * An Appender batches appends from one thread into a local buffer and
+ * claims room for the whole batch with one fetch_add, which takes most of
+ * the contention off the cursor when many threads append small elements.
+ *
+ * Appends past capacity throw std::length_error. A bulk append that does
+ * not fit leaves the array full at the point where it started.
+ */
+template <class type, class Allocator = std::allocator<type>>
+class ConcurrentAppendArray final {
+public:
+  class Appender;
+
+  /**
+   * @brief constructor
+   * @param capacity maximum number of elements
+   * @param allocator allocator to take storage from
+   */
+  explicit ConcurrentAppendArray(const std::size_t& capacity,
+                                 const Allocator& allocator = Allocator());
+
+  /**
+   * @brief append one element, safe from any thread
+   * @return index of the element
+   * @throws std::length_error if the array is full
+   */
+  std::size_t append(const type& value);
+
+  /**
+   * @brief append count elements as one contiguous run, safe from any thread
+   * @return index of the first element
+   * @throws std::length_error if the elements do not all fit
+   */
+  std::size_t append(const type* values, std::size_t count);
+
+  /**
+   * @brief create a batching append handle for the calling thread
+   * @param batchSize elements buffered before claiming room in the array
+   */
+  Appender appender(std::size_t batchSize = 256);
+
+  /**
+   * @brief Number of published elements
+   * Every element below size() is fully written and visible to the caller.
+   * @return length of the published prefix
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief Number of elements claimed so far, published or not
+   */
+  std::size_t reserved() const noexcept;
+
+  /**
+   * @brief Maximum number of elements
+   */
+  std::size_t capacity() const noexcept;
+
+  /**
+   * @brief Number of elements lost by Appenders destroyed with a batch that
+   * did not fit
+   * Flush explicitly to get the std::length_error instead.
+   */
+  std::size_t dropped() const noexcept;
+
+  /**
+   * @brief read-only view of the published prefix
+   * Elements in the view never change, later appends only add to the end.
+   */
+  ArrayView<const type> published() const noexcept;
+
+  /**
+   * @brief Access a published element
+   * @param position index below size()
+   */
+  const type& operator[](std::size_t position) const noexcept;
+
+  /**
+   * Per-thread batching append handle
+   *
+   * Buffers appended elements and moves each full batch into the array with
+   * one claim on the cursor. Elements become visible to readers only after
+   * their batch is flushed: when the buffer fills, on flush(), or when the
+   * Appender is destroyed.
+   */
+  class Appender {
+  public:
+    Appender(ConcurrentAppendArray& array, std::size_t batchSize);
+    Appender(Appender&& other) noexcept;
+
+    /**
+     * @brief destructor, flushes
+     * A batch that does not fit is lost and counted in dropped(). Call
+     * flush() first to handle a full array.
+     */
+    ~Appender();
+
+    /**
+     * @brief buffer one element, flushing first if the buffer is full
+     * @throws std::length_error if a flush does not fit
+     */
+    void append(const type& value);
+
+    /**
+     * @brief move buffered elements into the array and publish them
+     * @throws std::length_error if they do not fit, they stay buffered
+     */
+    void flush();
+
+    /**
+     * @brief Number of elements buffered but not yet flushed
+     */
+    std::size_t pending() const noexcept;
+
+  private:
+    ConcurrentAppendArray* array;
+    FlatArray<type> buffer;
+    std::size_t buffered;
+
+    Appender(const Appender& other) = delete;
+    Appender& operator=(const Appender& other) = delete;
+  };
+
+private:
+  // cursor and published prefix are hot and written by different parties,
+  // keep them off each other's and the storage's cache lines
+  struct alignas(CACHE_LINE_BYTES) Counter {
+    std::atomic<std::size_t> value;
+  };
+
+  FlatArray<type, Allocator> storage;
+  FlatArray<std::atomic<uint8_t>> ready;
+  Counter cursor;
+  mutable Counter prefix;
+  std::atomic<std::size_t> droppedCount;
+
+  // claim count indexes, returns the first
+  std::size_t claim(std::size_t count);
+
+  // mark [first, first + count) ready and move the published prefix
+  void publish(std::size_t first, std::size_t count) noexcept;
+
+  // move the published prefix over ready elements, returns it
+  std::size_t advance() const noexcept;
+
+  // no copy or assignment
+  ConcurrentAppendArray(const ConcurrentAppendArray& other) = delete;
+  ConcurrentAppendArray& operator=(const ConcurrentAppendArray& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, class Allocator>
+openlib::ConcurrentAppendArray<type, Allocator>::ConcurrentAppendArray(const std::size_t& capacity,
+                                                                       const Allocator& allocator):
+    storage(capacity, uninitialized, allocator),
+    ready(capacity) {
+  cursor.value.store(0, std::memory_order_relaxed);
+  prefix.value.store(0, std::memory_order_relaxed);
+  droppedCount.store(0, std::memory_order_relaxed);
+}
+
+template <class type, class Allocator>
+std::size_t openlib::ConcurrentAppendArray<type, Allocator>::claim(std::size_t count) {
+  const std::size_t first = cursor.value.fetch_add(count, std::memory_order_relaxed);
+  if (first > storage.size() || count > storage.size() - first) {
+    throw std::length_error("not enough capacity left in ConcurrentAppendArray");
+  }
+  return first;
+}
+
+template <class type, class Allocator>
+std::size_t openlib::ConcurrentAppendArray<type, Allocator>::append(const type& value) {
+  const std::size_t index = claim(1);
+  storage[index] = value;
+  publish(index, 1);
+  return index;
+}
+
+template <class type, class Allocator>
+std::size_t openlib::ConcurrentAppendArray<type, Allocator>::append(const type* values,
+                                                                    std::size_t count) {
+  const std::size_t first = claim(count);
+  std::copy(values, values + count, storage.data() + first);
+  publish(first, count);
+  return first;
+}
+
+template <class type, class Allocator>
+void openlib::ConcurrentAppendArray<type, Allocator>::publish(std::size_t first,
+                                                              std::size_t count) noexcept {
+  // release, so a reader that sees the flag sees the element
+  for (std::size_t i = first; i < first + count; i++) {
+    ready[i].store(1, std::memory_order_release);
+  }
+  // only the thread whose run starts at the prefix needs to move it; others
+  // are picked up when it, or a reader, gets there
+  if (prefix.value.load(std::memory_order_relaxed) == first) {
+    advance();
+  }
+}
+
+template <class type, class Allocator>
+std::size_t openlib::ConcurrentAppendArray<type, Allocator>::advance() const noexcept {
+  std::size_t published = prefix.value.load(std::memory_order_acquire);
+  while (true) {
+    std::size_t end = published;
+    while (end < storage.size() && ready[end].load(std::memory_order_acquire) != 0) {
+      end++;
+    }
+    if (end == published) {
+      return published;
+    }
+    // another thread may have moved it further, keep the larger value
+    if (prefix.value.compare_exchange_weak(published, end, std::memory_order_acq_rel)) {
+      published = end;
+    }
+  }
+}
+
+template <class type, class Allocator>
+typename openlib::ConcurrentAppendArray<type, Allocator>::Appender
+openlib::ConcurrentAppendArray<type, Allocator>::appender(std::size_t batchSize) {
+  return Appender(*this, batchSize);
+}
+
+template <class type, class Allocator>
+inline std::size_t openlib::ConcurrentAppendArray<type, Allocator>::size() const noexcept {
+  return advance();
+}
+
+template <class type, class Allocator>
+inline std::size_t openlib::ConcurrentAppendArray<type, Allocator>::reserved() const noexcept {
+  return std::min(cursor.value.load(std::memory_order_relaxed), storage.size());
+}
+
+template <class type, class Allocator>
+inline std::size_t openlib::ConcurrentAppendArray<type, Allocator>::capacity() const noexcept {
+  return storage.size();
+}
+
+template <class type, class Allocator>
+inline std::size_t openlib::ConcurrentAppendArray<type, Allocator>::dropped() const noexcept {
+  return droppedCount.load(std::memory_order_relaxed);
+}
+
+template <class type, class Allocator>
+inline openlib::ArrayView<const type>
+openlib::ConcurrentAppendArray<type, Allocator>::published() const noexcept {
+  return ArrayView<const type>(storage.data(), size());
+}
+
+template <class type, class Allocator>
+inline const type& openlib::ConcurrentAppendArray<type, Allocator>::operator[](std::size_t position) const noexcept {
+  return storage[position];
+}
+
+template <class type, class Allocator>
+openlib::ConcurrentAppendArray<type, Allocator>::Appender::Appender(ConcurrentAppendArray& array,
+                                                                    std::size_t batchSize):
+    array(&array), buffer(std::max<std::size_t>(batchSize, 1), uninitialized), buffered(0) {
+}
+
+template <class type, class Allocator>
+openlib::ConcurrentAppendArray<type, Allocator>::Appender::Appender(Appender&& other) noexcept:
+    array(other.array), buffer(std::move(other.buffer)), buffered(other.buffered) {
+  other.array = nullptr;
+}
+
+template <class type, class Allocator>
+openlib::ConcurrentAppendArray<type, Allocator>::Appender::~Appender() {
+  try {
+    flush();
+  } catch (const std::length_error&) {
+    // full, nothing to publish the batch into
+    array->droppedCount.fetch_add(buffered, std::memory_order_relaxed);
+  }
+}
+
+template <class type, class Allocator>
+inline void openlib::ConcurrentAppendArray<type, Allocator>::Appender::append(const type& value) {
+  if (buffered == buffer.size()) {
+    flush();
+  }
+  buffer[buffered++] = value;
+}
+
+template <class type, class Allocator>
+void openlib::ConcurrentAppendArray<type, Allocator>::Appender::flush() {
+  if (array == nullptr || buffered == 0) {
+    return;
+  }
+  array->append(buffer.data(), buffered);
+  buffered = 0;
+}
+
+template <class type, class Allocator>
+inline std::size_t openlib::ConcurrentAppendArray<type, Allocator>::Appender::pending() const noexcept {
+  return buffered;
+}
@@ -0,0 +1,455 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <openlib/ArrayView.h>
+#include <openlib/ByteOrder.h>
+
+namespace openlib {
+
+/**
+ * Reads back what a Serializer wrote, from a borrowed byte range
+ *
+ * Every get* mirrors the put* of the same name, in the byte order of the
+ * Order policy (see ByteOrder); strings are a uint16_t length followed by
+ * the characters. Deserializer reads Serializer's own format, big endian
+ * integers and host order floats, and BasicDeserializer<LittleEndian>
+ * reads what a BasicSerializer<LittleEndian> wrote. Each read checks the
+ * bytes it needs once, then loads them with a single unaligned read, and
+ * throws std::length_error without consuming anything if too few bytes are
+ * left.
+ *
+ * The views returned by getStringView() and getBytesView() point into the
+ * input buffer, which must outlive them.
+ */
+template <class Order>
+class BasicDeserializer final
+{
+public:
+
+  /**
+   * @brief construct a Deserializer over size bytes at data
+   * @param data bytes to read, not copied
+   * @param size number of bytes
+   */
+  BasicDeserializer(const void* data, std::size_t size) noexcept;
+
+  /**
+   * @brief construct a Deserializer over a view, e.g. Serializer::view()
+   * @param bytes bytes to read, not copied
+   */
+  explicit BasicDeserializer(ArrayView<const uint8_t> bytes) noexcept;
+
+  /**
+   * @brief get the total size of the input, in bytes
+   * @return size, in bytes
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief get the number of bytes read so far
+   * @return offset of the next read, in bytes
+   */
+  std::size_t offset() const noexcept;
+
+  /**
+   * @brief get the number of bytes left to read
+   * @return remaining bytes
+   */
+  std::size_t remaining() const noexcept;
+
+  /**
+   * @brief get a char from the buffer
+   * @return data
+   */
+  char getChar();
+
+  /**
+   * @brief get a int8_t from the buffer
+   * @return data
+   */
+  int8_t getInt8();
+
+  /**
+   * @brief get a uint8_t from the buffer
+   * @return data
+   */
+  uint8_t getUInt8();
+
+  /**
+   * @brief get a int16_t from the buffer
+   * @return data
+   */
+  int16_t getInt16();
+
+  /**
+   * @brief get a uint16_t from the buffer
+   * @return data
+   */
+  uint16_t getUInt16();
+
+  /**
+   * @brief get a int32_t from the buffer
+   * @return data
+   */
+  int32_t getInt32();
+
+  /**
+   * @brief get a uint32_t from the buffer
+   * @return data
+   */
+  uint32_t getUInt32();
+
+  /**
+   * @brief get a int64_t from the buffer
+   * @return data
+   */
+  int64_t getInt64();
+
+  /**
+   * @brief get a uint64_t from the buffer
+   * @return data
+   */
+  uint64_t getUInt64();
+
+  /**
+   * @brief get a float from the buffer
+   * @return data
+   */
+  float getFloat();
+
+  /**
+   * @brief get a double from the buffer
+   * @return data
+   */
+  double getDouble();
+
+  /**
+   * @brief get count elements with a single bounds check
+   * Byte swapped with the vector kernels if Order needs it, else copied.
+   * @param data where to put the elements
+   * @param count number of elements
+   */
+  void getInt16Array(int16_t* data, std::size_t count);
+  void getUInt16Array(uint16_t* data, std::size_t count);
+  void getInt32Array(int32_t* data, std::size_t count);
+  void getUInt32Array(uint32_t* data, std::size_t count);
+  void getInt64Array(int64_t* data, std::size_t count);
+  void getUInt64Array(uint64_t* data, std::size_t count);
+  void getFloatArray(float* data, std::size_t count);
+  void getDoubleArray(double* data, std::size_t count);
+
+  /**
+   * @brief fill an array or view, see getInt16Array()
+   * @param data where to put the elements, data.size() are read
+   */
+  void getInt16Array(ArrayView<int16_t> data);
+  void getUInt16Array(ArrayView<uint16_t> data);
+  void getInt32Array(ArrayView<int32_t> data);
+  void getUInt32Array(ArrayView<uint32_t> data);
+  void getInt64Array(ArrayView<int64_t> data);
+  void getUInt64Array(ArrayView<uint64_t> data);
+  void getFloatArray(ArrayView<float> data);
+  void getDoubleArray(ArrayView<double> data);
+
+  /**
+   * @brief get a string written by Serializer::putString, as a copy
+   * @return data
+   */
+  std::string getString();
+
+  /**
+   * @brief get a string written by Serializer::putString, without copying
+   * @return view of the characters in the input buffer
+   */
+  ArrayView<const char> getStringView();
+
+  /**
+   * @brief get the next size bytes, without copying
+   * @return view of the bytes in the input buffer
+   */
+  ArrayView<const uint8_t> getBytesView(std::size_t size);
+
+  /**
+   * @brief copy the next size bytes into data
+   */
+  void get(void* data, std::size_t size);
+
+  /**
+   * @brief skip the next size bytes
+   */
+  void skip(std::size_t size);
+
+private:
+
+  const uint8_t* begin;
+  const uint8_t* position;
+  const uint8_t* end;
+
+  // the only bounds check: returns the next size bytes and moves past them
+  const uint8_t* take(std::size_t size);
+
+  template <class type>
+  type load();
+
+  template <class type>
+  void getArray(type* data, std::size_t count);
+};
+
+typedef BasicDeserializer<BigEndianIntegers> Deserializer;
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class Order>
+inline openlib::BasicDeserializer<Order>::BasicDeserializer(const void* data, std::size_t size) noexcept:
+    begin(static_cast<const uint8_t*>(data)), position(begin), end(begin + size) {
+}
+
+template <class Order>
+inline openlib::BasicDeserializer<Order>::BasicDeserializer(ArrayView<const uint8_t> bytes) noexcept:
+    BasicDeserializer(bytes.data(), bytes.size()) {
+}
+
+template <class Order>
+inline std::size_t openlib::BasicDeserializer<Order>::size() const noexcept {
+  return end - begin;
+}
+
+template <class Order>
+inline std::size_t openlib::BasicDeserializer<Order>::offset() const noexcept {
+  return position - begin;
+}
+
+template <class Order>
+inline std::size_t openlib::BasicDeserializer<Order>::remaining() const noexcept {
+  return end - position;
+}
+
+template <class Order>
+inline const uint8_t* openlib::BasicDeserializer<Order>::take(std::size_t size) {
+  if (__builtin_expect(remaining() < size, 0)) {
+    throw std::length_error("not enough bytes left in Deserializer");
+  }
+  const uint8_t* bytes = position;
+  position += size;
+  return bytes;
+}
+
+template <class Order>
+template <class type>
+inline type openlib::BasicDeserializer<Order>::load() {
+  type data;
+  std::memcpy(&data, take(sizeof(data)), sizeof(data));
+  return Order::convert(data);
+}
+
+template <class Order>
+inline char openlib::BasicDeserializer<Order>::getChar() {
+  return load<char>();
+}
+
+template <class Order>
+inline int8_t openlib::BasicDeserializer<Order>::getInt8() {
+  return load<int8_t>();
+}
+
+template <class Order>
+inline uint8_t openlib::BasicDeserializer<Order>::getUInt8() {
+  return load<uint8_t>();
+}
+
+template <class Order>
+inline int16_t openlib::BasicDeserializer<Order>::getInt16() {
+  return load<int16_t>();
+}
+
+template <class Order>
+inline uint16_t openlib::BasicDeserializer<Order>::getUInt16() {
+  return load<uint16_t>();
+}
+
+template <class Order>
+inline int32_t openlib::BasicDeserializer<Order>::getInt32() {
+  return load<int32_t>();
+}
+
+template <class Order>
+inline uint32_t openlib::BasicDeserializer<Order>::getUInt32() {
+  return load<uint32_t>();
+}
+
+template <class Order>
+inline int64_t openlib::BasicDeserializer<Order>::getInt64() {
+  return load<int64_t>();
+}
+
+template <class Order>
+inline uint64_t openlib::BasicDeserializer<Order>::getUInt64() {
+  return load<uint64_t>();
+}
+
+template <class Order>
+inline float openlib::BasicDeserializer<Order>::getFloat() {
+  return load<float>();
+}
+
+template <class Order>
+inline double openlib::BasicDeserializer<Order>::getDouble() {
+  return load<double>();
+}
+
+template <class Order>
+template <class type>
+inline void openlib::BasicDeserializer<Order>::getArray(type* data, std::size_t count) {
+  if (__builtin_expect(remaining() / sizeof(type) < count, 0)) {
+    throw std::length_error("not enough bytes left in Deserializer");
+  }
+  Order::template convert<type>(data, take(count * sizeof(type)), count);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getInt16Array(int16_t* data, std::size_t count) {
+  getArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getUInt16Array(uint16_t* data, std::size_t count) {
+  getArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getInt32Array(int32_t* data, std::size_t count) {
+  getArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getUInt32Array(uint32_t* data, std::size_t count) {
+  getArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getInt64Array(int64_t* data, std::size_t count) {
+  getArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getUInt64Array(uint64_t* data, std::size_t count) {
+  getArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getFloatArray(float* data, std::size_t count) {
+  getArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getDoubleArray(double* data, std::size_t count) {
+  getArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getInt16Array(ArrayView<int16_t> data) {
+  getArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getUInt16Array(ArrayView<uint16_t> data) {
+  getArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getInt32Array(ArrayView<int32_t> data) {
+  getArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getUInt32Array(ArrayView<uint32_t> data) {
+  getArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getInt64Array(ArrayView<int64_t> data) {
+  getArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getUInt64Array(ArrayView<uint64_t> data) {
+  getArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getFloatArray(ArrayView<float> data) {
+  getArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::getDoubleArray(ArrayView<double> data) {
+  getArray(data.data(), data.size());
+}
+
+template <class Order>
+inline std::string openlib::BasicDeserializer<Order>::getString() {
+  ArrayView<const char> view = getStringView();
+  return std::string(view.data(), view.size());
+}
+
+template <class Order>
+inline openlib::ArrayView<const char> openlib::BasicDeserializer<Order>::getStringView() {
+  // check the length and the characters together, so a truncated string
+  // consumes nothing
+  if (remaining() < sizeof(uint16_t)) {
+    throw std::length_error("not enough bytes left in Deserializer");
+  }
+  uint16_t length;
+  std::memcpy(&length, position, sizeof(length));
+  length = Order::convert(length);
+  const uint8_t* bytes = take(sizeof(length) + length) + sizeof(length);
+  return ArrayView<const char>(reinterpret_cast<const char*>(bytes), length);
+}
+
+template <class Order>
+inline openlib::ArrayView<const uint8_t> openlib::BasicDeserializer<Order>::getBytesView(std::size_t size) {
+  return ArrayView<const uint8_t>(take(size), size);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::get(void* data, std::size_t size) {
+  std::memcpy(data, take(size), size);
+}
+
+template <class Order>
+inline void openlib::BasicDeserializer<Order>::skip(std::size_t size) {
+  take(size);
+}
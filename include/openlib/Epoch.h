@@ -0,0 +1,159 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <openlib/AlignedAllocator.h>
+#include <openlib/FlatArray.h>
+
+namespace openlib {
+
+/**
+ * Epoch-based reclamation domain
+ *
+ * Readers announce the global epoch in a slot of their own while they use
+ * shared data; a writer that has unlinked an object advances the epoch and
+ * may free the object once every announced epoch is newer. Each slot sits
+ * on its own cache line, so entering and leaving a read section never
+ * writes memory another thread writes.
+ *
+ * A reading thread acquires a slot once and keeps it. enter()/exit() on a
+ * slot nest, and a slot must only be used by one thread at a time.
+ */
+class EpochDomain final {
+public:
+
+  /**
+   * Per-reader announcement slot
+   */
+  struct alignas(CACHE_LINE_BYTES) Slot {
+    Slot() noexcept;
+
+    // epoch the owner entered at, IDLE when not in a read section
+    std::atomic<uint64_t> epoch;
+    std::atomic<bool> owned;
+    // read section nesting, touched only by the owner
+    std::size_t depth;
+  };
+
+  /**
+   * @brief slot value of a reader outside any read section
+   */
+  static const uint64_t IDLE = 0;
+
+  /**
+   * @brief constructor
+   */
+  EpochDomain();
+
+  /**
+   * @brief claim a free slot, or add one
+   * @return a slot owned by the caller until releaseSlot()
+   */
+  Slot& acquireSlot();
+
+  /**
+   * @brief give a slot back, its owner must be outside any read section
+   */
+  void releaseSlot(Slot& slot) noexcept;
+
+  /**
+   * @brief start a read section, wait-free
+   */
+  void enter(Slot& slot) noexcept;
+
+  /**
+   * @brief end a read section, wait-free
+   */
+  void exit(Slot& slot) noexcept;
+
+  /**
+   * @brief move to a new epoch
+   * Call after unlinking an object; the object may be freed once
+   * isQuiescent() returns true for the returned epoch.
+   * @return the new epoch
+   */
+  uint64_t advance() noexcept;
+
+  /**
+   * @brief whether every reader that entered before epoch has left
+   * @param epoch epoch returned by advance()
+   */
+  bool isQuiescent(uint64_t epoch);
+
+  /**
+   * @brief advance and wait until every earlier read section has ended
+   * Must not be called from inside a read section of this domain.
+   */
+  void synchronize();
+
+  /**
+   * @brief the current epoch
+   */
+  uint64_t current() const noexcept;
+
+private:
+  static const std::size_t SLOTS_PER_CHUNK = 64;
+
+  std::atomic<uint64_t> epoch;
+  std::mutex slotsLock;
+  std::vector<std::unique_ptr<FlatArray<Slot, AlignedAllocator<Slot>>>> slots;
+
+  // no copy or assignment
+  EpochDomain(const EpochDomain& other) = delete;
+  EpochDomain& operator=(const EpochDomain& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+inline void openlib::EpochDomain::enter(Slot& slot) noexcept {
+  if (slot.depth++ == 0) {
+    slot.epoch.store(epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    // pairs with the fence in isQuiescent(): either the writer sees this
+    // announcement or this reader sees everything unlinked before advance()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+inline void openlib::EpochDomain::exit(Slot& slot) noexcept {
+  if (--slot.depth == 0) {
+    slot.epoch.store(IDLE, std::memory_order_release);
+  }
+}
+
+inline uint64_t openlib::EpochDomain::current() const noexcept {
+  return epoch.load(std::memory_order_acquire);
+}
@@ -0,0 +1,420 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <memory>
+#include <new>
+#include <initializer_list>
+#include <type_traits>
+
+#include <openlib/AlignedAllocator.h>
+#include <openlib/Kernels.h>
+
+namespace openlib {
+
+/**
+ * Tag type selecting default-initialization of array elements
+ *
+ * Trivial element types (int, float, POD structs) are left uninitialized
+ * instead of zeroed. Non-trivial element types are still default
+ * constructed, so the tag is safe to use with any element type.
+ */
+struct Uninitialized {};
+
+/**
+ * @brief tag value, see Uninitialized
+ */
+constexpr Uninitialized uninitialized = Uninitialized();
+
+/**
+ * Dynamically allocated array data structure, non-polymorphic
+ *
+ * Same interface as openlib::Array, but every accessor is non-virtual and
+ * inlinable so loops over a FlatArray can be auto-vectorized. Use this type
+ * in hot code; openlib::Array wraps it for code that needs to subclass.
+ *
+ * Storage comes from Allocator, any standard conforming allocator works.
+ * See Arena.h, Pool.h and AlignedAllocator.h for allocators shipped with
+ * OpenLib. The alignment the allocator guarantees is known at compile time
+ * as FlatArray::alignment, and data() and begin() carry it to the
+ * optimizer so kernels can use aligned loads.
+ *
+ * Elements are guaranteed to stay in the same location in memory.
+ */
+template <class type, class Allocator = std::allocator<type>>
+class FlatArray final {
+public:
+
+  /**
+   * @brief guaranteed alignment of data(), in bytes
+   */
+  static constexpr std::size_t alignment = AllocatorAlignment<type, Allocator>::value;
+
+  /**
+   * @brief constructor
+   * @param size size of array
+   * @param allocator allocator to take storage from
+   */
+  explicit FlatArray(const std::size_t& size, const Allocator& allocator = Allocator());
+
+  /**
+   * @brief constructor, elements are default-initialized
+   * Trivial elements are left uninitialized rather than zeroed, which
+   * avoids touching every page of a large buffer that is about to be
+   * overwritten anyway.
+   * @param size size of array
+   * @param allocator allocator to take storage from
+   */
+  FlatArray(const std::size_t& size, Uninitialized, const Allocator& allocator = Allocator());
+
+  /**
+   * @brief constructor
+   * FlatArray will be initialized based off of the list.
+   * FlatArray will be the size of the list.
+   * @param list an initializer list
+   * @param allocator allocator to take storage from
+   */
+  FlatArray(const std::initializer_list<type>& list, const Allocator& allocator = Allocator());
+
+  /**
+   * @brief copy constructor
+   * FlatArray will be initialized based off the other array. Values will
+   * be copied.
+   */
+  FlatArray(const FlatArray& other);
+
+  /**
+   * @brief move constructor
+   * FlatArray will be initialized based off of the other array. This is a
+   * destructive move constructor, the old FlatArray object will no longer be
+   * valid.
+   */
+  FlatArray(FlatArray&& other) noexcept;
+
+  /**
+   * @brief destructor
+   */
+  ~FlatArray();
+
+  /**
+   * @brief Number of elements in the array
+   * @return the number of elements in the array
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief Access element at a given position
+   * @return a reference to the element at the given position
+   */
+  type& at(const std::size_t& position) noexcept;
+
+  /**
+   * @brief Access const element at a given position
+   * @return a const reference to the element at the given position
+   */
+  const type& at(const std::size_t& position) const noexcept;
+
+  /**
+   * @brief The first element
+   * @return a reference to the first element
+   */
+  type& front() const noexcept;
+
+  /**
+   * @brief The last element
+   * @return a reference to the last element
+   */
+  type& back() const noexcept;
+
+  /**
+   * @brief Returns a pointer to the underlying array
+   * @returns a pointer to the underlying array
+   */
+  type* data() const noexcept;
+
+  /**
+   * @brief Get a pointer to the first element
+   * @return a pointer to the first element
+   */
+  type* begin() const noexcept;
+
+  /**
+   * @brief Get a pointer to one past the last element
+   * @return a pointer to one past the last element
+   */
+  type* end() const noexcept;
+
+  /**
+   * @brief fill each element of the array with the same value
+   * @param value a value to fill the array with
+   */
+  void fill(const type& value);
+
+  /**
+   * @brief The allocator storage was taken from
+   * @return the allocator
+   */
+  const Allocator& allocator() const noexcept;
+
+  /**
+   * @brief auto cast to pointer to base type
+   */
+  operator type*() const noexcept;
+
+  /**
+   * @brief operator[]
+   */
+  type& operator[](std::size_t position) noexcept;
+
+  /**
+   * @brief operator[] const
+   */
+  const type& operator[](std::size_t position) const noexcept;
+
+private:
+  using Traits = std::allocator_traits<Allocator>;
+
+  Allocator alloc;
+  const std::size_t bufferSize;
+  type* buffer;
+
+  // allocate storage for bufferSize elements
+  type* allocate();
+
+  // construct every element with construct(pointer, index), cleaning up on throw
+  template <class Construct>
+  void constructEach(Construct construct);
+
+  // destroy the first count elements
+  void destroy(std::size_t count) noexcept;
+
+  // no assignment operator
+  FlatArray& operator=(const FlatArray& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, class Allocator>
+constexpr std::size_t openlib::FlatArray<type, Allocator>::alignment;
+
+template <class type, class Allocator>
+openlib::FlatArray<type, Allocator>::FlatArray(const std::size_t& size, const Allocator& allocator):
+    alloc(allocator),
+    bufferSize(size),
+    buffer(allocate()) {
+
+  constructEach([this](type* p, std::size_t) {
+    Traits::construct(alloc, p);
+  });
+}
+
+template <class type, class Allocator>
+openlib::FlatArray<type, Allocator>::FlatArray(const std::size_t& size, Uninitialized,
+                                               const Allocator& allocator):
+    alloc(allocator),
+    bufferSize(size),
+    buffer(allocate()) {
+
+  if (!std::is_trivially_default_constructible<type>::value) {
+    constructEach([](type* p, std::size_t) {
+      ::new (static_cast<void*>(p)) type;
+    });
+  }
+}
+
+template <class type, class Allocator>
+openlib::FlatArray<type, Allocator>::FlatArray(const std::initializer_list<type>& list,
+                                               const Allocator& allocator):
+    alloc(allocator),
+    bufferSize(list.size()),
+    buffer(allocate()) {
+
+  const type* source = list.begin();
+  constructEach([this, source](type* p, std::size_t i) {
+    Traits::construct(alloc, p, source[i]);
+  });
+}
+
+template <class type, class Allocator>
+openlib::FlatArray<type, Allocator>::FlatArray(const openlib::FlatArray<type, Allocator>& other):
+    alloc(Traits::select_on_container_copy_construction(other.alloc)),
+    bufferSize(other.bufferSize),
+    buffer(allocate()) {
+
+  if (std::is_trivially_copyable<type>::value) {
+    kernels::copy(buffer, other.buffer, bufferSize * sizeof(type));
+    return;
+  }
+
+  const type* source = other.buffer;
+  constructEach([this, source](type* p, std::size_t i) {
+    Traits::construct(alloc, p, source[i]);
+  });
+}
+
+template <class type, class Allocator>
+openlib::FlatArray<type, Allocator>::FlatArray(openlib::FlatArray<type, Allocator>&& other) noexcept:
+    alloc(other.alloc),
+    bufferSize(other.bufferSize),
+    buffer(other.buffer) {
+  other.buffer = nullptr;
+}
+
+template <class type, class Allocator>
+openlib::FlatArray<type, Allocator>::~FlatArray() {
+  if (buffer != nullptr) {
+    destroy(bufferSize);
+    Traits::deallocate(alloc, buffer, bufferSize);
+  }
+}
+
+template <class type, class Allocator>
+type* openlib::FlatArray<type, Allocator>::allocate() {
+  return Traits::allocate(alloc, bufferSize);
+}
+
+template <class type, class Allocator>
+template <class Construct>
+void openlib::FlatArray<type, Allocator>::constructEach(Construct construct) {
+  std::size_t i = 0;
+  try {
+    for (; i < bufferSize; i++) {
+      construct(buffer + i, i);
+    }
+  } catch (...) {
+    destroy(i);
+    Traits::deallocate(alloc, buffer, bufferSize);
+    throw;
+  }
+}
+
+template <class type, class Allocator>
+void openlib::FlatArray<type, Allocator>::destroy(std::size_t count) noexcept {
+  if (!std::is_trivially_destructible<type>::value) {
+    for (std::size_t i = 0; i < count; i++) {
+      Traits::destroy(alloc, buffer + i);
+    }
+  }
+}
+
+template <class type, class Allocator>
+inline std::size_t openlib::FlatArray<type, Allocator>::size() const noexcept {
+  return bufferSize;
+}
+
+template <class type, class Allocator>
+inline type& openlib::FlatArray<type, Allocator>::at(const std::size_t& position) noexcept {
+  return data()[position];
+}
+
+template <class type, class Allocator>
+inline const type& openlib::FlatArray<type, Allocator>::at(const std::size_t& position) const noexcept {
+  return data()[position];
+}
+
+template <class type, class Allocator>
+inline type& openlib::FlatArray<type, Allocator>::front() const noexcept {
+  return buffer[0];
+}
+
+template <class type, class Allocator>
+inline type& openlib::FlatArray<type, Allocator>::back() const noexcept {
+  return buffer[bufferSize - 1];
+}
+
+template <class type, class Allocator>
+inline type* openlib::FlatArray<type, Allocator>::data() const noexcept {
+  return static_cast<type*>(__builtin_assume_aligned(buffer, alignment));
+}
+
+template <class type, class Allocator>
+inline type* openlib::FlatArray<type, Allocator>::begin() const noexcept {
+  return data();
+}
+
+template <class type, class Allocator>
+inline type* openlib::FlatArray<type, Allocator>::end() const noexcept {
+  return data() + bufferSize;
+}
+
+template <class type, class Allocator>
+inline void openlib::FlatArray<type, Allocator>::fill(const type& value) {
+  kernels::detail::fillArray(data(), value, bufferSize, std::is_trivially_copyable<type>());
+}
+
+template <class type, class Allocator>
+inline const Allocator& openlib::FlatArray<type, Allocator>::allocator() const noexcept {
+  return alloc;
+}
+
+template <class type, class Allocator>
+inline openlib::FlatArray<type, Allocator>::operator type*() const noexcept {
+  return data();
+}
+
+template <class type, class Allocator>
+inline type& openlib::FlatArray<type, Allocator>::operator[](std::size_t position) noexcept {
+  return at(position);
+}
+
+template <class type, class Allocator>
+inline const type& openlib::FlatArray<type, Allocator>::operator[](std::size_t position) const noexcept {
+  return at(position);
+}
+
+/**
+ * @brief equality
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, class Allocator>
+inline bool operator==(const openlib::FlatArray<type, Allocator> &lhs,
+                       const openlib::FlatArray<type, Allocator> &rhs) {
+  return lhs.data() == rhs.data();
+}
+
+/**
+ * @brief inequality
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, class Allocator>
+inline bool operator!=(const openlib::FlatArray<type, Allocator> &lhs,
+                       const openlib::FlatArray<type, Allocator> &rhs) {
+  return lhs.data() != rhs.data();
+}
+
+/**
+ * @brief less than
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, class Allocator>
+inline bool operator<(const openlib::FlatArray<type, Allocator> &lhs,
+                      const openlib::FlatArray<type, Allocator> &rhs) {
+  return lhs.data() < rhs.data();
+}
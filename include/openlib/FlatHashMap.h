@@ -0,0 +1,1035 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <openlib/AlignedAllocator.h>
+#include <openlib/FlatArray.h>
+
+namespace openlib {
+
+namespace detail {
+
+/**
+ * Control byte of a hash table slot: the low 7 bits of the hash when the
+ * slot is full, one of the negative markers below otherwise
+ */
+typedef int8_t Control;
+
+const Control CONTROL_EMPTY = -128;
+const Control CONTROL_DELETED = -2;
+
+/**
+ * Sixteen control bytes, compared with the SSE2 byte compares
+ *
+ * Each match returns a bit mask with bit i set for control byte i.
+ */
+class ControlGroup {
+public:
+  static const std::size_t WIDTH = 16;
+
+  explicit ControlGroup(const Control* control) noexcept;
+
+  /**
+   * @brief full slots whose control byte is h2
+   */
+  uint32_t match(Control h2) const noexcept;
+
+  /**
+   * @brief empty slots
+   */
+  uint32_t matchEmpty() const noexcept;
+
+  /**
+   * @brief empty or deleted slots
+   */
+  uint32_t matchFree() const noexcept;
+
+private:
+#if defined(__SSE2__)
+  __m128i bytes;
+#else
+  Control bytes[WIDTH];
+#endif
+};
+
+/**
+ * @brief whether a hash or equality functor declares is_transparent
+ */
+template <class type, class Enable = void>
+struct IsTransparent : std::false_type {};
+
+template <class type>
+struct IsTransparent<type, typename std::conditional<true, void,
+                                                     typename type::is_transparent>::type>
+    : std::true_type {};
+
+/**
+ * @brief lookup key type, K for transparent functors and Key otherwise
+ * K is deduced from the argument only when the alias is K itself.
+ */
+template <bool transparent>
+struct KeyArg {
+  template <class K, class Key>
+  using type = K;
+};
+
+template <>
+struct KeyArg<false> {
+  template <class K, class Key>
+  using type = Key;
+};
+
+/**
+ * @brief slot layout of FlatHashMap
+ */
+template <class Key, class Value>
+struct MapPolicy {
+  typedef Key key_type;
+  typedef std::pair<const Key, Value> value_type;
+
+  static const Key& key(const value_type& value) noexcept {
+    return value.first;
+  }
+
+  // move-construct dst from src and destroy src; the key is moved out of
+  // its const member, which is safe because src is destroyed right after
+  static void transfer(value_type* dst, value_type* src) {
+    new (dst) value_type(std::move(const_cast<Key&>(src->first)), std::move(src->second));
+    src->~value_type();
+  }
+};
+
+/**
+ * @brief slot layout of FlatHashSet
+ */
+template <class Key>
+struct SetPolicy {
+  typedef Key key_type;
+  typedef const Key value_type;
+
+  static const Key& key(const Key& value) noexcept {
+    return value;
+  }
+
+  static void transfer(const Key* dst, const Key* src) {
+    Key* from = const_cast<Key*>(src);
+    new (const_cast<Key*>(dst)) Key(std::move(*from));
+    from->~Key();
+  }
+};
+
+/**
+ * Open-addressing hash table shared by FlatHashMap and FlatHashSet
+ *
+ * One control byte per slot plus slots of uninitialized storage, both in
+ * aligned FlatArrays. A lookup hashes the key once, then compares the
+ * low 7 bits of the hash with sixteen control bytes at a time and only
+ * compares keys whose control byte matched. Groups are probed
+ * quadratically, and the table grows before it is 7/8 full. Erasing
+ * empties the slot when every group that covers it also covers an empty
+ * slot, since no probe can have passed over it. Otherwise it leaves a
+ * tombstone, which later inserts reuse.
+ *
+ * Iterators and references are invalidated by any insert that grows the
+ * table.
+ */
+template <class Policy, class Hash, class KeyEqual>
+class FlatHashTable {
+public:
+  typedef typename Policy::key_type key_type;
+  typedef typename std::remove_const<typename Policy::value_type>::type value_type;
+  typedef Hash hasher;
+  typedef KeyEqual key_equal;
+
+  template <bool constant>
+  class Iterator;
+
+  typedef Iterator<std::is_const<typename Policy::value_type>::value> iterator;
+  typedef Iterator<true> const_iterator;
+
+  /**
+   * @brief lookup key, any type when Hash and KeyEqual are transparent
+   */
+  template <class K>
+  using key_arg = typename KeyArg<IsTransparent<Hash>::value &&
+                                  IsTransparent<KeyEqual>::value>::template type<K, key_type>;
+
+  /**
+   * @brief number of elements
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief whether there are no elements
+   */
+  bool empty() const noexcept;
+
+  /**
+   * @brief number of slots, the table grows before they are 7/8 full
+   */
+  std::size_t capacity() const noexcept;
+
+  /**
+   * @brief make room for count elements without growing again
+   */
+  void reserve(std::size_t count);
+
+  /**
+   * @brief erase every element, keeping the slots
+   */
+  void clear() noexcept;
+
+  iterator begin() noexcept;
+  iterator end() noexcept;
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+
+  /**
+   * @brief element with a key equal to key
+   * @return iterator to it, or end()
+   */
+  template <class K = key_type>
+  iterator find(const key_arg<K>& key);
+
+  template <class K = key_type>
+  const_iterator find(const key_arg<K>& key) const;
+
+  /**
+   * @brief whether an element with a key equal to key exists
+   */
+  template <class K = key_type>
+  bool contains(const key_arg<K>& key) const;
+
+  /**
+   * @brief number of elements with a key equal to key, 0 or 1
+   */
+  template <class K = key_type>
+  std::size_t count(const key_arg<K>& key) const;
+
+  /**
+   * @brief erase the element with a key equal to key
+   * @return number of elements erased, 0 or 1
+   */
+  template <class K = key_type>
+  std::size_t erase(const key_arg<K>& key);
+
+  /**
+   * @brief erase the element at position, which must not be end()
+   */
+  void erase(const_iterator position);
+
+protected:
+  typedef typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type Slot;
+
+  explicit FlatHashTable(std::size_t capacity, const Hash& hash, const KeyEqual& equal);
+  FlatHashTable(const FlatHashTable& other);
+  FlatHashTable(FlatHashTable&& other) noexcept;
+  ~FlatHashTable();
+
+  /**
+   * @brief find key, or construct a value with construct(pointer) if absent
+   * @return iterator to the element, and whether it was inserted
+   */
+  template <class K, class Construct>
+  std::pair<iterator, bool> findOrConstruct(const K& key, Construct construct);
+
+  value_type* slot(std::size_t index) const noexcept;
+
+private:
+  struct Storage {
+    explicit Storage(std::size_t capacity);
+
+    FlatArray<Control, AlignedAllocator<Control>> control;
+    FlatArray<Slot, AlignedAllocator<Slot>> slots;
+  };
+
+  Hash hash;
+  KeyEqual equal;
+  std::unique_ptr<Storage> storage;
+  // cached from storage, so lookups do not chase the pointer
+  Control* control;
+  Slot* slots;
+  std::size_t slotCount;
+  std::size_t elements;
+  // inserts into empty slots left before the table must grow
+  std::size_t growthLeft;
+
+  template <class K>
+  std::size_t hashOf(const K& key) const;
+
+  // index of the slot holding key, or slotCount
+  template <class K>
+  std::size_t findIndex(const K& key, std::size_t hashed) const;
+
+  // first free slot on the probe sequence of hashed
+  std::size_t findFree(std::size_t hashed) const noexcept;
+
+  void setControl(std::size_t index, Control value) noexcept;
+  void rehash(std::size_t capacity);
+  void destroyAll() noexcept;
+
+  static std::size_t capacityFor(std::size_t count) noexcept;
+  static std::size_t maxLoad(std::size_t capacity) noexcept;
+
+  // no assignment, like FlatArray
+  FlatHashTable& operator=(const FlatHashTable& other) = delete;
+};
+
+/**
+ * Forward iterator over the full slots of a FlatHashTable
+ */
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+class FlatHashTable<Policy, Hash, KeyEqual>::Iterator {
+public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef typename FlatHashTable::value_type value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef typename std::conditional<constant, const value_type*, value_type*>::type pointer;
+  typedef typename std::conditional<constant, const value_type&, value_type&>::type reference;
+
+  Iterator() noexcept;
+
+  /**
+   * @brief mutable to constant conversion
+   */
+  template <bool other, class = typename std::enable_if<constant && !other>::type>
+  Iterator(const Iterator<other>& iterator) noexcept;
+
+  reference operator*() const noexcept;
+  pointer operator->() const noexcept;
+  Iterator& operator++() noexcept;
+  Iterator operator++(int) noexcept;
+
+  bool operator==(const Iterator& other) const noexcept;
+  bool operator!=(const Iterator& other) const noexcept;
+
+private:
+  friend class FlatHashTable;
+  template <bool other>
+  friend class Iterator;
+
+  const FlatHashTable* table;
+  std::size_t index;
+
+  Iterator(const FlatHashTable* table, std::size_t index) noexcept;
+  void skipFree() noexcept;
+};
+
+} // namespace detail
+
+/**
+ * Hash map with open addressing over flat, aligned storage
+ *
+ * Entries live in one contiguous slot array instead of a node each, see
+ * detail::FlatHashTable for the layout. Lookups take any key type when
+ * Hash and KeyEqual both declare is_transparent.
+ */
+template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class FlatHashMap final : public detail::FlatHashTable<detail::MapPolicy<Key, Value>, Hash, KeyEqual> {
+  typedef detail::FlatHashTable<detail::MapPolicy<Key, Value>, Hash, KeyEqual> Table;
+
+public:
+  typedef Value mapped_type;
+  typedef typename Table::value_type value_type;
+  typedef typename Table::iterator iterator;
+  typedef typename Table::const_iterator const_iterator;
+
+  /**
+   * @brief constructor
+   * @param capacity elements to make room for
+   */
+  explicit FlatHashMap(std::size_t capacity = 0, const Hash& hash = Hash(),
+                       const KeyEqual& equal = KeyEqual());
+
+  /**
+   * @brief constructor
+   */
+  FlatHashMap(std::initializer_list<value_type> list);
+
+  /**
+   * @brief copy constructor
+   */
+  FlatHashMap(const FlatHashMap& other) = default;
+
+  /**
+   * @brief move constructor
+   */
+  FlatHashMap(FlatHashMap&& other) = default;
+
+  /**
+   * @brief insert value unless its key is present
+   * @return iterator to the element with the key, and whether it was inserted
+   */
+  std::pair<iterator, bool> insert(const value_type& value);
+  std::pair<iterator, bool> insert(value_type&& value);
+
+  /**
+   * @brief construct a value in place unless its key is present
+   * The value is built first to get at its key.
+   */
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+
+  /**
+   * @brief insert a value built from args unless key is present
+   * Nothing is constructed if the key is present.
+   */
+  template <class... Args>
+  std::pair<iterator, bool> tryEmplace(const Key& key, Args&&... args);
+
+  template <class... Args>
+  std::pair<iterator, bool> tryEmplace(Key&& key, Args&&... args);
+
+  /**
+   * @brief value for key, inserting a value-initialized one if absent
+   */
+  Value& operator[](const Key& key);
+  Value& operator[](Key&& key);
+
+  /**
+   * @brief value for key
+   * @throws std::out_of_range if key is absent
+   */
+  template <class K = Key>
+  Value& at(const typename Table::template key_arg<K>& key);
+
+  template <class K = Key>
+  const Value& at(const typename Table::template key_arg<K>& key) const;
+};
+
+/**
+ * Hash set with open addressing over flat, aligned storage
+ *
+ * See FlatHashMap.
+ */
+template <class Key, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class FlatHashSet final : public detail::FlatHashTable<detail::SetPolicy<Key>, Hash, KeyEqual> {
+  typedef detail::FlatHashTable<detail::SetPolicy<Key>, Hash, KeyEqual> Table;
+
+public:
+  typedef typename Table::iterator iterator;
+  typedef typename Table::const_iterator const_iterator;
+
+  /**
+   * @brief constructor
+   * @param capacity elements to make room for
+   */
+  explicit FlatHashSet(std::size_t capacity = 0, const Hash& hash = Hash(),
+                       const KeyEqual& equal = KeyEqual());
+
+  /**
+   * @brief constructor
+   */
+  FlatHashSet(std::initializer_list<Key> list);
+
+  /**
+   * @brief copy constructor
+   */
+  FlatHashSet(const FlatHashSet& other) = default;
+
+  /**
+   * @brief move constructor
+   */
+  FlatHashSet(FlatHashSet&& other) = default;
+
+  /**
+   * @brief insert key unless it is present
+   * @return iterator to the element, and whether it was inserted
+   */
+  std::pair<iterator, bool> insert(const Key& key);
+  std::pair<iterator, bool> insert(Key&& key);
+
+  /**
+   * @brief construct a key in place unless it is present
+   */
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+inline openlib::detail::ControlGroup::ControlGroup(const Control* control) noexcept {
+#if defined(__SSE2__)
+  bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+#else
+  for (std::size_t i = 0; i < WIDTH; i++) {
+    bytes[i] = control[i];
+  }
+#endif
+}
+
+inline uint32_t openlib::detail::ControlGroup::match(Control h2) const noexcept {
+#if defined(__SSE2__)
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(h2))));
+#else
+  uint32_t mask = 0;
+  for (std::size_t i = 0; i < WIDTH; i++) {
+    mask |= uint32_t(bytes[i] == h2) << i;
+  }
+  return mask;
+#endif
+}
+
+inline uint32_t openlib::detail::ControlGroup::matchEmpty() const noexcept {
+  return match(CONTROL_EMPTY);
+}
+
+inline uint32_t openlib::detail::ControlGroup::matchFree() const noexcept {
+#if defined(__SSE2__)
+  // every marker is negative, full slots hold 0..127
+  return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+#else
+  uint32_t mask = 0;
+  for (std::size_t i = 0; i < WIDTH; i++) {
+    mask |= uint32_t(bytes[i] < 0) << i;
+  }
+  return mask;
+#endif
+}
+
+template <class Policy, class Hash, class KeyEqual>
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Storage::Storage(std::size_t capacity):
+    control(capacity + ControlGroup::WIDTH, uninitialized), slots(capacity, uninitialized) {
+  control.fill(CONTROL_EMPTY);
+}
+
+template <class Policy, class Hash, class KeyEqual>
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::FlatHashTable(std::size_t capacity,
+                                                                     const Hash& hash,
+                                                                     const KeyEqual& equal):
+    hash(hash), equal(equal), control(nullptr), slots(nullptr), slotCount(0), elements(0),
+    growthLeft(0) {
+  reserve(capacity);
+}
+
+template <class Policy, class Hash, class KeyEqual>
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::FlatHashTable(const FlatHashTable& other):
+    FlatHashTable(other.size(), other.hash, other.equal) {
+  for (const auto& value : other) {
+    const std::size_t index = findFree(hashOf(Policy::key(value)));
+    new (slot(index)) value_type(value);
+    setControl(index, other.control[&value - other.slot(0)]);
+    elements++;
+    growthLeft--;
+  }
+}
+
+template <class Policy, class Hash, class KeyEqual>
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::FlatHashTable(FlatHashTable&& other) noexcept:
+    hash(std::move(other.hash)), equal(std::move(other.equal)),
+    storage(std::move(other.storage)), control(other.control), slots(other.slots),
+    slotCount(other.slotCount), elements(other.elements), growthLeft(other.growthLeft) {
+  other.control = nullptr;
+  other.slots = nullptr;
+  other.slotCount = 0;
+  other.elements = 0;
+  other.growthLeft = 0;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::~FlatHashTable() {
+  destroyAll();
+}
+
+template <class Policy, class Hash, class KeyEqual>
+inline std::size_t openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::size() const noexcept {
+  return elements;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+inline bool openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::empty() const noexcept {
+  return elements == 0;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+inline std::size_t openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::capacity() const noexcept {
+  return slotCount;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+std::size_t openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::maxLoad(
+    std::size_t capacity) noexcept {
+  return capacity - capacity / 8;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+std::size_t openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::capacityFor(
+    std::size_t count) noexcept {
+  if (count == 0) {
+    return 0;
+  }
+  std::size_t capacity = ControlGroup::WIDTH;
+  while (maxLoad(capacity) < count) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+void openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::reserve(std::size_t count) {
+  if (count > elements + growthLeft) {
+    rehash(capacityFor(count));
+  }
+}
+
+template <class Policy, class Hash, class KeyEqual>
+void openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::clear() noexcept {
+  destroyAll();
+  if (storage) {
+    storage->control.fill(CONTROL_EMPTY);
+  }
+  elements = 0;
+  growthLeft = maxLoad(slotCount);
+}
+
+template <class Policy, class Hash, class KeyEqual>
+void openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::destroyAll() noexcept {
+  if (!std::is_trivially_destructible<value_type>::value) {
+    for (std::size_t i = 0; i < slotCount; i++) {
+      if (control[i] >= 0) {
+        slot(i)->~value_type();
+      }
+    }
+  }
+}
+
+template <class Policy, class Hash, class KeyEqual>
+inline typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::value_type*
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::slot(std::size_t index) const noexcept {
+  return reinterpret_cast<value_type*>(slots + index);
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <class K>
+inline std::size_t openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::hashOf(
+    const K& key) const {
+  // std::hash of an integer is the integer itself, so mix every bit into
+  // the high bits (the probe start) and the low 7 (the control byte)
+  const unsigned __int128 product = static_cast<unsigned __int128>(hash(key)) *
+                                    0x9e3779b97f4a7c15ull;
+  return static_cast<std::size_t>(product) ^ static_cast<std::size_t>(product >> 64);
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <class K>
+inline std::size_t openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::findIndex(
+    const K& key, std::size_t hashed) const {
+  if (slotCount == 0) {
+    return 0;
+  }
+  const std::size_t mask = slotCount - 1;
+  const Control h2 = static_cast<Control>(hashed & 0x7f);
+  std::size_t offset = (hashed >> 7) & mask;
+  for (std::size_t step = ControlGroup::WIDTH; ; step += ControlGroup::WIDTH) {
+    const ControlGroup group(control + offset);
+    for (uint32_t matches = group.match(h2); matches != 0; matches &= matches - 1) {
+      const std::size_t index = (offset + __builtin_ctz(matches)) & mask;
+      if (equal(Policy::key(*slot(index)), key)) {
+        return index;
+      }
+    }
+    if (group.matchEmpty() != 0) {
+      return slotCount;
+    }
+    offset = (offset + step) & mask;
+  }
+}
+
+template <class Policy, class Hash, class KeyEqual>
+std::size_t openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::findFree(
+    std::size_t hashed) const noexcept {
+  const std::size_t mask = slotCount - 1;
+  std::size_t offset = (hashed >> 7) & mask;
+  for (std::size_t step = ControlGroup::WIDTH; ; step += ControlGroup::WIDTH) {
+    const uint32_t free = ControlGroup(control + offset).matchFree();
+    if (free != 0) {
+      return (offset + __builtin_ctz(free)) & mask;
+    }
+    offset = (offset + step) & mask;
+  }
+}
+
+template <class Policy, class Hash, class KeyEqual>
+inline void openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::setControl(
+    std::size_t index, Control value) noexcept {
+  control[index] = value;
+  // the bytes past the end mirror the first group, so a group load
+  // starting near the end sees the slots it wraps around to
+  if (index < ControlGroup::WIDTH) {
+    control[slotCount + index] = value;
+  }
+}
+
+template <class Policy, class Hash, class KeyEqual>
+void openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::rehash(std::size_t capacity) {
+  std::unique_ptr<Storage> next(new Storage(capacity));
+  std::unique_ptr<Storage> previous(std::move(storage));
+  Control* previousControl = control;
+  value_type* previousSlots = slot(0);
+  const std::size_t previousCount = slotCount;
+
+  storage = std::move(next);
+  control = storage->control.data();
+  slots = storage->slots.data();
+  slotCount = capacity;
+  growthLeft = maxLoad(capacity) - elements;
+
+  for (std::size_t i = 0; i < previousCount; i++) {
+    if (previousControl[i] >= 0) {
+      const std::size_t index = findFree(hashOf(Policy::key(previousSlots[i])));
+      Policy::transfer(slot(index), previousSlots + i);
+      setControl(index, previousControl[i]);
+    }
+  }
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <class K, class Construct>
+std::pair<typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::iterator, bool>
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::findOrConstruct(const K& key,
+                                                                       Construct construct) {
+  const std::size_t hashed = hashOf(key);
+  std::size_t index = findIndex(key, hashed);
+  if (index != slotCount) {
+    return std::make_pair(iterator(this, index), false);
+  }
+
+  if (growthLeft == 0) {
+    // mostly tombstones: clean up at the same size, otherwise double
+    rehash(slotCount == 0 ? capacityFor(1) :
+           elements < maxLoad(slotCount) / 2 ? slotCount : slotCount * 2);
+  }
+  index = findFree(hashed);
+  construct(slot(index));
+  growthLeft -= control[index] == CONTROL_EMPTY;
+  setControl(index, static_cast<Control>(hashed & 0x7f));
+  elements++;
+  return std::make_pair(iterator(this, index), true);
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <class K>
+typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::iterator
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::find(const key_arg<K>& key) {
+  return iterator(this, findIndex(key, hashOf(key)));
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <class K>
+typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::const_iterator
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::find(const key_arg<K>& key) const {
+  return const_iterator(this, findIndex(key, hashOf(key)));
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <class K>
+bool openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::contains(const key_arg<K>& key) const {
+  return findIndex(key, hashOf(key)) != slotCount;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <class K>
+std::size_t openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::count(
+    const key_arg<K>& key) const {
+  return contains<K>(key) ? 1 : 0;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <class K>
+std::size_t openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::erase(const key_arg<K>& key) {
+  const std::size_t index = findIndex(key, hashOf(key));
+  if (index == slotCount) {
+    return 0;
+  }
+  erase(const_iterator(this, index));
+  return 1;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+void openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::erase(const_iterator position) {
+  const std::size_t index = position.index;
+  slot(index)->~value_type();
+
+  // the full slots before and after index, within a group's width. If
+  // they leave room for an empty byte in every group holding index, each
+  // probe through index stopped at that empty, so index can be empty too.
+  const uint32_t emptyBefore =
+      ControlGroup(control + ((index - ControlGroup::WIDTH) & (slotCount - 1))).matchEmpty();
+  const uint32_t emptyAfter = ControlGroup(control + index).matchEmpty();
+  const std::size_t fullBefore = emptyBefore == 0 ? ControlGroup::WIDTH :
+      __builtin_clz(emptyBefore) - (32 - ControlGroup::WIDTH);
+  const std::size_t fullAfter = emptyAfter == 0 ? ControlGroup::WIDTH : __builtin_ctz(emptyAfter);
+  if (fullBefore + fullAfter < ControlGroup::WIDTH) {
+    setControl(index, CONTROL_EMPTY);
+    growthLeft++;
+  } else {
+    setControl(index, CONTROL_DELETED);
+  }
+  elements--;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::iterator
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::begin() noexcept {
+  iterator first(this, 0);
+  first.skipFree();
+  return first;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::iterator
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::end() noexcept {
+  return iterator(this, slotCount);
+}
+
+template <class Policy, class Hash, class KeyEqual>
+typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::const_iterator
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::begin() const noexcept {
+  const_iterator first(this, 0);
+  first.skipFree();
+  return first;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::const_iterator
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::end() const noexcept {
+  return const_iterator(this, slotCount);
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Iterator<constant>::Iterator() noexcept:
+    table(nullptr), index(0) {
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Iterator<constant>::Iterator(
+    const FlatHashTable* table, std::size_t index) noexcept:
+    table(table), index(index) {
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+template <bool other, class>
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Iterator<constant>::Iterator(
+    const Iterator<other>& iterator) noexcept:
+    table(iterator.table), index(iterator.index) {
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+inline typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::template Iterator<constant>::reference
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Iterator<constant>::operator*() const noexcept {
+  return *table->slot(index);
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+inline typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::template Iterator<constant>::pointer
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Iterator<constant>::operator->() const noexcept {
+  return table->slot(index);
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+inline void
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Iterator<constant>::skipFree() noexcept {
+  while (index < table->slotCount && table->control[index] < 0) {
+    index++;
+  }
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+inline typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::template Iterator<constant>&
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Iterator<constant>::operator++() noexcept {
+  index++;
+  skipFree();
+  return *this;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+inline typename openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::template Iterator<constant>
+openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Iterator<constant>::operator++(int) noexcept {
+  Iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+inline bool openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Iterator<constant>::operator==(
+    const Iterator& other) const noexcept {
+  return index == other.index && table == other.table;
+}
+
+template <class Policy, class Hash, class KeyEqual>
+template <bool constant>
+inline bool openlib::detail::FlatHashTable<Policy, Hash, KeyEqual>::Iterator<constant>::operator!=(
+    const Iterator& other) const noexcept {
+  return !(*this == other);
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::FlatHashMap(std::size_t capacity, const Hash& hash,
+                                                              const KeyEqual& equal):
+    Table(capacity, hash, equal) {
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::FlatHashMap(std::initializer_list<value_type> list):
+    Table(list.size(), Hash(), KeyEqual()) {
+  for (const auto& value : list) {
+    insert(value);
+  }
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+std::pair<typename openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::iterator, bool>
+openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::insert(const value_type& value) {
+  return this->findOrConstruct(value.first, [&](value_type* slot) { new (slot) value_type(value); });
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+std::pair<typename openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::iterator, bool>
+openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::insert(value_type&& value) {
+  return this->findOrConstruct(value.first, [&](value_type* slot) {
+    new (slot) value_type(std::move(value));
+  });
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+template <class... Args>
+std::pair<typename openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::iterator, bool>
+openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::emplace(Args&&... args) {
+  return insert(value_type(std::forward<Args>(args)...));
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+template <class... Args>
+std::pair<typename openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::iterator, bool>
+openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::tryEmplace(const Key& key, Args&&... args) {
+  return this->findOrConstruct(key, [&](value_type* slot) {
+    new (slot) value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+  });
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+template <class... Args>
+std::pair<typename openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::iterator, bool>
+openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::tryEmplace(Key&& key, Args&&... args) {
+  return this->findOrConstruct(key, [&](value_type* slot) {
+    new (slot) value_type(std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+  });
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+Value& openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::operator[](const Key& key) {
+  return tryEmplace(key).first->second;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+Value& openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::operator[](Key&& key) {
+  return tryEmplace(std::move(key)).first->second;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+template <class K>
+Value& openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::at(
+    const typename Table::template key_arg<K>& key) {
+  iterator found = this->template find<K>(key);
+  if (found == this->end()) {
+    throw std::out_of_range("key is not in the map");
+  }
+  return found->second;
+}
+
+template <class Key, class Value, class Hash, class KeyEqual>
+template <class K>
+const Value& openlib::FlatHashMap<Key, Value, Hash, KeyEqual>::at(
+    const typename Table::template key_arg<K>& key) const {
+  const_iterator found = this->template find<K>(key);
+  if (found == this->end()) {
+    throw std::out_of_range("key is not in the map");
+  }
+  return found->second;
+}
+
+template <class Key, class Hash, class KeyEqual>
+openlib::FlatHashSet<Key, Hash, KeyEqual>::FlatHashSet(std::size_t capacity, const Hash& hash,
+                                                      const KeyEqual& equal):
+    Table(capacity, hash, equal) {
+}
+
+template <class Key, class Hash, class KeyEqual>
+openlib::FlatHashSet<Key, Hash, KeyEqual>::FlatHashSet(std::initializer_list<Key> list):
+    Table(list.size(), Hash(), KeyEqual()) {
+  for (const auto& key : list) {
+    insert(key);
+  }
+}
+
+template <class Key, class Hash, class KeyEqual>
+std::pair<typename openlib::FlatHashSet<Key, Hash, KeyEqual>::iterator, bool>
+openlib::FlatHashSet<Key, Hash, KeyEqual>::insert(const Key& key) {
+  return this->findOrConstruct(key, [&](Key* slot) { new (slot) Key(key); });
+}
+
+template <class Key, class Hash, class KeyEqual>
+std::pair<typename openlib::FlatHashSet<Key, Hash, KeyEqual>::iterator, bool>
+openlib::FlatHashSet<Key, Hash, KeyEqual>::insert(Key&& key) {
+  return this->findOrConstruct(key, [&](Key* slot) { new (slot) Key(std::move(key)); });
+}
+
+template <class Key, class Hash, class KeyEqual>
+template <class... Args>
+std::pair<typename openlib::FlatHashSet<Key, Hash, KeyEqual>::iterator, bool>
+openlib::FlatHashSet<Key, Hash, KeyEqual>::emplace(Args&&... args) {
+  return insert(Key(std::forward<Args>(args)...));
+}
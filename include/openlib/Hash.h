@@ -0,0 +1,83 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+
+#include <openlib/Kernels.h>
+
+namespace openlib {
+
+/**
+ * Content hash of an array, for hash map keys
+ *
+ * Pass ArrayHash and ArrayEqual as the Hash and KeyEqual of FlatHashMap,
+ * FlatHashSet or std::unordered_map to key by array contents. std::hash
+ * is not specialized for the arrays because std::equal_to would use
+ * operator==, which compares addresses. Both are transparent, so a map
+ * keyed by FlatArray can be searched with an ArrayView of the same
+ * elements.
+ */
+struct ArrayHash {
+  typedef void is_transparent;
+
+  /**
+   * @brief hash(array)
+   * @param array FlatArray, Array, ArrayView, Serializer::view(), or
+   *              anything with data() and size()
+   */
+  template <class ArrayType>
+  std::size_t operator()(const ArrayType& array) const;
+};
+
+/**
+ * Content equality of two arrays, for hash map keys
+ */
+struct ArrayEqual {
+  typedef void is_transparent;
+
+  /**
+   * @brief equal(lhs, rhs)
+   */
+  template <class LhsArray, class RhsArray>
+  bool operator()(const LhsArray& lhs, const RhsArray& rhs) const;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class ArrayType>
+inline std::size_t openlib::ArrayHash::operator()(const ArrayType& array) const {
+  return static_cast<std::size_t>(hash(array));
+}
+
+template <class LhsArray, class RhsArray>
+inline bool openlib::ArrayEqual::operator()(const LhsArray& lhs, const RhsArray& rhs) const {
+  return equal(lhs, rhs);
+}
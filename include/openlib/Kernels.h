@@ -0,0 +1,527 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace openlib {
+
+/**
+ * Bulk kernels over contiguous memory
+ *
+ * Each kernel has SSE2, AVX2 and AVX-512 implementations plus a scalar
+ * reference. The widest implementation the CPU supports is picked at
+ * runtime. Array-level wrappers are in the openlib namespace below.
+ */
+namespace kernels {
+
+/**
+ * Instruction set used by the kernels
+ */
+enum class Isa {
+  Scalar,
+  SSE2,
+  AVX2,
+  AVX512
+};
+
+/**
+ * @brief instruction set currently used by the kernels
+ * @return the active instruction set
+ */
+Isa activeIsa();
+
+/**
+ * @brief instruction sets supported by this CPU, narrowest first
+ * @return supported instruction sets, always includes Isa::Scalar
+ */
+std::vector<Isa> supportedIsas();
+
+/**
+ * @brief force an instruction set, for testing and benchmarking
+ * Not thread safe with respect to running kernels.
+ * @param isa instruction set to use
+ * @throws std::invalid_argument if the CPU does not support isa
+ */
+void setIsa(Isa isa);
+
+/**
+ * @brief name of an instruction set
+ */
+const char* isaName(Isa isa);
+
+/**
+ * @brief fill count elements of the given width with a bit pattern
+ */
+void fill8(uint8_t* dst, uint8_t value, std::size_t count);
+void fill16(uint16_t* dst, uint16_t value, std::size_t count);
+void fill32(uint32_t* dst, uint32_t value, std::size_t count);
+void fill64(uint64_t* dst, uint64_t value, std::size_t count);
+
+/**
+ * @brief copy bytes between non-overlapping buffers
+ * Uses the C library memcpy, which already dispatches on the CPU.
+ */
+void copy(void* dst, const void* src, std::size_t bytes);
+
+/**
+ * @brief bitwise equality of two buffers
+ * @return true if the buffers hold the same bytes
+ */
+bool equal(const void* lhs, const void* rhs, std::size_t bytes);
+
+/**
+ * @brief index of the first element equal to value
+ * @return the index, or count if not found
+ */
+std::size_t find8(const uint8_t* data, std::size_t count, uint8_t value);
+std::size_t find16(const uint16_t* data, std::size_t count, uint16_t value);
+std::size_t find32(const uint32_t* data, std::size_t count, uint32_t value);
+std::size_t find64(const uint64_t* data, std::size_t count, uint64_t value);
+
+/**
+ * @brief number of elements equal to value
+ */
+std::size_t count8(const uint8_t* data, std::size_t count, uint8_t value);
+std::size_t count16(const uint16_t* data, std::size_t count, uint16_t value);
+std::size_t count32(const uint32_t* data, std::size_t count, uint32_t value);
+std::size_t count64(const uint64_t* data, std::size_t count, uint64_t value);
+
+/**
+ * @brief dst[i] = a[i] op b[i] over count 64-bit words
+ * andNot64 computes a[i] & ~b[i]. dst may be the same buffer as a or b.
+ */
+void and64(uint64_t* dst, const uint64_t* a, const uint64_t* b, std::size_t count);
+void or64(uint64_t* dst, const uint64_t* a, const uint64_t* b, std::size_t count);
+void xor64(uint64_t* dst, const uint64_t* a, const uint64_t* b, std::size_t count);
+void andNot64(uint64_t* dst, const uint64_t* a, const uint64_t* b, std::size_t count);
+
+/**
+ * @brief number of set bits in count 64-bit words
+ */
+std::size_t popcount64(const uint64_t* data, std::size_t count);
+
+/**
+ * @brief reverse the bytes of each of count 16, 32 or 64-bit words
+ * Neither buffer needs to be aligned. dst may be src, but must not
+ * otherwise overlap it.
+ */
+void byteSwap16(void* dst, const void* src, std::size_t count);
+void byteSwap32(void* dst, const void* src, std::size_t count);
+void byteSwap64(void* dst, const void* src, std::size_t count);
+
+/**
+ * @brief 64-bit non-cryptographic hash of a buffer
+ * Every instruction set gives the same result. Words are read in native
+ * byte order, so hashes differ between little and big endian machines.
+ * @param seed varies the hash function
+ */
+uint64_t hash64(const void* data, std::size_t bytes, uint64_t seed = 0);
+
+/**
+ * @brief smallest element, count must be non-zero
+ * NaN handling is unspecified.
+ */
+int32_t min(const int32_t* data, std::size_t count);
+uint32_t min(const uint32_t* data, std::size_t count);
+int64_t min(const int64_t* data, std::size_t count);
+uint64_t min(const uint64_t* data, std::size_t count);
+float min(const float* data, std::size_t count);
+double min(const double* data, std::size_t count);
+
+/**
+ * @brief largest element, count must be non-zero
+ * NaN handling is unspecified.
+ */
+int32_t max(const int32_t* data, std::size_t count);
+uint32_t max(const uint32_t* data, std::size_t count);
+int64_t max(const int64_t* data, std::size_t count);
+uint64_t max(const uint64_t* data, std::size_t count);
+float max(const float* data, std::size_t count);
+double max(const double* data, std::size_t count);
+
+/**
+ * @brief sum of all elements
+ * Integer sums wrap on overflow. Floating point sums are accumulated in
+ * several lanes, so rounding may differ from a sequential loop.
+ */
+int32_t sum(const int32_t* data, std::size_t count);
+uint32_t sum(const uint32_t* data, std::size_t count);
+int64_t sum(const int64_t* data, std::size_t count);
+uint64_t sum(const uint64_t* data, std::size_t count);
+float sum(const float* data, std::size_t count);
+double sum(const double* data, std::size_t count);
+
+/**
+ * @brief generic fallbacks for element types without a SIMD kernel
+ */
+template <class type>
+type min(const type* data, std::size_t count);
+
+template <class type>
+type max(const type* data, std::size_t count);
+
+template <class type>
+type sum(const type* data, std::size_t count);
+
+/**
+ * @brief true when elements compare equal exactly when their bytes do
+ */
+template <class type>
+struct IsBitwiseComparable {
+  static constexpr bool value = std::is_integral<type>::value
+                             || std::is_enum<type>::value
+                             || std::is_pointer<type>::value;
+};
+
+/**
+ * @brief fill with any trivially copyable type, by its bit pattern
+ */
+template <class type>
+void fill(type* dst, const type& value, std::size_t count);
+
+} // namespace kernels
+
+/**
+ * @brief fill each element of an array with the same value
+ * @param array FlatArray, Array, or anything with data() and size()
+ * @param value a value to fill the array with
+ */
+template <class ArrayType, class type>
+void fill(ArrayType& array, const type& value);
+
+/**
+ * @brief copy the elements of one array into another
+ * @param dst destination, must have at least src.size() elements
+ * @param src source
+ * @throws std::length_error if dst is smaller than src
+ */
+template <class DstArray, class SrcArray>
+void copy(DstArray& dst, const SrcArray& src);
+
+/**
+ * @brief content equality, unlike operator== which compares addresses
+ * @return true if both arrays have the same size and elements
+ */
+template <class LhsArray, class RhsArray>
+bool equal(const LhsArray& lhs, const RhsArray& rhs);
+
+/**
+ * @brief content hash, consistent with equal()
+ * Bitwise comparable elements are hashed as bytes with kernels::hash64,
+ * other elements by combining their std::hash values.
+ * @param seed varies the hash function
+ */
+template <class ArrayType>
+uint64_t hash(const ArrayType& array, uint64_t seed = 0);
+
+/**
+ * @brief index of the first element equal to value
+ * @return the index, or array.size() if not found
+ */
+template <class ArrayType, class type>
+std::size_t find(const ArrayType& array, const type& value);
+
+/**
+ * @brief number of elements equal to value
+ */
+template <class ArrayType, class type>
+std::size_t count(const ArrayType& array, const type& value);
+
+/**
+ * @brief smallest element
+ * @throws std::length_error if the array is empty
+ */
+template <class ArrayType>
+auto min(const ArrayType& array) -> typename std::remove_cv<
+    typename std::remove_reference<decltype(*array.data())>::type>::type;
+
+/**
+ * @brief largest element
+ * @throws std::length_error if the array is empty
+ */
+template <class ArrayType>
+auto max(const ArrayType& array) -> typename std::remove_cv<
+    typename std::remove_reference<decltype(*array.data())>::type>::type;
+
+/**
+ * @brief sum of all elements, see kernels::sum
+ */
+template <class ArrayType>
+auto sum(const ArrayType& array) -> typename std::remove_cv<
+    typename std::remove_reference<decltype(*array.data())>::type>::type;
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type>
+constexpr bool openlib::kernels::IsBitwiseComparable<type>::value;
+
+template <class type>
+type openlib::kernels::min(const type* data, std::size_t count) {
+  return *std::min_element(data, data + count);
+}
+
+template <class type>
+type openlib::kernels::max(const type* data, std::size_t count) {
+  return *std::max_element(data, data + count);
+}
+
+template <class type>
+type openlib::kernels::sum(const type* data, std::size_t count) {
+  type total = type();
+  for (std::size_t i = 0; i < count; i++) {
+    total += data[i];
+  }
+  return total;
+}
+
+template <class type>
+void openlib::kernels::fill(type* dst, const type& value, std::size_t count) {
+  static_assert(std::is_trivially_copyable<type>::value, "fill requires a trivially copyable type");
+
+  switch (sizeof(type)) {
+    case 1: {
+      uint8_t pattern;
+      std::memcpy(&pattern, &value, 1);
+      fill8(reinterpret_cast<uint8_t*>(dst), pattern, count);
+      break;
+    }
+    case 2: {
+      uint16_t pattern;
+      std::memcpy(&pattern, &value, 2);
+      fill16(reinterpret_cast<uint16_t*>(dst), pattern, count);
+      break;
+    }
+    case 4: {
+      uint32_t pattern;
+      std::memcpy(&pattern, &value, 4);
+      fill32(reinterpret_cast<uint32_t*>(dst), pattern, count);
+      break;
+    }
+    case 8: {
+      uint64_t pattern;
+      std::memcpy(&pattern, &value, 8);
+      fill64(reinterpret_cast<uint64_t*>(dst), pattern, count);
+      break;
+    }
+    default:
+      std::fill(dst, dst + count, value);
+      break;
+  }
+}
+
+namespace openlib {
+namespace kernels {
+namespace detail {
+
+// trivially copyable types go through the bit pattern kernels
+template <class type>
+void fillArray(type* dst, const type& value, std::size_t count, std::true_type) {
+  kernels::fill(dst, value, count);
+}
+
+template <class type>
+void fillArray(type* dst, const type& value, std::size_t count, std::false_type) {
+  std::fill(dst, dst + count, value);
+}
+
+template <class type>
+void copyArray(type* dst, const type* src, std::size_t count, std::true_type) {
+  kernels::copy(dst, src, count * sizeof(type));
+}
+
+template <class type>
+void copyArray(type* dst, const type* src, std::size_t count, std::false_type) {
+  std::copy(src, src + count, dst);
+}
+
+template <class type>
+bool equalArray(const type* lhs, const type* rhs, std::size_t count, std::true_type) {
+  return kernels::equal(lhs, rhs, count * sizeof(type));
+}
+
+template <class type>
+bool equalArray(const type* lhs, const type* rhs, std::size_t count, std::false_type) {
+  return std::equal(lhs, lhs + count, rhs);
+}
+
+// unsigned integer of a given width, void when there is none
+template <std::size_t bytes> struct Bits { using type = void; };
+template <> struct Bits<1> { using type = uint8_t; };
+template <> struct Bits<2> { using type = uint16_t; };
+template <> struct Bits<4> { using type = uint32_t; };
+template <> struct Bits<8> { using type = uint64_t; };
+
+inline std::size_t findBits(const uint8_t* d, std::size_t n, uint8_t v) { return find8(d, n, v); }
+inline std::size_t findBits(const uint16_t* d, std::size_t n, uint16_t v) { return find16(d, n, v); }
+inline std::size_t findBits(const uint32_t* d, std::size_t n, uint32_t v) { return find32(d, n, v); }
+inline std::size_t findBits(const uint64_t* d, std::size_t n, uint64_t v) { return find64(d, n, v); }
+inline std::size_t countBits(const uint8_t* d, std::size_t n, uint8_t v) { return count8(d, n, v); }
+inline std::size_t countBits(const uint16_t* d, std::size_t n, uint16_t v) { return count16(d, n, v); }
+inline std::size_t countBits(const uint32_t* d, std::size_t n, uint32_t v) { return count32(d, n, v); }
+inline std::size_t countBits(const uint64_t* d, std::size_t n, uint64_t v) { return count64(d, n, v); }
+
+template <class type>
+std::size_t findArray(const type* data, std::size_t count, const type& value, std::true_type) {
+  using bits = typename Bits<sizeof(type)>::type;
+  bits pattern;
+  std::memcpy(&pattern, &value, sizeof(type));
+  return findBits(reinterpret_cast<const bits*>(data), count, pattern);
+}
+
+template <class type>
+std::size_t findArray(const type* data, std::size_t count, const type& value, std::false_type) {
+  return std::find(data, data + count, value) - data;
+}
+
+template <class type>
+std::size_t countArray(const type* data, std::size_t count, const type& value, std::true_type) {
+  using bits = typename Bits<sizeof(type)>::type;
+  bits pattern;
+  std::memcpy(&pattern, &value, sizeof(type));
+  return countBits(reinterpret_cast<const bits*>(data), count, pattern);
+}
+
+template <class type>
+std::size_t countArray(const type* data, std::size_t count, const type& value, std::false_type) {
+  return std::count(data, data + count, value);
+}
+
+template <class type>
+uint64_t hashArray(const type* data, std::size_t count, uint64_t seed, std::true_type) {
+  return kernels::hash64(data, count * sizeof(type), seed);
+}
+
+template <class type>
+uint64_t hashArray(const type* data, std::size_t count, uint64_t seed, std::false_type) {
+  std::hash<type> hasher;
+  uint64_t state = count;
+  for (std::size_t i = 0; i < count; i++) {
+    state = (state ^ hasher(data[i])) * 0x9e3779b97f4a7c15ull;
+    state ^= state >> 29;
+  }
+  return kernels::hash64(&state, sizeof(state), seed);
+}
+
+template <class type>
+using HasBitsKernel = std::integral_constant<bool,
+    IsBitwiseComparable<type>::value && !std::is_void<typename Bits<sizeof(type)>::type>::value>;
+
+} // namespace detail
+} // namespace kernels
+} // namespace openlib
+
+template <class ArrayType, class type>
+void openlib::fill(ArrayType& array, const type& value) {
+  using element = typename std::remove_reference<decltype(*array.data())>::type;
+  const element converted = value;
+  kernels::detail::fillArray(array.data(), converted, array.size(),
+                             std::is_trivially_copyable<element>());
+}
+
+template <class DstArray, class SrcArray>
+void openlib::copy(DstArray& dst, const SrcArray& src) {
+  if (dst.size() < src.size()) {
+    throw std::length_error("destination array is smaller than source array");
+  }
+
+  using element = typename std::remove_reference<decltype(*dst.data())>::type;
+  kernels::detail::copyArray<element>(dst.data(), src.data(), src.size(),
+                                      std::is_trivially_copyable<element>());
+}
+
+template <class LhsArray, class RhsArray>
+bool openlib::equal(const LhsArray& lhs, const RhsArray& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+
+  using element = typename std::remove_cv<
+      typename std::remove_reference<decltype(*lhs.data())>::type>::type;
+  return kernels::detail::equalArray<element>(lhs.data(), rhs.data(), lhs.size(),
+      std::integral_constant<bool, kernels::IsBitwiseComparable<element>::value>());
+}
+
+template <class ArrayType>
+uint64_t openlib::hash(const ArrayType& array, uint64_t seed) {
+  using element = typename std::remove_cv<
+      typename std::remove_reference<decltype(*array.data())>::type>::type;
+  return kernels::detail::hashArray<element>(array.data(), array.size(), seed,
+      std::integral_constant<bool, kernels::IsBitwiseComparable<element>::value>());
+}
+
+template <class ArrayType, class type>
+std::size_t openlib::find(const ArrayType& array, const type& value) {
+  using element = typename std::remove_cv<
+      typename std::remove_reference<decltype(*array.data())>::type>::type;
+  const element converted = value;
+  return kernels::detail::findArray<element>(array.data(), array.size(), converted,
+                                             kernels::detail::HasBitsKernel<element>());
+}
+
+template <class ArrayType, class type>
+std::size_t openlib::count(const ArrayType& array, const type& value) {
+  using element = typename std::remove_cv<
+      typename std::remove_reference<decltype(*array.data())>::type>::type;
+  const element converted = value;
+  return kernels::detail::countArray<element>(array.data(), array.size(), converted,
+                                              kernels::detail::HasBitsKernel<element>());
+}
+
+template <class ArrayType>
+auto openlib::min(const ArrayType& array) -> typename std::remove_cv<
+    typename std::remove_reference<decltype(*array.data())>::type>::type {
+  if (array.size() == 0) {
+    throw std::length_error("min of an empty array");
+  }
+  return kernels::min(array.data(), array.size());
+}
+
+template <class ArrayType>
+auto openlib::max(const ArrayType& array) -> typename std::remove_cv<
+    typename std::remove_reference<decltype(*array.data())>::type>::type {
+  if (array.size() == 0) {
+    throw std::length_error("max of an empty array");
+  }
+  return kernels::max(array.data(), array.size());
+}
+
+template <class ArrayType>
+auto openlib::sum(const ArrayType& array) -> typename std::remove_cv<
+    typename std::remove_reference<decltype(*array.data())>::type>::type {
+  return kernels::sum(array.data(), array.size());
+}
@@ -0,0 +1,331 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <openlib/Kernels.h>
+#include <openlib/MappedFile.h>
+
+namespace openlib {
+
+/**
+ * Array backed by a memory-mapped file
+ *
+ * Same accessor interface as FlatArray, but elements live in the page
+ * cache rather than in memory allocated by the process. Opening a large
+ * table is O(1), pages are read on first touch, and every process mapping
+ * the same file shares them.
+ *
+ * The file holds the raw element bytes, so type must be trivially copyable
+ * and the file size a multiple of sizeof(type). A ReadOnly mapping is a
+ * MappedArray<const type>, so writes to it do not compile.
+ */
+template <class type>
+class MappedArray final {
+public:
+  static_assert(std::is_trivially_copyable<type>::value,
+                "MappedArray requires a trivially copyable type");
+
+  using Mode = MappedFile::Mode;
+  using Advice = MappedFile::Advice;
+
+  /**
+   * @brief map an existing file
+   * @param path file to map
+   * @param mode how the mapping may be written, ReadOnly by default for a
+   * const type and Private otherwise
+   * @throws std::system_error if the file cannot be mapped
+   * @throws std::length_error if the file size is not a multiple of sizeof(type)
+   * @throws std::invalid_argument if mode is ReadOnly and type is not const
+   */
+  explicit MappedArray(const std::string& path,
+                       Mode mode = std::is_const<type>::value ? Mode::ReadOnly : Mode::Private);
+
+  /**
+   * @brief create or truncate a file holding size elements and map it shared
+   * Not available for a const type.
+   * @param path file to create
+   * @param size number of elements
+   * @throws std::system_error if the file cannot be created
+   */
+  MappedArray(const std::string& path, const std::size_t& size);
+
+  /**
+   * @brief move constructor
+   * The old MappedArray object will no longer be valid.
+   */
+  MappedArray(MappedArray&& other) noexcept = default;
+
+  /**
+   * @brief Number of elements in the array
+   * @return the number of elements in the array
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief Access element at a given position
+   * @return a reference to the element at the given position
+   */
+  type& at(const std::size_t& position) noexcept;
+
+  /**
+   * @brief Access const element at a given position
+   * @return a const reference to the element at the given position
+   */
+  const type& at(const std::size_t& position) const noexcept;
+
+  /**
+   * @brief The first element
+   * @return a reference to the first element
+   */
+  type& front() noexcept;
+  const type& front() const noexcept;
+
+  /**
+   * @brief The last element
+   * @return a reference to the last element
+   */
+  type& back() noexcept;
+  const type& back() const noexcept;
+
+  /**
+   * @brief Returns a pointer to the underlying array
+   * @returns a pointer to the underlying array
+   */
+  type* data() noexcept;
+  const type* data() const noexcept;
+
+  /**
+   * @brief Get a pointer to the first element
+   * @return a pointer to the first element
+   */
+  type* begin() noexcept;
+  const type* begin() const noexcept;
+
+  /**
+   * @brief Get a pointer to one past the last element
+   * @return a pointer to one past the last element
+   */
+  type* end() noexcept;
+  const type* end() const noexcept;
+
+  /**
+   * @brief fill each element of the array with the same value
+   * Not available for a const type.
+   * @param value a value to fill the array with
+   */
+  void fill(const type& value);
+
+  /**
+   * @brief advise the kernel of the access pattern for the whole array
+   */
+  void advise(Advice advice);
+
+  /**
+   * @brief advise the kernel of the access pattern for a range of elements
+   * @param first first element
+   * @param count number of elements
+   */
+  void advise(Advice advice, std::size_t first, std::size_t count);
+
+  /**
+   * @brief flush writes of a Shared array to the file
+   */
+  void sync();
+
+  /**
+   * @brief the underlying file mapping
+   */
+  const MappedFile& file() const noexcept;
+
+  /**
+   * @brief auto cast to pointer to base type
+   */
+  operator type*() noexcept;
+  operator const type*() const noexcept;
+
+  /**
+   * @brief operator[]
+   */
+  type& operator[](std::size_t position) noexcept;
+
+  /**
+   * @brief operator[] const
+   */
+  const type& operator[](std::size_t position) const noexcept;
+
+private:
+  MappedFile mapped;
+  type* elements;
+  std::size_t elementCount;
+
+  // no copy or assignment
+  MappedArray(const MappedArray& other) = delete;
+  MappedArray& operator=(const MappedArray& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type>
+openlib::MappedArray<type>::MappedArray(const std::string& path, Mode mode):
+    mapped(path, mode),
+    elements(reinterpret_cast<type*>(mapped.data())),
+    elementCount(mapped.size() / sizeof(type)) {
+
+  if (mapped.size() % sizeof(type) != 0) {
+    throw std::length_error("file size is not a multiple of the element size");
+  }
+  if (!std::is_const<type>::value && mode == Mode::ReadOnly) {
+    throw std::invalid_argument("a ReadOnly mapping needs a MappedArray of const elements");
+  }
+}
+
+template <class type>
+openlib::MappedArray<type>::MappedArray(const std::string& path, const std::size_t& size):
+    mapped(path, size * sizeof(type)),
+    elements(reinterpret_cast<type*>(mapped.data())),
+    elementCount(size) {
+
+  static_assert(!std::is_const<type>::value, "cannot create a file for const elements");
+}
+
+template <class type>
+inline std::size_t openlib::MappedArray<type>::size() const noexcept {
+  return elementCount;
+}
+
+template <class type>
+inline type& openlib::MappedArray<type>::at(const std::size_t& position) noexcept {
+  return elements[position];
+}
+
+template <class type>
+inline const type& openlib::MappedArray<type>::at(const std::size_t& position) const noexcept {
+  return elements[position];
+}
+
+template <class type>
+inline type& openlib::MappedArray<type>::front() noexcept {
+  return elements[0];
+}
+
+template <class type>
+inline const type& openlib::MappedArray<type>::front() const noexcept {
+  return elements[0];
+}
+
+template <class type>
+inline type& openlib::MappedArray<type>::back() noexcept {
+  return elements[elementCount - 1];
+}
+
+template <class type>
+inline const type& openlib::MappedArray<type>::back() const noexcept {
+  return elements[elementCount - 1];
+}
+
+template <class type>
+inline type* openlib::MappedArray<type>::data() noexcept {
+  return elements;
+}
+
+template <class type>
+inline const type* openlib::MappedArray<type>::data() const noexcept {
+  return elements;
+}
+
+template <class type>
+inline type* openlib::MappedArray<type>::begin() noexcept {
+  return elements;
+}
+
+template <class type>
+inline const type* openlib::MappedArray<type>::begin() const noexcept {
+  return elements;
+}
+
+template <class type>
+inline type* openlib::MappedArray<type>::end() noexcept {
+  return elements + elementCount;
+}
+
+template <class type>
+inline const type* openlib::MappedArray<type>::end() const noexcept {
+  return elements + elementCount;
+}
+
+template <class type>
+void openlib::MappedArray<type>::fill(const type& value) {
+  static_assert(!std::is_const<type>::value, "cannot fill const elements");
+  kernels::fill(elements, value, elementCount);
+}
+
+template <class type>
+void openlib::MappedArray<type>::advise(Advice advice) {
+  mapped.advise(advice);
+}
+
+template <class type>
+void openlib::MappedArray<type>::advise(Advice advice, std::size_t first, std::size_t count) {
+  mapped.advise(advice, first * sizeof(type), count * sizeof(type));
+}
+
+template <class type>
+void openlib::MappedArray<type>::sync() {
+  mapped.sync();
+}
+
+template <class type>
+inline const openlib::MappedFile& openlib::MappedArray<type>::file() const noexcept {
+  return mapped;
+}
+
+template <class type>
+inline openlib::MappedArray<type>::operator type*() noexcept {
+  return data();
+}
+
+template <class type>
+inline openlib::MappedArray<type>::operator const type*() const noexcept {
+  return data();
+}
+
+template <class type>
+inline type& openlib::MappedArray<type>::operator[](std::size_t position) noexcept {
+  return at(position);
+}
+
+template <class type>
+inline const type& openlib::MappedArray<type>::operator[](std::size_t position) const noexcept {
+  return at(position);
+}
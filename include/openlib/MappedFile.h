@@ -0,0 +1,139 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace openlib {
+
+/**
+ * A file mapped into memory with mmap
+ *
+ * Pages are loaded lazily on first access and shared with every other
+ * process mapping the same file, so large read-only datasets cost no
+ * startup copy and no duplicate memory.
+ */
+class MappedFile final {
+public:
+
+  /**
+   * How the mapping may be written
+   */
+  enum class Mode {
+    ReadOnly,  // writes fault
+    Private,   // writes are copy-on-write and never reach the file
+    Shared     // writes reach the file and other processes mapping it
+  };
+
+  /**
+   * Expected access pattern, passed to madvise
+   */
+  enum class Advice {
+    Normal,
+    Sequential,  // aggressive read-ahead, pages dropped soon after use
+    Random,      // no read-ahead
+    WillNeed,    // start reading pages in now
+    DontNeed     // pages may be dropped, Private writes are lost
+  };
+
+  /**
+   * @brief map an existing file
+   * @param path file to map
+   * @param mode how the mapping may be written
+   * @throws std::system_error if the file cannot be opened or mapped
+   */
+  MappedFile(const std::string& path, Mode mode);
+
+  /**
+   * @brief create or truncate a file of a given size and map it shared
+   * @param path file to create
+   * @param size size of the file, in bytes
+   * @throws std::system_error if the file cannot be created or mapped
+   */
+  MappedFile(const std::string& path, const std::size_t& size);
+
+  /**
+   * @brief move constructor
+   * The old MappedFile object will no longer be valid.
+   */
+  MappedFile(MappedFile&& other) noexcept;
+
+  /**
+   * @brief destructor, unmaps the file
+   */
+  ~MappedFile();
+
+  /**
+   * @brief start of the mapping
+   * @return pointer to the first byte, nullptr for an empty file
+   */
+  uint8_t* data() const;
+
+  /**
+   * @brief size of the mapping, in bytes
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief how the mapping may be written
+   */
+  Mode mode() const;
+
+  /**
+   * @brief advise the kernel of the access pattern for the whole file
+   * @throws std::system_error if madvise fails
+   */
+  void advise(Advice advice);
+
+  /**
+   * @brief advise the kernel of the access pattern for a byte range
+   * @param offset first byte, rounded down to a page boundary
+   * @param length number of bytes
+   * @throws std::system_error if madvise fails
+   */
+  void advise(Advice advice, std::size_t offset, std::size_t length);
+
+  /**
+   * @brief flush writes of a Shared mapping to the file
+   * @throws std::system_error if msync fails
+   */
+  void sync();
+
+private:
+  uint8_t* mapping;
+  std::size_t mappingSize;
+  Mode mappingMode;
+
+  void map(int fd, const std::string& path);
+
+  // no copy or assignment
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile& operator=(const MappedFile& other) = delete;
+};
+
+} // namespace openlib
@@ -0,0 +1,183 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace openlib {
+
+/**
+ * Source of raw memory
+ *
+ * Type-erased interface for the memory sources shipped with OpenLib (Arena,
+ * Pool, ...). Lets non-template code such as Serializer take storage from
+ * any of them. Template code should prefer the concrete allocator types,
+ * which avoid the virtual call.
+ */
+class MemoryResource {
+public:
+
+  /**
+   * @brief destructor
+   */
+  virtual ~MemoryResource();
+
+  /**
+   * @brief allocate memory
+   * @param bytes number of bytes
+   * @param alignment required alignment, a power of two
+   * @return pointer to the memory
+   * @throws std::bad_alloc if the memory cannot be allocated
+   */
+  virtual void* allocate(std::size_t bytes, std::size_t alignment) = 0;
+
+  /**
+   * @brief return memory
+   * @param p pointer returned by allocate
+   * @param bytes bytes passed to allocate
+   * @param alignment alignment passed to allocate
+   */
+  virtual void deallocate(void* p, std::size_t bytes, std::size_t alignment) = 0;
+};
+
+/**
+ * @brief the global new/delete backed MemoryResource
+ * @return the default resource
+ */
+MemoryResource& defaultResource();
+
+/**
+ * Standard allocator that takes memory from a MemoryResource
+ */
+template <class type>
+class ResourceAllocator {
+public:
+  using value_type = type;
+
+  /**
+   * @brief constructor, uses defaultResource()
+   */
+  ResourceAllocator() noexcept;
+
+  /**
+   * @brief constructor
+   * @param resource resource to allocate from, must outlive the allocator
+   */
+  ResourceAllocator(MemoryResource& resource) noexcept;
+
+  /**
+   * @brief converting constructor
+   */
+  template <class other>
+  ResourceAllocator(const ResourceAllocator<other>& allocator) noexcept;
+
+  /**
+   * @brief allocate storage for n elements
+   * @param n number of elements
+   * @return pointer to the storage
+   */
+  type* allocate(std::size_t n);
+
+  /**
+   * @brief release storage
+   * @param p pointer returned by allocate
+   * @param n number of elements passed to allocate
+   */
+  void deallocate(type* p, std::size_t n) noexcept;
+
+  /**
+   * @brief the underlying resource
+   * @return the resource
+   */
+  MemoryResource& resource() const noexcept;
+
+private:
+  MemoryResource* memoryResource;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type>
+openlib::ResourceAllocator<type>::ResourceAllocator() noexcept:
+    memoryResource(&defaultResource()) {
+
+}
+
+template <class type>
+openlib::ResourceAllocator<type>::ResourceAllocator(MemoryResource& resource) noexcept:
+    memoryResource(&resource) {
+
+}
+
+template <class type>
+template <class other>
+openlib::ResourceAllocator<type>::ResourceAllocator(const ResourceAllocator<other>& allocator) noexcept:
+    memoryResource(&allocator.resource()) {
+
+}
+
+template <class type>
+type* openlib::ResourceAllocator<type>::allocate(std::size_t n) {
+  if (n > std::numeric_limits<std::size_t>::max() / sizeof(type)) {
+    throw std::bad_alloc();
+  }
+  return static_cast<type*>(memoryResource->allocate(n * sizeof(type), alignof(type)));
+}
+
+template <class type>
+void openlib::ResourceAllocator<type>::deallocate(type* p, std::size_t n) noexcept {
+  memoryResource->deallocate(p, n * sizeof(type), alignof(type));
+}
+
+template <class type>
+openlib::MemoryResource& openlib::ResourceAllocator<type>::resource() const noexcept {
+  return *memoryResource;
+}
+
+/**
+ * @brief equality
+ * Allocators are equal when they share a resource
+ */
+template <class type, class other>
+inline bool operator==(const openlib::ResourceAllocator<type>& lhs,
+                       const openlib::ResourceAllocator<other>& rhs) {
+  return &lhs.resource() == &rhs.resource();
+}
+
+/**
+ * @brief inequality
+ */
+template <class type, class other>
+inline bool operator!=(const openlib::ResourceAllocator<type>& lhs,
+                       const openlib::ResourceAllocator<other>& rhs) {
+  return &lhs.resource() != &rhs.resource();
+}
@@ -0,0 +1,356 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+#include <openlib/Sort.h>
+#include <openlib/ThreadPool.h>
+
+namespace openlib {
+
+/**
+ * Options for the parallel algorithms
+ */
+struct ParallelOptions {
+  /**
+   * @brief pool to run on, nullptr for ThreadPool::shared()
+   */
+  ThreadPool* pool = nullptr;
+
+  /**
+   * @brief elements per task, 0 for about DEFAULT_GRAIN_BYTES of elements
+   */
+  std::size_t grain = 0;
+
+  static const std::size_t DEFAULT_GRAIN_BYTES = 256 * 1024;
+};
+
+/**
+ * @brief call function(element) for every element
+ * @param array FlatArray, Array, or anything with data() and size()
+ */
+template <class ArrayType, class Function>
+void parallelForEach(ArrayType& array, Function function,
+                     const ParallelOptions& options = ParallelOptions());
+
+/**
+ * @brief dst[i] = function(src[i]) for every element
+ * @throws std::length_error if dst is smaller than src
+ */
+template <class SrcArray, class DstArray, class Function>
+void parallelTransform(const SrcArray& src, DstArray& dst, Function function,
+                       const ParallelOptions& options = ParallelOptions());
+
+/**
+ * @brief combine every element with an associative operation
+ * Elements are combined in chunks and the chunk results in order, so op
+ * must be associative but need not be commutative.
+ * @param init initial value, combined once
+ * @param op associative binary operation
+ */
+template <class ArrayType, class type, class Operation>
+type parallelReduce(const ArrayType& array, type init, Operation op,
+                    const ParallelOptions& options = ParallelOptions());
+
+/**
+ * @brief sum of all elements
+ */
+template <class ArrayType, class type>
+type parallelReduce(const ArrayType& array, type init,
+                    const ParallelOptions& options = ParallelOptions());
+
+/**
+ * @brief fill each element of an array with the same value
+ */
+template <class ArrayType, class type>
+void parallelFill(ArrayType& array, const type& value,
+                  const ParallelOptions& options = ParallelOptions());
+
+/**
+ * @brief sort an array
+ * Chunks are sorted in parallel with std::sort, then merged pairwise in
+ * parallel rounds through a scratch buffer of the same size. Not stable.
+ */
+template <class ArrayType, class Compare>
+void parallelSort(ArrayType& array, Compare compare,
+                  const ParallelOptions& options = ParallelOptions());
+
+/**
+ * @brief sort an array in ascending order
+ * Integer and floating point elements use a parallel LSD radix sort and
+ * the order of sort(), anything else the comparison sort above.
+ */
+template <class ArrayType>
+void parallelSort(ArrayType& array, const ParallelOptions& options = ParallelOptions());
+
+/**
+ * @brief sort keys in ascending order and move values along with them
+ * Parallel version of sortByKey(), stable.
+ * @throws std::length_error if keys and values differ in size
+ */
+template <class KeyArray, class ValueArray>
+void parallelSortByKey(KeyArray& keys, ValueArray& values,
+                       const ParallelOptions& options = ParallelOptions());
+
+namespace detail {
+
+/**
+ * @brief split [0, size) into chunks and run function(begin, end) on each
+ */
+template <class type, class Function>
+void forEachRange(std::size_t size, const ParallelOptions& options, Function function);
+
+/**
+ * @brief radix sort split into one chunk per thread, each at least a grain
+ */
+template <class Key, class Value>
+void parallelRadixSort(Key* keys, Value* values, std::size_t size, const ParallelOptions& options);
+
+template <class ArrayType>
+void parallelSortArray(ArrayType& array, const ParallelOptions& options, std::true_type);
+
+template <class ArrayType>
+void parallelSortArray(ArrayType& array, const ParallelOptions& options, std::false_type);
+
+} // namespace detail
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, class Function>
+void openlib::detail::forEachRange(std::size_t size, const ParallelOptions& options,
+                                   Function function) {
+  ThreadPool& pool = options.pool ? *options.pool : ThreadPool::shared();
+  std::size_t grain = options.grain;
+  if (grain == 0) {
+    grain = ParallelOptions::DEFAULT_GRAIN_BYTES / sizeof(type);
+    grain = grain == 0 ? 1 : grain;
+  }
+
+  const std::size_t chunks = (size + grain - 1) / grain;
+  if (chunks <= 1 || pool.size() == 1) {
+    function(std::size_t(0), size);
+    return;
+  }
+
+  pool.parallelFor(chunks, [&](std::size_t chunk) {
+    const std::size_t begin = chunk * grain;
+    const std::size_t end = std::min(begin + grain, size);
+    function(begin, end);
+  });
+}
+
+template <class ArrayType, class Function>
+void openlib::parallelForEach(ArrayType& array, Function function, const ParallelOptions& options) {
+  auto data = array.data();
+  using type = typename std::remove_reference<decltype(*data)>::type;
+
+  detail::forEachRange<type>(array.size(), options, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+      function(data[i]);
+    }
+  });
+}
+
+template <class SrcArray, class DstArray, class Function>
+void openlib::parallelTransform(const SrcArray& src, DstArray& dst, Function function,
+                                const ParallelOptions& options) {
+  if (dst.size() < src.size()) {
+    throw std::length_error("destination array is smaller than source array");
+  }
+
+  auto in = src.data();
+  auto out = dst.data();
+  using type = typename std::remove_reference<decltype(*in)>::type;
+
+  detail::forEachRange<type>(src.size(), options, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+      out[i] = function(in[i]);
+    }
+  });
+}
+
+template <class ArrayType, class type, class Operation>
+type openlib::parallelReduce(const ArrayType& array, type init, Operation op,
+                             const ParallelOptions& options) {
+  auto data = array.data();
+  using element = typename std::remove_reference<decltype(*data)>::type;
+
+  // one slot per chunk, combined in order afterwards
+  std::vector<type> partials;
+  std::size_t grain = options.grain;
+  if (grain == 0) {
+    grain = std::max<std::size_t>(1, ParallelOptions::DEFAULT_GRAIN_BYTES / sizeof(element));
+  }
+  const std::size_t chunks = (array.size() + grain - 1) / grain;
+  partials.resize(chunks, init);
+
+  ParallelOptions chunked = options;
+  chunked.grain = grain;
+  detail::forEachRange<element>(array.size(), chunked, [&](std::size_t begin, std::size_t end) {
+    // a single range covers every chunk when the pool has one thread
+    for (std::size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grain) {
+      const std::size_t chunkEnd = std::min(chunkBegin + grain, end);
+      type partial = data[chunkBegin];
+      for (std::size_t i = chunkBegin + 1; i < chunkEnd; i++) {
+        partial = op(partial, data[i]);
+      }
+      partials[chunkBegin / grain] = partial;
+    }
+  });
+
+  type result = init;
+  for (const auto& partial : partials) {
+    result = op(result, partial);
+  }
+  return result;
+}
+
+template <class ArrayType, class type>
+type openlib::parallelReduce(const ArrayType& array, type init, const ParallelOptions& options) {
+  return parallelReduce(array, init, std::plus<type>(), options);
+}
+
+template <class ArrayType, class type>
+void openlib::parallelFill(ArrayType& array, const type& value, const ParallelOptions& options) {
+  auto data = array.data();
+  using element = typename std::remove_reference<decltype(*data)>::type;
+  const element converted = value;
+
+  detail::forEachRange<element>(array.size(), options, [&](std::size_t begin, std::size_t end) {
+    kernels::detail::fillArray(data + begin, converted, end - begin,
+                               std::is_trivially_copyable<element>());
+  });
+}
+
+template <class ArrayType, class Compare>
+void openlib::parallelSort(ArrayType& array, Compare compare, const ParallelOptions& options) {
+  auto data = array.data();
+  using type = typename std::remove_reference<decltype(*data)>::type;
+  const std::size_t size = array.size();
+
+  ThreadPool& pool = options.pool ? *options.pool : ThreadPool::shared();
+  std::size_t grain = options.grain;
+  if (grain == 0) {
+    grain = std::max<std::size_t>(1, ParallelOptions::DEFAULT_GRAIN_BYTES / sizeof(type));
+  }
+
+  // at least one run per thread, each at least a grain long
+  std::size_t runs = std::min(pool.size(), (size + grain - 1) / grain);
+  if (runs <= 1) {
+    std::sort(data, data + size, compare);
+    return;
+  }
+  const std::size_t runLength = (size + runs - 1) / runs;
+  runs = (size + runLength - 1) / runLength;
+
+  pool.parallelFor(runs, [&](std::size_t run) {
+    const std::size_t begin = run * runLength;
+    const std::size_t end = std::min(begin + runLength, size);
+    std::sort(data + begin, data + end, compare);
+  });
+
+  // merge neighbouring runs, doubling their length each round
+  FlatArray<type> scratch(size, uninitialized);
+  type* from = data;
+  type* to = scratch.data();
+  for (std::size_t width = runLength; width < size; width *= 2) {
+    const std::size_t pairs = (size + 2 * width - 1) / (2 * width);
+    pool.parallelFor(pairs, [&](std::size_t pair) {
+      const std::size_t begin = pair * 2 * width;
+      const std::size_t middle = std::min(begin + width, size);
+      const std::size_t end = std::min(begin + 2 * width, size);
+      std::merge(std::make_move_iterator(from + begin), std::make_move_iterator(from + middle),
+                 std::make_move_iterator(from + middle), std::make_move_iterator(from + end),
+                 to + begin, compare);
+    });
+    std::swap(from, to);
+  }
+
+  if (from != data) {
+    std::move(from, from + size, data);
+  }
+}
+
+template <class Key, class Value>
+void openlib::detail::parallelRadixSort(Key* keys, Value* values, std::size_t size,
+                                        const ParallelOptions& options) {
+  ThreadPool& pool = options.pool ? *options.pool : ThreadPool::shared();
+  std::size_t grain = options.grain;
+  if (grain == 0) {
+    grain = std::max<std::size_t>(1, ParallelOptions::DEFAULT_GRAIN_BYTES / sizeof(Key));
+  }
+  const std::size_t chunks = std::min(pool.size(), (size + grain - 1) / grain);
+  radixSort(keys, values, size, &pool, chunks);
+}
+
+template <class ArrayType>
+void openlib::detail::parallelSortArray(ArrayType& array, const ParallelOptions& options,
+                                        std::true_type) {
+  auto data = array.data();
+  if (array.size() < RADIX_SORT_MIN_SIZE) {
+    sortArray(data, array.size(), std::true_type());
+    return;
+  }
+  parallelRadixSort(data, static_cast<NoValues*>(nullptr), array.size(), options);
+}
+
+template <class ArrayType>
+void openlib::detail::parallelSortArray(ArrayType& array, const ParallelOptions& options,
+                                        std::false_type) {
+  using type = typename std::remove_reference<decltype(*array.data())>::type;
+  parallelSort(array, std::less<type>(), options);
+}
+
+template <class ArrayType>
+void openlib::parallelSort(ArrayType& array, const ParallelOptions& options) {
+  using type = typename std::remove_reference<decltype(*array.data())>::type;
+  detail::parallelSortArray(array, options,
+                            std::integral_constant<bool, detail::RadixKey<type>::value>());
+}
+
+template <class KeyArray, class ValueArray>
+void openlib::parallelSortByKey(KeyArray& keys, ValueArray& values, const ParallelOptions& options) {
+  using Key = typename std::remove_reference<decltype(*keys.data())>::type;
+  static_assert(detail::RadixKey<Key>::value,
+                "parallelSortByKey needs integer or floating point keys");
+  if (keys.size() != values.size()) {
+    throw std::length_error("keys and values differ in size");
+  }
+  detail::parallelRadixSort(keys.data(), values.data(), keys.size(), options);
+}
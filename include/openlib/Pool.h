@@ -0,0 +1,237 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include <openlib/MemoryResource.h>
+
+namespace openlib {
+
+/**
+ * Size-class pool
+ *
+ * Requests are rounded up to a power of two size class between
+ * MIN_BLOCK_SIZE and MAX_BLOCK_SIZE. Each class keeps a free list, so
+ * repeatedly allocating and releasing same-sized buffers never reaches
+ * malloc after warm up. Larger requests go straight to operator new.
+ * Memory is returned to the system when the Pool is destroyed.
+ *
+ * Not thread safe.
+ */
+class Pool final : public MemoryResource {
+public:
+
+  static const std::size_t MIN_BLOCK_SIZE = 16;
+  static const std::size_t MAX_BLOCK_SIZE = 64 * 1024;
+
+  /**
+   * @brief constructor
+   */
+  Pool();
+
+  /**
+   * @brief destructor, releases all memory
+   */
+  ~Pool() override;
+
+  /**
+   * @brief allocate memory
+   * @param bytes number of bytes
+   * @param alignment required alignment, a power of two
+   * @return pointer to the memory
+   */
+  void* allocate(std::size_t bytes, std::size_t alignment) override;
+
+  /**
+   * @brief return memory to its size class
+   */
+  void deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+
+  /**
+   * @brief size class index for a request
+   * @param bytes number of bytes
+   * @return size class index, 0 for MIN_BLOCK_SIZE
+   */
+  static std::size_t sizeClass(std::size_t bytes);
+
+private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static const std::size_t SIZE_CLASSES = 13;
+  static const std::size_t CHUNK_SIZE = 256 * 1024;
+
+  FreeBlock* freeLists[SIZE_CLASSES];
+  std::vector<void*> chunks;
+
+  // true when a request is served by a size class rather than operator new
+  static bool pooled(std::size_t bytes, std::size_t alignment);
+
+  void refill(std::size_t sizeClass);
+
+  // no copy or assignment
+  Pool(const Pool& other) = delete;
+  Pool& operator=(const Pool& other) = delete;
+};
+
+/**
+ * Standard allocator that takes memory from a Pool
+ */
+template <class type>
+class PoolAllocator {
+public:
+  using value_type = type;
+
+  /**
+   * @brief constructor
+   * @param pool pool to allocate from, must outlive the allocator
+   */
+  PoolAllocator(Pool& pool) noexcept;
+
+  /**
+   * @brief converting constructor
+   */
+  template <class other>
+  PoolAllocator(const PoolAllocator<other>& allocator) noexcept;
+
+  /**
+   * @brief allocate storage for n elements
+   */
+  type* allocate(std::size_t n);
+
+  /**
+   * @brief return storage to the pool
+   */
+  void deallocate(type* p, std::size_t n) noexcept;
+
+  /**
+   * @brief the underlying pool
+   */
+  Pool& pool() const noexcept;
+
+private:
+  Pool* source;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+inline std::size_t openlib::Pool::sizeClass(std::size_t bytes) {
+  if (bytes <= MIN_BLOCK_SIZE) {
+    return 0;
+  }
+  // log2 of the smallest power of two >= bytes, relative to MIN_BLOCK_SIZE
+  return 64 - __builtin_clzll(static_cast<unsigned long long>(bytes - 1))
+            - __builtin_ctzll(MIN_BLOCK_SIZE);
+}
+
+inline bool openlib::Pool::pooled(std::size_t bytes, std::size_t alignment) {
+  return bytes <= MAX_BLOCK_SIZE && alignment <= alignof(std::max_align_t);
+}
+
+inline void* openlib::Pool::allocate(std::size_t bytes, std::size_t alignment) {
+  if (!pooled(bytes, alignment)) {
+    return defaultResource().allocate(bytes, alignment);
+  }
+
+  std::size_t index = sizeClass(bytes);
+  if (freeLists[index] == nullptr) {
+    refill(index);
+  }
+  FreeBlock* block = freeLists[index];
+  freeLists[index] = block->next;
+  return block;
+}
+
+inline void openlib::Pool::deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+  if (!pooled(bytes, alignment)) {
+    defaultResource().deallocate(p, bytes, alignment);
+    return;
+  }
+
+  std::size_t index = sizeClass(bytes);
+  FreeBlock* block = static_cast<FreeBlock*>(p);
+  block->next = freeLists[index];
+  freeLists[index] = block;
+}
+
+template <class type>
+openlib::PoolAllocator<type>::PoolAllocator(Pool& pool) noexcept:
+    source(&pool) {
+
+}
+
+template <class type>
+template <class other>
+openlib::PoolAllocator<type>::PoolAllocator(const PoolAllocator<other>& allocator) noexcept:
+    source(&allocator.pool()) {
+
+}
+
+template <class type>
+type* openlib::PoolAllocator<type>::allocate(std::size_t n) {
+  if (n > std::numeric_limits<std::size_t>::max() / sizeof(type)) {
+    throw std::bad_alloc();
+  }
+  return static_cast<type*>(source->allocate(n * sizeof(type), alignof(type)));
+}
+
+template <class type>
+void openlib::PoolAllocator<type>::deallocate(type* p, std::size_t n) noexcept {
+  source->deallocate(p, n * sizeof(type), alignof(type));
+}
+
+template <class type>
+openlib::Pool& openlib::PoolAllocator<type>::pool() const noexcept {
+  return *source;
+}
+
+/**
+ * @brief equality
+ * Allocators are equal when they share a pool
+ */
+template <class type, class other>
+inline bool operator==(const openlib::PoolAllocator<type>& lhs,
+                       const openlib::PoolAllocator<other>& rhs) {
+  return &lhs.pool() == &rhs.pool();
+}
+
+/**
+ * @brief inequality
+ */
+template <class type, class other>
+inline bool operator!=(const openlib::PoolAllocator<type>& lhs,
+                       const openlib::PoolAllocator<other>& rhs) {
+  return &lhs.pool() != &rhs.pool();
+}
@@ -0,0 +1,332 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <openlib/Epoch.h>
+#include <openlib/FlatArray.h>
+
+namespace openlib {
+
+/**
+ * Read-mostly array whose contents are replaced as a whole
+ *
+ * Readers see an immutable snapshot; publish() swaps in a new one
+ * atomically. Reading takes no lock and writes only the reader's own
+ * cache line (see EpochDomain), so readers scale with the number of cores
+ * while a writer reloads the table. Replaced snapshots are freed once
+ * every reader that could still see them has moved on.
+ *
+ *   openlib::RcuArray<Route> routes(loadRoutes());
+ *   // on each reading thread
+ *   auto reader = routes.reader();
+ *   {
+ *     auto snapshot = reader.read();
+ *     lookup(snapshot[i]);
+ *   }
+ *   // on the reloading thread
+ *   routes.publish(loadRoutes());
+ *
+ * Holding a Snapshot delays reclamation of that snapshot and everything
+ * published after it, so keep read sections short.
+ */
+template <class type, class Allocator = std::allocator<type>>
+class RcuArray final {
+public:
+  using Array = FlatArray<type, Allocator>;
+
+  class Snapshot;
+
+  /**
+   * Per-thread read handle
+   *
+   * Owns a slot in the array's EpochDomain. Create one per reading thread
+   * and keep it for as long as the thread reads; it must not outlive the
+   * RcuArray or be used by two threads at once.
+   */
+  class Reader {
+  public:
+    explicit Reader(RcuArray& array);
+    Reader(Reader&& other) noexcept;
+    ~Reader();
+
+    /**
+     * @brief pin the current snapshot, wait-free
+     * @return the snapshot, valid until the Snapshot object is destroyed
+     */
+    Snapshot read() const noexcept;
+
+  private:
+    RcuArray* array;
+    EpochDomain::Slot* slot;
+
+    Reader(const Reader& other) = delete;
+    Reader& operator=(const Reader& other) = delete;
+  };
+
+  /**
+   * Pinned, read-only snapshot
+   *
+   * Has the read-only FlatArray accessor interface. The elements stay
+   * valid and unchanged while the Snapshot exists.
+   */
+  class Snapshot {
+  public:
+    Snapshot(Snapshot&& other) noexcept;
+    ~Snapshot();
+
+    std::size_t size() const noexcept;
+    const type& at(const std::size_t& position) const noexcept;
+    const type& front() const noexcept;
+    const type& back() const noexcept;
+    const type* data() const noexcept;
+    const type* begin() const noexcept;
+    const type* end() const noexcept;
+    const type& operator[](std::size_t position) const noexcept;
+
+  private:
+    friend class Reader;
+
+    Snapshot(EpochDomain& domain, EpochDomain::Slot& slot, const Array* array) noexcept;
+
+    EpochDomain* domain;
+    EpochDomain::Slot* slot;
+    const Array* array;
+
+    Snapshot(const Snapshot& other) = delete;
+    Snapshot& operator=(const Snapshot& other) = delete;
+  };
+
+  /**
+   * @brief constructor
+   * @param initial the first snapshot
+   */
+  explicit RcuArray(Array&& initial);
+
+  /**
+   * @brief destructor, no Reader may still exist
+   */
+  ~RcuArray();
+
+  /**
+   * @brief create a read handle for the calling thread
+   */
+  Reader reader();
+
+  /**
+   * @brief replace the contents, never waits for readers
+   * The old snapshot is retired and freed by a later publish() or
+   * reclaim() once no reader can see it. Concurrent publishers are
+   * serialized.
+   * @param next the new snapshot
+   */
+  void publish(Array&& next);
+
+  /**
+   * @brief free every retired snapshot no reader can see any more
+   * @return number of snapshots still waiting for readers
+   */
+  std::size_t reclaim();
+
+  /**
+   * @brief wait for readers of retired snapshots, then free them all
+   * Must not be called while the calling thread holds a Snapshot.
+   */
+  void synchronize();
+
+private:
+  struct Retired {
+    const Array* array;
+    uint64_t epoch;
+  };
+
+  EpochDomain domain;
+  std::atomic<const Array*> current;
+  std::mutex writerLock;
+  std::vector<Retired> retired;
+
+  // free retired snapshots that are safe; writerLock must be held
+  std::size_t reclaimLocked();
+
+  // no copy or assignment
+  RcuArray(const RcuArray& other) = delete;
+  RcuArray& operator=(const RcuArray& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, class Allocator>
+openlib::RcuArray<type, Allocator>::RcuArray(Array&& initial):
+    current(new Array(std::move(initial))) {
+}
+
+template <class type, class Allocator>
+openlib::RcuArray<type, Allocator>::~RcuArray() {
+  for (const Retired& old : retired) {
+    delete old.array;
+  }
+  delete current.load(std::memory_order_relaxed);
+}
+
+template <class type, class Allocator>
+typename openlib::RcuArray<type, Allocator>::Reader openlib::RcuArray<type, Allocator>::reader() {
+  return Reader(*this);
+}
+
+template <class type, class Allocator>
+void openlib::RcuArray<type, Allocator>::publish(Array&& next) {
+  std::unique_ptr<const Array> fresh(new Array(std::move(next)));
+
+  std::lock_guard<std::mutex> guard(writerLock);
+  // make room for the old snapshot first so nothing throws once it is unlinked
+  retired.reserve(retired.size() + 1);
+  const Array* old = current.exchange(fresh.release(), std::memory_order_acq_rel);
+  retired.push_back(Retired{old, domain.advance()});
+  reclaimLocked();
+}
+
+template <class type, class Allocator>
+std::size_t openlib::RcuArray<type, Allocator>::reclaim() {
+  std::lock_guard<std::mutex> guard(writerLock);
+  return reclaimLocked();
+}
+
+template <class type, class Allocator>
+std::size_t openlib::RcuArray<type, Allocator>::reclaimLocked() {
+  // retired is in epoch order, so one check of the newest safe epoch frees a prefix
+  std::size_t safe = retired.size();
+  while (safe > 0 && !domain.isQuiescent(retired[safe - 1].epoch)) {
+    safe--;
+  }
+  for (std::size_t i = 0; i < safe; i++) {
+    delete retired[i].array;
+  }
+  retired.erase(retired.begin(), retired.begin() + safe);
+  return retired.size();
+}
+
+template <class type, class Allocator>
+void openlib::RcuArray<type, Allocator>::synchronize() {
+  std::lock_guard<std::mutex> guard(writerLock);
+  domain.synchronize();
+  reclaimLocked();
+}
+
+template <class type, class Allocator>
+openlib::RcuArray<type, Allocator>::Reader::Reader(RcuArray& array):
+    array(&array), slot(&array.domain.acquireSlot()) {
+}
+
+template <class type, class Allocator>
+openlib::RcuArray<type, Allocator>::Reader::Reader(Reader&& other) noexcept:
+    array(other.array), slot(other.slot) {
+  other.slot = nullptr;
+}
+
+template <class type, class Allocator>
+openlib::RcuArray<type, Allocator>::Reader::~Reader() {
+  if (slot != nullptr) {
+    array->domain.releaseSlot(*slot);
+  }
+}
+
+template <class type, class Allocator>
+inline typename openlib::RcuArray<type, Allocator>::Snapshot
+openlib::RcuArray<type, Allocator>::Reader::read() const noexcept {
+  array->domain.enter(*slot);
+  return Snapshot(array->domain, *slot, array->current.load(std::memory_order_acquire));
+}
+
+template <class type, class Allocator>
+inline openlib::RcuArray<type, Allocator>::Snapshot::Snapshot(EpochDomain& domain,
+                                                              EpochDomain::Slot& slot,
+                                                              const Array* array) noexcept:
+    domain(&domain), slot(&slot), array(array) {
+}
+
+template <class type, class Allocator>
+inline openlib::RcuArray<type, Allocator>::Snapshot::Snapshot(Snapshot&& other) noexcept:
+    domain(other.domain), slot(other.slot), array(other.array) {
+  other.slot = nullptr;
+}
+
+template <class type, class Allocator>
+inline openlib::RcuArray<type, Allocator>::Snapshot::~Snapshot() {
+  if (slot != nullptr) {
+    domain->exit(*slot);
+  }
+}
+
+template <class type, class Allocator>
+inline std::size_t openlib::RcuArray<type, Allocator>::Snapshot::size() const noexcept {
+  return array->size();
+}
+
+template <class type, class Allocator>
+inline const type& openlib::RcuArray<type, Allocator>::Snapshot::at(const std::size_t& position) const noexcept {
+  return (*array)[position];
+}
+
+template <class type, class Allocator>
+inline const type& openlib::RcuArray<type, Allocator>::Snapshot::front() const noexcept {
+  return array->front();
+}
+
+template <class type, class Allocator>
+inline const type& openlib::RcuArray<type, Allocator>::Snapshot::back() const noexcept {
+  return array->back();
+}
+
+template <class type, class Allocator>
+inline const type* openlib::RcuArray<type, Allocator>::Snapshot::data() const noexcept {
+  return array->data();
+}
+
+template <class type, class Allocator>
+inline const type* openlib::RcuArray<type, Allocator>::Snapshot::begin() const noexcept {
+  return array->begin();
+}
+
+template <class type, class Allocator>
+inline const type* openlib::RcuArray<type, Allocator>::Snapshot::end() const noexcept {
+  return array->end();
+}
+
+template <class type, class Allocator>
+inline const type& openlib::RcuArray<type, Allocator>::Snapshot::operator[](std::size_t position) const noexcept {
+  return (*array)[position];
+}
@@ -0,0 +1,311 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include <openlib/AlignedAllocator.h>
+#include <openlib/FlatArray.h>
+
+namespace openlib {
+
+/**
+ * Read-only search index over a sorted array
+ *
+ * Elements are stored in Eytzinger order, the breadth-first layout of a
+ * balanced binary search tree: the children of node k are 2k and 2k + 1.
+ * The first levels of every search share a few cache lines, and the four
+ * levels below a node sit in one cache line for 4-byte keys, so each
+ * search prefetches that line well before it needs it. The search itself
+ * is branchless.
+ *
+ * Results are positions in the sorted array the index was built from,
+ * computed from the node index, so a search touches nothing but the tree.
+ * Batched lookups walk a group of keys down the tree level by level, so
+ * the memory accesses of different keys overlap.
+ */
+template <class type, class Compare = std::less<type>>
+class SearchIndex final {
+public:
+
+  /**
+   * @brief keys walked down the tree together by the batched lookups
+   */
+  static const std::size_t BATCH = 16;
+
+  /**
+   * @brief constructor
+   * @param sorted FlatArray, Array, or anything with data() and size(),
+   *               sorted by compare
+   * @throws std::invalid_argument if sorted is not sorted
+   */
+  template <class ArrayType>
+  explicit SearchIndex(const ArrayType& sorted, const Compare& compare = Compare());
+
+  /**
+   * @brief move constructor
+   */
+  SearchIndex(SearchIndex&& other) = default;
+
+  /**
+   * @brief number of elements
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief element at a position of the sorted array
+   * @throws std::out_of_range if position >= size()
+   */
+  const type& at(std::size_t position) const;
+
+  /**
+   * @brief position of the first element not less than key
+   * @return position, or size() if every element is less than key
+   */
+  std::size_t lowerBound(const type& key) const;
+
+  /**
+   * @brief position of the first element greater than key
+   * @return position, or size() if no element is greater than key
+   */
+  std::size_t upperBound(const type& key) const;
+
+  /**
+   * @brief whether an element equal to key is in the index
+   */
+  bool contains(const type& key) const;
+
+  /**
+   * @brief lowerBound() of every key, results[i] for keys[i]
+   * @throws std::length_error if results is smaller than keys
+   */
+  template <class KeyArray, class ResultArray>
+  void lowerBound(const KeyArray& keys, ResultArray& results) const;
+
+  /**
+   * @brief upperBound() of every key, results[i] for keys[i]
+   * @throws std::length_error if results is smaller than keys
+   */
+  template <class KeyArray, class ResultArray>
+  void upperBound(const KeyArray& keys, ResultArray& results) const;
+
+private:
+  // elements of the same cache line, the prefetch distance in nodes
+  static const std::size_t LINE = CACHE_LINE_BYTES / sizeof(type) > 0 ?
+                                  CACHE_LINE_BYTES / sizeof(type) : 1;
+
+  std::size_t count;
+  // levels of the tree, every search ends after at most this many steps
+  std::size_t depth;
+  Compare compare;
+  // tree[k] for k in [1, count], tree[0] is unused
+  FlatArray<type, AlignedAllocator<type>> tree;
+
+  std::size_t build(const type* sorted, std::size_t node, std::size_t next);
+
+  // position in the sorted array of tree[node], node in [1, count]
+  std::size_t rank(std::size_t node) const noexcept;
+
+  // node of the result, 0 for none; upper searches for the first greater
+  template <bool upper>
+  std::size_t search(const type& key) const;
+
+  template <bool upper, class KeyArray, class ResultArray>
+  void searchBatch(const KeyArray& keys, ResultArray& results) const;
+
+  template <bool upper>
+  bool goRight(const type& node, const type& key) const;
+
+  // no copy or assignment
+  SearchIndex(const SearchIndex& other) = delete;
+  SearchIndex& operator=(const SearchIndex& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, class Compare>
+const std::size_t openlib::SearchIndex<type, Compare>::BATCH;
+
+template <class type, class Compare>
+const std::size_t openlib::SearchIndex<type, Compare>::LINE;
+
+template <class type, class Compare>
+template <class ArrayType>
+openlib::SearchIndex<type, Compare>::SearchIndex(const ArrayType& sorted, const Compare& compare):
+    count(sorted.size()), depth(0), compare(compare), tree(sorted.size() + 1) {
+  const type* data = sorted.data();
+  for (std::size_t i = 1; i < count; i++) {
+    if (compare(data[i], data[i - 1])) {
+      throw std::invalid_argument("array is not sorted");
+    }
+  }
+  for (std::size_t levels = count; levels > 0; levels >>= 1) {
+    depth++;
+  }
+  build(data, 1, 0);
+}
+
+template <class type, class Compare>
+std::size_t openlib::SearchIndex<type, Compare>::build(const type* sorted, std::size_t node,
+                                                      std::size_t next) {
+  // in-order walk of the implicit tree, recursion is only depth deep
+  if (node <= count) {
+    next = build(sorted, 2 * node, next);
+    tree[node] = sorted[next++];
+    next = build(sorted, 2 * node + 1, next);
+  }
+  return next;
+}
+
+template <class type, class Compare>
+inline std::size_t openlib::SearchIndex<type, Compare>::rank(std::size_t node) const noexcept {
+  // In-order rank in the perfect tree of depth levels: the subtrees left
+  // of node at its level, each 2^(below + 1) nodes wide, plus its own left
+  // subtree. Only the first last-level nodes exist; take away the missing
+  // ones that would come before node, perfect ranks of the last level are
+  // the even numbers.
+  const std::size_t level = 63 - __builtin_clzll(node);
+  const std::size_t below = depth - 1 - level;
+  const std::size_t perfect = ((node - (std::size_t(1) << level)) << (below + 1)) +
+                              (std::size_t(1) << below) - 1;
+  const std::size_t leaves = count - ((std::size_t(1) << (depth - 1)) - 1);
+  const std::size_t leavesBefore = (perfect + 1) / 2;
+  return leavesBefore > leaves ? perfect - (leavesBefore - leaves) : perfect;
+}
+
+template <class type, class Compare>
+inline std::size_t openlib::SearchIndex<type, Compare>::size() const noexcept {
+  return count;
+}
+
+template <class type, class Compare>
+const type& openlib::SearchIndex<type, Compare>::at(std::size_t position) const {
+  if (position >= count) {
+    throw std::out_of_range("position is past the end of the index");
+  }
+  // walk down to the node that holds position
+  std::size_t node = 1;
+  for (std::size_t here = rank(node); here != position; here = rank(node)) {
+    node = 2 * node + (here < position);
+  }
+  return tree[node];
+}
+
+template <class type, class Compare>
+template <bool upper>
+inline bool openlib::SearchIndex<type, Compare>::goRight(const type& node,
+                                                         const type& key) const {
+  return upper ? !compare(key, node) : compare(node, key);
+}
+
+template <class type, class Compare>
+template <bool upper>
+inline std::size_t openlib::SearchIndex<type, Compare>::search(const type& key) const {
+  const type* nodes = tree.data();
+  std::size_t node = 1;
+  while (node <= count) {
+    __builtin_prefetch(nodes + node * LINE);
+    node = 2 * node + goRight<upper>(nodes[node], key);
+  }
+  // every right turn after the last left one passed smaller elements,
+  // dropping them and the left turn leaves the node of the result
+  return node >> __builtin_ffsll(~node);
+}
+
+template <class type, class Compare>
+std::size_t openlib::SearchIndex<type, Compare>::lowerBound(const type& key) const {
+  std::size_t node = search<false>(key);
+  return node == 0 ? count : rank(node);
+}
+
+template <class type, class Compare>
+std::size_t openlib::SearchIndex<type, Compare>::upperBound(const type& key) const {
+  std::size_t node = search<true>(key);
+  return node == 0 ? count : rank(node);
+}
+
+template <class type, class Compare>
+bool openlib::SearchIndex<type, Compare>::contains(const type& key) const {
+  std::size_t node = search<false>(key);
+  return node != 0 && !compare(key, tree[node]);
+}
+
+template <class type, class Compare>
+template <bool upper, class KeyArray, class ResultArray>
+void openlib::SearchIndex<type, Compare>::searchBatch(const KeyArray& keys,
+                                                      ResultArray& results) const {
+  if (results.size() < keys.size()) {
+    throw std::length_error("results array is smaller than keys array");
+  }
+
+  const type* nodes = tree.data();
+  auto in = keys.data();
+  auto out = results.data();
+  std::size_t walk[BATCH];
+
+  for (std::size_t begin = 0; begin < keys.size(); begin += BATCH) {
+    const std::size_t n = std::min(BATCH, keys.size() - begin);
+    std::fill(walk, walk + n, std::size_t(1));
+    // a search that has left the tree keeps turning right, which the
+    // final shift drops, so every key takes exactly depth steps
+    for (std::size_t level = 0; level < depth; level++) {
+      for (std::size_t i = 0; i < n; i++) {
+        const std::size_t node = walk[i];
+        // clamped read instead of a branch, depth > 0 means count > 0
+        const bool outside = node > count;
+        const bool right = goRight<upper>(nodes[outside ? count : node], in[begin + i]);
+        walk[i] = 2 * node + (outside | right);
+        __builtin_prefetch(nodes + walk[i] * LINE);
+      }
+    }
+    for (std::size_t i = 0; i < n; i++) {
+      const std::size_t node = walk[i] >> __builtin_ffsll(~walk[i]);
+      out[begin + i] = node == 0 ? count : rank(node);
+    }
+  }
+}
+
+template <class type, class Compare>
+template <class KeyArray, class ResultArray>
+void openlib::SearchIndex<type, Compare>::lowerBound(const KeyArray& keys,
+                                                     ResultArray& results) const {
+  searchBatch<false>(keys, results);
+}
+
+template <class type, class Compare>
+template <class KeyArray, class ResultArray>
+void openlib::SearchIndex<type, Compare>::upperBound(const KeyArray& keys,
+                                                     ResultArray& results) const {
+  searchBatch<true>(keys, results);
+}
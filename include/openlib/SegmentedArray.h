@@ -0,0 +1,480 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <openlib/FlatArray.h>
+
+namespace openlib {
+
+/**
+ * Growable array whose elements never move
+ *
+ * Storage is a list of FlatArray chunks. Chunk k holds
+ * firstChunkSize * 2^k elements, so capacity doubles with each chunk and
+ * appending never relocates an existing element: pointers and references
+ * stay valid for the life of the SegmentedArray.
+ *
+ * Indexing is O(1): the chunk is the log2 of the biased index, looked up
+ * in a fixed table of chunk pointers. For tight loops use forEachChunk(),
+ * which hands out contiguous runs that vectorize like a FlatArray.
+ *
+ * Chunks are allocated with default-initialized elements (see
+ * Uninitialized), so type must be default constructible and assignable.
+ *
+ * Not thread safe.
+ */
+template <class type, class Allocator = std::allocator<type>, std::size_t firstChunkSize = 16>
+class SegmentedArray final {
+public:
+  static_assert(firstChunkSize > 0 && (firstChunkSize & (firstChunkSize - 1)) == 0,
+                "firstChunkSize must be a power of two");
+
+  class Iterator;
+
+  /**
+   * @brief constructor, creates an empty array
+   * @param allocator allocator to take chunk storage from
+   */
+  explicit SegmentedArray(const Allocator& allocator = Allocator());
+
+  /**
+   * @brief move constructor
+   * The old SegmentedArray object will be empty.
+   */
+  SegmentedArray(SegmentedArray&& other) noexcept;
+
+  /**
+   * @brief Number of elements in the array
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief Number of elements that fit before another chunk is allocated
+   */
+  std::size_t capacity() const noexcept;
+
+  /**
+   * @brief true if there are no elements
+   */
+  bool empty() const noexcept;
+
+  /**
+   * @brief Number of chunks allocated
+   */
+  std::size_t chunkCount() const noexcept;
+
+  /**
+   * @brief append an element
+   * Existing elements are never moved.
+   * @param value value to append
+   */
+  void push_back(const type& value);
+
+  /**
+   * @brief append an element
+   * Existing elements are never moved.
+   * @param value value to append
+   */
+  void push_back(type&& value);
+
+  /**
+   * @brief allocate chunks until capacity() >= count
+   * @param count number of elements
+   */
+  void reserve(std::size_t count);
+
+  /**
+   * @brief remove every element, keeping the chunks for reuse
+   * Elements of a type that is not trivially destructible are reset to
+   * type(), so the resources they hold are released now.
+   */
+  void clear() noexcept(std::is_trivially_destructible<type>::value ||
+                        (std::is_nothrow_default_constructible<type>::value &&
+                         std::is_nothrow_move_assignable<type>::value));
+
+  /**
+   * @brief Access element at a given position
+   * @return a reference to the element at the given position
+   */
+  type& at(const std::size_t& position) noexcept;
+
+  /**
+   * @brief Access const element at a given position
+   * @return a const reference to the element at the given position
+   */
+  const type& at(const std::size_t& position) const noexcept;
+
+  /**
+   * @brief The first element
+   */
+  type& front() const noexcept;
+
+  /**
+   * @brief The last element
+   */
+  type& back() const noexcept;
+
+  /**
+   * @brief call function(type* data, std::size_t count) once per chunk
+   * Chunks are visited in order and only the used part of the last chunk
+   * is passed. Loops inside function see contiguous memory.
+   */
+  template <class Function>
+  void forEachChunk(Function function) const;
+
+  /**
+   * @brief iterator to the first element
+   */
+  Iterator begin() const noexcept;
+
+  /**
+   * @brief iterator to one past the last element
+   */
+  Iterator end() const noexcept;
+
+  /**
+   * @brief operator[]
+   */
+  type& operator[](std::size_t position) noexcept;
+
+  /**
+   * @brief operator[] const
+   */
+  const type& operator[](std::size_t position) const noexcept;
+
+  /**
+   * Forward iterator, steps through a chunk with a plain pointer
+   */
+  class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = type*;
+    using reference = type&;
+
+    Iterator(const SegmentedArray* array, std::size_t chunk, type* current, type* chunkEnd);
+
+    reference operator*() const noexcept;
+    pointer operator->() const noexcept;
+    Iterator& operator++() noexcept;
+    Iterator operator++(int) noexcept;
+    bool operator==(const Iterator& other) const noexcept;
+    bool operator!=(const Iterator& other) const noexcept;
+
+  private:
+    const SegmentedArray* array;
+    std::size_t chunk;
+    type* current;
+    type* chunkEnd;
+  };
+
+private:
+  using Chunk = FlatArray<type, Allocator>;
+
+  static constexpr std::size_t FIRST_CHUNK_BITS = __builtin_ctzll(firstChunkSize);
+  static constexpr std::size_t MAX_CHUNKS = 64 - FIRST_CHUNK_BITS;
+
+  Allocator alloc;
+  std::unique_ptr<Chunk> chunks[MAX_CHUNKS];
+  type* chunkData[MAX_CHUNKS];
+  std::size_t elementCount;
+  std::size_t allocatedChunks;
+
+  static std::size_t chunkSize(std::size_t chunk) noexcept;
+  static std::size_t chunkStart(std::size_t chunk) noexcept;
+
+  // pointer to the element at position, which must be below capacity()
+  type* locate(std::size_t position) const noexcept;
+
+  // pointer to the slot for the next append, allocating a chunk if needed
+  type* nextSlot();
+
+  void addChunk();
+
+  // no copy or assignment
+  SegmentedArray(const SegmentedArray& other) = delete;
+  SegmentedArray& operator=(const SegmentedArray& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+constexpr std::size_t openlib::SegmentedArray<type, Allocator, firstChunkSize>::FIRST_CHUNK_BITS;
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+constexpr std::size_t openlib::SegmentedArray<type, Allocator, firstChunkSize>::MAX_CHUNKS;
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+openlib::SegmentedArray<type, Allocator, firstChunkSize>::SegmentedArray(const Allocator& allocator):
+    alloc(allocator),
+    elementCount(0),
+    allocatedChunks(0) {
+
+  for (std::size_t i = 0; i < MAX_CHUNKS; i++) {
+    chunkData[i] = nullptr;
+  }
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+openlib::SegmentedArray<type, Allocator, firstChunkSize>::SegmentedArray(SegmentedArray&& other) noexcept:
+    alloc(other.alloc),
+    elementCount(other.elementCount),
+    allocatedChunks(other.allocatedChunks) {
+
+  for (std::size_t i = 0; i < MAX_CHUNKS; i++) {
+    chunks[i] = std::move(other.chunks[i]);
+    chunkData[i] = other.chunkData[i];
+    other.chunkData[i] = nullptr;
+  }
+  other.elementCount = 0;
+  other.allocatedChunks = 0;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline std::size_t openlib::SegmentedArray<type, Allocator, firstChunkSize>::chunkSize(
+    std::size_t chunk) noexcept {
+  return firstChunkSize << chunk;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline std::size_t openlib::SegmentedArray<type, Allocator, firstChunkSize>::chunkStart(
+    std::size_t chunk) noexcept {
+  return (firstChunkSize << chunk) - firstChunkSize;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline type* openlib::SegmentedArray<type, Allocator, firstChunkSize>::locate(
+    std::size_t position) const noexcept {
+  // biasing by firstChunkSize makes the chunk index the position of the top bit
+  const std::size_t biased = position + firstChunkSize;
+  const std::size_t bit = 63 - __builtin_clzll(biased);
+  return chunkData[bit - FIRST_CHUNK_BITS] + (biased - (std::size_t(1) << bit));
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline std::size_t openlib::SegmentedArray<type, Allocator, firstChunkSize>::size() const noexcept {
+  return elementCount;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline std::size_t openlib::SegmentedArray<type, Allocator, firstChunkSize>::capacity() const noexcept {
+  return chunkStart(allocatedChunks);
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline bool openlib::SegmentedArray<type, Allocator, firstChunkSize>::empty() const noexcept {
+  return elementCount == 0;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline std::size_t openlib::SegmentedArray<type, Allocator, firstChunkSize>::chunkCount() const noexcept {
+  return allocatedChunks;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+void openlib::SegmentedArray<type, Allocator, firstChunkSize>::addChunk() {
+  if (allocatedChunks == MAX_CHUNKS) {
+    throw std::length_error("SegmentedArray is full");
+  }
+
+  const std::size_t chunk = allocatedChunks;
+  chunks[chunk].reset(new Chunk(chunkSize(chunk), uninitialized, alloc));
+  chunkData[chunk] = chunks[chunk]->data();
+  allocatedChunks++;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline type* openlib::SegmentedArray<type, Allocator, firstChunkSize>::nextSlot() {
+  if (elementCount == capacity()) {
+    addChunk();
+  }
+  return locate(elementCount);
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline void openlib::SegmentedArray<type, Allocator, firstChunkSize>::push_back(const type& value) {
+  *nextSlot() = value;
+  elementCount++;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline void openlib::SegmentedArray<type, Allocator, firstChunkSize>::push_back(type&& value) {
+  *nextSlot() = std::move(value);
+  elementCount++;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+void openlib::SegmentedArray<type, Allocator, firstChunkSize>::reserve(std::size_t count) {
+  while (capacity() < count) {
+    addChunk();
+  }
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+void openlib::SegmentedArray<type, Allocator, firstChunkSize>::clear() noexcept(
+    std::is_trivially_destructible<type>::value ||
+    (std::is_nothrow_default_constructible<type>::value &&
+     std::is_nothrow_move_assignable<type>::value)) {
+  if (!std::is_trivially_destructible<type>::value) {
+    forEachChunk([](type* data, std::size_t count) {
+      for (std::size_t i = 0; i < count; i++) {
+        data[i] = type();
+      }
+    });
+  }
+  elementCount = 0;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline type& openlib::SegmentedArray<type, Allocator, firstChunkSize>::at(
+    const std::size_t& position) noexcept {
+  return *locate(position);
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline const type& openlib::SegmentedArray<type, Allocator, firstChunkSize>::at(
+    const std::size_t& position) const noexcept {
+  return *locate(position);
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline type& openlib::SegmentedArray<type, Allocator, firstChunkSize>::front() const noexcept {
+  return *locate(0);
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline type& openlib::SegmentedArray<type, Allocator, firstChunkSize>::back() const noexcept {
+  return *locate(elementCount - 1);
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+template <class Function>
+void openlib::SegmentedArray<type, Allocator, firstChunkSize>::forEachChunk(Function function) const {
+  for (std::size_t chunk = 0; chunk < allocatedChunks && chunkStart(chunk) < elementCount; chunk++) {
+    const std::size_t remaining = elementCount - chunkStart(chunk);
+    const std::size_t count = remaining < chunkSize(chunk) ? remaining : chunkSize(chunk);
+    function(chunkData[chunk], count);
+  }
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+typename openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator
+openlib::SegmentedArray<type, Allocator, firstChunkSize>::begin() const noexcept {
+  if (elementCount == 0) {
+    return end();
+  }
+  const std::size_t count = elementCount < firstChunkSize ? elementCount : firstChunkSize;
+  return Iterator(this, 0, chunkData[0], chunkData[0] + count);
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+typename openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator
+openlib::SegmentedArray<type, Allocator, firstChunkSize>::end() const noexcept {
+  return Iterator(this, 0, nullptr, nullptr);
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline type& openlib::SegmentedArray<type, Allocator, firstChunkSize>::operator[](
+    std::size_t position) noexcept {
+  return at(position);
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline const type& openlib::SegmentedArray<type, Allocator, firstChunkSize>::operator[](
+    std::size_t position) const noexcept {
+  return at(position);
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator::Iterator(
+    const SegmentedArray* array, std::size_t chunk, type* current, type* chunkEnd):
+    array(array), chunk(chunk), current(current), chunkEnd(chunkEnd) {
+
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline type& openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator::operator*()
+    const noexcept {
+  return *current;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline type* openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator::operator->()
+    const noexcept {
+  return current;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline typename openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator&
+openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator::operator++() noexcept {
+  if (++current != chunkEnd) {
+    return *this;
+  }
+
+  // step into the next chunk, or become end()
+  chunk++;
+  const std::size_t start = chunkStart(chunk);
+  if (start >= array->elementCount) {
+    chunk = 0;
+    current = chunkEnd = nullptr;
+    return *this;
+  }
+  const std::size_t remaining = array->elementCount - start;
+  current = array->chunkData[chunk];
+  chunkEnd = current + (remaining < chunkSize(chunk) ? remaining : chunkSize(chunk));
+  return *this;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline typename openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator
+openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator::operator++(int) noexcept {
+  Iterator previous = *this;
+  ++*this;
+  return previous;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline bool openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator::operator==(
+    const Iterator& other) const noexcept {
+  return current == other.current;
+}
+
+template <class type, class Allocator, std::size_t firstChunkSize>
+inline bool openlib::SegmentedArray<type, Allocator, firstChunkSize>::Iterator::operator!=(
+    const Iterator& other) const noexcept {
+  return current != other.current;
+}
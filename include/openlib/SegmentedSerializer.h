@@ -0,0 +1,515 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <openlib/Array.h>
+#include <openlib/BufferPool.h>
+#include <openlib/ByteOrder.h>
+#include <openlib/MemoryResource.h>
+#include <openlib/Writer.h>
+
+namespace openlib {
+
+/**
+ * Growable Serializer built from a chain of fixed-size segments
+ *
+ * Where a Serializer throws once its capacity is used up, a
+ * SegmentedSerializer takes another segment from its MemoryResource and
+ * carries on. Nothing already written is reallocated or copied. The result
+ * goes out as an iovec list, for writev() or sendmsg(), or flatten()
+ * copies it into one contiguous Array when a single buffer is needed.
+ *
+ * The wire format is the same as BasicSerializer<Order>'s. put() and
+ * putString() split their bytes across segments. reserve() keeps a record
+ * contiguous in one segment so that the write* calls after it are
+ * unchecked stores, as with Writer. A record larger than segmentSize()
+ * gets a segment of its own.
+ *
+ * Not thread safe.
+ */
+template <class Order>
+class BasicSegmentedSerializer final
+{
+public:
+
+  static const std::size_t DEFAULT_SEGMENT_SIZE = 4096;
+
+  /**
+   * @brief construct an empty SegmentedSerializer, no segment is taken yet
+   * @param segmentSize bytes per segment, at least 1
+   * @param resource resource segments are taken from, must outlive the
+   *                 SegmentedSerializer
+   */
+  explicit BasicSegmentedSerializer(std::size_t segmentSize = DEFAULT_SEGMENT_SIZE,
+                                    MemoryResource& resource = BufferPool::shared());
+
+  /**
+   * @brief move constructor
+   * The old SegmentedSerializer object will be empty.
+   */
+  BasicSegmentedSerializer(BasicSegmentedSerializer&& other) noexcept;
+
+  /**
+   * @brief destructor, returns every segment to the resource
+   */
+  ~BasicSegmentedSerializer();
+
+  /**
+   * @brief get the number of bytes written, over all segments
+   * @return size, in bytes
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief get the size of a regular segment
+   * @return segment size, in bytes
+   */
+  std::size_t segmentSize() const noexcept;
+
+  /**
+   * @brief get the number of segments taken so far
+   * @return number of segments
+   */
+  std::size_t segmentCount() const noexcept;
+
+  /**
+   * @brief make bytes contiguous bytes writable, before unchecked write* calls
+   * Starts a new segment if the current one has fewer than bytes left.
+   * @param bytes number of bytes about to be written
+   */
+  void reserve(std::size_t bytes);
+
+  /** @brief write a char, unchecked, see reserve() */
+  void writeChar(char data) noexcept;
+
+  /** @brief write a int8_t, unchecked, see reserve() */
+  void writeInt8(int8_t data) noexcept;
+
+  /** @brief write a uint8_t, unchecked, see reserve() */
+  void writeUInt8(uint8_t data) noexcept;
+
+  /** @brief write a int16_t, unchecked, see reserve() */
+  void writeInt16(int16_t data) noexcept;
+
+  /** @brief write a uint16_t, unchecked, see reserve() */
+  void writeUInt16(uint16_t data) noexcept;
+
+  /** @brief write a int32_t, unchecked, see reserve() */
+  void writeInt32(int32_t data) noexcept;
+
+  /** @brief write a uint32_t, unchecked, see reserve() */
+  void writeUInt32(uint32_t data) noexcept;
+
+  /** @brief write a int64_t, unchecked, see reserve() */
+  void writeInt64(int64_t data) noexcept;
+
+  /** @brief write a uint64_t, unchecked, see reserve() */
+  void writeUInt64(uint64_t data) noexcept;
+
+  /** @brief write a float, unchecked, see reserve() */
+  void writeFloat(float data) noexcept;
+
+  /** @brief write a double, unchecked, see reserve() */
+  void writeDouble(double data) noexcept;
+
+  /**
+   * @brief put a char into the buffer
+   * @param data data
+   */
+  void putChar(char data);
+
+  /**
+   * @brief put a int8_t into the buffer
+   * @param data data
+   */
+  void putInt8(int8_t data);
+
+  /**
+   * @brief put a uint8_t into the buffer
+   * @param data data
+   */
+  void putUInt8(uint8_t data);
+
+  /**
+   * @brief put a int16_t into the buffer
+   * @param data data
+   */
+  void putInt16(int16_t data);
+
+  /**
+   * @brief put a uint16_t into the buffer
+   * @param data data
+   */
+  void putUInt16(uint16_t data);
+
+  /**
+   * @brief put a int32_t into the buffer
+   * @param data data
+   */
+  void putInt32(int32_t data);
+
+  /**
+   * @brief put a uint32_t into the buffer
+   * @param data data
+   */
+  void putUInt32(uint32_t data);
+
+  /**
+   * @brief put a int64_t into the buffer
+   * @param data data
+   */
+  void putInt64(int64_t data);
+
+  /**
+   * @brief put a uint64_t into the buffer
+   * @param data data
+   */
+  void putUInt64(uint64_t data);
+
+  /**
+   * @brief put a float into the buffer
+   * @param data data
+   */
+  void putFloat(float data);
+
+  /**
+   * @brief put a double into the buffer
+   * @param data data
+   */
+  void putDouble(double data);
+
+  /**
+   * @brief put a uint16_t length followed by the characters into the buffer
+   * @param data data
+   * @throws std::length_error if longer than Serializer::MAX_STRING_LENGTH
+   */
+  void putString(const std::string& data);
+
+  /**
+   * @brief put size raw bytes into the buffer, split across segments as needed
+   * @param data data
+   * @param size number of bytes
+   */
+  void put(const void* data, std::size_t size);
+
+  /**
+   * @brief put the bytes of a view into the buffer
+   * @param data bytes to copy, as they are. asBytes() gives host order
+   *             bytes, use the typed array puts to write integers in
+   *             byte order.
+   */
+  void put(ArrayView<const uint8_t> data);
+
+  /**
+   * @brief put count elements, split across segments on element boundaries
+   * Byte swapped with the vector kernels if Order needs it, else copied.
+   * @param data first element
+   * @param count number of elements
+   */
+  void putInt16Array(const int16_t* data, std::size_t count);
+  void putUInt16Array(const uint16_t* data, std::size_t count);
+  void putInt32Array(const int32_t* data, std::size_t count);
+  void putUInt32Array(const uint32_t* data, std::size_t count);
+  void putInt64Array(const int64_t* data, std::size_t count);
+  void putUInt64Array(const uint64_t* data, std::size_t count);
+  void putFloatArray(const float* data, std::size_t count);
+  void putDoubleArray(const double* data, std::size_t count);
+
+  /**
+   * @brief put every element of an array or view, see putInt16Array()
+   * @param data elements to put
+   */
+  void putInt16Array(ArrayView<const int16_t> data);
+  void putUInt16Array(ArrayView<const uint16_t> data);
+  void putInt32Array(ArrayView<const int32_t> data);
+  void putUInt32Array(ArrayView<const uint32_t> data);
+  void putInt64Array(ArrayView<const int64_t> data);
+  void putUInt64Array(ArrayView<const uint64_t> data);
+  void putFloatArray(ArrayView<const float> data);
+  void putDoubleArray(ArrayView<const double> data);
+
+  /**
+   * @brief the written bytes as one iovec per non-empty segment, in order
+   * The iovecs point into the segments and are invalidated by clear(),
+   * destruction or a move.
+   * @return iovec list for writev() or sendmsg()
+   */
+  std::vector<struct iovec> iovecs() const;
+
+  /**
+   * @brief copy the written bytes into one contiguous array
+   * @return array of size() bytes
+   */
+  Array<uint8_t> flatten() const;
+
+  /**
+   * @brief copy the written bytes to data, which must hold size() bytes
+   * @param data destination
+   */
+  void copyTo(void* data) const noexcept;
+
+  /**
+   * @brief forget everything written, keeping the first segment for reuse
+   */
+  void clear() noexcept;
+
+private:
+
+  struct Segment {
+    uint8_t* data;
+    std::size_t capacity;
+    std::size_t size;  // only kept up to date for segments before the last
+  };
+
+  MemoryResource* resource;
+  std::size_t regularSize;
+  std::vector<Segment> segments;
+  std::size_t sealedBytes;     // bytes in every segment but the last
+  BasicWriter<Order> current;  // writes into the last segment
+
+  // seal the current segment and start one with at least bytes capacity
+  void grow(std::size_t bytes);
+
+  void release(const Segment& segment) noexcept;
+
+  template <class type>
+  void putArray(const type* data, std::size_t count,
+                void (BasicWriter<Order>::*put)(const type*, std::size_t));
+
+  // no copy or assignment
+  BasicSegmentedSerializer(const BasicSegmentedSerializer& other) = delete;
+  BasicSegmentedSerializer& operator=(const BasicSegmentedSerializer& other) = delete;
+  BasicSegmentedSerializer& operator=(BasicSegmentedSerializer&& other) = delete;
+};
+
+typedef BasicSegmentedSerializer<BigEndianIntegers> SegmentedSerializer;
+
+// defined in the library, for every ByteOrder
+extern template class BasicSegmentedSerializer<ByteOrder<true, true>>;
+extern template class BasicSegmentedSerializer<ByteOrder<true, false>>;
+extern template class BasicSegmentedSerializer<ByteOrder<false, true>>;
+extern template class BasicSegmentedSerializer<ByteOrder<false, false>>;
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class Order>
+inline std::size_t openlib::BasicSegmentedSerializer<Order>::size() const noexcept {
+  return sealedBytes + current.size();
+}
+
+template <class Order>
+inline std::size_t openlib::BasicSegmentedSerializer<Order>::segmentSize() const noexcept {
+  return regularSize;
+}
+
+template <class Order>
+inline std::size_t openlib::BasicSegmentedSerializer<Order>::segmentCount() const noexcept {
+  return segments.size();
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::reserve(std::size_t bytes) {
+  if (__builtin_expect(current.remaining() < bytes, 0)) {
+    grow(bytes);
+  }
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeChar(char data) noexcept {
+  current.writeChar(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeInt8(int8_t data) noexcept {
+  current.writeInt8(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeUInt8(uint8_t data) noexcept {
+  current.writeUInt8(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeInt16(int16_t data) noexcept {
+  current.writeInt16(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeUInt16(uint16_t data) noexcept {
+  current.writeUInt16(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeInt32(int32_t data) noexcept {
+  current.writeInt32(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeUInt32(uint32_t data) noexcept {
+  current.writeUInt32(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeInt64(int64_t data) noexcept {
+  current.writeInt64(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeUInt64(uint64_t data) noexcept {
+  current.writeUInt64(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeFloat(float data) noexcept {
+  current.writeFloat(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::writeDouble(double data) noexcept {
+  current.writeDouble(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putChar(char data) {
+  reserve(sizeof(data));
+  current.writeChar(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putInt8(int8_t data) {
+  reserve(sizeof(data));
+  current.writeInt8(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putUInt8(uint8_t data) {
+  reserve(sizeof(data));
+  current.writeUInt8(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putInt16(int16_t data) {
+  reserve(sizeof(data));
+  current.writeInt16(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putUInt16(uint16_t data) {
+  reserve(sizeof(data));
+  current.writeUInt16(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putInt32(int32_t data) {
+  reserve(sizeof(data));
+  current.writeInt32(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putUInt32(uint32_t data) {
+  reserve(sizeof(data));
+  current.writeUInt32(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putInt64(int64_t data) {
+  reserve(sizeof(data));
+  current.writeInt64(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putUInt64(uint64_t data) {
+  reserve(sizeof(data));
+  current.writeUInt64(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putFloat(float data) {
+  reserve(sizeof(data));
+  current.writeFloat(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putDouble(double data) {
+  reserve(sizeof(data));
+  current.writeDouble(data);
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::put(ArrayView<const uint8_t> data) {
+  put(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putInt16Array(ArrayView<const int16_t> data) {
+  putInt16Array(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putUInt16Array(ArrayView<const uint16_t> data) {
+  putUInt16Array(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putInt32Array(ArrayView<const int32_t> data) {
+  putInt32Array(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putUInt32Array(ArrayView<const uint32_t> data) {
+  putUInt32Array(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putInt64Array(ArrayView<const int64_t> data) {
+  putInt64Array(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putUInt64Array(ArrayView<const uint64_t> data) {
+  putUInt64Array(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putFloatArray(ArrayView<const float> data) {
+  putFloatArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicSegmentedSerializer<Order>::putDoubleArray(ArrayView<const double> data) {
+  putDoubleArray(data.data(), data.size());
+}
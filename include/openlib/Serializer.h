@@ -27,10 +27,26 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <string>
 #include <openlib/Array.h>
+#include <openlib/ArrayView.h>
+#include <openlib/ByteOrder.h>
+#include <openlib/MemoryResource.h>
+#include <openlib/Writer.h>
 
 namespace openlib {
 
-class Serializer
+/**
+ * Owning, virtual interface to Writer
+ *
+ * Serializer owns its buffer and forwards to a Writer over it. Code that
+ * writes many small fields can take writer() and reserve once per record
+ * instead of paying a virtual call and a capacity check per field.
+ *
+ * Order is the ByteOrder of every field. Serializer keeps the original
+ * format, big endian integers and host order floats. Peers that are all
+ * little endian can use BasicSerializer<NativeEndian>, which never swaps.
+ */
+template <class Order>
+class BasicSerializer
 {
 public:
 
@@ -40,7 +56,30 @@ public:
    * @breif construct a Serializer with size bytes of available storage
    * @param capacity max bytes available to serialize
    */
-  explicit Serializer(const std::size_t& capacity);
+  explicit BasicSerializer(const std::size_t& capacity);
+
+  /**
+   * @brief construct a Serializer without zeroing its storage
+   * Bytes past size() are indeterminate until written.
+   * @param capacity max bytes available to serialize
+   */
+  BasicSerializer(const std::size_t& capacity, Uninitialized);
+
+  /**
+   * @brief construct a Serializer taking its storage from a MemoryResource
+   * @param capacity max bytes available to serialize
+   * @param resource resource to allocate from, e.g. an Arena or Pool. Must
+   *                 outlive the Serializer.
+   */
+  BasicSerializer(const std::size_t& capacity, MemoryResource& resource);
+
+  /**
+   * @brief construct a Serializer taking its storage from a MemoryResource,
+   * without zeroing it
+   * @param capacity max bytes available to serialize
+   * @param resource resource to allocate from, must outlive the Serializer
+   */
+  BasicSerializer(const std::size_t& capacity, Uninitialized, MemoryResource& resource);
 
   /**
    * @brief get the current size, in bytes
@@ -148,16 +187,86 @@ public:
 	 */
 	virtual void put(const void* data, std::size_t size);
 
+	/**
+	 * @brief put the bytes of a view into the buffer
+	 * @param data bytes to copy, as they are. asBytes() gives host order
+	 *             bytes, use the typed array puts to write integers in
+	 *             byte order.
+	 */
+	virtual void put(ArrayView<const uint8_t> data);
+
+	/**
+	 * @brief put count elements with a single capacity check
+	 * Byte swapped with the vector kernels if Order needs it, else copied.
+	 * @param data first element
+	 * @param count number of elements
+	 */
+	virtual void putInt16Array(const int16_t* data, std::size_t count);
+	virtual void putUInt16Array(const uint16_t* data, std::size_t count);
+	virtual void putInt32Array(const int32_t* data, std::size_t count);
+	virtual void putUInt32Array(const uint32_t* data, std::size_t count);
+	virtual void putInt64Array(const int64_t* data, std::size_t count);
+	virtual void putUInt64Array(const uint64_t* data, std::size_t count);
+	virtual void putFloatArray(const float* data, std::size_t count);
+	virtual void putDoubleArray(const double* data, std::size_t count);
+
+	/**
+	 * @brief put every element of an array or view, see putInt16Array()
+	 * @param data elements to put
+	 */
+	virtual void putInt16Array(ArrayView<const int16_t> data);
+	virtual void putUInt16Array(ArrayView<const uint16_t> data);
+	virtual void putInt32Array(ArrayView<const int32_t> data);
+	virtual void putUInt32Array(ArrayView<const uint32_t> data);
+	virtual void putInt64Array(ArrayView<const int64_t> data);
+	virtual void putUInt64Array(ArrayView<const uint64_t> data);
+	virtual void putFloatArray(ArrayView<const float> data);
+	virtual void putDoubleArray(ArrayView<const double> data);
+
+	/**
+	 * @brief view of the bytes serialized so far, without copying
+	 * @return view of the first size() bytes of the buffer
+	 */
+	virtual ArrayView<const uint8_t> view() const;
+
 	/**
 	 * @brief get the raw buffer
 	 * @return pointer to the buffer
 	 */
 	virtual uint8_t* data() const;
 
+	/**
+	 * @brief get the inline Writer this Serializer forwards to
+	 * @return writer over the buffer, sharing its position with this Serializer
+	 */
+	BasicWriter<Order>& writer() noexcept;
+
 private:
 
-  Array<uint8_t> buffer;
-  uint8_t *position;
+  FlatArray<uint8_t, ResourceAllocator<uint8_t>> buffer;
+  BasicWriter<Order> output;
+};
+
+// defined in the library, for every ByteOrder
+extern template class BasicSerializer<ByteOrder<true, true>>;
+extern template class BasicSerializer<ByteOrder<true, false>>;
+extern template class BasicSerializer<ByteOrder<false, true>>;
+extern template class BasicSerializer<ByteOrder<false, false>>;
+
+/**
+ * Serializer in the original format, big endian integers and host order
+ * floats
+ *
+ * A class rather than a typedef, so existing forward declarations of
+ * openlib::Serializer and subclasses keep compiling. The member functions
+ * are now those of BasicSerializer<BigEndianIntegers>, so the exported
+ * symbols of the library differ from releases before the ByteOrder policy
+ * and code using it must be rebuilt.
+ */
+class Serializer : public BasicSerializer<BigEndianIntegers>
+{
+public:
+  using BasicSerializer<BigEndianIntegers>::BasicSerializer;
 };
 
 } // namespace openlib
@@ -0,0 +1,465 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <openlib/FlatArray.h>
+
+namespace openlib {
+
+/**
+ * Reference-counted, copy-on-write array
+ *
+ * Copying a SharedArray is O(1): the copy shares the elements and bumps an
+ * atomic reference count. The elements are copied only when a handle that
+ * shares them is written to, so one large read-only table can be handed to
+ * many consumers, on any threads, without copying it.
+ *
+ * Reads go through the const accessors. Writes go through set(), fill()
+ * and mutableData(), which first give this handle its own copy if the
+ * elements are shared. A pointer from data() stays valid only until the
+ * next write through the same handle. Once mutableData() has handed out a
+ * pointer, copies of the handle copy the elements, so writes through that
+ * pointer never show up in a copy.
+ *
+ * Like std::shared_ptr, distinct handles may be used from different threads
+ * without locking; a single handle must not be written from one thread
+ * while another thread uses it.
+ */
+template <class type, class Allocator = std::allocator<type>>
+class SharedArray final {
+public:
+
+  /**
+   * @brief constructor
+   * @param size size of array
+   * @param allocator allocator to take storage from
+   */
+  explicit SharedArray(const std::size_t& size, const Allocator& allocator = Allocator());
+
+  /**
+   * @brief constructor, elements are default-initialized
+   * @param size size of array
+   * @param allocator allocator to take storage from
+   */
+  SharedArray(const std::size_t& size, Uninitialized, const Allocator& allocator = Allocator());
+
+  /**
+   * @brief constructor
+   * SharedArray will be initialized based off of the list.
+   * SharedArray will be the size of the list.
+   * @param list an initializer list
+   * @param allocator allocator to take storage from
+   */
+  SharedArray(const std::initializer_list<type>& list, const Allocator& allocator = Allocator());
+
+  /**
+   * @brief copy constructor, O(1)
+   * Shares the other array's elements until either one is written to. If
+   * other has handed out a pointer from mutableData(), the elements are
+   * copied instead.
+   */
+  SharedArray(const SharedArray& other);
+
+  /**
+   * @brief move constructor
+   * The other array is left empty.
+   */
+  SharedArray(SharedArray&& other) noexcept;
+
+  /**
+   * @brief destructor, frees the elements when the last sharer goes away
+   */
+  ~SharedArray();
+
+  /**
+   * @brief copy assignment, O(1)
+   * Copies the elements if other has handed out a pointer from
+   * mutableData(), as the copy constructor does.
+   */
+  SharedArray& operator=(const SharedArray& other);
+
+  /**
+   * @brief move assignment, the other array is left empty
+   */
+  SharedArray& operator=(SharedArray&& other) noexcept;
+
+  /**
+   * @brief Number of elements in the array
+   * @return the number of elements in the array
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief Number of handles sharing the elements
+   * @return the number of handles, 0 for an empty (moved-from) array
+   */
+  std::size_t useCount() const noexcept;
+
+  /**
+   * @brief Whether this handle is the only one using its elements
+   * @return true if a write will not copy
+   */
+  bool unique() const noexcept;
+
+  /**
+   * @brief Access const element at a given position
+   * @return a const reference to the element at the given position
+   */
+  const type& at(const std::size_t& position) const noexcept;
+
+  /**
+   * @brief The first element
+   * @return a const reference to the first element
+   */
+  const type& front() const noexcept;
+
+  /**
+   * @brief The last element
+   * @return a const reference to the last element
+   */
+  const type& back() const noexcept;
+
+  /**
+   * @brief Returns a const pointer to the underlying array
+   * @returns a const pointer to the underlying array
+   */
+  const type* data() const noexcept;
+
+  /**
+   * @brief Get a const pointer to the first element
+   * @return a const pointer to the first element
+   */
+  const type* begin() const noexcept;
+
+  /**
+   * @brief Get a const pointer to one past the last element
+   * @return a const pointer to one past the last element
+   */
+  const type* end() const noexcept;
+
+  /**
+   * @brief writable pointer to the elements, copying them first if shared
+   * From then on copies of this handle get their own elements.
+   * @returns a pointer to the underlying array, owned by this handle only
+   */
+  type* mutableData();
+
+  /**
+   * @brief write one element, copying the elements first if shared
+   * @param position position of the element
+   * @param value new value
+   */
+  void set(const std::size_t& position, const type& value);
+
+  /**
+   * @brief fill each element of the array with the same value
+   * If the elements are shared this handle gets fresh storage instead of
+   * copying elements that are about to be overwritten.
+   * @param value a value to fill the array with
+   */
+  void fill(const type& value);
+
+  /**
+   * @brief operator[] const
+   */
+  const type& operator[](std::size_t position) const noexcept;
+
+private:
+  struct Block {
+    std::atomic<std::size_t> references;
+    // set by mutableData() while this block has a single handle, which
+    // then is the only one reading or writing it
+    bool unshareable;
+    FlatArray<type, Allocator> storage;
+
+    template <class... Arguments>
+    explicit Block(Arguments&&... arguments);
+  };
+
+  using BlockAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+  using BlockTraits = std::allocator_traits<BlockAllocator>;
+
+  Block* block;
+
+  // new block holding a FlatArray built from arguments, reference count 1
+  template <class... Arguments>
+  static Block* create(const Allocator& allocator, Arguments&&... arguments);
+
+  // drop this handle's reference, freeing the block if it was the last
+  void release() noexcept;
+
+  // make sure this handle is the only user of its block
+  void detach();
+
+  // block for a new handle copying this one: this block with one more
+  // reference, or a copy of it if it is unshareable
+  Block* share() const;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, class Allocator>
+template <class... Arguments>
+openlib::SharedArray<type, Allocator>::Block::Block(Arguments&&... arguments):
+    references(1),
+    unshareable(false),
+    storage(std::forward<Arguments>(arguments)...) {
+}
+
+template <class type, class Allocator>
+openlib::SharedArray<type, Allocator>::SharedArray(const std::size_t& size,
+                                                   const Allocator& allocator):
+    block(create(allocator, size, allocator)) {
+}
+
+template <class type, class Allocator>
+openlib::SharedArray<type, Allocator>::SharedArray(const std::size_t& size, Uninitialized,
+                                                   const Allocator& allocator):
+    block(create(allocator, size, uninitialized, allocator)) {
+}
+
+template <class type, class Allocator>
+openlib::SharedArray<type, Allocator>::SharedArray(const std::initializer_list<type>& list,
+                                                   const Allocator& allocator):
+    block(create(allocator, list, allocator)) {
+}
+
+template <class type, class Allocator>
+openlib::SharedArray<type, Allocator>::SharedArray(const SharedArray& other):
+    block(other.share()) {
+}
+
+template <class type, class Allocator>
+openlib::SharedArray<type, Allocator>::SharedArray(SharedArray&& other) noexcept:
+    block(other.block) {
+  other.block = nullptr;
+}
+
+template <class type, class Allocator>
+openlib::SharedArray<type, Allocator>::~SharedArray() {
+  release();
+}
+
+template <class type, class Allocator>
+openlib::SharedArray<type, Allocator>&
+openlib::SharedArray<type, Allocator>::operator=(const SharedArray& other) {
+  if (this == &other) {
+    return *this;
+  }
+  Block* incoming = other.share();
+  release();
+  block = incoming;
+  return *this;
+}
+
+template <class type, class Allocator>
+openlib::SharedArray<type, Allocator>&
+openlib::SharedArray<type, Allocator>::operator=(SharedArray&& other) noexcept {
+  if (this != &other) {
+    release();
+    block = other.block;
+    other.block = nullptr;
+  }
+  return *this;
+}
+
+template <class type, class Allocator>
+template <class... Arguments>
+typename openlib::SharedArray<type, Allocator>::Block*
+openlib::SharedArray<type, Allocator>::create(const Allocator& allocator,
+                                              Arguments&&... arguments) {
+  BlockAllocator blockAllocator(allocator);
+  Block* result = BlockTraits::allocate(blockAllocator, 1);
+  try {
+    ::new (static_cast<void*>(result)) Block(std::forward<Arguments>(arguments)...);
+  } catch (...) {
+    BlockTraits::deallocate(blockAllocator, result, 1);
+    throw;
+  }
+  return result;
+}
+
+template <class type, class Allocator>
+void openlib::SharedArray<type, Allocator>::release() noexcept {
+  if (block == nullptr) {
+    return;
+  }
+  // acq_rel so the last owner sees every other owner's writes before freeing
+  if (block->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    BlockAllocator blockAllocator(block->storage.allocator());
+    block->~Block();
+    BlockTraits::deallocate(blockAllocator, block, 1);
+  }
+  block = nullptr;
+}
+
+template <class type, class Allocator>
+void openlib::SharedArray<type, Allocator>::detach() {
+  if (block == nullptr || block->references.load(std::memory_order_acquire) == 1) {
+    return;
+  }
+  Block* copy = create(block->storage.allocator(), block->storage);
+  release();
+  block = copy;
+}
+
+template <class type, class Allocator>
+typename openlib::SharedArray<type, Allocator>::Block*
+openlib::SharedArray<type, Allocator>::share() const {
+  if (block == nullptr) {
+    return nullptr;
+  }
+  if (block->unshareable) {
+    return create(block->storage.allocator(), block->storage);
+  }
+  block->references.fetch_add(1, std::memory_order_relaxed);
+  return block;
+}
+
+template <class type, class Allocator>
+inline std::size_t openlib::SharedArray<type, Allocator>::size() const noexcept {
+  return block == nullptr ? 0 : block->storage.size();
+}
+
+template <class type, class Allocator>
+inline std::size_t openlib::SharedArray<type, Allocator>::useCount() const noexcept {
+  return block == nullptr ? 0 : block->references.load(std::memory_order_relaxed);
+}
+
+template <class type, class Allocator>
+inline bool openlib::SharedArray<type, Allocator>::unique() const noexcept {
+  return useCount() == 1;
+}
+
+template <class type, class Allocator>
+inline const type& openlib::SharedArray<type, Allocator>::at(const std::size_t& position) const noexcept {
+  return block->storage[position];
+}
+
+template <class type, class Allocator>
+inline const type& openlib::SharedArray<type, Allocator>::front() const noexcept {
+  return block->storage.front();
+}
+
+template <class type, class Allocator>
+inline const type& openlib::SharedArray<type, Allocator>::back() const noexcept {
+  return block->storage.back();
+}
+
+template <class type, class Allocator>
+inline const type* openlib::SharedArray<type, Allocator>::data() const noexcept {
+  return block == nullptr ? nullptr : block->storage.data();
+}
+
+template <class type, class Allocator>
+inline const type* openlib::SharedArray<type, Allocator>::begin() const noexcept {
+  return data();
+}
+
+template <class type, class Allocator>
+inline const type* openlib::SharedArray<type, Allocator>::end() const noexcept {
+  return data() + size();
+}
+
+template <class type, class Allocator>
+inline type* openlib::SharedArray<type, Allocator>::mutableData() {
+  detach();
+  if (block == nullptr) {
+    return nullptr;
+  }
+  block->unshareable = true;
+  return block->storage.data();
+}
+
+template <class type, class Allocator>
+inline void openlib::SharedArray<type, Allocator>::set(const std::size_t& position,
+                                                       const type& value) {
+  // no pointer escapes, so the block stays shareable
+  detach();
+  block->storage[position] = value;
+}
+
+template <class type, class Allocator>
+void openlib::SharedArray<type, Allocator>::fill(const type& value) {
+  if (block == nullptr) {
+    return;
+  }
+  if (block->references.load(std::memory_order_acquire) != 1) {
+    Block* fresh = create(block->storage.allocator(), block->storage.size(), uninitialized,
+                          block->storage.allocator());
+    release();
+    block = fresh;
+  }
+  block->storage.fill(value);
+}
+
+template <class type, class Allocator>
+inline const type& openlib::SharedArray<type, Allocator>::operator[](std::size_t position) const noexcept {
+  return block->storage[position];
+}
+
+/**
+ * @brief equality
+ * Determined by looking at the location of the underling data's memory location,
+ * so two handles sharing the same elements compare equal
+ */
+template <class type, class Allocator>
+inline bool operator==(const openlib::SharedArray<type, Allocator> &lhs,
+                       const openlib::SharedArray<type, Allocator> &rhs) {
+  return lhs.data() == rhs.data();
+}
+
+/**
+ * @brief inequality
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, class Allocator>
+inline bool operator!=(const openlib::SharedArray<type, Allocator> &lhs,
+                       const openlib::SharedArray<type, Allocator> &rhs) {
+  return lhs.data() != rhs.data();
+}
+
+/**
+ * @brief less than
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, class Allocator>
+inline bool operator<(const openlib::SharedArray<type, Allocator> &lhs,
+                      const openlib::SharedArray<type, Allocator> &rhs) {
+  return lhs.data() < rhs.data();
+}
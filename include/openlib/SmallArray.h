@@ -0,0 +1,436 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+
+namespace openlib {
+
+/**
+ * Array with inline storage for up to N elements
+ *
+ * Same interface as openlib::FlatArray. Arrays of at most N elements are
+ * stored inside the object and never allocate; larger arrays take their
+ * storage from Allocator like a FlatArray does. The size is fixed at
+ * construction, so which storage is used never changes.
+ *
+ * Moving an inline SmallArray moves its elements one by one, moving a
+ * spilled one just takes over its buffer.
+ */
+template <class type, std::size_t N, class Allocator = std::allocator<type>>
+class SmallArray final {
+public:
+
+  /**
+   * @brief number of elements stored without allocating
+   */
+  static constexpr std::size_t inlineCapacity = N;
+
+  /**
+   * @brief constructor
+   * @param size size of array
+   * @param allocator allocator to take storage from if size > N
+   */
+  explicit SmallArray(const std::size_t& size, const Allocator& allocator = Allocator());
+
+  /**
+   * @brief constructor, elements are default-initialized
+   * @param size size of array
+   * @param allocator allocator to take storage from if size > N
+   */
+  SmallArray(const std::size_t& size, Uninitialized, const Allocator& allocator = Allocator());
+
+  /**
+   * @brief constructor
+   * SmallArray will be initialized based off of the list.
+   * SmallArray will be the size of the list.
+   * @param list an initializer list
+   * @param allocator allocator to take storage from if the list is longer than N
+   */
+  SmallArray(const std::initializer_list<type>& list, const Allocator& allocator = Allocator());
+
+  /**
+   * @brief copy constructor
+   * SmallArray will be initialized based off the other array. Values will
+   * be copied.
+   */
+  SmallArray(const SmallArray& other);
+
+  /**
+   * @brief move constructor
+   * A spilled array hands over its buffer and is no longer valid. An
+   * inline array keeps its moved-from elements.
+   */
+  SmallArray(SmallArray&& other) noexcept(std::is_nothrow_move_constructible<type>::value);
+
+  /**
+   * @brief destructor
+   */
+  ~SmallArray();
+
+  /**
+   * @brief Number of elements in the array
+   * @return the number of elements in the array
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief Whether the elements are stored inside the object
+   * @return true if size() <= N
+   */
+  bool isInline() const noexcept;
+
+  /**
+   * @brief Access element at a given position
+   * @return a reference to the element at the given position
+   */
+  type& at(const std::size_t& position) noexcept;
+
+  /**
+   * @brief Access const element at a given position
+   * @return a const reference to the element at the given position
+   */
+  const type& at(const std::size_t& position) const noexcept;
+
+  /**
+   * @brief The first element
+   * @return a reference to the first element
+   */
+  type& front() const noexcept;
+
+  /**
+   * @brief The last element
+   * @return a reference to the last element
+   */
+  type& back() const noexcept;
+
+  /**
+   * @brief Returns a pointer to the underlying array
+   * @returns a pointer to the underlying array
+   */
+  type* data() const noexcept;
+
+  /**
+   * @brief Get a pointer to the first element
+   * @return a pointer to the first element
+   */
+  type* begin() const noexcept;
+
+  /**
+   * @brief Get a pointer to one past the last element
+   * @return a pointer to one past the last element
+   */
+  type* end() const noexcept;
+
+  /**
+   * @brief fill each element of the array with the same value
+   * @param value a value to fill the array with
+   */
+  void fill(const type& value);
+
+  /**
+   * @brief The allocator spilled storage is taken from
+   * @return the allocator
+   */
+  const Allocator& allocator() const noexcept;
+
+  /**
+   * @brief auto cast to pointer to base type
+   */
+  operator type*() const noexcept;
+
+  /**
+   * @brief operator[]
+   */
+  type& operator[](std::size_t position) noexcept;
+
+  /**
+   * @brief operator[] const
+   */
+  const type& operator[](std::size_t position) const noexcept;
+
+private:
+  using Traits = std::allocator_traits<Allocator>;
+
+  Allocator alloc;
+  const std::size_t bufferSize;
+  typename std::aligned_storage<sizeof(type), alignof(type)>::type inlineBuffer[N > 0 ? N : 1];
+  type* buffer;
+
+  // inline storage if bufferSize fits, otherwise storage from alloc
+  type* allocate();
+
+  // give back storage taken by allocate()
+  void deallocate() noexcept;
+
+  // construct every element with construct(pointer, index), cleaning up on throw
+  template <class Construct>
+  void constructEach(Construct construct);
+
+  // destroy the first count elements
+  void destroy(std::size_t count) noexcept;
+
+  // no assignment operator
+  SmallArray& operator=(const SmallArray& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, std::size_t N, class Allocator>
+constexpr std::size_t openlib::SmallArray<type, N, Allocator>::inlineCapacity;
+
+template <class type, std::size_t N, class Allocator>
+openlib::SmallArray<type, N, Allocator>::SmallArray(const std::size_t& size,
+                                                    const Allocator& allocator):
+    alloc(allocator),
+    bufferSize(size),
+    buffer(allocate()) {
+
+  constructEach([](type* p, std::size_t) {
+    ::new (static_cast<void*>(p)) type();
+  });
+}
+
+template <class type, std::size_t N, class Allocator>
+openlib::SmallArray<type, N, Allocator>::SmallArray(const std::size_t& size, Uninitialized,
+                                                    const Allocator& allocator):
+    alloc(allocator),
+    bufferSize(size),
+    buffer(allocate()) {
+
+  if (!std::is_trivially_default_constructible<type>::value) {
+    constructEach([](type* p, std::size_t) {
+      ::new (static_cast<void*>(p)) type;
+    });
+  }
+}
+
+template <class type, std::size_t N, class Allocator>
+openlib::SmallArray<type, N, Allocator>::SmallArray(const std::initializer_list<type>& list,
+                                                    const Allocator& allocator):
+    alloc(allocator),
+    bufferSize(list.size()),
+    buffer(allocate()) {
+
+  const type* source = list.begin();
+  constructEach([source](type* p, std::size_t i) {
+    ::new (static_cast<void*>(p)) type(source[i]);
+  });
+}
+
+template <class type, std::size_t N, class Allocator>
+openlib::SmallArray<type, N, Allocator>::SmallArray(const openlib::SmallArray<type, N, Allocator>& other):
+    alloc(Traits::select_on_container_copy_construction(other.alloc)),
+    bufferSize(other.bufferSize),
+    buffer(allocate()) {
+
+  if (std::is_trivially_copyable<type>::value) {
+    kernels::copy(buffer, other.buffer, bufferSize * sizeof(type));
+    return;
+  }
+
+  const type* source = other.buffer;
+  constructEach([source](type* p, std::size_t i) {
+    ::new (static_cast<void*>(p)) type(source[i]);
+  });
+}
+
+template <class type, std::size_t N, class Allocator>
+openlib::SmallArray<type, N, Allocator>::SmallArray(openlib::SmallArray<type, N, Allocator>&& other)
+    noexcept(std::is_nothrow_move_constructible<type>::value):
+    alloc(other.alloc),
+    bufferSize(other.bufferSize),
+    buffer(nullptr) {
+
+  if (!other.isInline()) {
+    buffer = other.buffer;
+    other.buffer = nullptr;
+    return;
+  }
+
+  buffer = reinterpret_cast<type*>(inlineBuffer);
+  type* source = other.buffer;
+  constructEach([source](type* p, std::size_t i) {
+    ::new (static_cast<void*>(p)) type(std::move(source[i]));
+  });
+}
+
+template <class type, std::size_t N, class Allocator>
+openlib::SmallArray<type, N, Allocator>::~SmallArray() {
+  if (buffer != nullptr) {
+    destroy(bufferSize);
+    deallocate();
+  }
+}
+
+template <class type, std::size_t N, class Allocator>
+type* openlib::SmallArray<type, N, Allocator>::allocate() {
+  if (bufferSize <= N) {
+    return reinterpret_cast<type*>(inlineBuffer);
+  }
+  return Traits::allocate(alloc, bufferSize);
+}
+
+template <class type, std::size_t N, class Allocator>
+void openlib::SmallArray<type, N, Allocator>::deallocate() noexcept {
+  if (bufferSize > N) {
+    Traits::deallocate(alloc, buffer, bufferSize);
+  }
+}
+
+template <class type, std::size_t N, class Allocator>
+template <class Construct>
+void openlib::SmallArray<type, N, Allocator>::constructEach(Construct construct) {
+  std::size_t i = 0;
+  try {
+    for (; i < bufferSize; i++) {
+      construct(buffer + i, i);
+    }
+  } catch (...) {
+    destroy(i);
+    deallocate();
+    throw;
+  }
+}
+
+template <class type, std::size_t N, class Allocator>
+void openlib::SmallArray<type, N, Allocator>::destroy(std::size_t count) noexcept {
+  if (!std::is_trivially_destructible<type>::value) {
+    for (std::size_t i = 0; i < count; i++) {
+      buffer[i].~type();
+    }
+  }
+}
+
+template <class type, std::size_t N, class Allocator>
+inline std::size_t openlib::SmallArray<type, N, Allocator>::size() const noexcept {
+  return bufferSize;
+}
+
+template <class type, std::size_t N, class Allocator>
+inline bool openlib::SmallArray<type, N, Allocator>::isInline() const noexcept {
+  return bufferSize <= N;
+}
+
+template <class type, std::size_t N, class Allocator>
+inline type& openlib::SmallArray<type, N, Allocator>::at(const std::size_t& position) noexcept {
+  return buffer[position];
+}
+
+template <class type, std::size_t N, class Allocator>
+inline const type& openlib::SmallArray<type, N, Allocator>::at(const std::size_t& position) const noexcept {
+  return buffer[position];
+}
+
+template <class type, std::size_t N, class Allocator>
+inline type& openlib::SmallArray<type, N, Allocator>::front() const noexcept {
+  return buffer[0];
+}
+
+template <class type, std::size_t N, class Allocator>
+inline type& openlib::SmallArray<type, N, Allocator>::back() const noexcept {
+  return buffer[bufferSize - 1];
+}
+
+template <class type, std::size_t N, class Allocator>
+inline type* openlib::SmallArray<type, N, Allocator>::data() const noexcept {
+  return buffer;
+}
+
+template <class type, std::size_t N, class Allocator>
+inline type* openlib::SmallArray<type, N, Allocator>::begin() const noexcept {
+  return buffer;
+}
+
+template <class type, std::size_t N, class Allocator>
+inline type* openlib::SmallArray<type, N, Allocator>::end() const noexcept {
+  return buffer + bufferSize;
+}
+
+template <class type, std::size_t N, class Allocator>
+inline void openlib::SmallArray<type, N, Allocator>::fill(const type& value) {
+  kernels::detail::fillArray(buffer, value, bufferSize, std::is_trivially_copyable<type>());
+}
+
+template <class type, std::size_t N, class Allocator>
+inline const Allocator& openlib::SmallArray<type, N, Allocator>::allocator() const noexcept {
+  return alloc;
+}
+
+template <class type, std::size_t N, class Allocator>
+inline openlib::SmallArray<type, N, Allocator>::operator type*() const noexcept {
+  return buffer;
+}
+
+template <class type, std::size_t N, class Allocator>
+inline type& openlib::SmallArray<type, N, Allocator>::operator[](std::size_t position) noexcept {
+  return buffer[position];
+}
+
+template <class type, std::size_t N, class Allocator>
+inline const type& openlib::SmallArray<type, N, Allocator>::operator[](std::size_t position) const noexcept {
+  return buffer[position];
+}
+
+/**
+ * @brief equality
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, std::size_t N, class Allocator>
+inline bool operator==(const openlib::SmallArray<type, N, Allocator> &lhs,
+                       const openlib::SmallArray<type, N, Allocator> &rhs) {
+  return lhs.data() == rhs.data();
+}
+
+/**
+ * @brief inequality
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, std::size_t N, class Allocator>
+inline bool operator!=(const openlib::SmallArray<type, N, Allocator> &lhs,
+                       const openlib::SmallArray<type, N, Allocator> &rhs) {
+  return lhs.data() != rhs.data();
+}
+
+/**
+ * @brief less than
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, std::size_t N, class Allocator>
+inline bool operator<(const openlib::SmallArray<type, N, Allocator> &lhs,
+                      const openlib::SmallArray<type, N, Allocator> &rhs) {
+  return lhs.data() < rhs.data();
+}
@@ -0,0 +1,338 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <openlib/AlignedAllocator.h>
+#include <openlib/ArrayView.h>
+#include <openlib/FlatArray.h>
+
+namespace openlib {
+
+/**
+ * Structure-of-arrays container
+ *
+ * SoAArray<Fields...> stores field I of every row in its own cache-line
+ * aligned FlatArray, so a scan over one field reads only that field's
+ * memory and vectorizes like a loop over a plain FlatArray:
+ *
+ *   openlib::SoAArray<uint64_t, float, uint8_t> trades(n);
+ *   float total = openlib::sum(trades.column<1>());
+ *
+ * operator[] returns a proxy row for code that wants record-at-a-time
+ * access; get<I>() on the row is a reference into column I. A column can
+ * be written in one call with the typed bulk puts, which apply the
+ * serializer's byte order: serializer.putUInt16Array(array.column<I>()).
+ *
+ * Like FlatArray the number of rows is fixed at construction.
+ */
+template <class... Fields>
+class SoAArray final {
+public:
+  template <class Owner>
+  class RowReference;
+
+  /**
+   * @brief number of fields in a row
+   */
+  static constexpr std::size_t columnCount = sizeof...(Fields);
+
+  /**
+   * @brief type of field I
+   */
+  template <std::size_t I>
+  using Field = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+  /**
+   * @brief storage type of column I
+   */
+  template <std::size_t I>
+  using Column = FlatArray<Field<I>, AlignedAllocator<Field<I>>>;
+
+  /**
+   * @brief a row copied out of the array
+   */
+  using Row = std::tuple<Fields...>;
+
+  /**
+   * @brief constructor, every field is value-initialized
+   * @param size number of rows
+   */
+  explicit SoAArray(const std::size_t& size);
+
+  /**
+   * @brief constructor, every field is default-initialized
+   * @param size number of rows
+   */
+  SoAArray(const std::size_t& size, Uninitialized);
+
+  /**
+   * @brief Number of rows in the array
+   * @return the number of rows in the array
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief storage of field I, contiguous and cache-line aligned
+   * @return the column
+   */
+  template <std::size_t I>
+  Column<I>& column() noexcept;
+
+  /**
+   * @brief storage of field I, const
+   * @return the column
+   */
+  template <std::size_t I>
+  const Column<I>& column() const noexcept;
+
+  /**
+   * @brief Access a row at a given position
+   * @return a proxy for the row at the given position
+   */
+  RowReference<SoAArray> at(const std::size_t& position) noexcept;
+
+  /**
+   * @brief Access a const row at a given position
+   * @return a read-only proxy for the row at the given position
+   */
+  RowReference<const SoAArray> at(const std::size_t& position) const noexcept;
+
+  /**
+   * @brief copy a row out of the array
+   * @return the fields of the row at the given position
+   */
+  Row row(const std::size_t& position) const;
+
+  /**
+   * @brief fill every row with the same fields
+   */
+  void fill(const Fields&... fields);
+
+  /**
+   * @brief operator[]
+   */
+  RowReference<SoAArray> operator[](std::size_t position) noexcept;
+
+  /**
+   * @brief operator[] const
+   */
+  RowReference<const SoAArray> operator[](std::size_t position) const noexcept;
+
+  /**
+   * Proxy for one row of an SoAArray
+   *
+   * Holds the array and a row index; get<I>() reaches into column I.
+   * Assigning a Row writes every field, converting to Row reads them all.
+   */
+  template <class Owner>
+  class RowReference {
+  public:
+    RowReference(Owner& array, std::size_t position) noexcept;
+
+    /**
+     * @brief field I of the row
+     */
+    template <std::size_t I>
+    auto get() const noexcept -> decltype(std::declval<Owner&>().template column<I>()[0]);
+
+    /**
+     * @brief index of the row
+     */
+    std::size_t index() const noexcept;
+
+    /**
+     * @brief write every field of the row
+     */
+    const RowReference& operator=(const Row& row) const;
+
+    /**
+     * @brief read every field of the row
+     */
+    operator Row() const;
+
+  private:
+    Owner& array;
+    const std::size_t position;
+
+    template <std::size_t... I>
+    void assign(const Row& row, std::index_sequence<I...>) const;
+
+    template <std::size_t... I>
+    Row load(std::index_sequence<I...>) const;
+  };
+
+private:
+  std::size_t rows;
+  std::tuple<FlatArray<Fields, AlignedAllocator<Fields>>...> columns;
+
+  template <std::size_t... I>
+  void fillColumns(const Row& row, std::index_sequence<I...>);
+
+  // no copy or assignment
+  SoAArray(const SoAArray& other) = delete;
+  SoAArray& operator=(const SoAArray& other) = delete;
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class... Fields>
+constexpr std::size_t openlib::SoAArray<Fields...>::columnCount;
+
+template <class... Fields>
+openlib::SoAArray<Fields...>::SoAArray(const std::size_t& size):
+    rows(size),
+    columns(FlatArray<Fields, AlignedAllocator<Fields>>(size)...) {
+}
+
+template <class... Fields>
+openlib::SoAArray<Fields...>::SoAArray(const std::size_t& size, Uninitialized):
+    rows(size),
+    columns(FlatArray<Fields, AlignedAllocator<Fields>>(size, uninitialized)...) {
+}
+
+template <class... Fields>
+inline std::size_t openlib::SoAArray<Fields...>::size() const noexcept {
+  return rows;
+}
+
+template <class... Fields>
+template <std::size_t I>
+inline typename openlib::SoAArray<Fields...>::template Column<I>&
+openlib::SoAArray<Fields...>::column() noexcept {
+  return std::get<I>(columns);
+}
+
+template <class... Fields>
+template <std::size_t I>
+inline const typename openlib::SoAArray<Fields...>::template Column<I>&
+openlib::SoAArray<Fields...>::column() const noexcept {
+  return std::get<I>(columns);
+}
+
+template <class... Fields>
+inline typename openlib::SoAArray<Fields...>::template RowReference<openlib::SoAArray<Fields...>>
+openlib::SoAArray<Fields...>::at(const std::size_t& position) noexcept {
+  return RowReference<SoAArray>(*this, position);
+}
+
+template <class... Fields>
+inline typename openlib::SoAArray<Fields...>::template RowReference<const openlib::SoAArray<Fields...>>
+openlib::SoAArray<Fields...>::at(const std::size_t& position) const noexcept {
+  return RowReference<const SoAArray>(*this, position);
+}
+
+template <class... Fields>
+inline typename openlib::SoAArray<Fields...>::Row
+openlib::SoAArray<Fields...>::row(const std::size_t& position) const {
+  return at(position);
+}
+
+template <class... Fields>
+void openlib::SoAArray<Fields...>::fill(const Fields&... fields) {
+  fillColumns(Row(fields...), std::index_sequence_for<Fields...>());
+}
+
+template <class... Fields>
+template <std::size_t... I>
+void openlib::SoAArray<Fields...>::fillColumns(const Row& row, std::index_sequence<I...>) {
+  // expands to one column fill per field
+  int expand[] = {0, (std::get<I>(columns).fill(std::get<I>(row)), 0)...};
+  (void) expand;
+}
+
+template <class... Fields>
+inline typename openlib::SoAArray<Fields...>::template RowReference<openlib::SoAArray<Fields...>>
+openlib::SoAArray<Fields...>::operator[](std::size_t position) noexcept {
+  return at(position);
+}
+
+template <class... Fields>
+inline typename openlib::SoAArray<Fields...>::template RowReference<const openlib::SoAArray<Fields...>>
+openlib::SoAArray<Fields...>::operator[](std::size_t position) const noexcept {
+  return at(position);
+}
+
+template <class... Fields>
+template <class Owner>
+inline openlib::SoAArray<Fields...>::RowReference<Owner>::RowReference(Owner& array,
+                                                                       std::size_t position) noexcept:
+    array(array), position(position) {
+}
+
+template <class... Fields>
+template <class Owner>
+template <std::size_t I>
+inline auto openlib::SoAArray<Fields...>::RowReference<Owner>::get() const noexcept
+    -> decltype(std::declval<Owner&>().template column<I>()[0]) {
+  return array.template column<I>()[position];
+}
+
+template <class... Fields>
+template <class Owner>
+inline std::size_t openlib::SoAArray<Fields...>::RowReference<Owner>::index() const noexcept {
+  return position;
+}
+
+template <class... Fields>
+template <class Owner>
+inline const typename openlib::SoAArray<Fields...>::template RowReference<Owner>&
+openlib::SoAArray<Fields...>::RowReference<Owner>::operator=(const Row& row) const {
+  static_assert(!std::is_const<Owner>::value, "cannot assign through a const row");
+  assign(row, std::index_sequence_for<Fields...>());
+  return *this;
+}
+
+template <class... Fields>
+template <class Owner>
+inline openlib::SoAArray<Fields...>::RowReference<Owner>::operator Row() const {
+  return load(std::index_sequence_for<Fields...>());
+}
+
+template <class... Fields>
+template <class Owner>
+template <std::size_t... I>
+inline void openlib::SoAArray<Fields...>::RowReference<Owner>::assign(
+    const Row& row, std::index_sequence<I...>) const {
+  int expand[] = {0, (get<I>() = std::get<I>(row), 0)...};
+  (void) expand;
+}
+
+template <class... Fields>
+template <class Owner>
+template <std::size_t... I>
+inline typename openlib::SoAArray<Fields...>::Row
+openlib::SoAArray<Fields...>::RowReference<Owner>::load(std::index_sequence<I...>) const {
+  return Row(get<I>()...);
+}
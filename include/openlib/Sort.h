@@ -0,0 +1,328 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <openlib/FlatArray.h>
+#include <openlib/ThreadPool.h>
+
+namespace openlib {
+
+/**
+ * @brief sort an array in ascending order
+ * Integer and floating point elements are sorted with an LSD radix sort,
+ * anything else with std::sort. Floats are ordered by IEEE totalOrder:
+ * -NaN < -inf < ... < -0 < +0 < ... < inf < NaN. Not stable for non
+ * numeric elements.
+ * @param array FlatArray, Array, or anything with data() and size()
+ */
+template <class ArrayType>
+void sort(ArrayType& array);
+
+/**
+ * @brief sort keys in ascending order and move values along with them
+ * Stable: values with equal keys keep their order. Keys must be integers
+ * or floating point, ordered as in sort().
+ * @throws std::length_error if keys and values differ in size
+ */
+template <class KeyArray, class ValueArray>
+void sortByKey(KeyArray& keys, ValueArray& values);
+
+namespace detail {
+
+/**
+ * Maps keys to unsigned integers with the same order, so the radix sort
+ * only ever compares unsigned bytes
+ */
+template <class type, class Enable = void>
+struct RadixKey {
+  static const bool value = false;
+};
+
+template <class type>
+struct RadixKey<type, typename std::enable_if<std::is_integral<type>::value &&
+                                              !std::is_same<type, bool>::value>::type> {
+  static const bool value = true;
+  typedef typename std::make_unsigned<type>::type Bits;
+
+  static Bits encode(type key) {
+    // flipping the sign bit moves negative numbers below positive ones
+    return std::is_signed<type>::value ? Bits(Bits(key) ^ signBit()) : Bits(key);
+  }
+
+  static type decode(Bits bits) {
+    return std::is_signed<type>::value ? type(Bits(bits ^ signBit())) : type(bits);
+  }
+
+  static constexpr Bits signBit() {
+    return Bits(Bits(1) << (8 * sizeof(Bits) - 1));
+  }
+};
+
+template <class type>
+struct RadixKey<type, typename std::enable_if<std::is_floating_point<type>::value &&
+                                              (sizeof(type) == 4 || sizeof(type) == 8)>::type> {
+  static const bool value = true;
+  typedef typename std::conditional<sizeof(type) == 4, uint32_t, uint64_t>::type Bits;
+
+  static Bits encode(type key) {
+    Bits bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    // negative values reverse order, positive values go above them
+    return (bits & signBit()) ? Bits(~bits) : Bits(bits | signBit());
+  }
+
+  static type decode(Bits bits) {
+    bits = (bits & signBit()) ? Bits(bits ^ signBit()) : Bits(~bits);
+    type key;
+    std::memcpy(&key, &bits, sizeof(key));
+    return key;
+  }
+
+  static constexpr Bits signBit() {
+    return Bits(Bits(1) << (8 * sizeof(Bits) - 1));
+  }
+};
+
+/**
+ * @brief value type for a radix sort of keys alone
+ */
+struct NoValues {};
+
+/**
+ * @brief below this many keys sort() uses a comparison sort
+ */
+const std::size_t RADIX_SORT_MIN_SIZE = 2048;
+
+/**
+ * @brief LSD radix sort over 8-bit digits
+ * Every digit histogram is built in one read of the keys, and digits in
+ * which all keys agree are skipped. With chunks > 1 the keys are split
+ * into that many ranges which are counted and scattered on pool, each
+ * chunk writing to its own part of every bucket so the sort stays stable.
+ * @param values values moved along with the keys, or nullptr
+ */
+template <class Key, class Value>
+void radixSort(Key* keys, Value* values, std::size_t size, ThreadPool* pool, std::size_t chunks);
+
+template <class type>
+void sortArray(type* data, std::size_t size, std::true_type);
+
+template <class type>
+void sortArray(type* data, std::size_t size, std::false_type);
+
+} // namespace detail
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, class Enable>
+const bool openlib::detail::RadixKey<type, Enable>::value;
+
+template <class type>
+const bool openlib::detail::RadixKey<
+    type, typename std::enable_if<std::is_integral<type>::value &&
+                                  !std::is_same<type, bool>::value>::type>::value;
+
+template <class type>
+const bool openlib::detail::RadixKey<
+    type, typename std::enable_if<std::is_floating_point<type>::value &&
+                                  (sizeof(type) == 4 || sizeof(type) == 8)>::type>::value;
+
+template <class Key, class Value>
+void openlib::detail::radixSort(Key* keys, Value* values, std::size_t size, ThreadPool* pool,
+                                std::size_t chunks) {
+  typedef RadixKey<Key> Traits;
+  typedef typename Traits::Bits Bits;
+  const std::size_t RADIX = 256;
+  const std::size_t DIGITS = sizeof(Bits);
+  const bool hasValues = values != nullptr;
+
+  chunks = std::max<std::size_t>(1, std::min(chunks, size));
+  const std::size_t chunkSize = size == 0 ? 0 : (size + chunks - 1) / chunks;
+  chunks = size == 0 ? 1 : (size + chunkSize - 1) / chunkSize;
+  auto run = [&](auto function) {
+    auto body = [&](std::size_t chunk) {
+      const std::size_t begin = chunk * chunkSize;
+      function(chunk, begin, std::min(begin + chunkSize, size));
+    };
+    if (pool && chunks > 1) {
+      pool->parallelFor(chunks, body);
+    } else {
+      for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+        body(chunk);
+      }
+    }
+  };
+
+  // The caller's keys and values are one of the two buffers of every
+  // pass, so the only scratch is one more array of each. Encoded keys are
+  // stored over the keys with memcpy, since floats and their bits are
+  // different types.
+  auto load = [](const uint8_t* buffer, std::size_t i) {
+    Bits bits;
+    std::memcpy(&bits, buffer + i * sizeof(Bits), sizeof(Bits));
+    return bits;
+  };
+  auto store = [](uint8_t* buffer, std::size_t i, Bits bits) {
+    std::memcpy(buffer + i * sizeof(Bits), &bits, sizeof(Bits));
+  };
+
+  // everything is allocated before the keys are encoded, so a bad_alloc
+  // leaves them untouched
+  // counts[(chunk * DIGITS + digit) * RADIX + byte]
+  FlatArray<std::size_t> counts(chunks * DIGITS * RADIX);
+  FlatArray<std::size_t> offsets(chunks * RADIX, uninitialized);
+  FlatArray<Bits> bitsScratch(size, uninitialized);
+  FlatArray<Value> valuesScratch(hasValues ? size : 0, uninitialized);
+  uint8_t* const bitsKeys = reinterpret_cast<uint8_t*>(keys);
+
+  // encode the keys in place and count every digit in a single read
+  run([&](std::size_t chunk, std::size_t begin, std::size_t end) {
+    std::size_t* count = counts.data() + chunk * DIGITS * RADIX;
+    for (std::size_t i = begin; i < end; i++) {
+      const Bits key = Traits::encode(keys[i]);
+      store(bitsKeys, i, key);
+      for (std::size_t digit = 0; digit < DIGITS; digit++) {
+        count[digit * RADIX + ((key >> (8 * digit)) & 0xff)]++;
+      }
+    }
+  });
+
+  uint8_t* bitsFrom = bitsKeys;
+  uint8_t* bitsTo = reinterpret_cast<uint8_t*>(bitsScratch.data());
+  Value* valuesFrom = values;
+  Value* valuesTo = valuesScratch.data();
+  bool sorted = false;
+
+  for (std::size_t digit = 0; digit < DIGITS; digit++) {
+    const std::size_t shift = 8 * digit;
+
+    // with one chunk the histogram does not depend on the order, with
+    // several it has to be recounted after every pass that moved keys
+    if (sorted && chunks > 1) {
+      run([&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        std::size_t* count = counts.data() + (chunk * DIGITS + digit) * RADIX;
+        std::fill(count, count + RADIX, std::size_t(0));
+        for (std::size_t i = begin; i < end; i++) {
+          count[(load(bitsFrom, i) >> shift) & 0xff]++;
+        }
+      });
+    }
+
+    // skip digits every key agrees on, the order is already right
+    std::size_t offset = 0;
+    bool skip = false;
+    for (std::size_t byte = 0; byte < RADIX && !skip; byte++) {
+      std::size_t total = 0;
+      for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+        const std::size_t count = counts.data()[(chunk * DIGITS + digit) * RADIX + byte];
+        offsets.data()[chunk * RADIX + byte] = offset + total;
+        total += count;
+      }
+      skip = total == size;
+      offset += total;
+    }
+    if (skip) {
+      continue;
+    }
+
+    run([&](std::size_t chunk, std::size_t begin, std::size_t end) {
+      std::size_t* offset = offsets.data() + chunk * RADIX;
+      for (std::size_t i = begin; i < end; i++) {
+        const Bits key = load(bitsFrom, i);
+        const std::size_t position = offset[(key >> shift) & 0xff]++;
+        store(bitsTo, position, key);
+        if (hasValues) {
+          valuesTo[position] = std::move(valuesFrom[i]);
+        }
+      }
+    });
+
+    std::swap(bitsFrom, bitsTo);
+    std::swap(valuesFrom, valuesTo);
+    sorted = true;
+  }
+
+  // decode into the keys, a no-op for unsigned keys that ended up there
+  const bool inPlace = bitsFrom == bitsKeys;
+  if (inPlace && std::is_unsigned<Key>::value) {
+    return;
+  }
+  run([&](std::size_t, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+      keys[i] = Traits::decode(load(bitsFrom, i));
+    }
+    if (hasValues && !inPlace) {
+      std::move(valuesFrom + begin, valuesFrom + end, values + begin);
+    }
+  });
+}
+
+template <class type>
+void openlib::detail::sortArray(type* data, std::size_t size, std::true_type) {
+  typedef RadixKey<type> Traits;
+  if (size < RADIX_SORT_MIN_SIZE) {
+    // same order as the radix sort, which differs from < for floats
+    std::sort(data, data + size, [](const type& lhs, const type& rhs) {
+      return Traits::encode(lhs) < Traits::encode(rhs);
+    });
+    return;
+  }
+  radixSort(data, static_cast<NoValues*>(nullptr), size, nullptr, 1);
+}
+
+template <class type>
+void openlib::detail::sortArray(type* data, std::size_t size, std::false_type) {
+  std::sort(data, data + size);
+}
+
+template <class ArrayType>
+void openlib::sort(ArrayType& array) {
+  auto data = array.data();
+  using type = typename std::remove_reference<decltype(*data)>::type;
+  detail::sortArray(data, array.size(), std::integral_constant<bool, detail::RadixKey<type>::value>());
+}
+
+template <class KeyArray, class ValueArray>
+void openlib::sortByKey(KeyArray& keys, ValueArray& values) {
+  using Key = typename std::remove_reference<decltype(*keys.data())>::type;
+  static_assert(detail::RadixKey<Key>::value, "sortByKey needs integer or floating point keys");
+  if (keys.size() != values.size()) {
+    throw std::length_error("keys and values differ in size");
+  }
+  detail::radixSort(keys.data(), values.data(), keys.size(), nullptr, 1);
+}
@@ -0,0 +1,291 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include <openlib/Kernels.h>
+
+namespace openlib {
+
+/**
+ * Fixed-size array with inline storage
+ *
+ * Same accessor interface as openlib::FlatArray, but the size is a
+ * template parameter and the elements live inside the object, so a
+ * StaticArray never allocates. size() is a constant expression.
+ *
+ * StaticArray is an aggregate and every accessor is constexpr, so it can
+ * be built and read at compile time:
+ *
+ *   constexpr openlib::StaticArray<int, 3> primes = {2, 3, 5};
+ *   static_assert(primes[2] == 5, "");
+ */
+template <class type, std::size_t N>
+struct StaticArray final {
+
+  /**
+   * @brief guaranteed alignment of data(), in bytes
+   */
+  static constexpr std::size_t alignment = alignof(type);
+
+  /**
+   * @brief Number of elements in the array
+   * @return the number of elements in the array
+   */
+  static constexpr std::size_t size() noexcept;
+
+  /**
+   * @brief Access element at a given position
+   * @return a reference to the element at the given position
+   */
+  constexpr type& at(const std::size_t& position) noexcept;
+
+  /**
+   * @brief Access const element at a given position
+   * @return a const reference to the element at the given position
+   */
+  constexpr const type& at(const std::size_t& position) const noexcept;
+
+  /**
+   * @brief The first element
+   * @return a reference to the first element
+   */
+  constexpr type& front() noexcept;
+
+  /**
+   * @brief The first element, const
+   * @return a const reference to the first element
+   */
+  constexpr const type& front() const noexcept;
+
+  /**
+   * @brief The last element
+   * @return a reference to the last element
+   */
+  constexpr type& back() noexcept;
+
+  /**
+   * @brief The last element, const
+   * @return a const reference to the last element
+   */
+  constexpr const type& back() const noexcept;
+
+  /**
+   * @brief Returns a pointer to the underlying array
+   * @returns a pointer to the underlying array
+   */
+  constexpr type* data() noexcept;
+
+  /**
+   * @brief Returns a const pointer to the underlying array
+   * @returns a const pointer to the underlying array
+   */
+  constexpr const type* data() const noexcept;
+
+  /**
+   * @brief Get a pointer to the first element
+   * @return a pointer to the first element
+   */
+  constexpr type* begin() noexcept;
+
+  /**
+   * @brief Get a const pointer to the first element
+   * @return a const pointer to the first element
+   */
+  constexpr const type* begin() const noexcept;
+
+  /**
+   * @brief Get a pointer to one past the last element
+   * @return a pointer to one past the last element
+   */
+  constexpr type* end() noexcept;
+
+  /**
+   * @brief Get a const pointer to one past the last element
+   * @return a const pointer to one past the last element
+   */
+  constexpr const type* end() const noexcept;
+
+  /**
+   * @brief fill each element of the array with the same value
+   * @param value a value to fill the array with
+   */
+  void fill(const type& value);
+
+  /**
+   * @brief auto cast to pointer to base type
+   */
+  constexpr operator type*() noexcept;
+
+  /**
+   * @brief auto cast to const pointer to base type
+   */
+  constexpr operator const type*() const noexcept;
+
+  /**
+   * @brief operator[]
+   */
+  constexpr type& operator[](std::size_t position) noexcept;
+
+  /**
+   * @brief operator[] const
+   */
+  constexpr const type& operator[](std::size_t position) const noexcept;
+
+  // public only so StaticArray is an aggregate, use data() instead
+  type elements[N > 0 ? N : 1];
+};
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class type, std::size_t N>
+constexpr std::size_t openlib::StaticArray<type, N>::alignment;
+
+template <class type, std::size_t N>
+inline constexpr std::size_t openlib::StaticArray<type, N>::size() noexcept {
+  return N;
+}
+
+template <class type, std::size_t N>
+inline constexpr type& openlib::StaticArray<type, N>::at(const std::size_t& position) noexcept {
+  return elements[position];
+}
+
+template <class type, std::size_t N>
+inline constexpr const type& openlib::StaticArray<type, N>::at(const std::size_t& position) const noexcept {
+  return elements[position];
+}
+
+template <class type, std::size_t N>
+inline constexpr type& openlib::StaticArray<type, N>::front() noexcept {
+  return elements[0];
+}
+
+template <class type, std::size_t N>
+inline constexpr const type& openlib::StaticArray<type, N>::front() const noexcept {
+  return elements[0];
+}
+
+template <class type, std::size_t N>
+inline constexpr type& openlib::StaticArray<type, N>::back() noexcept {
+  return elements[N - 1];
+}
+
+template <class type, std::size_t N>
+inline constexpr const type& openlib::StaticArray<type, N>::back() const noexcept {
+  return elements[N - 1];
+}
+
+template <class type, std::size_t N>
+inline constexpr type* openlib::StaticArray<type, N>::data() noexcept {
+  return elements;
+}
+
+template <class type, std::size_t N>
+inline constexpr const type* openlib::StaticArray<type, N>::data() const noexcept {
+  return elements;
+}
+
+template <class type, std::size_t N>
+inline constexpr type* openlib::StaticArray<type, N>::begin() noexcept {
+  return elements;
+}
+
+template <class type, std::size_t N>
+inline constexpr const type* openlib::StaticArray<type, N>::begin() const noexcept {
+  return elements;
+}
+
+template <class type, std::size_t N>
+inline constexpr type* openlib::StaticArray<type, N>::end() noexcept {
+  return elements + N;
+}
+
+template <class type, std::size_t N>
+inline constexpr const type* openlib::StaticArray<type, N>::end() const noexcept {
+  return elements + N;
+}
+
+template <class type, std::size_t N>
+inline void openlib::StaticArray<type, N>::fill(const type& value) {
+  kernels::detail::fillArray(elements, value, N, std::is_trivially_copyable<type>());
+}
+
+template <class type, std::size_t N>
+inline constexpr openlib::StaticArray<type, N>::operator type*() noexcept {
+  return elements;
+}
+
+template <class type, std::size_t N>
+inline constexpr openlib::StaticArray<type, N>::operator const type*() const noexcept {
+  return elements;
+}
+
+template <class type, std::size_t N>
+inline constexpr type& openlib::StaticArray<type, N>::operator[](std::size_t position) noexcept {
+  return elements[position];
+}
+
+template <class type, std::size_t N>
+inline constexpr const type& openlib::StaticArray<type, N>::operator[](std::size_t position) const noexcept {
+  return elements[position];
+}
+
+/**
+ * @brief equality
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, std::size_t N>
+inline bool operator==(const openlib::StaticArray<type, N> &lhs,
+                       const openlib::StaticArray<type, N> &rhs) {
+  return lhs.data() == rhs.data();
+}
+
+/**
+ * @brief inequality
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, std::size_t N>
+inline bool operator!=(const openlib::StaticArray<type, N> &lhs,
+                       const openlib::StaticArray<type, N> &rhs) {
+  return lhs.data() != rhs.data();
+}
+
+/**
+ * @brief less than
+ * Determined by looking at the location of the underling data's memory location
+ */
+template <class type, std::size_t N>
+inline bool operator<(const openlib::StaticArray<type, N> &lhs,
+                      const openlib::StaticArray<type, N> &rhs) {
+  return lhs.data() < rhs.data();
+}
@@ -0,0 +1,124 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openlib {
+
+/**
+ * Work-stealing thread pool
+ *
+ * Every worker owns a task deque. Workers take their own newest task first
+ * (cache-warm) and, when idle, steal the oldest task from another worker.
+ * Tasks submitted from outside the pool go to a shared injection deque.
+ *
+ * A thread waiting in parallelFor() runs tasks too, so a pool of N threads
+ * starts N - 1 workers and nested parallelFor() calls cannot deadlock.
+ */
+class ThreadPool final {
+public:
+
+  /**
+   * @brief constructor
+   * @param threads total threads doing work, including the caller of
+   *                parallelFor(). 0 means one per hardware thread.
+   */
+  explicit ThreadPool(std::size_t threads = 0);
+
+  /**
+   * @brief destructor, waits for queued tasks and joins the workers
+   */
+  ~ThreadPool();
+
+  /**
+   * @brief total threads doing work, including the waiting caller
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief queue a task
+   * The task must not throw: an exception escaping it calls std::terminate,
+   * on whichever thread ran it. Use parallelFor() to get exceptions back.
+   * @param task task to run on some thread of the pool
+   */
+  void submit(std::function<void()> task);
+
+  /**
+   * @brief run function(i) for every i in [0, count) and wait for all of them
+   * The calling thread runs tasks while it waits. If function throws, the
+   * first exception is rethrown here once every task has finished. If a
+   * task cannot be queued, the tasks already queued finish and the
+   * queueing error is rethrown, so some indexes may not have run.
+   * @param count number of tasks
+   * @param function task body
+   */
+  void parallelFor(std::size_t count, const std::function<void(std::size_t)>& function);
+
+  /**
+   * @brief pool shared by the parallel algorithms in Parallel.h
+   * Sized by the OPENLIB_THREADS environment variable, or one thread per
+   * hardware thread when it is not set.
+   */
+  static ThreadPool& shared();
+
+private:
+  struct Queue {
+    std::mutex lock;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  const std::size_t threadCount;
+  std::vector<std::unique_ptr<Queue>> queues;  // one per worker, plus injection
+  std::vector<std::thread> workers;
+
+  std::atomic<std::size_t> queued;
+  std::atomic<bool> stopping;
+  std::mutex sleepLock;
+  std::condition_variable wake;
+
+  // queue index of the calling thread, the injection queue for non-workers
+  std::size_t currentQueue() const;
+
+  // run one task from queue self, or stolen from another; false if none
+  bool runOne(std::size_t self);
+
+  void workerLoop(std::size_t self);
+
+  // no copy or assignment
+  ThreadPool(const ThreadPool& other) = delete;
+  ThreadPool& operator=(const ThreadPool& other) = delete;
+};
+
+} // namespace openlib
@@ -0,0 +1,566 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <openlib/ArrayView.h>
+#include <openlib/ByteOrder.h>
+
+namespace openlib {
+
+/**
+ * Inline writer of Serializer's wire format into a borrowed buffer
+ *
+ * Fields are written in the byte order of the Order policy, see
+ * ByteOrder. Writer writes Serializer's own format, big endian integers
+ * and host order floats.
+ *
+ * Writer is the non-virtual write path under Serializer. The put* methods
+ * check capacity on every call, like Serializer's. For hot loops, reserve()
+ * checks once for a whole record and the write* methods that follow are
+ * unchecked stores:
+ *
+ *   writer.reserve(sizeof(uint32_t) + sizeof(uint64_t));
+ *   writer.writeUInt32(id);
+ *   writer.writeUInt64(timestamp);
+ *
+ * Writing more than was reserved is undefined behaviour. The buffer must
+ * outlive the Writer.
+ */
+template <class Order>
+class BasicWriter final
+{
+public:
+
+  static const std::size_t MAX_STRING_LENGTH = UINT16_MAX;
+
+  /**
+   * @brief construct a Writer over capacity bytes at data
+   * @param data buffer to write into, not owned
+   * @param capacity size of the buffer, in bytes
+   */
+  BasicWriter(void* data, std::size_t capacity) noexcept;
+
+  /**
+   * @brief construct a Writer over a writable view
+   * @param bytes buffer to write into, see asWritableBytes()
+   */
+  explicit BasicWriter(ArrayView<uint8_t> bytes) noexcept;
+
+  /**
+   * @brief get the number of bytes written, in bytes
+   * @return size, in bytes
+   */
+  std::size_t size() const noexcept;
+
+  /**
+   * @brief get the total capacity, in bytes
+   * @return capacity, in bytes
+   */
+  std::size_t capacity() const noexcept;
+
+  /**
+   * @brief get the remaining capacity, in bytes
+   * @return remaining capacity, in bytes
+   */
+  std::size_t remaining() const noexcept;
+
+  /**
+   * @brief check that bytes more bytes fit, before unchecked write* calls
+   * @param bytes number of bytes about to be written
+   * @throws std::length_error if fewer than bytes remain
+   */
+  void reserve(std::size_t bytes);
+
+  /** @brief write a char, unchecked, see reserve() */
+  void writeChar(char data) noexcept;
+
+  /** @brief write a int8_t, unchecked, see reserve() */
+  void writeInt8(int8_t data) noexcept;
+
+  /** @brief write a uint8_t, unchecked, see reserve() */
+  void writeUInt8(uint8_t data) noexcept;
+
+  /** @brief write a int16_t, unchecked, see reserve() */
+  void writeInt16(int16_t data) noexcept;
+
+  /** @brief write a uint16_t, unchecked, see reserve() */
+  void writeUInt16(uint16_t data) noexcept;
+
+  /** @brief write a int32_t, unchecked, see reserve() */
+  void writeInt32(int32_t data) noexcept;
+
+  /** @brief write a uint32_t, unchecked, see reserve() */
+  void writeUInt32(uint32_t data) noexcept;
+
+  /** @brief write a int64_t, unchecked, see reserve() */
+  void writeInt64(int64_t data) noexcept;
+
+  /** @brief write a uint64_t, unchecked, see reserve() */
+  void writeUInt64(uint64_t data) noexcept;
+
+  /** @brief write a float, unchecked, see reserve() */
+  void writeFloat(float data) noexcept;
+
+  /** @brief write a double, unchecked, see reserve() */
+  void writeDouble(double data) noexcept;
+
+  /** @brief write size raw bytes, unchecked, see reserve() */
+  void write(const void* data, std::size_t size) noexcept;
+
+  /**
+   * @brief put a char into the buffer
+   * @param data data
+   */
+  void putChar(char data);
+
+  /**
+   * @brief put a int8_t into the buffer
+   * @param data data
+   */
+  void putInt8(int8_t data);
+
+  /**
+   * @brief put a uint8_t into the buffer
+   * @param data data
+   */
+  void putUInt8(uint8_t data);
+
+  /**
+   * @brief put a int16_t into the buffer
+   * @param data data
+   */
+  void putInt16(int16_t data);
+
+  /**
+   * @brief put a uint16_t into the buffer
+   * @param data data
+   */
+  void putUInt16(uint16_t data);
+
+  /**
+   * @brief put a int32_t into the buffer
+   * @param data data
+   */
+  void putInt32(int32_t data);
+
+  /**
+   * @brief put a uint32_t into the buffer
+   * @param data data
+   */
+  void putUInt32(uint32_t data);
+
+  /**
+   * @brief put a int64_t into the buffer
+   * @param data data
+   */
+  void putInt64(int64_t data);
+
+  /**
+   * @brief put a uint64_t into the buffer
+   * @param data data
+   */
+  void putUInt64(uint64_t data);
+
+  /**
+   * @brief put a float into the buffer
+   * @param data data
+   */
+  void putFloat(float data);
+
+  /**
+   * @brief put a double into the buffer
+   * @param data data
+   */
+  void putDouble(double data);
+
+  /**
+   * @brief put a uint16_t length followed by the characters into the buffer
+   * @param data data
+   * @throws std::length_error if longer than MAX_STRING_LENGTH
+   */
+  void putString(const std::string& data);
+
+  /**
+   * @brief put size raw bytes into the buffer
+   * @param data data
+   * @param size number of bytes
+   */
+  void put(const void* data, std::size_t size);
+
+  /**
+   * @brief put count elements with a single capacity check
+   * Byte swapped with the vector kernels if Order needs it, else copied.
+   * @param data first element
+   * @param count number of elements
+   */
+  void putInt16Array(const int16_t* data, std::size_t count);
+  void putUInt16Array(const uint16_t* data, std::size_t count);
+  void putInt32Array(const int32_t* data, std::size_t count);
+  void putUInt32Array(const uint32_t* data, std::size_t count);
+  void putInt64Array(const int64_t* data, std::size_t count);
+  void putUInt64Array(const uint64_t* data, std::size_t count);
+  void putFloatArray(const float* data, std::size_t count);
+  void putDoubleArray(const double* data, std::size_t count);
+
+  /**
+   * @brief put every element of an array or view, see putInt16Array()
+   * @param data elements to put
+   */
+  void putInt16Array(ArrayView<const int16_t> data);
+  void putUInt16Array(ArrayView<const uint16_t> data);
+  void putInt32Array(ArrayView<const int32_t> data);
+  void putUInt32Array(ArrayView<const uint32_t> data);
+  void putInt64Array(ArrayView<const int64_t> data);
+  void putUInt64Array(ArrayView<const uint64_t> data);
+  void putFloatArray(ArrayView<const float> data);
+  void putDoubleArray(ArrayView<const double> data);
+
+  /**
+   * @brief view of the bytes written so far, without copying
+   * @return view of the first size() bytes of the buffer
+   */
+  ArrayView<const uint8_t> view() const noexcept;
+
+  /**
+   * @brief get the raw buffer
+   * @return pointer to the buffer
+   */
+  uint8_t* data() const noexcept;
+
+private:
+
+  uint8_t* begin;
+  uint8_t* position;
+  uint8_t* end;
+
+  template <class type>
+  void store(type data) noexcept;
+
+  template <class type>
+  void putArray(const type* data, std::size_t count);
+};
+
+typedef BasicWriter<BigEndianIntegers> Writer;
+
+} // namespace openlib
+
+///////////////////////////////////////////////////////////////////////////////
+// Definition complete, implemention below
+///////////////////////////////////////////////////////////////////////////////
+
+template <class Order>
+const std::size_t openlib::BasicWriter<Order>::MAX_STRING_LENGTH;
+
+template <class Order>
+inline openlib::BasicWriter<Order>::BasicWriter(void* data, std::size_t capacity) noexcept:
+    begin(static_cast<uint8_t*>(data)), position(begin), end(begin + capacity) {
+}
+
+template <class Order>
+inline openlib::BasicWriter<Order>::BasicWriter(ArrayView<uint8_t> bytes) noexcept:
+    BasicWriter(bytes.data(), bytes.size()) {
+}
+
+template <class Order>
+inline std::size_t openlib::BasicWriter<Order>::size() const noexcept {
+  return position - begin;
+}
+
+template <class Order>
+inline std::size_t openlib::BasicWriter<Order>::capacity() const noexcept {
+  return end - begin;
+}
+
+template <class Order>
+inline std::size_t openlib::BasicWriter<Order>::remaining() const noexcept {
+  return end - position;
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::reserve(std::size_t bytes) {
+  if (__builtin_expect(remaining() < bytes, 0)) {
+    throw std::length_error("not enough capacity left in Serializer");
+  }
+}
+
+template <class Order>
+template <class type>
+inline void openlib::BasicWriter<Order>::store(type data) noexcept {
+  data = Order::convert(data);
+  std::memcpy(position, &data, sizeof(data));
+  position += sizeof(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeChar(char data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeInt8(int8_t data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeUInt8(uint8_t data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeInt16(int16_t data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeUInt16(uint16_t data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeInt32(int32_t data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeUInt32(uint32_t data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeInt64(int64_t data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeUInt64(uint64_t data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeFloat(float data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::writeDouble(double data) noexcept {
+  store(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::write(const void* data, std::size_t size) noexcept {
+  if (size != 0) {
+    std::memcpy(position, data, size);
+    position += size;
+  }
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putChar(char data) {
+  reserve(sizeof(data));
+  writeChar(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putInt8(int8_t data) {
+  reserve(sizeof(data));
+  writeInt8(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putUInt8(uint8_t data) {
+  reserve(sizeof(data));
+  writeUInt8(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putInt16(int16_t data) {
+  reserve(sizeof(data));
+  writeInt16(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putUInt16(uint16_t data) {
+  reserve(sizeof(data));
+  writeUInt16(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putInt32(int32_t data) {
+  reserve(sizeof(data));
+  writeInt32(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putUInt32(uint32_t data) {
+  reserve(sizeof(data));
+  writeUInt32(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putInt64(int64_t data) {
+  reserve(sizeof(data));
+  writeInt64(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putUInt64(uint64_t data) {
+  reserve(sizeof(data));
+  writeUInt64(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putFloat(float data) {
+  reserve(sizeof(data));
+  writeFloat(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putDouble(double data) {
+  reserve(sizeof(data));
+  writeDouble(data);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putString(const std::string& data) {
+  if (MAX_STRING_LENGTH < data.length()) {
+    throw std::length_error("string cannot exceed MAX_STRING_LENGTH");
+  }
+
+  reserve(sizeof(uint16_t) + data.length());
+  writeUInt16(static_cast<uint16_t>(data.length()));
+  write(data.data(), data.length());
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::put(const void* data, std::size_t size) {
+  reserve(size);
+  write(data, size);
+}
+
+template <class Order>
+template <class type>
+inline void openlib::BasicWriter<Order>::putArray(const type* data, std::size_t count) {
+  if (__builtin_expect(remaining() / sizeof(type) < count, 0)) {
+    throw std::length_error("not enough capacity left in Serializer");
+  }
+  Order::template convert<type>(position, data, count);
+  position += count * sizeof(type);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putInt16Array(const int16_t* data, std::size_t count) {
+  putArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putUInt16Array(const uint16_t* data, std::size_t count) {
+  putArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putInt32Array(const int32_t* data, std::size_t count) {
+  putArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putUInt32Array(const uint32_t* data, std::size_t count) {
+  putArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putInt64Array(const int64_t* data, std::size_t count) {
+  putArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putUInt64Array(const uint64_t* data, std::size_t count) {
+  putArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putFloatArray(const float* data, std::size_t count) {
+  putArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putDoubleArray(const double* data, std::size_t count) {
+  putArray(data, count);
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putInt16Array(ArrayView<const int16_t> data) {
+  putArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putUInt16Array(ArrayView<const uint16_t> data) {
+  putArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putInt32Array(ArrayView<const int32_t> data) {
+  putArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putUInt32Array(ArrayView<const uint32_t> data) {
+  putArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putInt64Array(ArrayView<const int64_t> data) {
+  putArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putUInt64Array(ArrayView<const uint64_t> data) {
+  putArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putFloatArray(ArrayView<const float> data) {
+  putArray(data.data(), data.size());
+}
+
+template <class Order>
+inline void openlib::BasicWriter<Order>::putDoubleArray(ArrayView<const double> data) {
+  putArray(data.data(), data.size());
+}
+
+template <class Order>
+inline openlib::ArrayView<const uint8_t> openlib::BasicWriter<Order>::view() const noexcept {
+  return ArrayView<const uint8_t>(begin, size());
+}
+
+template <class Order>
+inline uint8_t* openlib::BasicWriter<Order>::data() const noexcept {
+  return begin;
+}
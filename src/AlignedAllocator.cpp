@@ -0,0 +1,98 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <sys/mman.h>
+
+#include "openlib/AlignedAllocator.h"
+
+namespace {
+
+std::size_t roundUp(std::size_t value, std::size_t multiple) {
+  return (value + multiple - 1) & ~(multiple - 1);
+}
+
+} // namespace
+
+void* openlib::alignedAllocate(std::size_t bytes, std::size_t alignment) {
+  if (alignment < sizeof(void*)) {
+    alignment = sizeof(void*);
+  }
+
+  void* p = nullptr;
+  std::size_t size = roundUp(bytes == 0 ? 1 : bytes, alignment);
+  if (posix_memalign(&p, alignment, size) != 0) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void openlib::alignedDeallocate(void* p) noexcept {
+  std::free(p);
+}
+
+void* openlib::mapPages(std::size_t bytes, bool hugePages) {
+  const std::size_t granularity = hugePages ? HUGE_PAGE_BYTES : PAGE_BYTES;
+  const std::size_t size = roundUp(bytes == 0 ? 1 : bytes, granularity);
+
+  if (!hugePages) {
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    return p;
+  }
+
+  // over-map by one huge page, then trim to a huge page boundary
+  const std::size_t mapped = size + HUGE_PAGE_BYTES;
+  void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+
+  std::uintptr_t start = reinterpret_cast<std::uintptr_t>(p);
+  std::uintptr_t aligned = roundUp(start, HUGE_PAGE_BYTES);
+  if (aligned > start) {
+    munmap(p, aligned - start);
+  }
+  std::size_t tail = (start + mapped) - (aligned + size);
+  if (tail > 0) {
+    munmap(reinterpret_cast<void*>(aligned + size), tail);
+  }
+
+#ifdef MADV_HUGEPAGE
+  // a hint only, fails harmlessly when transparent huge pages are disabled
+  madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE);
+#endif
+  return reinterpret_cast<void*>(aligned);
+}
+
+void openlib::unmapPages(void* p, std::size_t bytes, bool hugePages) noexcept {
+  const std::size_t granularity = hugePages ? HUGE_PAGE_BYTES : PAGE_BYTES;
+  munmap(p, roundUp(bytes == 0 ? 1 : bytes, granularity));
+}
@@ -0,0 +1,86 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <limits>
+#include <new>
+
+#include "openlib/Arena.h"
+
+const std::size_t openlib::Arena::DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+openlib::Arena::Arena(const std::size_t& blockSize):
+    blockSize(blockSize), blocks(nullptr), cursor(0), limit(0), bytesAllocated(0) {
+
+}
+
+openlib::Arena::~Arena() {
+  while (blocks != nullptr) {
+    Block* next = blocks->next;
+    ::operator delete(blocks);
+    blocks = next;
+  }
+}
+
+void openlib::Arena::reset() {
+  if (blocks == nullptr) {
+    return;
+  }
+
+  // keep the newest block, release the rest
+  Block* keep = blocks;
+  Block* block = keep->next;
+  while (block != nullptr) {
+    Block* next = block->next;
+    ::operator delete(block);
+    block = next;
+  }
+  keep->next = nullptr;
+  blocks = keep;
+
+  cursor = reinterpret_cast<std::uintptr_t>(keep + 1);
+  limit = cursor + keep->size;
+  bytesAllocated = 0;
+}
+
+std::size_t openlib::Arena::allocated() const {
+  return bytesAllocated;
+}
+
+void* openlib::Arena::allocateFromNewBlock(std::size_t bytes, std::size_t alignment) {
+  if (bytes > std::numeric_limits<std::size_t>::max() - sizeof(Block) - alignment) {
+    throw std::bad_alloc();
+  }
+
+  std::size_t size = bytes + alignment > blockSize ? bytes + alignment : blockSize;
+  Block* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+  block->next = blocks;
+  block->size = size;
+  blocks = block;
+
+  cursor = reinterpret_cast<std::uintptr_t>(block + 1);
+  limit = cursor + size;
+  return allocate(bytes, alignment);
+}
@@ -0,0 +1,282 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "openlib/BitArray.h"
+#include "openlib/Kernels.h"
+
+const std::size_t openlib::BitArray::WORD_BITS;
+const std::size_t openlib::BitRankIndex::BLOCK_BITS;
+
+namespace {
+
+const std::size_t WORD_BITS = openlib::BitArray::WORD_BITS;
+const std::size_t BLOCK_WORDS = openlib::BitRankIndex::BLOCK_BITS / WORD_BITS;
+// words counted per kernel call while searching for a rank
+const std::size_t SELECT_CHUNK_WORDS = 64;
+
+std::size_t wordsFor(std::size_t bits) {
+  return (bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+std::size_t popcount(uint64_t word) {
+  return __builtin_popcountll(word);
+}
+
+// position of the set bit with the given rank in word, which must have
+// more than rank bits set
+std::size_t selectInWord(uint64_t word, std::size_t rank) {
+  std::size_t offset = 0;
+  for (;;) {
+    std::size_t inByte = popcount(word & 0xff);
+    if (rank < inByte) {
+      break;
+    }
+    rank -= inByte;
+    word >>= 8;
+    offset += 8;
+  }
+  for (; rank > 0; rank--) {
+    word &= word - 1;
+  }
+  return offset + __builtin_ctzll(word);
+}
+
+// position of the set bit with the given rank in words, starting the word
+// scan at first, or end * WORD_BITS if there are too few set bits
+std::size_t selectFrom(const uint64_t* words, std::size_t first, std::size_t end,
+                       std::size_t rank) {
+  std::size_t w = first;
+  while (w < end) {
+    std::size_t chunk = std::min(SELECT_CHUNK_WORDS, end - w);
+    std::size_t inChunk = openlib::kernels::popcount64(words + w, chunk);
+    if (rank < inChunk) {
+      break;
+    }
+    rank -= inChunk;
+    w += chunk;
+  }
+  for (; w < end; w++) {
+    std::size_t inWord = popcount(words[w]);
+    if (rank < inWord) {
+      return w * WORD_BITS + selectInWord(words[w], rank);
+    }
+    rank -= inWord;
+  }
+  return end * WORD_BITS;
+}
+
+} // namespace
+
+openlib::BitArray::BitArray(std::size_t size):
+    bits(size), words(wordsFor(size)) {
+}
+
+openlib::BitArray::BitArray(std::size_t size, bool value):
+    bits(size), words(wordsFor(size), uninitialized) {
+  fill(value);
+}
+
+openlib::BitArray::BitArray(const BitArray& other):
+    bits(other.bits), words(other.words) {
+}
+
+openlib::BitArray::BitArray(BitArray&& other) noexcept:
+    bits(other.bits), words(std::move(other.words)) {
+  other.bits = 0;
+}
+
+void openlib::BitArray::fill(bool value) {
+  words.fill(value ? ~Word(0) : Word(0));
+  clearTail();
+}
+
+void openlib::BitArray::flip() {
+  Word* data = words.data();
+  for (std::size_t i = 0; i < words.size(); i++) {
+    data[i] = ~data[i];
+  }
+  clearTail();
+}
+
+openlib::BitArray& openlib::BitArray::operator&=(const BitArray& other) {
+  checkSize(other);
+  kernels::and64(words.data(), words.data(), other.words.data(), words.size());
+  return *this;
+}
+
+openlib::BitArray& openlib::BitArray::operator|=(const BitArray& other) {
+  checkSize(other);
+  kernels::or64(words.data(), words.data(), other.words.data(), words.size());
+  return *this;
+}
+
+openlib::BitArray& openlib::BitArray::operator^=(const BitArray& other) {
+  checkSize(other);
+  kernels::xor64(words.data(), words.data(), other.words.data(), words.size());
+  return *this;
+}
+
+openlib::BitArray& openlib::BitArray::andNot(const BitArray& other) {
+  checkSize(other);
+  kernels::andNot64(words.data(), words.data(), other.words.data(), words.size());
+  return *this;
+}
+
+std::size_t openlib::BitArray::count() const {
+  return kernels::popcount64(words.data(), words.size());
+}
+
+bool openlib::BitArray::any() const {
+  const Word* data = words.data();
+  for (std::size_t i = 0; i < words.size(); i++) {
+    if (data[i] != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool openlib::BitArray::none() const {
+  return !any();
+}
+
+bool openlib::BitArray::all() const {
+  return count() == bits;
+}
+
+std::size_t openlib::BitArray::findFirst() const noexcept {
+  const Word* data = words.data();
+  for (std::size_t i = 0; i < words.size(); i++) {
+    if (data[i] != 0) {
+      return i * WORD_BITS + __builtin_ctzll(data[i]);
+    }
+  }
+  return bits;
+}
+
+std::size_t openlib::BitArray::findNext(std::size_t position) const noexcept {
+  if (position + 1 >= bits) {
+    return bits;
+  }
+  position++;
+
+  const Word* data = words.data();
+  std::size_t i = position / WORD_BITS;
+  Word word = data[i] & (~Word(0) << (position % WORD_BITS));
+  for (;;) {
+    if (word != 0) {
+      return i * WORD_BITS + __builtin_ctzll(word);
+    }
+    if (++i == words.size()) {
+      return bits;
+    }
+    word = data[i];
+  }
+}
+
+std::size_t openlib::BitArray::rank(std::size_t position) const {
+  if (position > bits) {
+    throw std::out_of_range("rank position is past the end of the bit array");
+  }
+  const Word* data = words.data();
+  std::size_t whole = position / WORD_BITS;
+  std::size_t result = kernels::popcount64(data, whole);
+  if (position % WORD_BITS != 0) {
+    result += popcount(data[whole] & ((Word(1) << (position % WORD_BITS)) - 1));
+  }
+  return result;
+}
+
+std::size_t openlib::BitArray::select(std::size_t rank) const {
+  return std::min(selectFrom(words.data(), 0, words.size(), rank), bits);
+}
+
+void openlib::BitArray::clearTail() noexcept {
+  if (bits % WORD_BITS != 0) {
+    words.data()[words.size() - 1] &= (Word(1) << (bits % WORD_BITS)) - 1;
+  }
+}
+
+void openlib::BitArray::checkPosition(std::size_t position) const {
+  if (position >= bits) {
+    throw std::out_of_range("position is past the end of the bit array");
+  }
+}
+
+void openlib::BitArray::checkSize(const BitArray& other) const {
+  if (other.bits != bits) {
+    throw std::length_error("bit arrays differ in size");
+  }
+}
+
+openlib::BitRankIndex::BitRankIndex(const BitArray& bits):
+    bits(bits), blocks((bits.wordCount() + BLOCK_WORDS - 1) / BLOCK_WORDS + 1) {
+  const uint64_t* data = bits.data();
+  const std::size_t wordCount = bits.wordCount();
+  uint64_t* counts = blocks.data();
+  counts[0] = 0;
+  for (std::size_t block = 0; block + 1 < blocks.size(); block++) {
+    std::size_t first = block * BLOCK_WORDS;
+    std::size_t n = std::min(BLOCK_WORDS, wordCount - first);
+    counts[block + 1] = counts[block] + kernels::popcount64(data + first, n);
+  }
+}
+
+std::size_t openlib::BitRankIndex::rank(std::size_t position) const {
+  if (position > bits.size()) {
+    throw std::out_of_range("rank position is past the end of the bit array");
+  }
+  const uint64_t* data = bits.data();
+  std::size_t whole = position / WORD_BITS;
+  std::size_t w = whole / BLOCK_WORDS * BLOCK_WORDS;
+  std::size_t result = blocks.data()[w / BLOCK_WORDS];
+  for (; w < whole; w++) {
+    result += popcount(data[w]);
+  }
+  if (position % WORD_BITS != 0) {
+    result += popcount(data[whole] & ((uint64_t(1) << (position % WORD_BITS)) - 1));
+  }
+  return result;
+}
+
+std::size_t openlib::BitRankIndex::select(std::size_t rank) const {
+  if (rank >= count()) {
+    return bits.size();
+  }
+  // last block that starts with at most rank bits before it
+  const uint64_t* counts = blocks.data();
+  std::size_t block = std::upper_bound(counts, counts + blocks.size(), uint64_t(rank)) - counts - 1;
+  std::size_t first = block * BLOCK_WORDS;
+  std::size_t end = std::min(first + BLOCK_WORDS, bits.wordCount());
+  return selectFrom(bits.data(), first, end, rank - counts[block]);
+}
+
+std::size_t openlib::BitRankIndex::count() const noexcept {
+  return blocks.data()[blocks.size() - 1];
+}
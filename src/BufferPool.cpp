@@ -0,0 +1,443 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "openlib/AlignedAllocator.h"
+#include "openlib/BufferPool.h"
+
+const std::size_t openlib::BufferPool::MIN_BLOCK_SIZE;
+const std::size_t openlib::BufferPool::MAX_BLOCK_SIZE;
+const std::size_t openlib::BufferPool::SIZE_CLASSES;
+
+namespace {
+
+// every pooled block is cache-line aligned, so neighbouring buffers used by
+// different threads never share a line
+const std::size_t BLOCK_ALIGNMENT = openlib::CACHE_LINE_BYTES;
+
+// pool ids are never reused, so a thread's stale cache entry never matches
+std::atomic<uint64_t> nextPoolId(1);
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct FreeList {
+  FreeBlock* head = nullptr;
+  std::size_t count = 0;
+
+  void push(void* p) {
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    block->next = head;
+    head = block;
+    count++;
+  }
+
+  void* pop() {
+    FreeBlock* block = head;
+    if (block != nullptr) {
+      head = block->next;
+      count--;
+    }
+    return block;
+  }
+};
+
+std::size_t blockSize(std::size_t sizeClass) {
+  return openlib::BufferPool::MIN_BLOCK_SIZE << sizeClass;
+}
+
+// blocks of a size class that fit in budget, at least one
+std::size_t blockLimit(std::size_t budget, std::size_t sizeClass) {
+  return std::max<std::size_t>(1, budget / blockSize(sizeClass));
+}
+
+// only the owning thread writes a cache's counters, so a relaxed load and
+// store is enough and no locked read-modify-write is needed
+template <class T>
+void increase(std::atomic<T>& counter, T amount) {
+  counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+template <class T>
+void decrease(std::atomic<T>& counter, T amount) {
+  counter.store(counter.load(std::memory_order_relaxed) - amount, std::memory_order_relaxed);
+}
+
+void addCounters(openlib::BufferPool::Stats& total, const openlib::BufferPool::Stats& part) {
+  total.allocations += part.allocations;
+  total.threadHits += part.threadHits;
+  total.depotHits += part.depotHits;
+  total.misses += part.misses;
+  total.uncached += part.uncached;
+}
+
+} // namespace
+
+struct openlib::BufferPool::ThreadCache {
+  // the lists are only touched by the owning thread, and by the pool's
+  // destructor once no thread uses the pool any more; the counters are also
+  // read by stats() from other threads
+  FreeList lists[SIZE_CLASSES];
+  std::atomic<std::size_t> bytes{0};
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> threadHits{0};
+  std::atomic<uint64_t> depotHits{0};
+  std::atomic<uint64_t> misses{0};
+  std::atomic<uint64_t> uncached{0};
+
+  Stats counters() const {
+    Stats result;
+    result.allocations = allocations.load(std::memory_order_relaxed);
+    result.threadHits = threadHits.load(std::memory_order_relaxed);
+    result.depotHits = depotHits.load(std::memory_order_relaxed);
+    result.misses = misses.load(std::memory_order_relaxed);
+    result.uncached = uncached.load(std::memory_order_relaxed);
+    return result;
+  }
+};
+
+struct openlib::BufferPool::State {
+  struct Depot {
+    std::mutex lock;
+    FreeList list;
+  };
+
+  State(const Options& options, MemoryResource& upstream):
+      options(options), upstream(upstream), id(nextPoolId++) {
+  }
+
+  const Options options;
+  MemoryResource& upstream;
+  const uint64_t id;
+  Depot depots[SIZE_CLASSES];
+
+  // lock order: registryLock, then a Depot lock
+  std::mutex registryLock;
+  std::vector<ThreadCache*> caches;
+  Stats retired;
+  bool closed = false;
+
+  // hand count blocks of list to the depot, anything over its limit goes upstream
+  void toDepot(FreeList& list, std::size_t count, std::size_t sizeClass) {
+    FreeList overflow;
+    {
+      Depot& depot = depots[sizeClass];
+      std::lock_guard<std::mutex> guard(depot.lock);
+      const std::size_t limit = blockLimit(options.depotBytes, sizeClass);
+      for (std::size_t i = 0; i < count; i++) {
+        void* block = list.pop();
+        if (depot.list.count < limit) {
+          depot.list.push(block);
+        } else {
+          overflow.push(block);
+        }
+      }
+    }
+    release(overflow, sizeClass);
+  }
+
+  // return every block of list upstream
+  void release(FreeList& list, std::size_t sizeClass) {
+    while (void* block = list.pop()) {
+      upstream.deallocate(block, blockSize(sizeClass), BLOCK_ALIGNMENT);
+    }
+  }
+
+  // allocate for a thread whose caches are gone, from the depot or upstream
+  void* allocateUncached(std::size_t bytes, std::size_t alignment) {
+    Stats counters;
+    counters.allocations = 1;
+    void* block = nullptr;
+    if (bytes > MAX_BLOCK_SIZE || alignment > BLOCK_ALIGNMENT) {
+      counters.uncached = 1;
+      block = upstream.allocate(bytes, alignment);
+    } else {
+      const std::size_t index = sizeClass(bytes);
+      {
+        Depot& depot = depots[index];
+        std::lock_guard<std::mutex> guard(depot.lock);
+        block = depot.list.pop();
+      }
+      if (block != nullptr) {
+        counters.depotHits = 1;
+      } else {
+        counters.misses = 1;
+        block = upstream.allocate(blockSize(index), BLOCK_ALIGNMENT);
+      }
+    }
+
+    std::lock_guard<std::mutex> registryGuard(registryLock);
+    addCounters(retired, counters);
+    return block;
+  }
+};
+
+/**
+ * The calling thread's caches, one per pool it has used
+ *
+ * Destroyed at thread exit, which empties each cache into its pool's depot.
+ * Other thread_local or, on the main thread, static objects may still
+ * allocate and free afterwards; finished sends them to the depot instead.
+ */
+struct openlib::BufferPool::LocalCaches {
+  struct Entry {
+    uint64_t id;
+    std::weak_ptr<State> state;
+    std::unique_ptr<ThreadCache> cache;
+  };
+
+  std::vector<Entry> entries;
+
+  // the cache used last, checked before searching entries. Trivially
+  // destructible, so they can still be read after entries is destroyed.
+  static thread_local uint64_t lastId;
+  static thread_local ThreadCache* lastCache;
+  static thread_local bool finished;
+
+  ~LocalCaches() {
+    lastId = 0;
+    lastCache = nullptr;
+    finished = true;
+    for (Entry& entry : entries) {
+      retire(entry);
+    }
+  }
+
+  static void retire(Entry& entry) {
+    std::shared_ptr<State> state = entry.state.lock();
+    if (!state) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> registryGuard(state->registryLock);
+    if (state->closed) {
+      return;
+    }
+    ThreadCache& cache = *entry.cache;
+    for (std::size_t i = 0; i < SIZE_CLASSES; i++) {
+      state->toDepot(cache.lists[i], cache.lists[i].count, i);
+    }
+    cache.bytes.store(0, std::memory_order_relaxed);
+    addCounters(state->retired, cache.counters());
+    state->caches.erase(std::find(state->caches.begin(), state->caches.end(), &cache));
+  }
+};
+
+// pool ids start at 1, so lastId 0 never matches
+thread_local uint64_t openlib::BufferPool::LocalCaches::lastId = 0;
+thread_local openlib::BufferPool::ThreadCache* openlib::BufferPool::LocalCaches::lastCache = nullptr;
+thread_local bool openlib::BufferPool::LocalCaches::finished = false;
+
+std::size_t openlib::BufferPool::Stats::bytesCached() const noexcept {
+  return threadCacheBytes + depotBytes;
+}
+
+double openlib::BufferPool::Stats::hitRate() const noexcept {
+  if (allocations == 0) {
+    return 0;
+  }
+  return static_cast<double>(threadHits + depotHits) / allocations;
+}
+
+openlib::BufferPool::BufferPool(MemoryResource& upstream):
+    BufferPool(Options(), upstream) {
+}
+
+openlib::BufferPool::BufferPool(const Options& options, MemoryResource& upstream):
+    state(std::make_shared<State>(options, upstream)) {
+}
+
+openlib::BufferPool::~BufferPool() {
+  {
+    std::lock_guard<std::mutex> registryGuard(state->registryLock);
+    state->closed = true;
+    // no other thread may still be using the pool, so their lists are ours
+    for (ThreadCache* cache : state->caches) {
+      for (std::size_t i = 0; i < SIZE_CLASSES; i++) {
+        state->release(cache->lists[i], i);
+      }
+      cache->bytes.store(0, std::memory_order_relaxed);
+    }
+    state->caches.clear();
+  }
+  trim();
+}
+
+openlib::BufferPool::ThreadCache* openlib::BufferPool::localCache() {
+  if (LocalCaches::lastId == state->id) {
+    return LocalCaches::lastCache;
+  }
+  if (LocalCaches::finished) {
+    return nullptr;
+  }
+
+  thread_local LocalCaches locals;
+
+  ThreadCache* cache = nullptr;
+  for (auto& entry : locals.entries) {
+    if (entry.id == state->id) {
+      cache = entry.cache.get();
+    }
+  }
+
+  if (cache == nullptr) {
+    // forget caches of pools that have been destroyed
+    locals.entries.erase(std::remove_if(locals.entries.begin(), locals.entries.end(),
+                                        [](const LocalCaches::Entry& entry) {
+                                          return entry.state.expired();
+                                        }),
+                         locals.entries.end());
+
+    std::unique_ptr<ThreadCache> fresh(new ThreadCache());
+    cache = fresh.get();
+    {
+      std::lock_guard<std::mutex> guard(state->registryLock);
+      state->caches.push_back(cache);
+    }
+    locals.entries.push_back(LocalCaches::Entry{state->id, state, std::move(fresh)});
+  }
+
+  LocalCaches::lastId = state->id;
+  LocalCaches::lastCache = cache;
+  return cache;
+}
+
+void* openlib::BufferPool::allocate(std::size_t bytes, std::size_t alignment) {
+  ThreadCache* local = localCache();
+  if (local == nullptr) {
+    return state->allocateUncached(bytes, alignment);
+  }
+  ThreadCache& cache = *local;
+
+  increase<uint64_t>(cache.allocations, 1);
+
+  if (bytes > MAX_BLOCK_SIZE || alignment > BLOCK_ALIGNMENT) {
+    increase<uint64_t>(cache.uncached, 1);
+    return state->upstream.allocate(bytes, alignment);
+  }
+
+  const std::size_t index = sizeClass(bytes);
+  const std::size_t size = blockSize(index);
+  if (void* block = cache.lists[index].pop()) {
+    increase<uint64_t>(cache.threadHits, 1);
+    decrease(cache.bytes, size);
+    return block;
+  }
+
+  // refill from the depot, up to half of what the thread may cache
+  FreeList refill;
+  {
+    State::Depot& depot = state->depots[index];
+    std::lock_guard<std::mutex> guard(depot.lock);
+    std::size_t count = std::min(depot.list.count,
+                                 std::max<std::size_t>(1, blockLimit(state->options.threadCacheBytes, index) / 2));
+    for (std::size_t i = 0; i < count; i++) {
+      refill.push(depot.list.pop());
+    }
+  }
+
+  if (void* block = refill.pop()) {
+    increase<uint64_t>(cache.depotHits, 1);
+    increase(cache.bytes, refill.count * size);
+    while (void* extra = refill.pop()) {
+      cache.lists[index].push(extra);
+    }
+    return block;
+  }
+  increase<uint64_t>(cache.misses, 1);
+  return state->upstream.allocate(size, BLOCK_ALIGNMENT);
+}
+
+void openlib::BufferPool::deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+  if (bytes > MAX_BLOCK_SIZE || alignment > BLOCK_ALIGNMENT) {
+    state->upstream.deallocate(p, bytes, alignment);
+    return;
+  }
+
+  const std::size_t index = sizeClass(bytes);
+  const std::size_t size = blockSize(index);
+  ThreadCache* local = localCache();
+  if (local == nullptr) {
+    FreeList single;
+    single.push(p);
+    state->toDepot(single, 1, index);
+    return;
+  }
+  ThreadCache& cache = *local;
+
+  // over the limit, half of the cache goes to the depot for other threads
+  FreeList& list = cache.lists[index];
+  list.push(p);
+  increase(cache.bytes, size);
+
+  const std::size_t limit = blockLimit(state->options.threadCacheBytes, index);
+  if (list.count > limit) {
+    const std::size_t count = list.count - limit / 2;
+    decrease(cache.bytes, count * size);
+    state->toDepot(list, count, index);
+  }
+}
+
+void openlib::BufferPool::trim() {
+  for (std::size_t i = 0; i < SIZE_CLASSES; i++) {
+    FreeList list;
+    {
+      State::Depot& depot = state->depots[i];
+      std::lock_guard<std::mutex> guard(depot.lock);
+      std::swap(list, depot.list);
+    }
+    state->release(list, i);
+  }
+}
+
+openlib::BufferPool::Stats openlib::BufferPool::stats() const {
+  Stats total;
+  {
+    std::lock_guard<std::mutex> registryGuard(state->registryLock);
+    addCounters(total, state->retired);
+    for (ThreadCache* cache : state->caches) {
+      addCounters(total, cache->counters());
+      total.threadCacheBytes += cache->bytes.load(std::memory_order_relaxed);
+    }
+  }
+  for (std::size_t i = 0; i < SIZE_CLASSES; i++) {
+    State::Depot& depot = state->depots[i];
+    std::lock_guard<std::mutex> guard(depot.lock);
+    total.depotBytes += depot.list.count * blockSize(i);
+  }
+  return total;
+}
+
+openlib::BufferPool& openlib::BufferPool::shared() {
+  // never destroyed, static objects may free into it during exit
+  static BufferPool* pool = new BufferPool();
+  return *pool;
+}
@@ -0,0 +1,90 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <thread>
+
+#include "openlib/Epoch.h"
+
+const uint64_t openlib::EpochDomain::IDLE;
+const std::size_t openlib::EpochDomain::SLOTS_PER_CHUNK;
+
+openlib::EpochDomain::Slot::Slot() noexcept:
+    epoch(IDLE), owned(false), depth(0) {
+}
+
+openlib::EpochDomain::EpochDomain():
+    epoch(IDLE + 1) {
+}
+
+openlib::EpochDomain::Slot& openlib::EpochDomain::acquireSlot() {
+  std::lock_guard<std::mutex> guard(slotsLock);
+  for (auto& chunk : slots) {
+    for (Slot& slot : *chunk) {
+      if (!slot.owned.load(std::memory_order_relaxed)) {
+        slot.owned.store(true, std::memory_order_relaxed);
+        slot.depth = 0;
+        return slot;
+      }
+    }
+  }
+
+  slots.emplace_back(new FlatArray<Slot, AlignedAllocator<Slot>>(SLOTS_PER_CHUNK));
+  Slot& slot = slots.back()->front();
+  slot.owned.store(true, std::memory_order_relaxed);
+  return slot;
+}
+
+void openlib::EpochDomain::releaseSlot(Slot& slot) noexcept {
+  std::lock_guard<std::mutex> guard(slotsLock);
+  slot.epoch.store(IDLE, std::memory_order_release);
+  slot.owned.store(false, std::memory_order_relaxed);
+}
+
+uint64_t openlib::EpochDomain::advance() noexcept {
+  return epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+}
+
+bool openlib::EpochDomain::isQuiescent(uint64_t target) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  std::lock_guard<std::mutex> guard(slotsLock);
+  for (auto& chunk : slots) {
+    for (const Slot& slot : *chunk) {
+      const uint64_t announced = slot.epoch.load(std::memory_order_acquire);
+      if (announced != IDLE && announced < target) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void openlib::EpochDomain::synchronize() {
+  const uint64_t target = advance();
+  while (!isQuiescent(target)) {
+    std::this_thread::yield();
+  }
+}
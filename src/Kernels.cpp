@@ -0,0 +1,1106 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "openlib/Kernels.h"
+
+/*
+ * Every kernel is written once as an always_inline template over the vector
+ * width, using GCC vector extensions. The template is then inlined into one
+ * entry point per instruction set, each compiled with the matching target
+ * attribute, so the same source produces SSE2, AVX2 and AVX-512 code. The
+ * scalar versions are plain loops and serve as the reference in tests.
+ */
+
+#define OPENLIB_INLINE __attribute__((always_inline)) inline
+
+namespace {
+
+using openlib::kernels::Isa;
+
+///////////////////////////////////////////////////////////////////////////////
+// Scalar reference
+///////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+void fillScalar(T* dst, T value, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) {
+    dst[i] = value;
+  }
+}
+
+bool equalScalar(const void* lhs, const void* rhs, std::size_t bytes) {
+  const uint8_t* a = static_cast<const uint8_t*>(lhs);
+  const uint8_t* b = static_cast<const uint8_t*>(rhs);
+  for (std::size_t i = 0; i < bytes; i++) {
+    if (a[i] != b[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class T>
+std::size_t findScalar(const T* data, std::size_t n, T value) {
+  for (std::size_t i = 0; i < n; i++) {
+    if (data[i] == value) {
+      return i;
+    }
+  }
+  return n;
+}
+
+template <class T>
+std::size_t countScalar(const T* data, std::size_t n, T value) {
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    total += data[i] == value;
+  }
+  return total;
+}
+
+template <class T>
+T minScalar(const T* data, std::size_t n) {
+  T result = data[0];
+  for (std::size_t i = 1; i < n; i++) {
+    result = data[i] < result ? data[i] : result;
+  }
+  return result;
+}
+
+template <class T>
+T maxScalar(const T* data, std::size_t n) {
+  T result = data[0];
+  for (std::size_t i = 1; i < n; i++) {
+    result = data[i] > result ? data[i] : result;
+  }
+  return result;
+}
+
+template <class T>
+T sumScalar(const T* data, std::size_t n) {
+  T total = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    total += data[i];
+  }
+  return total;
+}
+
+// bitwise operations, applied to scalars and vectors alike; results are
+// written through a reference for the same -Wpsabi reason as load/store
+struct AndBits {
+  template <class V>
+  OPENLIB_INLINE void operator()(V& r, const V& a, const V& b) const { r = a & b; }
+};
+
+struct OrBits {
+  template <class V>
+  OPENLIB_INLINE void operator()(V& r, const V& a, const V& b) const { r = a | b; }
+};
+
+struct XorBits {
+  template <class V>
+  OPENLIB_INLINE void operator()(V& r, const V& a, const V& b) const { r = a ^ b; }
+};
+
+struct AndNotBits {
+  template <class V>
+  OPENLIB_INLINE void operator()(V& r, const V& a, const V& b) const { r = a & ~b; }
+};
+
+template <class Op>
+void bitwiseScalar(uint64_t* dst, const uint64_t* a, const uint64_t* b, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) {
+    Op()(dst[i], a[i], b[i]);
+  }
+}
+
+std::size_t popcountScalar(const uint64_t* data, std::size_t n) {
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    total += __builtin_popcountll(data[i]);
+  }
+  return total;
+}
+
+OPENLIB_INLINE uint16_t swapBytes(uint16_t value) { return __builtin_bswap16(value); }
+OPENLIB_INLINE uint32_t swapBytes(uint32_t value) { return __builtin_bswap32(value); }
+OPENLIB_INLINE uint64_t swapBytes(uint64_t value) { return __builtin_bswap64(value); }
+
+// dst and src need not be aligned, so words go through memcpy
+template <class T>
+void byteSwapScalar(void* dst, const void* src, std::size_t n) {
+  uint8_t* out = static_cast<uint8_t*>(dst);
+  const uint8_t* in = static_cast<const uint8_t*>(src);
+  for (std::size_t i = 0; i < n; i++) {
+    T word;
+    std::memcpy(&word, in + i * sizeof(T), sizeof(T));
+    word = swapBytes(word);
+    std::memcpy(out + i * sizeof(T), &word, sizeof(T));
+  }
+}
+
+/*
+ * 64-bit content hash in the style of XXH3. Inputs up to 240 bytes are
+ * mixed 16 bytes at a time with folded 64x64 -> 128-bit multiplies. Longer
+ * inputs feed 64-byte stripes into eight accumulator lanes, each lane
+ * adding a 32x32 -> 64-bit product of the data and a secret word, which
+ * maps directly onto pmuludq. The accumulators are scrambled every 1 KiB
+ * and folded together at the end. Words are read in native byte order.
+ */
+const uint64_t HASH_SECRET[32] = {
+  0xb9096a04e7d80069ull, 0xc963cfe0afae5a3bull, 0xe1454c40c439f34bull, 0x26b563b1e794ee15ull,
+  0xac8be7d742840d2bull, 0xd96e5adfa2beee31ull, 0x19fcfc64e7aa8577ull, 0x53d23c0bdf43efb3ull,
+  0xe7ca430e92ac3d43ull, 0x06e82a012b5c5cd1ull, 0x6820212c69599355ull, 0x1333bc1cfe6c2b03ull,
+  0x20050ed31a6e72b9ull, 0x7972a36d51b31a6dull, 0x94a67f00f335c357ull, 0x6977a41b730bed9dull,
+  0x332726d0356a4153ull, 0xa0187b4d51209e8full, 0xae6ac4a9e89c5bc7ull, 0x542861cd55e7d67full,
+  0x17bcc74d6d683cf9ull, 0x8491cabea0afe357ull, 0xd775f593ce3ad2b3ull, 0x67a9b05c7dfb27e9ull,
+  0x34d2ea1614daf467ull, 0x3e1dcfb592bde31dull, 0x33aa391808fc2081ull, 0x1570bc621832c9e3ull,
+  0x40e0529930b9f609ull, 0xc3b1b366b1852ac9ull, 0x4e18a3634891a61bull, 0x41bc858eb0b4362full,
+};
+
+const uint64_t HASH_PRIME_1 = 0x9e3779b185ebca87ull;
+const uint64_t HASH_PRIME_2 = 0xc2b2ae3d27d4eb4full;
+const uint64_t HASH_PRIME_32 = 0x9e3779b1ull;
+const std::size_t HASH_SHORT_BYTES = 240;
+const std::size_t HASH_STRIPE_BYTES = 64;
+const std::size_t HASH_BLOCK_STRIPES = 16;
+
+// adds stripes 64-byte stripes into acc[8], stripe i keyed by secret + i
+typedef void (*HashAccumulate)(uint64_t* acc, const uint8_t* data, std::size_t stripes,
+                               const uint64_t* secret);
+
+uint64_t read64(const uint8_t* p) {
+  uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint64_t read32(const uint8_t* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint64_t foldMultiply(uint64_t a, uint64_t b) {
+  const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+uint64_t avalanche(uint64_t h) {
+  h ^= h >> 37;
+  h *= 0x165667919e3779f9ull;
+  return h ^ (h >> 32);
+}
+
+uint64_t hashShort(const uint8_t* p, std::size_t n, uint64_t seed) {
+  const uint64_t* secret = HASH_SECRET;
+  if (n > 16) {
+    // whole 16-byte chunks, then the last 16 bytes which may overlap them
+    uint64_t acc = n * HASH_PRIME_1;
+    const std::size_t chunks = (n - 1) / 16;
+    for (std::size_t i = 0; i < chunks; i++) {
+      acc += foldMultiply(read64(p + 16 * i) ^ (secret[i] + seed),
+                          read64(p + 16 * i + 8) ^ (secret[i + 16] - seed));
+    }
+    acc += foldMultiply(read64(p + n - 16) ^ (secret[15] + seed),
+                        read64(p + n - 8) ^ (secret[31] - seed));
+    return avalanche(acc);
+  }
+  if (n > 8) {
+    const uint64_t lo = read64(p) ^ (secret[0] + seed);
+    const uint64_t hi = read64(p + n - 8) ^ (secret[1] - seed);
+    return avalanche(n + lo + hi + foldMultiply(lo, hi));
+  }
+  if (n >= 4) {
+    const uint64_t combined = (read32(p) << 32) | read32(p + n - 4);
+    return avalanche(foldMultiply(combined ^ (secret[2] + seed), secret[3] ^ n));
+  }
+  if (n > 0) {
+    const uint64_t combined = uint64_t(p[0]) | (uint64_t(p[n / 2]) << 8) |
+                              (uint64_t(p[n - 1]) << 16) | (uint64_t(n) << 24);
+    return avalanche(foldMultiply(combined ^ (secret[4] + seed), HASH_PRIME_1));
+  }
+  return avalanche(seed ^ secret[5]);
+}
+
+void hashScramble(uint64_t* acc) {
+  for (std::size_t lane = 0; lane < 8; lane++) {
+    uint64_t value = acc[lane];
+    value ^= value >> 47;
+    value ^= HASH_SECRET[24 + lane];
+    acc[lane] = value * HASH_PRIME_32;
+  }
+}
+
+uint64_t hashBytes(const void* data, std::size_t n, uint64_t seed, HashAccumulate accumulate) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  if (n <= HASH_SHORT_BYTES) {
+    return hashShort(p, n, seed);
+  }
+
+  uint64_t acc[8] = {
+    HASH_PRIME_32 + seed, HASH_PRIME_1 - seed, HASH_PRIME_2 + seed, 0x165667b19e3779f9ull - seed,
+    0x85ebca77c2b2ae63ull + seed, 0x85ebca77ull - seed, 0x27d4eb2f165667c5ull + seed,
+    0xc2b2ae3dull - seed,
+  };
+
+  // every stripe but the last, which is taken from the final 64 bytes
+  const std::size_t stripes = (n - 1) / HASH_STRIPE_BYTES;
+  for (std::size_t stripe = 0; stripe < stripes; stripe += HASH_BLOCK_STRIPES) {
+    const std::size_t count = std::min(HASH_BLOCK_STRIPES, stripes - stripe);
+    accumulate(acc, p + stripe * HASH_STRIPE_BYTES, count, HASH_SECRET);
+    if (count == HASH_BLOCK_STRIPES) {
+      hashScramble(acc);
+    }
+  }
+  accumulate(acc, p + n - HASH_STRIPE_BYTES, 1, HASH_SECRET + 7);
+
+  uint64_t h = n * HASH_PRIME_1 + seed;
+  for (std::size_t lane = 0; lane < 8; lane += 2) {
+    h += foldMultiply(acc[lane] ^ HASH_SECRET[16 + lane], acc[lane + 1] ^ HASH_SECRET[17 + lane]);
+  }
+  return avalanche(h);
+}
+
+void accumulateScalar(uint64_t* acc, const uint8_t* data, std::size_t stripes,
+                      const uint64_t* secret) {
+  for (std::size_t stripe = 0; stripe < stripes; stripe++) {
+    for (std::size_t lane = 0; lane < 8; lane++) {
+      const uint64_t value = read64(data + stripe * HASH_STRIPE_BYTES + 8 * lane);
+      const uint64_t keyed = value ^ secret[stripe + lane];
+      // the value goes to the neighbouring lane, so a product of zero
+      // cannot erase it
+      acc[lane ^ 1] += value;
+      acc[lane] += (keyed & 0xffffffff) * (keyed >> 32);
+    }
+  }
+}
+
+uint64_t hashScalar(const void* data, std::size_t n, uint64_t seed) {
+  return hashBytes(data, n, seed, accumulateScalar);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Vector bodies, W is the vector width in bytes
+///////////////////////////////////////////////////////////////////////////////
+
+template <std::size_t W, class T>
+struct Vector {
+  typedef T type __attribute__((vector_size(W)));
+  static const std::size_t lanes = W / sizeof(T);
+};
+
+// vectors are passed by reference only, passing them by value between
+// functions compiled for different targets would change the ABI
+template <std::size_t W, class T>
+OPENLIB_INLINE void load(typename Vector<W, T>::type& v, const T* p) {
+  std::memcpy(&v, p, W);
+}
+
+template <std::size_t W, class T>
+OPENLIB_INLINE void store(T* p, const typename Vector<W, T>::type& v) {
+  std::memcpy(p, &v, W);
+}
+
+// true if any lane of v is non-zero
+template <std::size_t W, class V>
+OPENLIB_INLINE bool any(const V& v) {
+  typename Vector<W, uint64_t>::type wide;
+  std::memcpy(&wide, &v, W);
+  uint64_t bits = 0;
+  for (std::size_t i = 0; i < W / sizeof(uint64_t); i++) {
+    bits |= wide[i];
+  }
+  return bits != 0;
+}
+
+template <std::size_t W, class T>
+OPENLIB_INLINE void fillVector(T* dst, T value, std::size_t n) {
+  typedef typename Vector<W, T>::type V;
+  const std::size_t L = Vector<W, T>::lanes;
+  const V v = V{} + value;
+
+  std::size_t i = 0;
+  for (; i + 4 * L <= n; i += 4 * L) {
+    store<W>(dst + i, v);
+    store<W>(dst + i + L, v);
+    store<W>(dst + i + 2 * L, v);
+    store<W>(dst + i + 3 * L, v);
+  }
+  for (; i + L <= n; i += L) {
+    store<W>(dst + i, v);
+  }
+  for (; i < n; i++) {
+    dst[i] = value;
+  }
+}
+
+template <std::size_t W>
+OPENLIB_INLINE bool equalVector(const void* lhs, const void* rhs, std::size_t bytes) {
+  const uint8_t* a = static_cast<const uint8_t*>(lhs);
+  const uint8_t* b = static_cast<const uint8_t*>(rhs);
+
+  typedef typename Vector<W, uint8_t>::type V;
+  V a0, a1, a2, a3, b0, b1, b2, b3;
+
+  std::size_t i = 0;
+  for (; i + 4 * W <= bytes; i += 4 * W) {
+    load<W>(a0, a + i);
+    load<W>(a1, a + i + W);
+    load<W>(a2, a + i + 2 * W);
+    load<W>(a3, a + i + 3 * W);
+    load<W>(b0, b + i);
+    load<W>(b1, b + i + W);
+    load<W>(b2, b + i + 2 * W);
+    load<W>(b3, b + i + 3 * W);
+    V x = (a0 ^ b0) | (a1 ^ b1) | (a2 ^ b2) | (a3 ^ b3);
+    if (any<W>(x)) {
+      return false;
+    }
+  }
+  for (; i + W <= bytes; i += W) {
+    load<W>(a0, a + i);
+    load<W>(b0, b + i);
+    V x = a0 ^ b0;
+    if (any<W>(x)) {
+      return false;
+    }
+  }
+  return std::memcmp(a + i, b + i, bytes - i) == 0;
+}
+
+template <std::size_t W, class T>
+OPENLIB_INLINE std::size_t findVector(const T* data, std::size_t n, T value) {
+  typedef typename Vector<W, T>::type V;
+  const std::size_t L = Vector<W, T>::lanes;
+  const V v = V{} + value;
+
+  V block;
+  std::size_t i = 0;
+  for (; i + L <= n; i += L) {
+    load<W>(block, data + i);
+    auto match = block == v;
+    if (any<W>(match)) {
+      break;
+    }
+  }
+  for (; i < n; i++) {
+    if (data[i] == value) {
+      return i;
+    }
+  }
+  return n;
+}
+
+template <std::size_t W, class T>
+OPENLIB_INLINE std::size_t countVector(const T* data, std::size_t n, T value) {
+  typedef typename Vector<W, T>::type V;
+  const std::size_t L = Vector<W, T>::lanes;
+  // lane counters are unsigned and T wide, flush before they can overflow.
+  // A match is an all-ones mask lane, subtracting it adds one.
+  const std::size_t flushEvery = sizeof(T) == 1 ? 255 : sizeof(T) == 2 ? 65535 : (1u << 30);
+  const V v = V{} + value;
+
+  V block;
+  std::size_t total = 0;
+  std::size_t i = 0;
+  while (i + L <= n) {
+    V counters = {};
+    for (std::size_t k = 0; k < flushEvery && i + L <= n; k++, i += L) {
+      load<W>(block, data + i);
+      counters -= (V)(block == v);
+    }
+    for (std::size_t lane = 0; lane < L; lane++) {
+      total += counters[lane];
+    }
+  }
+  for (; i < n; i++) {
+    total += data[i] == value;
+  }
+  return total;
+}
+
+template <std::size_t W, class T>
+OPENLIB_INLINE T minVector(const T* data, std::size_t n) {
+  typedef typename Vector<W, T>::type V;
+  const std::size_t L = Vector<W, T>::lanes;
+  if (n < L) {
+    return minScalar(data, n);
+  }
+
+  V result, v;
+  load<W>(result, data);
+  std::size_t i = L;
+  for (; i + L <= n; i += L) {
+    load<W>(v, data + i);
+    result = v < result ? v : result;
+  }
+
+  T value = result[0];
+  for (std::size_t lane = 1; lane < L; lane++) {
+    value = result[lane] < value ? result[lane] : value;
+  }
+  for (; i < n; i++) {
+    value = data[i] < value ? data[i] : value;
+  }
+  return value;
+}
+
+template <std::size_t W, class T>
+OPENLIB_INLINE T maxVector(const T* data, std::size_t n) {
+  typedef typename Vector<W, T>::type V;
+  const std::size_t L = Vector<W, T>::lanes;
+  if (n < L) {
+    return maxScalar(data, n);
+  }
+
+  V result, v;
+  load<W>(result, data);
+  std::size_t i = L;
+  for (; i + L <= n; i += L) {
+    load<W>(v, data + i);
+    result = v > result ? v : result;
+  }
+
+  T value = result[0];
+  for (std::size_t lane = 1; lane < L; lane++) {
+    value = result[lane] > value ? result[lane] : value;
+  }
+  for (; i < n; i++) {
+    value = data[i] > value ? data[i] : value;
+  }
+  return value;
+}
+
+template <std::size_t W, class T>
+OPENLIB_INLINE T sumVector(const T* data, std::size_t n) {
+  typedef typename Vector<W, T>::type V;
+  const std::size_t L = Vector<W, T>::lanes;
+
+  // four accumulators hide the latency of floating point adds
+  V acc0 = {}, acc1 = {}, acc2 = {}, acc3 = {};
+  V v0, v1, v2, v3;
+  std::size_t i = 0;
+  for (; i + 4 * L <= n; i += 4 * L) {
+    load<W>(v0, data + i);
+    load<W>(v1, data + i + L);
+    load<W>(v2, data + i + 2 * L);
+    load<W>(v3, data + i + 3 * L);
+    acc0 += v0;
+    acc1 += v1;
+    acc2 += v2;
+    acc3 += v3;
+  }
+  for (; i + L <= n; i += L) {
+    load<W>(v0, data + i);
+    acc0 += v0;
+  }
+
+  V acc = (acc0 + acc1) + (acc2 + acc3);
+  T total = 0;
+  for (std::size_t lane = 0; lane < L; lane++) {
+    total += acc[lane];
+  }
+  for (; i < n; i++) {
+    total += data[i];
+  }
+  return total;
+}
+
+template <std::size_t W, class Op>
+OPENLIB_INLINE void bitwiseVector(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+                                  std::size_t n) {
+  typedef typename Vector<W, uint64_t>::type V;
+  const std::size_t L = Vector<W, uint64_t>::lanes;
+  const Op op;
+
+  V a0, a1, b0, b1, r0, r1;
+  std::size_t i = 0;
+  for (; i + 2 * L <= n; i += 2 * L) {
+    load<W>(a0, a + i);
+    load<W>(a1, a + i + L);
+    load<W>(b0, b + i);
+    load<W>(b1, b + i + L);
+    // both loads happen before either store, so dst may alias a or b
+    op(r0, a0, b0);
+    op(r1, a1, b1);
+    store<W>(dst + i, r0);
+    store<W>(dst + i + L, r1);
+  }
+  for (; i < n; i++) {
+    op(dst[i], a[i], b[i]);
+  }
+}
+
+// SWAR popcount: bit counts per byte, summed in byte lanes for up to 31
+// vectors (31 * 8 < 256), then widened to the 64-bit lanes. Only shifts,
+// adds and ands, so it vectorizes on every instruction set.
+template <std::size_t W>
+OPENLIB_INLINE std::size_t popcountVector(const uint64_t* data, std::size_t n) {
+  typedef typename Vector<W, uint64_t>::type V;
+  const std::size_t L = Vector<W, uint64_t>::lanes;
+  const V m1 = V{} + 0x5555555555555555ull;
+  const V m2 = V{} + 0x3333333333333333ull;
+  const V m4 = V{} + 0x0f0f0f0f0f0f0f0full;
+  const V m8 = V{} + 0x00ff00ff00ff00ffull;
+
+  V total = {};
+  V x;
+  std::size_t i = 0;
+  while (i + L <= n) {
+    V bytes = {};
+    for (std::size_t k = 0; k < 31 && i + L <= n; k++, i += L) {
+      load<W>(x, data + i);
+      x = x - ((x >> 1) & m1);
+      x = (x & m2) + ((x >> 2) & m2);
+      bytes += (x + (x >> 4)) & m4;
+    }
+    bytes = (bytes & m8) + ((bytes >> 8) & m8);
+    bytes = bytes + (bytes >> 16);
+    bytes = bytes + (bytes >> 32);
+    total += bytes & 0xffff;
+  }
+
+  std::size_t result = 0;
+  for (std::size_t lane = 0; lane < L; lane++) {
+    result += total[lane];
+  }
+  for (; i < n; i++) {
+    result += __builtin_popcountll(data[i]);
+  }
+  return result;
+}
+
+// rotates every lane of type T in v by half its width
+template <std::size_t W, class T>
+OPENLIB_INLINE void rotateHalves(typename Vector<W, uint8_t>::type& v) {
+  typename Vector<W, T>::type lanes;
+  std::memcpy(&lanes, &v, W);
+  lanes = (lanes << (4 * sizeof(T))) | (lanes >> (4 * sizeof(T)));
+  std::memcpy(&v, &lanes, W);
+}
+
+// byte of v that ends up at position i when every T lane is reversed
+template <class T>
+constexpr std::size_t reversedByte(std::size_t i) {
+  return i - i % sizeof(T) + sizeof(T) - 1 - i % sizeof(T);
+}
+
+// Shuffles v into reversed T lanes. Clang and GCC 12 take the constant
+// indices of __builtin_shufflevector; older GCC only has __builtin_shuffle,
+// which takes them as a vector.
+template <std::size_t W, class T, std::size_t... I>
+OPENLIB_INLINE void shuffleReversed(typename Vector<W, uint8_t>::type& v,
+                                    std::index_sequence<I...>) {
+#if defined(__clang__) || __GNUC__ >= 12
+  v = __builtin_shufflevector(v, v, reversedByte<T>(I)...);
+#else
+  const typename Vector<W, uint8_t>::type order = {static_cast<uint8_t>(reversedByte<T>(I))...};
+  v = __builtin_shuffle(v, order);
+#endif
+}
+
+// Reverses the bytes of every T lane of v. AVX2 and AVX-512 do it with one
+// pshufb; plain SSE2 has no byte shuffle, so it rotates 16-bit, then 32 and
+// 64-bit lanes by half their width instead.
+template <std::size_t W, class T>
+OPENLIB_INLINE void reverseBytes(typename Vector<W, uint8_t>::type& v) {
+  if (W > 16) {
+    shuffleReversed<W, T>(v, std::make_index_sequence<W>());
+  } else {
+    rotateHalves<W, uint16_t>(v);
+    if (sizeof(T) >= 4) {
+      rotateHalves<W, uint32_t>(v);
+    }
+    if (sizeof(T) >= 8) {
+      rotateHalves<W, uint64_t>(v);
+    }
+  }
+}
+
+template <std::size_t W, class T>
+OPENLIB_INLINE void byteSwapVector(void* dst, const void* src, std::size_t n) {
+  typedef typename Vector<W, uint8_t>::type Bytes;
+  const std::size_t L = Vector<W, T>::lanes;
+  uint8_t* out = static_cast<uint8_t*>(dst);
+  const uint8_t* in = static_cast<const uint8_t*>(src);
+
+  Bytes v0, v1;
+  std::size_t i = 0;
+  for (; i + 2 * L <= n; i += 2 * L) {
+    load<W>(v0, in + i * sizeof(T));
+    load<W>(v1, in + (i + L) * sizeof(T));
+    reverseBytes<W, T>(v0);
+    reverseBytes<W, T>(v1);
+    store<W>(out + i * sizeof(T), v0);
+    store<W>(out + (i + L) * sizeof(T), v1);
+  }
+  byteSwapScalar<T>(out + i * sizeof(T), in + i * sizeof(T), n - i);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Dispatch
+///////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+struct ReduceTable {
+  T (*min)(const T*, std::size_t);
+  T (*max)(const T*, std::size_t);
+  T (*sum)(const T*, std::size_t);
+};
+
+template <class T>
+struct MatchTable {
+  void (*fill)(T*, T, std::size_t);
+  std::size_t (*find)(const T*, std::size_t, T);
+  std::size_t (*count)(const T*, std::size_t, T);
+};
+
+struct BitwiseTable {
+  void (*andBits)(uint64_t*, const uint64_t*, const uint64_t*, std::size_t);
+  void (*orBits)(uint64_t*, const uint64_t*, const uint64_t*, std::size_t);
+  void (*xorBits)(uint64_t*, const uint64_t*, const uint64_t*, std::size_t);
+  void (*andNotBits)(uint64_t*, const uint64_t*, const uint64_t*, std::size_t);
+  std::size_t (*popcount)(const uint64_t*, std::size_t);
+};
+
+struct ByteSwapTable {
+  void (*swap16)(void*, const void*, std::size_t);
+  void (*swap32)(void*, const void*, std::size_t);
+  void (*swap64)(void*, const void*, std::size_t);
+};
+
+struct KernelTable {
+  MatchTable<uint8_t> bits8;
+  MatchTable<uint16_t> bits16;
+  MatchTable<uint32_t> bits32;
+  MatchTable<uint64_t> bits64;
+  bool (*equal)(const void*, const void*, std::size_t);
+  ReduceTable<int32_t> int32;
+  ReduceTable<uint32_t> uint32;
+  ReduceTable<int64_t> int64;
+  ReduceTable<uint64_t> uint64;
+  ReduceTable<float> float32;
+  ReduceTable<double> float64;
+  BitwiseTable bitwise;
+  uint64_t (*hash)(const void*, std::size_t, uint64_t);
+  ByteSwapTable byteSwap;
+};
+
+const KernelTable scalarTable = {
+  { fillScalar<uint8_t>, findScalar<uint8_t>, countScalar<uint8_t> },
+  { fillScalar<uint16_t>, findScalar<uint16_t>, countScalar<uint16_t> },
+  { fillScalar<uint32_t>, findScalar<uint32_t>, countScalar<uint32_t> },
+  { fillScalar<uint64_t>, findScalar<uint64_t>, countScalar<uint64_t> },
+  equalScalar,
+  { minScalar<int32_t>, maxScalar<int32_t>, sumScalar<int32_t> },
+  { minScalar<uint32_t>, maxScalar<uint32_t>, sumScalar<uint32_t> },
+  { minScalar<int64_t>, maxScalar<int64_t>, sumScalar<int64_t> },
+  { minScalar<uint64_t>, maxScalar<uint64_t>, sumScalar<uint64_t> },
+  { minScalar<float>, maxScalar<float>, sumScalar<float> },
+  { minScalar<double>, maxScalar<double>, sumScalar<double> },
+  { bitwiseScalar<AndBits>, bitwiseScalar<OrBits>, bitwiseScalar<XorBits>,
+    bitwiseScalar<AndNotBits>, popcountScalar },
+  hashScalar,
+  { byteSwapScalar<uint16_t>, byteSwapScalar<uint32_t>, byteSwapScalar<uint64_t> },
+};
+
+/*
+ * Hash stripe accumulation per instruction set. GCC vector extensions
+ * have no 32x32 -> 64-bit multiply and emulate a full 64-bit one, so these
+ * use the pmuludq intrinsics directly and match accumulateScalar().
+ */
+namespace sse2 {
+
+void accumulate(uint64_t* acc, const uint8_t* data, std::size_t stripes, const uint64_t* secret) {
+#if defined(__SSE2__)
+  __m128i lanes[4];
+  for (std::size_t v = 0; v < 4; v++) {
+    lanes[v] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + 2 * v));
+  }
+  for (std::size_t stripe = 0; stripe < stripes; stripe++) {
+    for (std::size_t v = 0; v < 4; v++) {
+      const __m128i value = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(data + stripe * HASH_STRIPE_BYTES + 16 * v));
+      const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + stripe + 2 * v));
+      const __m128i keyed = _mm_xor_si128(value, key);
+      const __m128i product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+      lanes[v] = _mm_add_epi64(lanes[v], _mm_add_epi64(product, _mm_shuffle_epi32(value, 0x4e)));
+    }
+  }
+  for (std::size_t v = 0; v < 4; v++) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2 * v), lanes[v]);
+  }
+#else
+  accumulateScalar(acc, data, stripes, secret);
+#endif
+}
+
+} // namespace sse2
+
+#if defined(__x86_64__) || defined(__i386__)
+namespace avx2 {
+
+__attribute__((target("avx2")))
+void accumulate(uint64_t* acc, const uint8_t* data, std::size_t stripes, const uint64_t* secret) {
+  __m256i lanes[2];
+  for (std::size_t v = 0; v < 2; v++) {
+    lanes[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + 4 * v));
+  }
+  for (std::size_t stripe = 0; stripe < stripes; stripe++) {
+    for (std::size_t v = 0; v < 2; v++) {
+      const __m256i value = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(data + stripe * HASH_STRIPE_BYTES + 32 * v));
+      const __m256i key = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(secret + stripe + 4 * v));
+      const __m256i keyed = _mm256_xor_si256(value, key);
+      const __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+      lanes[v] = _mm256_add_epi64(lanes[v],
+                                  _mm256_add_epi64(product, _mm256_shuffle_epi32(value, 0x4e)));
+    }
+  }
+  for (std::size_t v = 0; v < 2; v++) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + 4 * v), lanes[v]);
+  }
+}
+
+} // namespace avx2
+
+namespace avx512 {
+
+__attribute__((target("avx512f,avx512bw")))
+void accumulate(uint64_t* acc, const uint8_t* data, std::size_t stripes, const uint64_t* secret) {
+  // the all-lanes maskz forms, GCC 12 warns about the undefined source
+  // vector inside the unmasked ones
+  const __mmask8 all64 = 0xff;
+  const __mmask16 all32 = 0xffff;
+  __m512i lanes = _mm512_loadu_si512(acc);
+  for (std::size_t stripe = 0; stripe < stripes; stripe++) {
+    const __m512i value = _mm512_loadu_si512(data + stripe * HASH_STRIPE_BYTES);
+    const __m512i key = _mm512_loadu_si512(secret + stripe);
+    const __m512i keyed = _mm512_xor_si512(value, key);
+    const __m512i product = _mm512_maskz_mul_epu32(all64, keyed,
+                                                   _mm512_maskz_srli_epi64(all64, keyed, 32));
+    const __m512i swapped = _mm512_maskz_shuffle_epi32(all32, value, _MM_PERM_BADC);
+    lanes = _mm512_add_epi64(lanes, _mm512_add_epi64(product, swapped));
+  }
+  _mm512_storeu_si512(acc, lanes);
+}
+
+} // namespace avx512
+#endif
+
+/*
+ * Define one entry point per kernel and element type for an instruction
+ * set, and the table pointing at them.
+ */
+#define OPENLIB_MATCH_KERNELS(TARGET, W, T)                                             \
+  TARGET void fill(T* dst, T value, std::size_t n) { fillVector<W>(dst, value, n); }      \
+  TARGET std::size_t find(const T* data, std::size_t n, T value) {                        \
+    return findVector<W>(data, n, value);                                                 \
+  }                                                                                       \
+  TARGET std::size_t count(const T* data, std::size_t n, T value) {                       \
+    return countVector<W>(data, n, value);                                                \
+  }
+
+#define OPENLIB_REDUCE_KERNELS(TARGET, W, T)                                            \
+  TARGET T min(const T* data, std::size_t n) { return minVector<W>(data, n); }           \
+  TARGET T max(const T* data, std::size_t n) { return maxVector<W>(data, n); }           \
+  TARGET T sum(const T* data, std::size_t n) { return sumVector<W>(data, n); }
+
+#define OPENLIB_DEFINE_KERNELS(NAME, TARGET, W)                                         \
+  namespace NAME {                                                                        \
+    OPENLIB_MATCH_KERNELS(TARGET, W, uint8_t)                                             \
+    OPENLIB_MATCH_KERNELS(TARGET, W, uint16_t)                                            \
+    OPENLIB_MATCH_KERNELS(TARGET, W, uint32_t)                                            \
+    OPENLIB_MATCH_KERNELS(TARGET, W, uint64_t)                                            \
+    OPENLIB_REDUCE_KERNELS(TARGET, W, int32_t)                                            \
+    OPENLIB_REDUCE_KERNELS(TARGET, W, uint32_t)                                           \
+    OPENLIB_REDUCE_KERNELS(TARGET, W, int64_t)                                            \
+    OPENLIB_REDUCE_KERNELS(TARGET, W, uint64_t)                                           \
+    OPENLIB_REDUCE_KERNELS(TARGET, W, float)                                              \
+    OPENLIB_REDUCE_KERNELS(TARGET, W, double)                                             \
+    TARGET bool equal(const void* lhs, const void* rhs, std::size_t bytes) {              \
+      return equalVector<W>(lhs, rhs, bytes);                                             \
+    }                                                                                     \
+    template <class Op>                                                                   \
+    TARGET void bitwise(uint64_t* dst, const uint64_t* a, const uint64_t* b,              \
+                        std::size_t n) {                                                  \
+      bitwiseVector<W, Op>(dst, a, b, n);                                                 \
+    }                                                                                     \
+    TARGET std::size_t popcount(const uint64_t* data, std::size_t n) {                    \
+      return popcountVector<W>(data, n);                                                  \
+    }                                                                                     \
+    uint64_t hash(const void* data, std::size_t n, uint64_t seed) {                       \
+      return hashBytes(data, n, seed, accumulate);                                        \
+    }                                                                                     \
+    template <class T>                                                                    \
+    TARGET void byteSwap(void* dst, const void* src, std::size_t n) {                     \
+      byteSwapVector<W, T>(dst, src, n);                                                  \
+    }                                                                                     \
+    template <class T>                                                                    \
+    MatchTable<T> match() {                                                               \
+      return { fill, find, count };                                                       \
+    }                                                                                     \
+    template <class T>                                                                    \
+    ReduceTable<T> reduce() {                                                             \
+      return { min, max, sum };                                                           \
+    }                                                                                     \
+    const KernelTable table = {                                                           \
+      match<uint8_t>(), match<uint16_t>(), match<uint32_t>(), match<uint64_t>(),          \
+      equal,                                                                              \
+      reduce<int32_t>(), reduce<uint32_t>(), reduce<int64_t>(), reduce<uint64_t>(),       \
+      reduce<float>(), reduce<double>(),                                                  \
+      { bitwise<AndBits>, bitwise<OrBits>, bitwise<XorBits>, bitwise<AndNotBits>,         \
+        popcount },                                                                       \
+      hash,                                                                               \
+      { byteSwap<uint16_t>, byteSwap<uint32_t>, byteSwap<uint64_t> },                     \
+    };                                                                                    \
+  }
+
+// SSE2 is part of the x86-64 baseline and needs no target attribute
+OPENLIB_DEFINE_KERNELS(sse2, , 16)
+
+#if defined(__x86_64__) || defined(__i386__)
+OPENLIB_DEFINE_KERNELS(avx2, __attribute__((target("avx2"))), 32)
+OPENLIB_DEFINE_KERNELS(avx512, __attribute__((target("avx512f,avx512bw"))), 64)
+#endif
+
+bool cpuSupports(Isa isa) {
+  switch (isa) {
+    case Isa::Scalar:
+    case Isa::SSE2:
+      return true;
+#if defined(__x86_64__) || defined(__i386__)
+    case Isa::AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+    case Isa::AVX512:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+    default:
+      return false;
+  }
+}
+
+const KernelTable* tableFor(Isa isa) {
+  switch (isa) {
+    case Isa::SSE2:
+      return &sse2::table;
+#if defined(__x86_64__) || defined(__i386__)
+    case Isa::AVX2:
+      return &avx2::table;
+    case Isa::AVX512:
+      return &avx512::table;
+#endif
+    default:
+      return &scalarTable;
+  }
+}
+
+struct Dispatch {
+  Isa isa;
+  const KernelTable* table;
+};
+
+// picked on first use, so kernels work from static initializers too
+Dispatch& dispatch() {
+  static Dispatch current = []() {
+    Isa isa = Isa::SSE2;
+    if (cpuSupports(Isa::AVX512)) {
+      isa = Isa::AVX512;
+    } else if (cpuSupports(Isa::AVX2)) {
+      isa = Isa::AVX2;
+    }
+    return Dispatch{ isa, tableFor(isa) };
+  }();
+  return current;
+}
+
+const KernelTable& active() {
+  return *dispatch().table;
+}
+
+} // namespace
+
+openlib::kernels::Isa openlib::kernels::activeIsa() {
+  return dispatch().isa;
+}
+
+std::vector<openlib::kernels::Isa> openlib::kernels::supportedIsas() {
+  std::vector<Isa> isas;
+  for (Isa isa : { Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::AVX512 }) {
+    if (cpuSupports(isa)) {
+      isas.push_back(isa);
+    }
+  }
+  return isas;
+}
+
+void openlib::kernels::setIsa(Isa isa) {
+  if (!cpuSupports(isa)) {
+    throw std::invalid_argument("instruction set not supported by this CPU");
+  }
+  dispatch() = Dispatch{ isa, tableFor(isa) };
+}
+
+const char* openlib::kernels::isaName(Isa isa) {
+  switch (isa) {
+    case Isa::Scalar:
+      return "scalar";
+    case Isa::SSE2:
+      return "SSE2";
+    case Isa::AVX2:
+      return "AVX2";
+    case Isa::AVX512:
+      return "AVX-512";
+  }
+  return "unknown";
+}
+
+void openlib::kernels::fill8(uint8_t* dst, uint8_t value, std::size_t count) {
+  active().bits8.fill(dst, value, count);
+}
+
+void openlib::kernels::fill16(uint16_t* dst, uint16_t value, std::size_t count) {
+  active().bits16.fill(dst, value, count);
+}
+
+void openlib::kernels::fill32(uint32_t* dst, uint32_t value, std::size_t count) {
+  active().bits32.fill(dst, value, count);
+}
+
+void openlib::kernels::fill64(uint64_t* dst, uint64_t value, std::size_t count) {
+  active().bits64.fill(dst, value, count);
+}
+
+void openlib::kernels::copy(void* dst, const void* src, std::size_t bytes) {
+  std::memcpy(dst, src, bytes);
+}
+
+bool openlib::kernels::equal(const void* lhs, const void* rhs, std::size_t bytes) {
+  return active().equal(lhs, rhs, bytes);
+}
+
+std::size_t openlib::kernels::find8(const uint8_t* data, std::size_t count, uint8_t value) {
+  return active().bits8.find(data, count, value);
+}
+
+std::size_t openlib::kernels::find16(const uint16_t* data, std::size_t count, uint16_t value) {
+  return active().bits16.find(data, count, value);
+}
+
+std::size_t openlib::kernels::find32(const uint32_t* data, std::size_t count, uint32_t value) {
+  return active().bits32.find(data, count, value);
+}
+
+std::size_t openlib::kernels::find64(const uint64_t* data, std::size_t count, uint64_t value) {
+  return active().bits64.find(data, count, value);
+}
+
+std::size_t openlib::kernels::count8(const uint8_t* data, std::size_t count, uint8_t value) {
+  return active().bits8.count(data, count, value);
+}
+
+std::size_t openlib::kernels::count16(const uint16_t* data, std::size_t count, uint16_t value) {
+  return active().bits16.count(data, count, value);
+}
+
+std::size_t openlib::kernels::count32(const uint32_t* data, std::size_t count, uint32_t value) {
+  return active().bits32.count(data, count, value);
+}
+
+std::size_t openlib::kernels::count64(const uint64_t* data, std::size_t count, uint64_t value) {
+  return active().bits64.count(data, count, value);
+}
+
+void openlib::kernels::and64(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+                             std::size_t count) {
+  active().bitwise.andBits(dst, a, b, count);
+}
+
+void openlib::kernels::or64(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+                            std::size_t count) {
+  active().bitwise.orBits(dst, a, b, count);
+}
+
+void openlib::kernels::xor64(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+                             std::size_t count) {
+  active().bitwise.xorBits(dst, a, b, count);
+}
+
+void openlib::kernels::andNot64(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+                                std::size_t count) {
+  active().bitwise.andNotBits(dst, a, b, count);
+}
+
+std::size_t openlib::kernels::popcount64(const uint64_t* data, std::size_t count) {
+  return active().bitwise.popcount(data, count);
+}
+
+uint64_t openlib::kernels::hash64(const void* data, std::size_t bytes, uint64_t seed) {
+  return active().hash(data, bytes, seed);
+}
+
+void openlib::kernels::byteSwap16(void* dst, const void* src, std::size_t count) {
+  active().byteSwap.swap16(dst, src, count);
+}
+
+void openlib::kernels::byteSwap32(void* dst, const void* src, std::size_t count) {
+  active().byteSwap.swap32(dst, src, count);
+}
+
+void openlib::kernels::byteSwap64(void* dst, const void* src, std::size_t count) {
+  active().byteSwap.swap64(dst, src, count);
+}
+
+#define OPENLIB_REDUCE_ENTRY(T, MEMBER)                                                 \
+  T openlib::kernels::min(const T* data, std::size_t count) {                            \
+    return active().MEMBER.min(data, count);                                           \
+  }                                                                                       \
+  T openlib::kernels::max(const T* data, std::size_t count) {                            \
+    return active().MEMBER.max(data, count);                                           \
+  }                                                                                       \
+  T openlib::kernels::sum(const T* data, std::size_t count) {                            \
+    return active().MEMBER.sum(data, count);                                           \
+  }
+
+OPENLIB_REDUCE_ENTRY(int32_t, int32)
+OPENLIB_REDUCE_ENTRY(uint32_t, uint32)
+OPENLIB_REDUCE_ENTRY(int64_t, int64)
+OPENLIB_REDUCE_ENTRY(uint64_t, uint64)
+OPENLIB_REDUCE_ENTRY(float, float32)
+OPENLIB_REDUCE_ENTRY(double, float64)
@@ -0,0 +1,171 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "openlib/MappedFile.h"
+
+namespace {
+
+std::system_error systemError(const std::string& what) {
+  return std::system_error(errno, std::generic_category(), what);
+}
+
+int adviceFlag(openlib::MappedFile::Advice advice) {
+  switch (advice) {
+    case openlib::MappedFile::Advice::Sequential:
+      return MADV_SEQUENTIAL;
+    case openlib::MappedFile::Advice::Random:
+      return MADV_RANDOM;
+    case openlib::MappedFile::Advice::WillNeed:
+      return MADV_WILLNEED;
+    case openlib::MappedFile::Advice::DontNeed:
+      return MADV_DONTNEED;
+    default:
+      return MADV_NORMAL;
+  }
+}
+
+/*
+ * Closes a file descriptor when it goes out of scope. The mapping stays
+ * valid after the descriptor is closed.
+ */
+class FileDescriptor {
+public:
+  explicit FileDescriptor(int fd) : fd(fd) {}
+  ~FileDescriptor() {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  int get() const {
+    return fd;
+  }
+
+private:
+  int fd;
+};
+
+} // namespace
+
+openlib::MappedFile::MappedFile(const std::string& path, Mode mode):
+    mapping(nullptr), mappingSize(0), mappingMode(mode) {
+
+  FileDescriptor fd(open(path.c_str(), (mode == Mode::Shared ? O_RDWR : O_RDONLY) | O_CLOEXEC));
+  if (fd.get() < 0) {
+    throw systemError("cannot open " + path);
+  }
+
+  struct stat status;
+  if (fstat(fd.get(), &status) != 0) {
+    throw systemError("cannot stat " + path);
+  }
+  mappingSize = status.st_size;
+
+  map(fd.get(), path);
+}
+
+openlib::MappedFile::MappedFile(const std::string& path, const std::size_t& size):
+    mapping(nullptr), mappingSize(size), mappingMode(Mode::Shared) {
+
+  FileDescriptor fd(open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+  if (fd.get() < 0) {
+    throw systemError("cannot create " + path);
+  }
+  if (ftruncate(fd.get(), size) != 0) {
+    throw systemError("cannot resize " + path);
+  }
+
+  map(fd.get(), path);
+}
+
+openlib::MappedFile::MappedFile(MappedFile&& other) noexcept:
+    mapping(other.mapping), mappingSize(other.mappingSize), mappingMode(other.mappingMode) {
+  other.mapping = nullptr;
+  other.mappingSize = 0;
+}
+
+openlib::MappedFile::~MappedFile() {
+  if (mapping != nullptr) {
+    munmap(mapping, mappingSize);
+  }
+}
+
+void openlib::MappedFile::map(int fd, const std::string& path) {
+  // mmap rejects empty mappings, an empty file maps to nullptr
+  if (mappingSize == 0) {
+    return;
+  }
+
+  int protection = mappingMode == Mode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+  int flags = mappingMode == Mode::Shared ? MAP_SHARED : MAP_PRIVATE;
+  void* p = mmap(nullptr, mappingSize, protection, flags, fd, 0);
+  if (p == MAP_FAILED) {
+    throw systemError("cannot map " + path);
+  }
+  mapping = static_cast<uint8_t*>(p);
+}
+
+uint8_t* openlib::MappedFile::data() const {
+  return mapping;
+}
+
+std::size_t openlib::MappedFile::size() const {
+  return mappingSize;
+}
+
+openlib::MappedFile::Mode openlib::MappedFile::mode() const {
+  return mappingMode;
+}
+
+void openlib::MappedFile::advise(Advice advice) {
+  advise(advice, 0, mappingSize);
+}
+
+void openlib::MappedFile::advise(Advice advice, std::size_t offset, std::size_t length) {
+  if (mapping == nullptr || length == 0) {
+    return;
+  }
+
+  // madvise needs a page aligned start
+  const std::size_t pageSize = sysconf(_SC_PAGESIZE);
+  std::size_t start = offset - offset % pageSize;
+  if (madvise(mapping + start, length + (offset - start), adviceFlag(advice)) != 0) {
+    throw systemError("madvise failed");
+  }
+}
+
+void openlib::MappedFile::sync() {
+  if (mapping != nullptr && msync(mapping, mappingSize, MS_SYNC) != 0) {
+    throw systemError("msync failed");
+  }
+}
@@ -0,0 +1,70 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdlib>
+
+#include "openlib/MemoryResource.h"
+
+namespace {
+
+/*
+ * MemoryResource backed by global operator new, or posix_memalign for
+ * alignments operator new does not guarantee.
+ */
+class NewDeleteResource final : public openlib::MemoryResource {
+public:
+  void* allocate(std::size_t bytes, std::size_t alignment) override {
+    if (alignment <= alignof(std::max_align_t)) {
+      return ::operator new(bytes);
+    }
+
+    void* p = nullptr;
+    if (posix_memalign(&p, alignment, bytes == 0 ? alignment : bytes) != 0) {
+      throw std::bad_alloc();
+    }
+    return p;
+  }
+
+  void deallocate(void* p, std::size_t, std::size_t alignment) override {
+    if (alignment <= alignof(std::max_align_t)) {
+      ::operator delete(p);
+    } else {
+      std::free(p);
+    }
+  }
+};
+
+} // namespace
+
+openlib::MemoryResource::~MemoryResource() {
+  // no action needed
+}
+
+openlib::MemoryResource& openlib::defaultResource() {
+  // never destroyed, so pools on top of it may outlive static destructors
+  static MemoryResource* resource = new NewDeleteResource();
+  return *resource;
+}
@@ -0,0 +1,59 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "openlib/Pool.h"
+
+const std::size_t openlib::Pool::MIN_BLOCK_SIZE;
+const std::size_t openlib::Pool::MAX_BLOCK_SIZE;
+const std::size_t openlib::Pool::SIZE_CLASSES;
+const std::size_t openlib::Pool::CHUNK_SIZE;
+
+openlib::Pool::Pool() {
+  for (std::size_t i = 0; i < SIZE_CLASSES; i++) {
+    freeLists[i] = nullptr;
+  }
+}
+
+openlib::Pool::~Pool() {
+  for (void* chunk : chunks) {
+    ::operator delete(chunk);
+  }
+}
+
+void openlib::Pool::refill(std::size_t sizeClass) {
+  const std::size_t blockSize = MIN_BLOCK_SIZE << sizeClass;
+
+  chunks.reserve(chunks.size() + 1);
+  char* chunk = static_cast<char*>(::operator new(CHUNK_SIZE));
+  chunks.push_back(chunk);
+
+  // thread every block of the chunk onto the free list
+  for (std::size_t offset = 0; offset + blockSize <= CHUNK_SIZE; offset += blockSize) {
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + offset);
+    block->next = freeLists[sizeClass];
+    freeLists[sizeClass] = block;
+  }
+}
@@ -0,0 +1,228 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "openlib/SegmentedSerializer.h"
+
+template <class Order>
+const std::size_t openlib::BasicSegmentedSerializer<Order>::DEFAULT_SEGMENT_SIZE;
+
+namespace {
+
+const std::size_t SEGMENT_ALIGNMENT = alignof(std::max_align_t);
+
+} // namespace
+
+template <class Order>
+openlib::BasicSegmentedSerializer<Order>::BasicSegmentedSerializer(std::size_t segmentSize,
+                                                                   MemoryResource& resource):
+    resource(&resource), regularSize(segmentSize), sealedBytes(0), current(nullptr, 0) {
+  if (segmentSize == 0) {
+    throw std::invalid_argument("segmentSize must be at least 1");
+  }
+}
+
+template <class Order>
+openlib::BasicSegmentedSerializer<Order>::BasicSegmentedSerializer(BasicSegmentedSerializer&& other) noexcept:
+    resource(other.resource), regularSize(other.regularSize),
+    segments(std::move(other.segments)), sealedBytes(other.sealedBytes),
+    current(other.current) {
+  other.segments.clear();
+  other.sealedBytes = 0;
+  other.current = BasicWriter<Order>(nullptr, 0);
+}
+
+template <class Order>
+openlib::BasicSegmentedSerializer<Order>::~BasicSegmentedSerializer() {
+  for (const Segment& segment : segments) {
+    release(segment);
+  }
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::putString(const std::string& data) {
+  if (BasicWriter<Order>::MAX_STRING_LENGTH < data.length()) {
+    throw std::length_error("string cannot exceed MAX_STRING_LENGTH");
+  }
+
+  putUInt16(static_cast<uint16_t>(data.length()));
+  put(data.data(), data.length());
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::put(const void* data, std::size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  while (size > current.remaining()) {
+    std::size_t chunk = current.remaining();
+    current.write(bytes, chunk);
+    bytes += chunk;
+    size -= chunk;
+    grow(std::min(size, regularSize));
+  }
+  current.write(bytes, size);
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::putInt16Array(const int16_t* data, std::size_t count) {
+  putArray(data, count, &BasicWriter<Order>::putInt16Array);
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::putUInt16Array(const uint16_t* data, std::size_t count) {
+  putArray(data, count, &BasicWriter<Order>::putUInt16Array);
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::putInt32Array(const int32_t* data, std::size_t count) {
+  putArray(data, count, &BasicWriter<Order>::putInt32Array);
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::putUInt32Array(const uint32_t* data, std::size_t count) {
+  putArray(data, count, &BasicWriter<Order>::putUInt32Array);
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::putInt64Array(const int64_t* data, std::size_t count) {
+  putArray(data, count, &BasicWriter<Order>::putInt64Array);
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::putUInt64Array(const uint64_t* data, std::size_t count) {
+  putArray(data, count, &BasicWriter<Order>::putUInt64Array);
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::putFloatArray(const float* data, std::size_t count) {
+  putArray(data, count, &BasicWriter<Order>::putFloatArray);
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::putDoubleArray(const double* data, std::size_t count) {
+  putArray(data, count, &BasicWriter<Order>::putDoubleArray);
+}
+
+template <class Order>
+std::vector<struct iovec> openlib::BasicSegmentedSerializer<Order>::iovecs() const {
+  std::vector<struct iovec> result;
+  result.reserve(segments.size());
+  for (std::size_t i = 0; i < segments.size(); ++i) {
+    std::size_t bytes = i + 1 == segments.size() ? current.size() : segments[i].size;
+    if (bytes != 0) {
+      struct iovec vector;
+      vector.iov_base = segments[i].data;
+      vector.iov_len = bytes;
+      result.push_back(vector);
+    }
+  }
+  return result;
+}
+
+template <class Order>
+openlib::Array<uint8_t> openlib::BasicSegmentedSerializer<Order>::flatten() const {
+  Array<uint8_t> result(size(), uninitialized);
+  copyTo(result.data());
+  return result;
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::copyTo(void* data) const noexcept {
+  uint8_t* destination = static_cast<uint8_t*>(data);
+  for (std::size_t i = 0; i < segments.size(); ++i) {
+    std::size_t bytes = i + 1 == segments.size() ? current.size() : segments[i].size;
+    if (bytes != 0) {
+      std::memcpy(destination, segments[i].data, bytes);
+      destination += bytes;
+    }
+  }
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::clear() noexcept {
+  while (segments.size() > 1) {
+    release(segments.back());
+    segments.pop_back();
+  }
+  sealedBytes = 0;
+  if (segments.empty()) {
+    current = BasicWriter<Order>(nullptr, 0);
+  } else {
+    current = BasicWriter<Order>(segments.front().data, segments.front().capacity);
+  }
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::grow(std::size_t bytes) {
+  std::size_t capacity = std::max(bytes, regularSize);
+  Segment segment;
+  segment.data = static_cast<uint8_t*>(resource->allocate(capacity, SEGMENT_ALIGNMENT));
+  segment.capacity = capacity;
+  segment.size = 0;
+  try {
+    segments.push_back(segment);
+  } catch (...) {
+    release(segment);
+    throw;
+  }
+
+  if (segments.size() > 1) {
+    Segment& sealed = segments[segments.size() - 2];
+    sealed.size = current.size();
+    sealedBytes += sealed.size;
+  }
+  current = BasicWriter<Order>(segment.data, segment.capacity);
+}
+
+template <class Order>
+template <class type>
+void openlib::BasicSegmentedSerializer<Order>::putArray(
+    const type* data, std::size_t count, void (BasicWriter<Order>::*put)(const type*, std::size_t)) {
+  while (true) {
+    std::size_t fits = std::min(current.remaining() / sizeof(type), count);
+    (current.*put)(data, fits);
+    data += fits;
+    count -= fits;
+    if (count == 0) {
+      return;
+    }
+    // a word never straddles two segments, the few bytes left over go unused
+    grow(std::max(sizeof(type), std::min(count * sizeof(type), regularSize)));
+  }
+}
+
+template <class Order>
+void openlib::BasicSegmentedSerializer<Order>::release(const Segment& segment) noexcept {
+  resource->deallocate(segment.data, segment.capacity, SEGMENT_ALIGNMENT);
+}
+
+// every combination of swaps, so each byte order typedef is one of these
+template class openlib::BasicSegmentedSerializer<openlib::ByteOrder<true, true>>;
+template class openlib::BasicSegmentedSerializer<openlib::ByteOrder<true, false>>;
+template class openlib::BasicSegmentedSerializer<openlib::ByteOrder<false, true>>;
+template class openlib::BasicSegmentedSerializer<openlib::ByteOrder<false, false>>;
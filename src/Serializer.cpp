@@ -24,100 +24,220 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ****************************************************************************/
 
-#include <cstdint>
-#include <cstring>
-
 #include "openlib/Serializer.h"
 
 
-const std::size_t openlib::Serializer::MAX_STRING_LENGTH = UINT16_MAX;
+template <class Order>
+const std::size_t openlib::BasicSerializer<Order>::MAX_STRING_LENGTH =
+    openlib::BasicWriter<Order>::MAX_STRING_LENGTH;
+
+template <class Order>
+openlib::BasicSerializer<Order>::BasicSerializer(const std::size_t& capacity):
+    buffer(capacity), output(buffer.data(), buffer.size()){
+
+}
+
+template <class Order>
+openlib::BasicSerializer<Order>::BasicSerializer(const std::size_t& capacity, Uninitialized):
+    buffer(capacity, uninitialized), output(buffer.data(), buffer.size()){
+
+}
+
+template <class Order>
+openlib::BasicSerializer<Order>::BasicSerializer(const std::size_t& capacity, MemoryResource& resource):
+    buffer(capacity, resource), output(buffer.data(), buffer.size()){
+
+}
+
+template <class Order>
+openlib::BasicSerializer<Order>::BasicSerializer(const std::size_t& capacity, Uninitialized,
+                                                 MemoryResource& resource):
+    buffer(capacity, uninitialized, resource), output(buffer.data(), buffer.size()){
+
+}
+
+template <class Order>
+std::size_t openlib::BasicSerializer<Order>::size() const {
+  return output.size();
+}
+
+template <class Order>
+std::size_t openlib::BasicSerializer<Order>::capacity() const {
+  return output.capacity();
+}
+
+template <class Order>
+std::size_t openlib::BasicSerializer<Order>::remaining() const {
+  return output.remaining();
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putChar(char data) {
+  output.putChar(data);
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putInt8(int8_t data) {
+  output.putInt8(data);
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putUInt8(uint8_t data) {
+  output.putUInt8(data);
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putInt16(int16_t data) {
+  output.putInt16(data);
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putUInt16(uint16_t data) {
+  output.putUInt16(data);
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putInt32(int32_t data) {
+  output.putInt32(data);
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putUInt32(uint32_t data) {
+  output.putUInt32(data);
+}
 
-openlib::Serializer::Serializer(const std::size_t& capacity):
-    buffer(capacity), position(buffer.data()){
+template <class Order>
+void openlib::BasicSerializer<Order>::putInt64(int64_t data) {
+  output.putInt64(data);
+}
 
+template <class Order>
+void openlib::BasicSerializer<Order>::putUInt64(uint64_t data) {
+  output.putUInt64(data);
 }
 
-std::size_t openlib::Serializer::size() const {
-  return position - data();
+template <class Order>
+void openlib::BasicSerializer<Order>::putFloat(float data) {
+  output.putFloat(data);
 }
 
-std::size_t openlib::Serializer::capacity() const {
-  return buffer.size();
+template <class Order>
+void openlib::BasicSerializer<Order>::putDouble(double data) {
+  output.putDouble(data);
 }
 
-std::size_t openlib::Serializer::remaining() const {
-  return capacity() - size();
+template <class Order>
+void openlib::BasicSerializer<Order>::putString(const std::string& data) {
+  output.putString(data);
 }
 
-void openlib::Serializer::putChar(char data) {
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::put(const void* data, std::size_t size) {
+  output.put(data, size);
 }
 
-void openlib::Serializer::putInt8(int8_t data) {
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::put(ArrayView<const uint8_t> data) {
+  output.put(data.data(), data.size());
 }
 
-void openlib::Serializer::putUInt8(uint8_t data) {
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::putInt16Array(const int16_t* data, std::size_t count) {
+  output.putInt16Array(data, count);
 }
 
-void openlib::Serializer::putInt16(int16_t data) {
-  data = htobe16(data);
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::putUInt16Array(const uint16_t* data, std::size_t count) {
+  output.putUInt16Array(data, count);
 }
 
-void openlib::Serializer::putUInt16(uint16_t data) {
-  data = htobe16(data);
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::putInt32Array(const int32_t* data, std::size_t count) {
+  output.putInt32Array(data, count);
 }
 
-void openlib::Serializer::putInt32(int32_t data) {
-  data = htobe32(data);
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::putUInt32Array(const uint32_t* data, std::size_t count) {
+  output.putUInt32Array(data, count);
 }
 
-void openlib::Serializer::putUInt32(uint32_t data) {
-  data = htobe32(data);
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::putInt64Array(const int64_t* data, std::size_t count) {
+  output.putInt64Array(data, count);
 }
 
-void openlib::Serializer::putInt64(int64_t data) {
-  data = htobe64(data);
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::putUInt64Array(const uint64_t* data, std::size_t count) {
+  output.putUInt64Array(data, count);
 }
 
-void openlib::Serializer::putUInt64(uint64_t data) {
-  data = htobe64(data);
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::putFloatArray(const float* data, std::size_t count) {
+  output.putFloatArray(data, count);
 }
 
-void openlib::Serializer::putFloat(float data) {
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::putDoubleArray(const double* data, std::size_t count) {
+  output.putDoubleArray(data, count);
 }
 
-void openlib::Serializer::putDouble(double data) {
-  put(reinterpret_cast<const uint8_t*>(&data), sizeof(data));
+template <class Order>
+void openlib::BasicSerializer<Order>::putInt16Array(ArrayView<const int16_t> data) {
+  output.putInt16Array(data);
 }
 
-void openlib::Serializer::putString(const std::string& data) {
-  if (Serializer::MAX_STRING_LENGTH < data.length()) {
-    throw std::length_error("string cannot exceed MAX_STRING_LENGTH");
-  }
+template <class Order>
+void openlib::BasicSerializer<Order>::putUInt16Array(ArrayView<const uint16_t> data) {
+  output.putUInt16Array(data);
+}
 
-  putUInt16(data.length());
-  put(reinterpret_cast<const uint8_t*>(data.c_str()), data.length());
+template <class Order>
+void openlib::BasicSerializer<Order>::putInt32Array(ArrayView<const int32_t> data) {
+  output.putInt32Array(data);
 }
 
-void openlib::Serializer::put(const void* data, std::size_t size) {
-  if (remaining() < size) {
-    throw std::length_error("not enough capacity left in Serializer");
-  }
+template <class Order>
+void openlib::BasicSerializer<Order>::putUInt32Array(ArrayView<const uint32_t> data) {
+  output.putUInt32Array(data);
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putInt64Array(ArrayView<const int64_t> data) {
+  output.putInt64Array(data);
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putUInt64Array(ArrayView<const uint64_t> data) {
+  output.putUInt64Array(data);
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putFloatArray(ArrayView<const float> data) {
+  output.putFloatArray(data);
+}
+
+template <class Order>
+void openlib::BasicSerializer<Order>::putDoubleArray(ArrayView<const double> data) {
+  output.putDoubleArray(data);
+}
+
+template <class Order>
+openlib::ArrayView<const uint8_t> openlib::BasicSerializer<Order>::view() const {
+  return output.view();
+}
 
-  std::memcpy(position, data, size);
-  position += size;
+template <class Order>
+uint8_t* openlib::BasicSerializer<Order>::data() const {
+  return output.data();
 }
 
-uint8_t* openlib::Serializer::data() const {
-  return buffer.data();
+template <class Order>
+openlib::BasicWriter<Order>& openlib::BasicSerializer<Order>::writer() noexcept {
+  return output;
 }
 
+// every combination of swaps, so each byte order typedef is one of these
+template class openlib::BasicSerializer<openlib::ByteOrder<true, true>>;
+template class openlib::BasicSerializer<openlib::ByteOrder<true, false>>;
+template class openlib::BasicSerializer<openlib::ByteOrder<false, true>>;
+template class openlib::BasicSerializer<openlib::ByteOrder<false, false>>;
@@ -0,0 +1,219 @@
+/****************************************************************************
+Copyright (c) 2016, 2018 OpenLib Proje
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or witho
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, th
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentati
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, T
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE A
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIAB
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTI
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS 
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEV
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE U
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdlib>
+#include <exception>
+
+#include "openlib/ThreadPool.h"
+
+namespace {
+
+// pool and queue index of the current worker thread, if any
+thread_local const openlib::ThreadPool* workerPool = nullptr;
+thread_local std::size_t workerIndex = 0;
+
+// a submitted task that throws terminates, wherever it runs, rather than
+// unwinding into whichever parallelFor() or destructor happened to steal it
+void runTask(const std::function<void()>& task) noexcept {
+  task();
+}
+
+std::size_t defaultThreads() {
+  std::size_t threads = std::thread::hardware_concurrency();
+  return threads == 0 ? 1 : threads;
+}
+
+} // namespace
+
+openlib::ThreadPool::ThreadPool(std::size_t threads):
+    threadCount(threads == 0 ? defaultThreads() : threads),
+    queued(0),
+    stopping(false) {
+
+  // queues[0 .. threadCount - 2] belong to workers, the last is for injection
+  for (std::size_t i = 0; i < threadCount; i++) {
+    queues.emplace_back(new Queue());
+  }
+  for (std::size_t i = 0; i + 1 < threadCount; i++) {
+    workers.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+openlib::ThreadPool::~ThreadPool() {
+  // let the workers drain what is queued
+  while (queued.load() > 0 && !workers.empty()) {
+    std::this_thread::yield();
+  }
+  while (queued.load() > 0 && runOne(threadCount - 1)) {
+    // no workers, run the remaining tasks here
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(sleepLock);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+std::size_t openlib::ThreadPool::size() const {
+  return threadCount;
+}
+
+std::size_t openlib::ThreadPool::currentQueue() const {
+  return workerPool == this ? workerIndex : threadCount - 1;
+}
+
+void openlib::ThreadPool::submit(std::function<void()> task) {
+  Queue& queue = *queues[currentQueue()];
+  // count before publishing, a worker may pop and decrement right away
+  queued++;
+  try {
+    std::lock_guard<std::mutex> guard(queue.lock);
+    queue.tasks.push_back(std::move(task));
+  } catch (...) {
+    queued--;
+    throw;
+  }
+
+  if (!workers.empty()) {
+    std::lock_guard<std::mutex> guard(sleepLock);
+    wake.notify_one();
+  }
+}
+
+bool openlib::ThreadPool::runOne(std::size_t self) {
+  std::function<void()> task;
+
+  // own queue, newest first
+  {
+    Queue& queue = *queues[self];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+  }
+
+  // steal the oldest task from someone else
+  for (std::size_t i = 1; !task && i < threadCount; i++) {
+    Queue& queue = *queues[(self + i) % threadCount];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+  }
+
+  if (!task) {
+    return false;
+  }
+  queued--;
+  runTask(task);
+  return true;
+}
+
+void openlib::ThreadPool::workerLoop(std::size_t self) {
+  workerPool = this;
+  workerIndex = self;
+
+  while (true) {
+    if (runOne(self)) {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> guard(sleepLock);
+    wake.wait(guard, [this]() {
+      return stopping.load() || queued.load() > 0;
+    });
+    if (stopping.load() && queued.load() == 0) {
+      return;
+    }
+  }
+}
+
+void openlib::ThreadPool::parallelFor(std::size_t count,
+                                      const std::function<void(std::size_t)>& function) {
+  if (count == 0) {
+    return;
+  }
+
+  std::atomic<std::size_t> remaining(count);
+  std::exception_ptr error;
+  std::mutex errorLock;
+
+  auto run = [&](std::size_t i) {
+    try {
+      function(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(errorLock);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+    remaining--;
+  };
+
+  // queue all but the first task, then run the first here. The queued
+  // tasks point into this frame, so if queueing fails the ones already
+  // queued must finish before the exception leaves.
+  std::exception_ptr submitError;
+  std::size_t submitted = 1;
+  try {
+    for (; submitted < count; submitted++) {
+      const std::size_t i = submitted;
+      submit([&run, i]() { run(i); });
+    }
+  } catch (...) {
+    submitError = std::current_exception();
+    remaining -= count - submitted;
+  }
+  run(0);
+
+  const std::size_t self = currentQueue();
+  while (remaining.load() > 0) {
+    if (!runOne(self)) {
+      std::this_thread::yield();
+    }
+  }
+
+  if (submitError) {
+    std::rethrow_exception(submitError);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+openlib::ThreadPool& openlib::ThreadPool::shared() {
+  static ThreadPool pool([]() {
+    const char* value = std::getenv("OPENLIB_THREADS");
+    return value ? std::strtoull(value, nullptr, 10) : 0;
+  }());
+  return pool;
+}
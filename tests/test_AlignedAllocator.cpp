@@ -0,0 +1,93 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <openlib/AlignedAllocator.h>
+#include <openlib/Array.h>
+#include <openlib/FlatArray.h>
+
+namespace {
+
+bool isAligned(const void* p, std::size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+TEST(AlignedAllocator, alignmentKnownAtCompileTime) {
+  static_assert(openlib::FlatArray<float>::alignment == alignof(float), "");
+  static_assert(openlib::FlatArray<float, openlib::AlignedAllocator<float>>::alignment == 64, "");
+  static_assert(openlib::FlatArray<float, openlib::AlignedAllocator<float, 32>>::alignment == 32, "");
+  static_assert(openlib::FlatArray<float, openlib::PageAllocator<float>>::alignment == 4096, "");
+  static_assert(openlib::FlatArray<float, openlib::HugePageAllocator<float>>::alignment
+                == 2 * 1024 * 1024, "");
+  static_assert(openlib::Array<float, openlib::AlignedAllocator<float>>::alignment == 64, "");
+  // if this test compiles it passe
+}
+
+TEST(AlignedAllocator, cacheLineAligned) {
+  for (std::size_t size = 1; size < 100; size += 7) {
+    openlib::FlatArray<char, openlib::AlignedAllocator<char>> array(size);
+    EXPECT_TRUE(isAligned(array.data(), 64));
+  }
+}
+
+TEST(AlignedAllocator, customAlignment) {
+  openlib::FlatArray<double, openlib::AlignedAllocator<double, 256>> array(3);
+  EXPECT_TRUE(isAligned(array.data(), 256));
+}
+
+TEST(AlignedAllocator, pageAligned) {
+  openlib::FlatArray<int, openlib::PageAllocator<int>> array(5000);
+  EXPECT_TRUE(isAligned(array.data(), 4096));
+
+  array.fill(3);
+  EXPECT_EQ(array[4999], 3);
+}
+
+TEST(AlignedAllocator, hugePageAligned) {
+  openlib::FlatArray<uint64_t, openlib::HugePageAllocator<uint64_t>> array(1 << 20);
+  EXPECT_TRUE(isAligned(array.data(), 2 * 1024 * 1024));
+
+  array.fill(7);
+  EXPECT_EQ(array[(1 << 20) - 1], 7);
+}
+
+TEST(AlignedAllocator, emptyArray) {
+  openlib::FlatArray<int, openlib::PageAllocator<int>> pages(0);
+  openlib::FlatArray<int, openlib::AlignedAllocator<int>> aligned(0);
+  EXPECT_EQ(pages.size(), 0);
+  EXPECT_EQ(aligned.size(), 0);
+}
+
+TEST(AlignedAllocator, arrayWithAlignedAllocator) {
+  openlib::Array<float, openlib::AlignedAllocator<float>> array = {1.0f, 2.0f};
+  EXPECT_TRUE(isAligned(array.data(), 64));
+  EXPECT_EQ(array[1], 2.0f);
+}
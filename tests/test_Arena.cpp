@@ -0,0 +1,121 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Arena.h>
+#include <openlib/FlatArray.h>
+
+TEST(Arena, isConstructable) {
+  openlib::Arena arena;
+  // if the test gets this far it passe
+}
+
+TEST(Arena, allocateRespectsAlignment) {
+  openlib::Arena arena(256);
+
+  for (std::size_t alignment = 1; alignment <= 128; alignment *= 2) {
+    arena.allocate(1, 1);
+    void* p = arena.allocate(3, alignment);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignment, 0);
+  }
+}
+
+TEST(Arena, allocationsDoNotOverlap) {
+  openlib::Arena arena(64);
+
+  uint8_t* a = static_cast<uint8_t*>(arena.allocate(40, 1));
+  uint8_t* b = static_cast<uint8_t*>(arena.allocate(40, 1));
+  EXPECT_TRUE(a + 40 <= b || b + 40 <= a);
+}
+
+TEST(Arena, allocationMayFillBlockExactly) {
+  openlib::Arena arena(64);
+
+  uint8_t* a = static_cast<uint8_t*>(arena.allocate(32, 1));
+  uint8_t* b = static_cast<uint8_t*>(arena.allocate(32, 1));
+  EXPECT_EQ(a + 32, b);
+  EXPECT_NE(arena.allocate(0, 1), nullptr);
+  EXPECT_EQ(arena.allocated(), 64);
+}
+
+TEST(Arena, zeroBytesBeforeFirstBlock) {
+  openlib::Arena arena;
+
+  EXPECT_NE(arena.allocate(0, 1), nullptr);
+}
+
+TEST(Arena, allocateLargerThanBlockSize) {
+  openlib::Arena arena(64);
+
+  uint8_t* p = static_cast<uint8_t*>(arena.allocate(1024, 8));
+  p[0] = 1;
+  p[1023] = 2;
+  EXPECT_EQ(p[1023], 2);
+}
+
+TEST(Arena, allocatedTracksBytes) {
+  openlib::Arena arena;
+
+  arena.allocate(100, 1);
+  EXPECT_EQ(arena.allocated(), 100);
+}
+
+TEST(Arena, resetReusesMemory) {
+  openlib::Arena arena;
+
+  void* first = arena.allocate(100, 8);
+  arena.reset();
+  void* second = arena.allocate(100, 8);
+
+  EXPECT_EQ(arena.allocated(), 100);
+  EXPECT_EQ(first, second);
+}
+
+TEST(Arena, flatArrayWithArenaAllocator) {
+  openlib::Arena arena;
+  openlib::ArenaAllocator<int> allocator(arena);
+
+  openlib::FlatArray<int, openlib::ArenaAllocator<int>> array({1, 2, 3}, allocator);
+
+  EXPECT_EQ(array.size(), 3);
+  EXPECT_EQ(array[2], 3);
+  EXPECT_EQ(arena.allocated(), 3 * sizeof(int));
+}
+
+TEST(Arena, allocatorsCompareByArena) {
+  openlib::Arena arena1;
+  openlib::Arena arena2;
+
+  openlib::ArenaAllocator<int> a(arena1);
+  openlib::ArenaAllocator<double> b(arena1);
+  openlib::ArenaAllocator<int> c(arena2);
+
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(a != c);
+}
@@ -173,3 +173,13 @@ TEST(Array, copyConstructor) {
   EXPECT_EQ(array1[2], array2[2]);
 }
 
+
+TEST(Array, uninitializedConstructor) {
+  openlib::Array<int> array(3, openlib::uninitialized);
+  array.fill(7);
+
+  EXPECT_EQ(array.size(), 3);
+  for (const auto& value : array) {
+    EXPECT_EQ(value, 7);
+  }
+}
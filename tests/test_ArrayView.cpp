@@ -0,0 +1,220 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Array.h>
+#include <openlib/ArrayView.h>
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+#include <openlib/SmallArray.h>
+#include <openlib/StaticArray.h>
+
+#include "AllocationCounter.h"
+
+namespace {
+
+int total(openlib::ArraySlice<int> slice) {
+  return std::accumulate(slice.begin(), slice.end(), 0);
+}
+
+} // namespace
+
+TEST(ArrayView, isCheapToPass) {
+  static_assert(sizeof(openlib::ArrayView<int>) == 2 * sizeof(void*), "pointer and size");
+  static_assert(std::is_trivially_copyable<openlib::ArrayView<int>>::value, "trivial copy");
+
+  openlib::ArrayView<int> empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.size(), 0);
+}
+
+TEST(ArrayView, viewsAnyArray) {
+  openlib::FlatArray<int> flat = {1, 2, 3};
+  openlib::Array<int> array = {1, 2, 3};
+  openlib::StaticArray<int, 3> fixed = {1, 2, 3};
+  openlib::SmallArray<int, 4> small = {1, 2, 3};
+  const openlib::FlatArray<int>& constant = flat;
+
+  EXPECT_EQ(total(flat), 6);
+  EXPECT_EQ(total(array), 6);
+  EXPECT_EQ(total(fixed), 6);
+  EXPECT_EQ(total(small), 6);
+  EXPECT_EQ(total(constant), 6);
+
+  openlib::ArrayView<int> view = flat;
+  EXPECT_EQ(view.data(), flat.data());
+  EXPECT_EQ(view.size(), 3);
+  EXPECT_EQ(total(view), 6);
+
+  auto deduced = openlib::makeView(array);
+  static_assert(std::is_same<decltype(deduced), openlib::ArrayView<int>>::value, "deduced");
+  EXPECT_EQ(deduced.data(), array.data());
+
+  static_assert(!std::is_convertible<const openlib::StaticArray<int, 3>&,
+                                     openlib::ArrayView<int>>::value,
+                "const arrays only give read-only views");
+}
+
+TEST(ArrayView, temporariesOnlyBindReadOnly) {
+  static_assert(!std::is_convertible<openlib::FlatArray<int>&&, openlib::ArrayView<int>>::value,
+                "a mutable view of a temporary would dangle");
+  static_assert(std::is_convertible<openlib::FlatArray<int>&, openlib::ArrayView<int>>::value,
+                "mutable views of lvalues");
+  static_assert(std::is_convertible<openlib::FlatArray<int>&&, openlib::ArraySlice<int>>::value,
+                "read-only views of temporaries, for function parameters");
+  static_assert(std::is_convertible<openlib::ArrayView<int>&&, openlib::ArraySlice<int>>::value,
+                "views of views");
+
+  EXPECT_EQ(total(openlib::FlatArray<int>({1, 2, 3})), 6);
+}
+
+TEST(ArrayView, writesThrough) {
+  openlib::FlatArray<int> array(6);
+  openlib::ArrayView<int> view = array;
+
+  view[0] = 7;
+  view.slice(1, 2).fill(9);
+  view.back() = 5;
+
+  EXPECT_EQ(array[0], 7);
+  EXPECT_EQ(array[1], 9);
+  EXPECT_EQ(array[2], 9);
+  EXPECT_EQ(array[3], 0);
+  EXPECT_EQ(array[5], 5);
+}
+
+TEST(ArrayView, slice) {
+  openlib::FlatArray<int> array = {0, 1, 2, 3, 4, 5, 6, 7};
+  openlib::ArrayView<int> view = array;
+
+  auto middle = view.slice(2, 4);
+  EXPECT_EQ(middle.data(), array.data() + 2);
+  EXPECT_EQ(middle.size(), 4);
+  EXPECT_EQ(middle.front(), 2);
+  EXPECT_EQ(middle.back(), 5);
+
+  auto tail = middle.slice(3);
+  EXPECT_EQ(tail.size(), 1);
+  EXPECT_EQ(tail[0], 5);
+
+  EXPECT_EQ(view.slice(8).size(), 0);
+  EXPECT_EQ(view.slice(8, 0).size(), 0);
+  EXPECT_THROW(view.slice(9), std::out_of_range);
+  EXPECT_THROW(view.slice(4, 5), std::out_of_range);
+  EXPECT_THROW(view.slice(1, SIZE_MAX), std::out_of_range);
+}
+
+TEST(ArrayView, slicingNeverAllocates) {
+  openlib::FlatArray<int> array(1000);
+  array.fill(1);
+
+  const std::size_t before = openlib::test::allocationCount();
+  int sum = 0;
+  openlib::ArraySlice<int> view = array;
+  for (std::size_t offset = 0; offset < view.size(); offset += 100) {
+    sum += openlib::sum(view.slice(offset, 100));
+  }
+  EXPECT_EQ(openlib::test::allocationCount(), before);
+  EXPECT_EQ(sum, 1000);
+}
+
+TEST(ArrayView, worksWithKernels) {
+  openlib::FlatArray<float> array = {4, 1, 3, 2, 8};
+  openlib::ArraySlice<float> view = openlib::ArraySlice<float>(array).slice(1, 3);
+
+  EXPECT_EQ(openlib::sum(view), 6);
+  EXPECT_EQ(openlib::min(view), 1);
+  EXPECT_EQ(openlib::max(view), 3);
+  EXPECT_EQ(openlib::find(view, 3.0f), 1);
+
+  openlib::FlatArray<float> copy(3);
+  openlib::copy(copy, view);
+  EXPECT_TRUE(openlib::equal(copy, view));
+}
+
+TEST(ArrayView, strided) {
+  openlib::FlatArray<int> array = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  openlib::ArrayView<int> view = array;
+
+  auto evens = view.strided(2);
+  EXPECT_EQ(evens.size(), 5);
+  EXPECT_EQ(evens.stride(), 2);
+  EXPECT_EQ(evens[3], 6);
+  EXPECT_EQ(evens.back(), 8);
+
+  auto thirds = view.strided(3, 1);
+  std::vector<int> seen(thirds.begin(), thirds.end());
+  EXPECT_EQ(seen, std::vector<int>({1, 4, 7}));
+
+  thirds.fill(-1);
+  EXPECT_EQ(array[1], -1);
+  EXPECT_EQ(array[4], -1);
+  EXPECT_EQ(array[7], -1);
+  EXPECT_EQ(array[8], 8);
+
+  EXPECT_EQ(view.strided(4, 10).size(), 0);
+  EXPECT_THROW(view.strided(0), std::invalid_argument);
+  EXPECT_THROW(view.strided(1, 11), std::out_of_range);
+}
+
+TEST(ArrayView, stridedIteratorNonDividingStride) {
+  openlib::FlatArray<int> array = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  openlib::ArrayView<int> view = array;
+
+  // 10 elements with stride 3, one past the last element would be at 12
+  auto thirds = view.strided(3);
+  EXPECT_EQ(thirds.size(), 4);
+  std::vector<int> seen(thirds.begin(), thirds.end());
+  EXPECT_EQ(seen, std::vector<int>({0, 3, 6, 9}));
+
+  auto empty = view.strided(4, 10);
+  EXPECT_TRUE(empty.begin() == empty.end());
+}
+
+TEST(ArrayView, asBytes) {
+  openlib::FlatArray<uint32_t> array = {0x01020304, 0x05060708};
+
+  auto bytes = openlib::asBytes(array);
+  static_assert(std::is_same<decltype(bytes), openlib::ArrayView<const uint8_t>>::value, "");
+  EXPECT_EQ(bytes.size(), 8);
+  EXPECT_EQ(static_cast<const void*>(bytes.data()), static_cast<const void*>(array.data()));
+
+  auto writable = openlib::asWritableBytes(array);
+  writable.slice(4).fill(0);
+  EXPECT_EQ(array[0], 0x01020304u);
+  EXPECT_EQ(array[1], 0u);
+
+  openlib::ArrayView<uint32_t> view = array;
+  EXPECT_EQ(openlib::asBytes(view.slice(1)).size(), 4);
+}
@@ -0,0 +1,192 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/BitArray.h>
+
+namespace {
+
+// random bits with roughly one in density set, and the same bits as bools
+std::pair<openlib::BitArray, std::vector<bool>> randomBits(std::size_t size, int density,
+                                                           unsigned seed) {
+  std::mt19937 engine(seed);
+  std::uniform_int_distribution<int> distribution(0, density - 1);
+  openlib::BitArray bits(size);
+  std::vector<bool> reference(size);
+  for (std::size_t i = 0; i < size; i++) {
+    reference[i] = distribution(engine) == 0;
+    bits.set(i, reference[i]);
+  }
+  return std::make_pair(std::move(bits), std::move(reference));
+}
+
+} // namespace
+
+TEST(BitArray, isConstructable) {
+  openlib::BitArray bits(130);
+  EXPECT_EQ(bits.size(), 130);
+  EXPECT_EQ(bits.wordCount(), 3);
+  EXPECT_TRUE(bits.none());
+
+  openlib::BitArray ones(130, true);
+  EXPECT_TRUE(ones.all());
+  EXPECT_EQ(ones.count(), 130);
+  // bits past size() stay clear
+  EXPECT_EQ(ones.data()[2], 3u);
+
+  openlib::BitArray empty(0);
+  EXPECT_EQ(empty.wordCount(), 0);
+  EXPECT_TRUE(empty.all());
+  EXPECT_EQ(empty.findFirst(), 0);
+}
+
+TEST(BitArray, setAndTest) {
+  openlib::BitArray bits(100);
+  bits.set(3);
+  bits.set(64);
+  bits.set(99, true);
+  EXPECT_TRUE(bits.test(3));
+  EXPECT_TRUE(bits[64]);
+  EXPECT_TRUE(bits.test(99));
+  EXPECT_FALSE(bits.test(4));
+  EXPECT_EQ(bits.count(), 3);
+
+  bits.reset(3);
+  bits.flip(64);
+  bits.flip(65);
+  bits.set(99, false);
+  EXPECT_FALSE(bits.test(3));
+  EXPECT_FALSE(bits.test(64));
+  EXPECT_TRUE(bits.test(65));
+  EXPECT_EQ(bits.count(), 1);
+
+  EXPECT_THROW(bits.test(100), std::out_of_range);
+  EXPECT_THROW(bits.set(100), std::out_of_range);
+  EXPECT_THROW(bits.flip(100), std::out_of_range);
+}
+
+TEST(BitArray, fillAndFlip) {
+  openlib::BitArray bits(77);
+  bits.fill(true);
+  EXPECT_EQ(bits.count(), 77);
+  bits.reset(10);
+  bits.flip();
+  EXPECT_EQ(bits.count(), 1);
+  EXPECT_TRUE(bits.test(10));
+  EXPECT_EQ(bits.data()[1] >> 13, 0u);
+  bits.fill(false);
+  EXPECT_TRUE(bits.none());
+}
+
+TEST(BitArray, logicalOperations) {
+  const std::size_t size = 10007;
+  auto a = randomBits(size, 2, 1);
+  auto b = randomBits(size, 3, 2);
+
+  openlib::BitArray andBits(a.first);
+  andBits &= b.first;
+  openlib::BitArray orBits(a.first);
+  orBits |= b.first;
+  openlib::BitArray xorBits(a.first);
+  xorBits ^= b.first;
+  openlib::BitArray andNotBits(a.first);
+  andNotBits.andNot(b.first);
+
+  for (std::size_t i = 0; i < size; i++) {
+    ASSERT_EQ(andBits[i], a.second[i] && b.second[i]);
+    ASSERT_EQ(orBits[i], a.second[i] || b.second[i]);
+    ASSERT_EQ(xorBits[i], a.second[i] != b.second[i]);
+    ASSERT_EQ(andNotBits[i], a.second[i] && !b.second[i]);
+  }
+
+  openlib::BitArray other(size + 1);
+  EXPECT_THROW(andBits &= other, std::length_error);
+  EXPECT_THROW(andBits.andNot(other), std::length_error);
+}
+
+TEST(BitArray, countAndFind) {
+  const std::size_t size = 5000;
+  auto random = randomBits(size, 50, 3);
+  const openlib::BitArray& bits = random.first;
+
+  std::vector<std::size_t> expected;
+  for (std::size_t i = 0; i < size; i++) {
+    if (random.second[i]) {
+      expected.push_back(i);
+    }
+  }
+  EXPECT_EQ(bits.count(), expected.size());
+
+  std::vector<std::size_t> found;
+  for (std::size_t i = bits.findFirst(); i < bits.size(); i = bits.findNext(i)) {
+    found.push_back(i);
+  }
+  EXPECT_EQ(found, expected);
+
+  openlib::BitArray last(200);
+  last.set(199);
+  EXPECT_EQ(last.findFirst(), 199);
+  EXPECT_EQ(last.findNext(199), 200);
+  EXPECT_EQ(last.findNext(500), 200);
+}
+
+TEST(BitArray, rankAndSelect) {
+  const std::size_t size = 20011;
+  auto random = randomBits(size, 7, 4);
+  const openlib::BitArray& bits = random.first;
+  openlib::BitRankIndex index(bits);
+
+  std::size_t rank = 0;
+  for (std::size_t i = 0; i <= size; i++) {
+    ASSERT_EQ(bits.rank(i), rank);
+    ASSERT_EQ(index.rank(i), rank);
+    if (i < size && random.second[i]) {
+      ASSERT_EQ(bits.select(rank), i);
+      ASSERT_EQ(index.select(rank), i);
+      rank++;
+    }
+  }
+  EXPECT_EQ(index.count(), rank);
+  EXPECT_EQ(bits.select(rank), size);
+  EXPECT_EQ(index.select(rank), size);
+  EXPECT_THROW(bits.rank(size + 1), std::out_of_range);
+  EXPECT_THROW(index.rank(size + 1), std::out_of_range);
+}
+
+TEST(BitArray, isMovable) {
+  openlib::BitArray bits(64, true);
+  const uint64_t* words = bits.data();
+  openlib::BitArray moved(std::move(bits));
+  EXPECT_EQ(moved.data(), words);
+  EXPECT_EQ(moved.count(), 64);
+  EXPECT_EQ(bits.size(), 0);
+}
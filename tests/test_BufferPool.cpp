@@ -0,0 +1,254 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/BufferPool.h>
+#include <openlib/FlatArray.h>
+#include <openlib/Serializer.h>
+
+namespace {
+
+// counts what reaches upstream
+class CountingResource : public openlib::MemoryResource {
+public:
+  std::size_t allocations = 0;
+  std::size_t outstanding = 0;
+
+  void* allocate(std::size_t bytes, std::size_t alignment) override {
+    allocations++;
+    outstanding++;
+    return openlib::defaultResource().allocate(bytes, alignment);
+  }
+
+  void deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    outstanding--;
+    openlib::defaultResource().deallocate(p, bytes, alignment);
+  }
+};
+
+} // namespace
+
+TEST(BufferPool, sizeClass) {
+  EXPECT_EQ(openlib::BufferPool::sizeClass(1), 0);
+  EXPECT_EQ(openlib::BufferPool::sizeClass(64), 0);
+  EXPECT_EQ(openlib::BufferPool::sizeClass(65), 1);
+  EXPECT_EQ(openlib::BufferPool::sizeClass(4096), 6);
+  EXPECT_EQ(openlib::BufferPool::sizeClass(openlib::BufferPool::MAX_BLOCK_SIZE),
+            openlib::BufferPool::SIZE_CLASSES - 1);
+}
+
+TEST(BufferPool, reusesFreedBuffers) {
+  CountingResource upstream;
+  openlib::BufferPool pool(upstream);
+
+  void* first = pool.allocate(1000, 8);
+  pool.deallocate(first, 1000, 8);
+  void* second = pool.allocate(1024, 8);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 64, 0);
+  pool.deallocate(second, 1024, 8);
+
+  EXPECT_EQ(upstream.allocations, 1);
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.allocations, 2);
+  EXPECT_EQ(stats.threadHits, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_DOUBLE_EQ(stats.hitRate(), 0.5);
+  EXPECT_EQ(stats.threadCacheBytes, 1024);
+  EXPECT_EQ(stats.bytesCached(), 1024);
+}
+
+TEST(BufferPool, largeRequestsGoUpstream) {
+  CountingResource upstream;
+  openlib::BufferPool pool(upstream);
+
+  void* large = pool.allocate(openlib::BufferPool::MAX_BLOCK_SIZE + 1, 8);
+  void* aligned = pool.allocate(64, 4096);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 4096, 0);
+  pool.deallocate(large, openlib::BufferPool::MAX_BLOCK_SIZE + 1, 8);
+  pool.deallocate(aligned, 64, 4096);
+
+  EXPECT_EQ(upstream.outstanding, 0);
+  EXPECT_EQ(pool.stats().uncached, 2);
+  EXPECT_EQ(pool.stats().bytesCached(), 0);
+}
+
+TEST(BufferPool, cacheLimitSpillsToDepot) {
+  CountingResource upstream;
+  openlib::BufferPool::Options options;
+  options.threadCacheBytes = 4 * 1024;
+  options.depotBytes = 8 * 1024;
+  openlib::BufferPool pool(options, upstream);
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < 32; i++) {
+    blocks.push_back(pool.allocate(1024, 8));
+  }
+  for (void* block : blocks) {
+    pool.deallocate(block, 1024, 8);
+  }
+
+  auto stats = pool.stats();
+  EXPECT_LE(stats.threadCacheBytes, options.threadCacheBytes);
+  EXPECT_LE(stats.depotBytes, options.depotBytes);
+  EXPECT_GT(stats.depotBytes, 0);
+  // whatever the caches could not hold went back upstream
+  EXPECT_EQ(upstream.outstanding * 1024, stats.bytesCached());
+
+  pool.trim();
+  EXPECT_EQ(pool.stats().depotBytes, 0);
+}
+
+TEST(BufferPool, crossThreadFreesAreReused) {
+  CountingResource upstream;
+  openlib::BufferPool::Options options;
+  options.threadCacheBytes = 2 * 4096;
+  openlib::BufferPool pool(options, upstream);
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < 64; i++) {
+    blocks.push_back(pool.allocate(4096, 8));
+  }
+
+  // freed on another thread, which spills to the depot and empties on exit
+  std::thread([&]() {
+    for (void* block : blocks) {
+      pool.deallocate(block, 4096, 8);
+    }
+  }).join();
+
+  for (int i = 0; i < 64; i++) {
+    blocks[i] = pool.allocate(4096, 8);
+  }
+  EXPECT_EQ(upstream.allocations, 64);
+  EXPECT_GT(pool.stats().depotHits, 0);
+
+  for (void* block : blocks) {
+    pool.deallocate(block, 4096, 8);
+  }
+}
+
+TEST(BufferPool, destructorReturnsEverything) {
+  CountingResource upstream;
+  {
+    openlib::BufferPool pool(upstream);
+    std::thread([&]() {
+      pool.deallocate(pool.allocate(100, 8), 100, 8);
+    }).join();
+    pool.deallocate(pool.allocate(100, 8), 100, 8);
+    pool.deallocate(pool.allocate(5000, 8), 5000, 8);
+  }
+  EXPECT_EQ(upstream.outstanding, 0);
+
+  // a later pool on this thread gets a cache of its own
+  openlib::BufferPool pool(upstream);
+  pool.deallocate(pool.allocate(100, 8), 100, 8);
+  EXPECT_EQ(pool.stats().allocations, 1);
+}
+
+namespace {
+
+// frees its block when the thread's thread_local objects are destroyed
+struct TeardownFree {
+  openlib::BufferPool* pool = nullptr;
+  void* block = nullptr;
+
+  ~TeardownFree() {
+    if (pool != nullptr) {
+      pool->deallocate(block, 100, 8);
+      pool->deallocate(pool->allocate(100, 8), 100, 8);
+    }
+  }
+};
+
+} // namespace
+
+TEST(BufferPool, freeDuringThreadLocalTeardown) {
+  CountingResource upstream;
+  {
+    openlib::BufferPool pool(upstream);
+    std::thread([&]() {
+      // constructed before the pool's caches, so destroyed after them
+      thread_local TeardownFree holder;
+      holder.block = pool.allocate(100, 8);
+      holder.pool = &pool;
+    }).join();
+
+    auto stats = pool.stats();
+    EXPECT_EQ(stats.allocations, 2);
+    EXPECT_EQ(stats.depotHits, 1);
+    EXPECT_EQ(stats.threadCacheBytes, 0);
+    EXPECT_EQ(stats.depotBytes, 128);
+  }
+  EXPECT_EQ(upstream.outstanding, 0);
+}
+
+TEST(BufferPool, manyThreads) {
+  openlib::BufferPool pool;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&, t]() {
+      std::vector<void*> held;
+      for (int i = 0; i < 5000; i++) {
+        const std::size_t bytes = 64 << ((i + t) % 8);
+        void* block = pool.allocate(bytes, 8);
+        static_cast<uint8_t*>(block)[bytes - 1] = 1;
+        pool.deallocate(block, bytes, 8);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.allocations, 8 * 5000);
+  EXPECT_GT(stats.hitRate(), 0.9);
+}
+
+TEST(BufferPool, backsSerializersAndArrays) {
+  openlib::BufferPool pool;
+  uint8_t* first;
+  {
+    openlib::Serializer serializer(4096, openlib::uninitialized, pool);
+    serializer.putUInt32(1);
+    first = serializer.data();
+  }
+  openlib::Serializer serializer(4000, openlib::uninitialized, pool);
+  EXPECT_EQ(serializer.data(), first);
+
+  {
+    openlib::FlatArray<double, openlib::ResourceAllocator<double>> array(100, pool);
+    array.fill(1.0);
+  }
+  openlib::FlatArray<double, openlib::ResourceAllocator<double>> array(100, pool);
+  EXPECT_EQ(pool.stats().threadHits, 2);
+}
@@ -0,0 +1,150 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/ByteOrder.h>
+#include <openlib/Deserializer.h>
+#include <openlib/SegmentedSerializer.h>
+#include <openlib/Serializer.h>
+#include <openlib/Writer.h>
+
+namespace {
+
+bool littleEndianHost() {
+  const uint16_t one = 1;
+  uint8_t first;
+  std::memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+} // namespace
+
+TEST(ByteOrder, nativeNeverSwaps) {
+  EXPECT_FALSE(openlib::NativeEndian::swapsIntegers);
+  EXPECT_FALSE(openlib::NativeEndian::swapsFloats);
+  EXPECT_EQ(openlib::NativeEndian::convert(uint32_t(0x01020304)), 0x01020304u);
+}
+
+TEST(ByteOrder, policiesMatchHost) {
+  const bool little = littleEndianHost();
+  EXPECT_EQ(openlib::BigEndian::swapsIntegers, little);
+  EXPECT_EQ(openlib::BigEndian::swapsFloats, little);
+  EXPECT_EQ(openlib::LittleEndian::swapsIntegers, !little);
+  EXPECT_EQ(openlib::BigEndianIntegers::swapsIntegers, little);
+  EXPECT_FALSE(openlib::BigEndianIntegers::swapsFloats);
+}
+
+TEST(ByteOrder, convertIsItsOwnInverse) {
+  typedef openlib::ByteOrder<true, true> Swap;
+  EXPECT_EQ(Swap::convert(uint16_t(0x0102)), 0x0201);
+  EXPECT_EQ(Swap::convert(int32_t(0x01020304)), 0x04030201);
+  EXPECT_EQ(Swap::convert(uint64_t(0x0102030405060708)), 0x0807060504030201u);
+  EXPECT_EQ(Swap::convert(uint8_t(7)), 7);
+  EXPECT_EQ(Swap::convert(Swap::convert(1.5)), 1.5);
+  EXPECT_NE(Swap::convert(1.5), 1.5);
+  EXPECT_EQ((openlib::ByteOrder<true, false>::convert(1.5)), 1.5);
+}
+
+TEST(ByteOrder, bulkConvertCopiesWhenNoSwap) {
+  std::vector<uint32_t> words = {1, 2, 3, 0x01020304};
+  std::vector<uint32_t> copied(words.size()), swapped(words.size());
+
+  openlib::ByteOrder<false, false>::convert<uint32_t>(copied.data(), words.data(), words.size());
+  openlib::ByteOrder<true, true>::convert<uint32_t>(swapped.data(), words.data(), words.size());
+
+  EXPECT_EQ(copied, words);
+  EXPECT_EQ(swapped[3], 0x04030201u);
+  EXPECT_EQ(swapped[0], 0x01000000u);
+}
+
+TEST(ByteOrder, writerLayouts) {
+  uint8_t little[6], big[6];
+  openlib::BasicWriter<openlib::LittleEndian> littleWriter(little, sizeof(little));
+  openlib::BasicWriter<openlib::BigEndian> bigWriter(big, sizeof(big));
+
+  littleWriter.putUInt16(0x0102);
+  littleWriter.putUInt32(0x03040506);
+  bigWriter.putUInt16(0x0102);
+  bigWriter.putUInt32(0x03040506);
+
+  const uint8_t expectedLittle[6] = {0x02, 0x01, 0x06, 0x05, 0x04, 0x03};
+  const uint8_t expectedBig[6] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+  EXPECT_EQ(std::memcmp(little, expectedLittle, 6), 0);
+  EXPECT_EQ(std::memcmp(big, expectedBig, 6), 0);
+}
+
+TEST(ByteOrder, bigEndianSwapsFloatsToo) {
+  openlib::BasicSerializer<openlib::BigEndian> serializer(4);
+  serializer.putFloat(1.0f);
+
+  // 1.0f is 0x3f800000
+  EXPECT_EQ(serializer.data()[0], 0x3f);
+  EXPECT_EQ(serializer.data()[1], 0x80);
+  EXPECT_EQ(serializer.data()[3], 0x00);
+}
+
+TEST(ByteOrder, roundTripsEveryPolicy) {
+  openlib::BasicSerializer<openlib::LittleEndian> serializer(256);
+  std::vector<int64_t> longs = {-1, 2, -3, 4, -5, 6, -7, 8, -9};
+  serializer.putInt16(-2);
+  serializer.putDouble(0.75);
+  serializer.putString("abc");
+  serializer.putInt64Array(longs.data(), longs.size());
+
+  openlib::BasicDeserializer<openlib::LittleEndian> deserializer(serializer.view());
+  EXPECT_EQ(deserializer.getInt16(), -2);
+  EXPECT_EQ(deserializer.getDouble(), 0.75);
+  EXPECT_EQ(deserializer.getString(), "abc");
+  std::vector<int64_t> back(longs.size());
+  deserializer.getInt64Array(back.data(), back.size());
+  EXPECT_EQ(back, longs);
+
+  openlib::BasicSegmentedSerializer<openlib::BigEndian> segmented(8);
+  segmented.putUInt32(0x01020304);
+  segmented.putFloatArray(std::vector<float>{0.5f, 2.0f}.data(), 2);
+  openlib::Array<uint8_t> flat = segmented.flatten();
+  openlib::BasicDeserializer<openlib::BigEndian> bigDeserializer(flat.data(), flat.size());
+  EXPECT_EQ(flat[0], 0x01);
+  EXPECT_EQ(bigDeserializer.getUInt32(), 0x01020304u);
+  EXPECT_EQ(bigDeserializer.getFloat(), 0.5f);
+  EXPECT_EQ(bigDeserializer.getFloat(), 2.0f);
+}
+
+TEST(ByteOrder, defaultFormatUnchanged) {
+  openlib::Serializer serializer(8);
+  serializer.putUInt16(0x0102);
+  serializer.putFloat(0.5f);
+
+  EXPECT_EQ(serializer.data()[0], 0x01);
+  float value;
+  std::memcpy(&value, serializer.data() + 2, sizeof(value));
+  EXPECT_EQ(value, 0.5f);
+}
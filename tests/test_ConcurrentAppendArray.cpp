@@ -0,0 +1,209 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/ConcurrentAppendArray.h>
+#include <openlib/Kernels.h>
+
+TEST(ConcurrentAppendArray, isConstructable) {
+  openlib::ConcurrentAppendArray<int> array(10);
+  EXPECT_EQ(array.size(), 0);
+  EXPECT_EQ(array.reserved(), 0);
+  EXPECT_EQ(array.capacity(), 10);
+  EXPECT_TRUE(array.published().empty());
+}
+
+TEST(ConcurrentAppendArray, append) {
+  openlib::ConcurrentAppendArray<int> array(4);
+  EXPECT_EQ(array.append(7), 0);
+  EXPECT_EQ(array.append(8), 1);
+
+  int values[] = {1, 2};
+  EXPECT_EQ(array.append(values, 2), 2);
+  EXPECT_EQ(array.size(), 4);
+  EXPECT_EQ(array[3], 2);
+  EXPECT_EQ(openlib::sum(array.published()), 18);
+}
+
+TEST(ConcurrentAppendArray, throwsWhenFull) {
+  openlib::ConcurrentAppendArray<int> array(3);
+  array.append(1);
+  int values[] = {1, 2, 3};
+  EXPECT_THROW(array.append(values, 3), std::length_error);
+  EXPECT_THROW(array.append(1), std::length_error);
+  EXPECT_EQ(array.size(), 1);
+  EXPECT_EQ(array.reserved(), 3);
+}
+
+TEST(ConcurrentAppendArray, appenderPublishesOnFlush) {
+  openlib::ConcurrentAppendArray<int> array(100);
+  {
+    auto appender = array.appender(8);
+    for (int i = 0; i < 10; i++) {
+      appender.append(i);
+    }
+    // the first batch of 8 went out when the buffer filled
+    EXPECT_EQ(array.size(), 8);
+    appender.flush();
+    EXPECT_EQ(array.size(), 10);
+    appender.append(10);
+  }
+  EXPECT_EQ(array.size(), 11);
+  EXPECT_EQ(array[10], 10);
+}
+
+TEST(ConcurrentAppendArray, appenderReportsFullArray) {
+  openlib::ConcurrentAppendArray<int> array(4);
+  {
+    auto appender = array.appender(8);
+    for (int i = 0; i < 6; i++) {
+      appender.append(i);
+    }
+    EXPECT_THROW(appender.flush(), std::length_error);
+    EXPECT_EQ(appender.pending(), 6);
+  }
+  EXPECT_EQ(array.size(), 0);
+  EXPECT_EQ(array.dropped(), 6);
+}
+
+namespace {
+
+// copying a gated element blocks until the gate opens, which holds its slot
+// claimed but unpublished
+struct Gate {
+  std::atomic<bool> entered{false};
+  std::atomic<bool> open{false};
+};
+
+struct Gated {
+  int value = 0;
+  Gate* gate = nullptr;
+
+  Gated() = default;
+  Gated(int value, Gate* gate = nullptr): value(value), gate(gate) {}
+  Gated(const Gated& other) = default;
+
+  Gated& operator=(const Gated& other) {
+    if (other.gate != nullptr) {
+      other.gate->entered.store(true);
+      while (!other.gate->open.load()) {
+        std::this_thread::yield();
+      }
+    }
+    value = other.value;
+    return *this;
+  }
+};
+
+} // namespace
+
+TEST(ConcurrentAppendArray, unfinishedRunHidesLaterOnes) {
+  openlib::ConcurrentAppendArray<Gated> array(10);
+  array.append(Gated(0));
+  array.append(Gated(1));
+
+  // slot 2 is claimed, its element stays half written until the gate opens
+  Gate gate;
+  std::thread writer([&]() { array.append(Gated(2, &gate)); });
+  while (!gate.entered.load()) {
+    std::this_thread::yield();
+  }
+
+  // later slots are published, both directly and through an Appender
+  Gated values[] = {Gated(3), Gated(4)};
+  EXPECT_EQ(array.append(values, 2), 3);
+  {
+    auto appender = array.appender(4);
+    appender.append(Gated(5));
+    appender.append(Gated(6));
+  }
+  EXPECT_EQ(array.reserved(), 7);
+  EXPECT_EQ(array.size(), 2);
+  EXPECT_EQ(array.published().size(), 2);
+
+  gate.open.store(true);
+  writer.join();
+  EXPECT_EQ(array.size(), 7);
+  for (int i = 0; i < 7; i++) {
+    EXPECT_EQ(array[i].value, i);
+  }
+}
+
+TEST(ConcurrentAppendArray, manyThreads) {
+  const int THREADS = 8;
+  const int PER_THREAD = 20000;
+  openlib::ConcurrentAppendArray<uint32_t> array(THREADS * PER_THREAD);
+  std::atomic<bool> done(false);
+  std::atomic<int> bad(0);
+
+  // a reader checks that the published prefix only holds written values
+  std::thread reader([&]() {
+    while (!done.load()) {
+      auto view = array.published();
+      for (uint32_t value : view) {
+        if (value == 0) {
+          bad++;
+        }
+      }
+    }
+  });
+
+  std::vector<std::thread> writers;
+  for (int t = 0; t < THREADS; t++) {
+    writers.emplace_back([&, t]() {
+      auto appender = array.appender(t % 2 == 0 ? 64 : 1);
+      for (int i = 0; i < PER_THREAD; i++) {
+        const uint32_t value = t * PER_THREAD + i + 1;
+        if (i % 3 == 0) {
+          array.append(value);
+        } else {
+          appender.append(value);
+        }
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+
+  EXPECT_EQ(bad.load(), 0);
+  ASSERT_EQ(array.size(), THREADS * PER_THREAD);
+  std::vector<uint32_t> values(array.published().begin(), array.published().end());
+  std::sort(values.begin(), values.end());
+  for (std::size_t i = 0; i < values.size(); i++) {
+    ASSERT_EQ(values[i], i + 1);
+  }
+}
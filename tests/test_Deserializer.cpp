@@ -0,0 +1,204 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Array.h>
+#include <openlib/Deserializer.h>
+#include <openlib/Serializer.h>
+
+TEST(Deserializer, sizeInitialized) {
+  uint8_t bytes[4] = {};
+  openlib::Deserializer deserializer(bytes, sizeof(bytes));
+
+  EXPECT_EQ(deserializer.size(), 4);
+  EXPECT_EQ(deserializer.offset(), 0);
+  EXPECT_EQ(deserializer.remaining(), 4);
+}
+
+TEST(Deserializer, roundTripsEveryType) {
+  openlib::Serializer serializer(128);
+  serializer.putChar('x');
+  serializer.putInt8(-8);
+  serializer.putUInt8(200);
+  serializer.putInt16(-1600);
+  serializer.putUInt16(0xBEEF);
+  serializer.putInt32(std::numeric_limits<int32_t>::min());
+  serializer.putUInt32(0xDEADBEEF);
+  serializer.putInt64(-64);
+  serializer.putUInt64(0x0102030405060708);
+  serializer.putFloat(1.5f);
+  serializer.putDouble(-2.25);
+  serializer.putString("hello");
+
+  openlib::Deserializer deserializer(serializer.view());
+  EXPECT_EQ(deserializer.getChar(), 'x');
+  EXPECT_EQ(deserializer.getInt8(), -8);
+  EXPECT_EQ(deserializer.getUInt8(), 200);
+  EXPECT_EQ(deserializer.getInt16(), -1600);
+  EXPECT_EQ(deserializer.getUInt16(), 0xBEEF);
+  EXPECT_EQ(deserializer.getInt32(), std::numeric_limits<int32_t>::min());
+  EXPECT_EQ(deserializer.getUInt32(), 0xDEADBEEF);
+  EXPECT_EQ(deserializer.getInt64(), -64);
+  EXPECT_EQ(deserializer.getUInt64(), 0x0102030405060708);
+  EXPECT_EQ(deserializer.getFloat(), 1.5f);
+  EXPECT_EQ(deserializer.getDouble(), -2.25);
+  EXPECT_EQ(deserializer.getString(), "hello");
+  EXPECT_EQ(deserializer.remaining(), 0);
+  EXPECT_EQ(deserializer.offset(), serializer.size());
+}
+
+TEST(Deserializer, roundTripsNaN) {
+  openlib::Serializer serializer(8);
+  serializer.putDouble(std::numeric_limits<double>::quiet_NaN());
+
+  openlib::Deserializer deserializer(serializer.view());
+  EXPECT_TRUE(std::isnan(deserializer.getDouble()));
+}
+
+TEST(Deserializer, stringViewPointsIntoBuffer) {
+  openlib::Serializer serializer(16);
+  serializer.putString("abc");
+  serializer.putString("");
+
+  openlib::Deserializer deserializer(serializer.view());
+  openlib::ArrayView<const char> view = deserializer.getStringView();
+  EXPECT_EQ(view.size(), 3);
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(view.data()), serializer.data() + 2);
+  EXPECT_EQ(std::string(view.data(), view.size()), "abc");
+  EXPECT_EQ(deserializer.getStringView().size(), 0);
+  EXPECT_EQ(deserializer.remaining(), 0);
+}
+
+TEST(Deserializer, bytesViewPointsIntoBuffer) {
+  uint8_t bytes[6] = {1, 2, 3, 4, 5, 6};
+  openlib::Deserializer deserializer(bytes, sizeof(bytes));
+
+  deserializer.skip(1);
+  openlib::ArrayView<const uint8_t> view = deserializer.getBytesView(4);
+  EXPECT_EQ(view.data(), bytes + 1);
+  EXPECT_EQ(view.size(), 4);
+  EXPECT_EQ(deserializer.getUInt8(), 6);
+}
+
+TEST(Deserializer, getCopiesBytes) {
+  uint8_t bytes[3] = {7, 8, 9};
+  uint8_t copy[2] = {};
+  openlib::Deserializer deserializer(bytes, sizeof(bytes));
+
+  deserializer.get(copy, sizeof(copy));
+  EXPECT_EQ(copy[0], 7);
+  EXPECT_EQ(copy[1], 8);
+  EXPECT_EQ(deserializer.remaining(), 1);
+}
+
+TEST(Deserializer, truncatedReadThrowsWithoutConsuming) {
+  uint8_t bytes[3] = {1, 2, 3};
+  openlib::Deserializer deserializer(bytes, sizeof(bytes));
+
+  EXPECT_THROW(deserializer.getUInt32(), std::length_error);
+  EXPECT_EQ(deserializer.offset(), 0);
+  EXPECT_THROW(deserializer.getBytesView(4), std::length_error);
+  EXPECT_THROW(deserializer.skip(4), std::length_error);
+  EXPECT_EQ(deserializer.getUInt16(), 0x0102);
+  EXPECT_THROW(deserializer.getUInt16(), std::length_error);
+  EXPECT_EQ(deserializer.getUInt8(), 3);
+  EXPECT_THROW(deserializer.getUInt8(), std::length_error);
+}
+
+TEST(Deserializer, truncatedStringThrowsWithoutConsuming) {
+  openlib::Serializer serializer(16);
+  serializer.putString("abcdef");
+
+  openlib::Deserializer deserializer(serializer.data(), serializer.size() - 1);
+  EXPECT_THROW(deserializer.getStringView(), std::length_error);
+  EXPECT_THROW(deserializer.getString(), std::length_error);
+  EXPECT_EQ(deserializer.offset(), 0);
+
+  openlib::Deserializer empty(serializer.data(), 1);
+  EXPECT_THROW(empty.getString(), std::length_error);
+  EXPECT_EQ(empty.offset(), 0);
+}
+
+TEST(Deserializer, roundTripsArrays) {
+  openlib::Array<int32_t> ints(1001);
+  openlib::Array<uint64_t> longs(33);
+  openlib::Array<float> floats(7);
+  for (std::size_t i = 0; i < ints.size(); ++i) {
+    ints[i] = static_cast<int32_t>(i * 2654435761u);
+  }
+  for (std::size_t i = 0; i < longs.size(); ++i) {
+    longs[i] = i * 0x9e3779b97f4a7c15ull;
+  }
+  for (std::size_t i = 0; i < floats.size(); ++i) {
+    floats[i] = i * 0.5f;
+  }
+
+  openlib::Serializer serializer(8192);
+  serializer.putInt32Array(ints);
+  serializer.putUInt64Array(longs);
+  serializer.putFloatArray(floats);
+
+  openlib::Deserializer deserializer(serializer.view());
+  EXPECT_EQ(deserializer.getInt32(), ints[0]);
+  openlib::Array<int32_t> intsBack(ints.size() - 1);
+  openlib::Array<uint64_t> longsBack(longs.size());
+  openlib::Array<float> floatsBack(floats.size());
+  deserializer.getInt32Array(intsBack);
+  deserializer.getUInt64Array(longsBack.data(), longsBack.size());
+  deserializer.getFloatArray(floatsBack);
+
+  for (std::size_t i = 0; i < intsBack.size(); ++i) {
+    ASSERT_EQ(intsBack[i], ints[i + 1]);
+  }
+  for (std::size_t i = 0; i < longs.size(); ++i) {
+    ASSERT_EQ(longsBack[i], longs[i]);
+  }
+  for (std::size_t i = 0; i < floats.size(); ++i) {
+    ASSERT_EQ(floatsBack[i], floats[i]);
+  }
+  EXPECT_EQ(deserializer.remaining(), 0);
+}
+
+TEST(Deserializer, truncatedArrayThrowsWithoutConsuming) {
+  uint8_t bytes[7] = {0, 1, 0, 2, 0, 3, 0};
+  uint16_t values[4] = {};
+  openlib::Deserializer deserializer(bytes, sizeof(bytes));
+
+  EXPECT_THROW(deserializer.getUInt16Array(values, 4), std::length_error);
+  EXPECT_THROW(deserializer.getUInt16Array(values, SIZE_MAX / 2), std::length_error);
+  EXPECT_EQ(deserializer.offset(), 0);
+  deserializer.getUInt16Array(values, 3);
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[2], 3);
+  EXPECT_EQ(values[3], 0);
+}
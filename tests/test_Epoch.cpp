@@ -0,0 +1,85 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Epoch.h>
+
+TEST(Epoch, slotsAreCacheLinePadded) {
+  static_assert(sizeof(openlib::EpochDomain::Slot) == openlib::CACHE_LINE_BYTES, "padded");
+
+  openlib::EpochDomain domain;
+  openlib::EpochDomain::Slot& first = domain.acquireSlot();
+  openlib::EpochDomain::Slot& second = domain.acquireSlot();
+  EXPECT_NE(&first, &second);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(&first) % openlib::CACHE_LINE_BYTES, 0);
+
+  domain.releaseSlot(first);
+  EXPECT_EQ(&domain.acquireSlot(), &first);
+}
+
+TEST(Epoch, readersBlockQuiescence) {
+  openlib::EpochDomain domain;
+  openlib::EpochDomain::Slot& slot = domain.acquireSlot();
+
+  domain.enter(slot);
+  const uint64_t epoch = domain.advance();
+  EXPECT_FALSE(domain.isQuiescent(epoch));
+
+  // nested sections keep the first announcement
+  domain.enter(slot);
+  domain.exit(slot);
+  EXPECT_FALSE(domain.isQuiescent(epoch));
+
+  domain.exit(slot);
+  EXPECT_TRUE(domain.isQuiescent(epoch));
+}
+
+TEST(Epoch, laterReadersDoNotBlock) {
+  openlib::EpochDomain domain;
+  openlib::EpochDomain::Slot& slot = domain.acquireSlot();
+
+  const uint64_t epoch = domain.advance();
+  domain.enter(slot);
+  EXPECT_TRUE(domain.isQuiescent(epoch));
+  EXPECT_FALSE(domain.isQuiescent(domain.advance()));
+  domain.exit(slot);
+
+  domain.synchronize();
+  EXPECT_GT(domain.current(), epoch);
+}
+
+TEST(Epoch, manySlots) {
+  openlib::EpochDomain domain;
+  for (int i = 0; i < 200; i++) {
+    openlib::EpochDomain::Slot& slot = domain.acquireSlot();
+    domain.enter(slot);
+    domain.exit(slot);
+  }
+  EXPECT_TRUE(domain.isQuiescent(domain.advance()));
+}
@@ -0,0 +1,257 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Array.h>
+#include <openlib/FlatArray.h>
+#include <openlib/Pool.h>
+
+TEST(FlatArray, isConstructable) {
+  openlib::FlatArray<int> array(0);
+  // if the test gets this far it passe
+}
+
+TEST(FlatArray, isConstructableViaInitList) {
+  openlib::FlatArray<int> array = {1, 2, 3};
+  // if the test gets this far it passe
+}
+
+TEST(FlatArray, getSize) {
+  openlib::FlatArray<int> array(3);
+  EXPECT_EQ(array.size(), 3);
+}
+
+TEST(FlatArray, getSizeViaInitList) {
+  openlib::FlatArray<int> array = {1, 2, 3, 4};
+  EXPECT_EQ(array.size(), 4);
+}
+
+TEST(FlatArray, atReturnCorrectValue) {
+  openlib::FlatArray<int> array = {1, 2, 3, 4};
+
+  for (std::size_t i = 0; i < array.size(); i++) {
+    EXPECT_EQ(array.at(i), i + 1);
+  }
+}
+
+TEST(FlatArray, atReturnCorrectValueConst) {
+  const openlib::FlatArray<int> array = {1, 2, 3, 4};
+
+  for (std::size_t i = 0; i < array.size(); i++) {
+    EXPECT_EQ(array.at(i), i + 1);
+  }
+}
+
+TEST(FlatArray, operatorBracketReturnCorrectValue) {
+  openlib::FlatArray<int> array = {1, 2, 3, 4};
+
+  for (std::size_t i = 0; i < array.size(); i++) {
+    EXPECT_EQ(array[i], i + 1);
+  }
+}
+
+TEST(FlatArray, operatorBracketReturnCorrectValueConst) {
+  const openlib::FlatArray<char> array = {'a', 'b', 'c', 'd'};
+
+  for (std::size_t i = 0; i < array.size(); i++) {
+    EXPECT_EQ(array[i], 'a' + i);
+  }
+}
+
+TEST(FlatArray, frontReturnsFirstElement) {
+  openlib::FlatArray<char> array = {'a', 'b', 'c'};
+  EXPECT_EQ(array.front(), 'a');
+}
+
+TEST(FlatArray, backReturnsLastElement) {
+  openlib::FlatArray<char> array = {'a', 'b', 'c'};
+  EXPECT_EQ(array.back(), 'c');
+}
+
+TEST(FlatArray, dataReturnsPointerToData) {
+  openlib::FlatArray<char> array = {1, 2, 3, 4};
+  for (std::size_t i = 0; i < array.size(); i++) {
+    EXPECT_EQ(array.data()[i], i + 1);
+  }
+}
+
+TEST(FlatArray, rangeBasedForLoop) {
+  openlib::FlatArray<int> array = {1, 2, 3, 4};
+
+  int expectedValue = 0;
+  for (const auto& value : array) {
+    EXPECT_EQ(value, ++expectedValue);
+    EXPECT_LE(expectedValue, array.size());
+  }
+
+  EXPECT_EQ(expectedValue, array.size());
+}
+
+TEST(FlatArray, fill) {
+  openlib::FlatArray<int> array = {1, 2, 3, 4};
+
+  array.fill(99);
+
+  for (const auto& value : array) {
+    EXPECT_EQ(value, 99);
+  }
+}
+
+TEST(FlatArray, autoCastToPointer) {
+  openlib::FlatArray<int> array = { 1, 2, 3 };
+  int *p = array;
+  EXPECT_EQ(p, array.data());
+  EXPECT_EQ(p[0], 1);
+  EXPECT_EQ(p[1], 2);
+  EXPECT_EQ(p[2], 3);
+}
+
+TEST(FlatArray, operatorEquality) {
+  openlib::FlatArray<uint8_t> array = {1, 2, 3, 4};
+
+  EXPECT_TRUE(array == array);
+}
+
+TEST(FlatArray, operatorNotEqual) {
+  openlib::FlatArray<int> array1 = {1, 2, 3, 4};
+  openlib::FlatArray<int> array2 = {1, 2, 3, 4};
+
+  EXPECT_FALSE(array1 == array2);
+  EXPECT_TRUE(array1 != array2);
+}
+
+TEST(FlatArray, operatorLessThan) {
+  openlib::FlatArray<int> array1 = {1, 2, 3, 4};
+  openlib::FlatArray<int> array2 = {1, 2, 3, 4};
+
+  if (array1.data() < array2.data()) {
+    EXPECT_TRUE(array1 < array2);
+  } else {
+    EXPECT_TRUE(array2 < array1);
+  }
+}
+
+TEST(FlatArray, moveConstructor) {
+  openlib::FlatArray<char> array1 = {'a', 'b', 'c'};
+  openlib::FlatArray<char> array2 = std::move(array1);
+
+  EXPECT_EQ(3, array2.size());
+  EXPECT_EQ('a', array2[0]);
+  EXPECT_EQ('b', array2[1]);
+  EXPECT_EQ('c', array2[2]);
+}
+
+TEST(FlatArray, copyConstructor) {
+  openlib::FlatArray<char> array1 = {'a', 'b', 'c'};
+  openlib::FlatArray<char> array2(array1);
+
+  EXPECT_EQ(array1.size(), array2.size());
+  EXPECT_EQ(array1[0], array2[0]);
+  EXPECT_EQ(array1[1], array2[1]);
+  EXPECT_EQ(array1[2], array2[2]);
+}
+
+TEST(FlatArray, arrayWrapsFlatArray) {
+  openlib::Array<int> array = {1, 2, 3};
+
+  EXPECT_EQ(array.data(), array.flat().data());
+  EXPECT_EQ(array.size(), array.flat().size());
+}
+
+TEST(FlatArray, isNotPolymorphic) {
+  EXPECT_FALSE(std::is_polymorphic<openlib::FlatArray<int>>::value);
+  EXPECT_TRUE(std::is_final<openlib::FlatArray<int>>::value);
+}
+
+TEST(FlatArray, uninitializedConstructorSize) {
+  openlib::FlatArray<int> array(16, openlib::uninitialized);
+  EXPECT_EQ(array.size(), 16);
+}
+
+TEST(FlatArray, uninitializedConstructorDefaultConstructsNonTrivial) {
+  openlib::FlatArray<std::string> array(4, openlib::uninitialized);
+
+  for (const auto& value : array) {
+    EXPECT_TRUE(value.empty());
+  }
+}
+
+namespace {
+
+/*
+ * Element type that throws on the third construction
+ */
+struct ThrowOnThird {
+  static int constructed;
+  static int destroyed;
+
+  ThrowOnThird() {
+    if (constructed == 2) {
+      throw std::runtime_error("third");
+    }
+    constructed++;
+  }
+
+  ~ThrowOnThird() {
+    destroyed++;
+  }
+};
+
+int ThrowOnThird::constructed = 0;
+int ThrowOnThird::destroyed = 0;
+
+} // namespace
+
+TEST(FlatArray, constructorCleansUpOnThrow) {
+  ThrowOnThird::constructed = 0;
+  ThrowOnThird::destroyed = 0;
+
+  EXPECT_THROW(openlib::FlatArray<ThrowOnThird> array(4), std::runtime_error);
+  EXPECT_EQ(ThrowOnThird::constructed, 2);
+  EXPECT_EQ(ThrowOnThird::destroyed, 2);
+}
+
+TEST(FlatArray, copyKeepsAllocator) {
+  openlib::Pool pool;
+  openlib::FlatArray<int, openlib::PoolAllocator<int>> array1({1, 2, 3}, pool);
+  openlib::FlatArray<int, openlib::PoolAllocator<int>> array2(array1);
+
+  EXPECT_TRUE(array1.allocator() == array2.allocator());
+  EXPECT_EQ(array2[2], 3);
+}
+
+TEST(FlatArray, moveLeavesSourceEmpty) {
+  openlib::FlatArray<std::string> array1 = {"a", "b"};
+  openlib::FlatArray<std::string> array2 = std::move(array1);
+
+  EXPECT_EQ(array1.data(), nullptr);
+  EXPECT_EQ(array2[1], "b");
+}
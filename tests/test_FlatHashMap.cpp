@@ -0,0 +1,236 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatHashMap.h>
+
+namespace {
+
+// hashes std::string and C strings alike, so lookups need no temporary
+struct StringHash {
+  typedef void is_transparent;
+
+  std::size_t operator()(const char* text) const {
+    return hash(text, std::strlen(text));
+  }
+
+  std::size_t operator()(const std::string& text) const {
+    return hash(text.data(), text.size());
+  }
+
+  static std::size_t hash(const char* text, std::size_t length) {
+    std::size_t result = 14695981039346656037ull;
+    for (std::size_t i = 0; i < length; i++) {
+      result = (result ^ static_cast<unsigned char>(text[i])) * 1099511628211ull;
+    }
+    return result;
+  }
+};
+
+struct StringEqual {
+  typedef void is_transparent;
+
+  bool operator()(const std::string& lhs, const char* rhs) const {
+    return lhs == rhs;
+  }
+
+  bool operator()(const std::string& lhs, const std::string& rhs) const {
+    return lhs == rhs;
+  }
+};
+
+} // namespace
+
+TEST(FlatHashMap, insertFindErase) {
+  openlib::FlatHashMap<int, std::string> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.find(1), map.end());
+
+  EXPECT_TRUE(map.insert(std::make_pair(1, std::string("one"))).second);
+  EXPECT_FALSE(map.insert(std::make_pair(1, std::string("uno"))).second);
+  EXPECT_TRUE(map.emplace(2, "two").second);
+  EXPECT_TRUE(map.tryEmplace(3, 5, 'x').second);
+  map[4] = "four";
+
+  EXPECT_EQ(map.size(), 4);
+  EXPECT_EQ(map.find(1)->second, "one");
+  EXPECT_EQ(map.at(3), "xxxxx");
+  EXPECT_EQ(map[4], "four");
+  EXPECT_TRUE(map.contains(2));
+  EXPECT_EQ(map.count(5), 0);
+  EXPECT_THROW(map.at(5), std::out_of_range);
+
+  EXPECT_EQ(map.erase(2), 1);
+  EXPECT_EQ(map.erase(2), 0);
+  map.erase(map.find(1));
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_FALSE(map.contains(1));
+  EXPECT_FALSE(map.contains(2));
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(FlatHashMap, eraseInSparseTableLeavesNoTombstones) {
+  openlib::FlatHashMap<int, int> map;
+  map[0] = 0;
+  const int* kept = &map[0];
+  const std::size_t capacity = map.capacity();
+
+  // with tombstones the table would fill up and rehash, moving kept
+  for (int i = 1; i < 10000; i++) {
+    map[i] = i;
+    map.erase(i);
+  }
+  EXPECT_EQ(map.capacity(), capacity);
+  EXPECT_EQ(&map[0], kept);
+  EXPECT_EQ(map.size(), 1);
+}
+
+TEST(FlatHashMap, matchesUnorderedMap) {
+  std::mt19937 random(42);
+  openlib::FlatHashMap<uint32_t, uint32_t> map;
+  std::unordered_map<uint32_t, uint32_t> expected;
+
+  for (int i = 0; i < 200000; i++) {
+    const uint32_t key = random() % 5000;
+    switch (random() % 3) {
+    case 0:
+      map[key] = i;
+      expected[key] = i;
+      break;
+    case 1:
+      ASSERT_EQ(map.erase(key), expected.erase(key));
+      break;
+    default:
+      ASSERT_EQ(map.contains(key), expected.count(key) == 1);
+      if (expected.count(key)) {
+        ASSERT_EQ(map.at(key), expected[key]);
+      }
+    }
+  }
+
+  ASSERT_EQ(map.size(), expected.size());
+  std::size_t visited = 0;
+  for (const auto& entry : map) {
+    ASSERT_EQ(expected.at(entry.first), entry.second);
+    visited++;
+  }
+  EXPECT_EQ(visited, expected.size());
+  // tombstones are cleaned up instead of growing the table forever
+  EXPECT_LE(map.capacity(), 16384);
+}
+
+TEST(FlatHashMap, reserve) {
+  openlib::FlatHashMap<int, int> map(1000);
+  const std::size_t capacity = map.capacity();
+  EXPECT_GE(capacity, 1000);
+  for (int i = 0; i < 1000; i++) {
+    map[i] = i;
+  }
+  EXPECT_EQ(map.capacity(), capacity);
+
+  map.reserve(100000);
+  EXPECT_GE(map.capacity(), 100000);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(map.at(i), i);
+  }
+}
+
+TEST(FlatHashMap, heterogeneousLookup) {
+  openlib::FlatHashMap<std::string, int, StringHash, StringEqual> map;
+  map["apple"] = 1;
+  map["pear"] = 2;
+
+  const char* key = "pear";
+  EXPECT_EQ(map.find(key)->second, 2);
+  EXPECT_TRUE(map.contains("apple"));
+  EXPECT_FALSE(map.contains("fig"));
+  EXPECT_EQ(map.at("apple"), 1);
+  EXPECT_EQ(map.erase("apple"), 1);
+  EXPECT_EQ(map.size(), 1);
+}
+
+TEST(FlatHashMap, destroysValues) {
+  auto tracked = std::make_shared<int>(7);
+  {
+    openlib::FlatHashMap<int, std::shared_ptr<int>> map;
+    for (int i = 0; i < 100; i++) {
+      map[i] = tracked;
+    }
+    EXPECT_EQ(tracked.use_count(), 101);
+    map.erase(5);
+    EXPECT_EQ(tracked.use_count(), 100);
+
+    openlib::FlatHashMap<int, std::shared_ptr<int>> copy(map);
+    EXPECT_EQ(tracked.use_count(), 199);
+    openlib::FlatHashMap<int, std::shared_ptr<int>> moved(std::move(copy));
+    EXPECT_EQ(tracked.use_count(), 199);
+    EXPECT_EQ(moved.size(), 99);
+    EXPECT_TRUE(copy.empty());
+  }
+  EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(FlatHashSet, insertFindErase) {
+  openlib::FlatHashSet<std::string> set = {"a", "b", "c"};
+  EXPECT_EQ(set.size(), 3);
+  EXPECT_FALSE(set.insert("a").second);
+  EXPECT_TRUE(set.emplace(3, 'd').second);
+  EXPECT_TRUE(set.contains("ddd"));
+  EXPECT_EQ(*set.find("b"), "b");
+  EXPECT_EQ(set.erase("b"), 1);
+  EXPECT_EQ(set.size(), 3);
+
+  std::size_t visited = 0;
+  for (const std::string& key : set) {
+    EXPECT_TRUE(key == "a" || key == "c" || key == "ddd");
+    visited++;
+  }
+  EXPECT_EQ(visited, 3);
+}
+
+TEST(FlatHashSet, manyKeys) {
+  openlib::FlatHashSet<uint64_t> set;
+  for (uint64_t i = 0; i < 100000; i++) {
+    set.insert(i * 64);
+  }
+  EXPECT_EQ(set.size(), 100000);
+  for (uint64_t i = 0; i < 100000; i++) {
+    ASSERT_TRUE(set.contains(i * 64));
+    ASSERT_FALSE(set.contains(i * 64 + 1));
+  }
+}
@@ -0,0 +1,114 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/ArrayView.h>
+#include <openlib/FlatArray.h>
+#include <openlib/FlatHashMap.h>
+#include <openlib/Hash.h>
+#include <openlib/Kernels.h>
+#include <openlib/Serializer.h>
+
+TEST(Hash, isStable) {
+  // pinned, so a change to the function is noticed; hashes may be stored
+  const std::string text = "The quick brown fox jumps over the lazy dog";
+  std::vector<uint64_t> hashes;
+  for (std::size_t length : {0, 3, 8, 16, 43}) {
+    hashes.push_back(openlib::kernels::hash64(text.data(), length));
+  }
+  std::string longText;
+  for (int i = 0; i < 100; i++) {
+    longText += text;
+  }
+  hashes.push_back(openlib::kernels::hash64(longText.data(), longText.size()));
+  hashes.push_back(openlib::kernels::hash64(longText.data(), longText.size(), 42));
+
+  const std::vector<uint64_t> expected = {
+    4264860695939522459ull, 4302007362194025635ull, 14370039766930584721ull,
+    1778452140746430753ull, 6121350503147940068ull, 2780485548604224813ull,
+    7294831095230733365ull,
+  };
+  EXPECT_EQ(hashes, expected);
+}
+
+TEST(Hash, contentNotAddress) {
+  openlib::FlatArray<int> a = {1, 2, 3, 4};
+  openlib::FlatArray<int> b = {1, 2, 3, 4};
+  openlib::FlatArray<int> c = {1, 2, 3, 5};
+  std::vector<int> d = {1, 2, 3, 4};
+
+  EXPECT_EQ(openlib::hash(a), openlib::hash(b));
+  EXPECT_EQ(openlib::hash(a), openlib::hash(d));
+  EXPECT_NE(openlib::hash(a), openlib::hash(c));
+  EXPECT_NE(openlib::hash(a), openlib::hash(a, 1));
+  EXPECT_TRUE(openlib::equal(a, b));
+  EXPECT_FALSE(a == b);
+}
+
+TEST(Hash, elementsThatAreNotBitwiseComparable) {
+  openlib::FlatArray<std::string> a = {"x", "yz"};
+  openlib::FlatArray<std::string> b = {"x", "yz"};
+  openlib::FlatArray<std::string> c = {"xy", "z"};
+  EXPECT_EQ(openlib::hash(a), openlib::hash(b));
+  EXPECT_NE(openlib::hash(a), openlib::hash(c));
+
+  // -0.0 == 0.0, so they must hash alike
+  openlib::FlatArray<double> zero = {0.0};
+  openlib::FlatArray<double> negativeZero = {-0.0};
+  EXPECT_EQ(openlib::hash(zero), openlib::hash(negativeZero));
+}
+
+TEST(Hash, serializerBuffers) {
+  openlib::Serializer a(16);
+  openlib::Serializer b(16);
+  a.putUInt32(7);
+  b.putUInt32(7);
+  EXPECT_EQ(openlib::hash(a.view()), openlib::hash(b.view()));
+  b.putUInt8(1);
+  EXPECT_NE(openlib::hash(a.view()), openlib::hash(b.view()));
+}
+
+TEST(Hash, keysHashMaps) {
+  openlib::FlatHashMap<openlib::FlatArray<int>, int, openlib::ArrayHash, openlib::ArrayEqual> map;
+  map[openlib::FlatArray<int>{1, 2}] = 12;
+  map[openlib::FlatArray<int>{3}] = 3;
+
+  EXPECT_EQ(map.at(openlib::FlatArray<int>{1, 2}), 12);
+  // transparent: look up with a view, no key array is built
+  const int key[] = {3};
+  EXPECT_EQ(map.find(openlib::ArrayView<const int>(key, 1))->second, 3);
+  EXPECT_FALSE(map.contains(openlib::ArrayView<const int>(key, 0)));
+
+  std::unordered_map<std::vector<int>, int, openlib::ArrayHash, openlib::ArrayEqual> standard;
+  standard[{1, 2, 3}] = 6;
+  EXPECT_EQ(standard.at({1, 2, 3}), 6);
+}
@@ -0,0 +1,390 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Array.h>
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+
+using openlib::kernels::Isa;
+
+namespace {
+
+/*
+ * Runs every test once per instruction set this machine supports and
+ * compares against plain loops.
+ */
+class Kernels : public testing::TestWithParam<Isa> {
+protected:
+  void SetUp() override {
+    previous = openlib::kernels::activeIsa();
+    openlib::kernels::setIsa(GetParam());
+  }
+
+  void TearDown() override {
+    openlib::kernels::setIsa(previous);
+  }
+
+  template <class type>
+  std::vector<type> random(std::size_t size, int range) {
+    std::uniform_int_distribution<int> distribution(-range, range);
+    std::vector<type> values(size);
+    for (auto& value : values) {
+      value = static_cast<type>(distribution(engine));
+    }
+    return values;
+  }
+
+  // sizes around every vector width and unroll factor, plus a large one
+  std::vector<std::size_t> sizes() {
+    std::vector<std::size_t> result;
+    for (std::size_t size = 0; size <= 300; size++) {
+      result.push_back(size);
+    }
+    result.push_back(100003);
+    return result;
+  }
+
+  std::mt19937 engine{42};
+  Isa previous;
+};
+
+template <class type>
+void checkReductions(const std::vector<type>& values) {
+  for (std::size_t offset = 0; offset < 3 && offset < values.size(); offset++) {
+    const type* data = values.data() + offset;
+    std::size_t n = values.size() - offset;
+
+    type expectedMin = data[0];
+    type expectedMax = data[0];
+    type expectedSum = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      expectedMin = data[i] < expectedMin ? data[i] : expectedMin;
+      expectedMax = data[i] > expectedMax ? data[i] : expectedMax;
+      expectedSum += data[i];
+    }
+
+    EXPECT_EQ(openlib::kernels::min(data, n), expectedMin);
+    EXPECT_EQ(openlib::kernels::max(data, n), expectedMax);
+    EXPECT_EQ(openlib::kernels::sum(data, n), expectedSum);
+  }
+}
+
+template <class type>
+void checkFindAndCount(const std::vector<type>& values, type needle) {
+  std::size_t expectedFind = values.size();
+  std::size_t expectedCount = 0;
+  for (std::size_t i = 0; i < values.size(); i++) {
+    if (values[i] == needle) {
+      expectedCount++;
+      if (expectedFind == values.size()) {
+        expectedFind = i;
+      }
+    }
+  }
+
+  openlib::FlatArray<type> array(values.size());
+  std::copy(values.begin(), values.end(), array.begin());
+  EXPECT_EQ(openlib::find(array, needle), expectedFind);
+  EXPECT_EQ(openlib::count(array, needle), expectedCount);
+}
+
+} // namespace
+
+TEST_P(Kernels, fill) {
+  for (std::size_t size : sizes()) {
+    openlib::FlatArray<uint8_t> bytes(size + 2);
+    openlib::FlatArray<int16_t> shorts(size);
+    openlib::FlatArray<float> floats(size);
+    openlib::FlatArray<uint64_t> longs(size);
+
+    openlib::kernels::fill8(bytes.data() + 1, 0xab, size);
+    openlib::fill(shorts, -3);
+    openlib::fill(floats, 1.5f);
+    openlib::fill(longs, 0x0102030405060708ull);
+
+    EXPECT_EQ(bytes[0], 0);
+    EXPECT_EQ(bytes[size + 1], 0);
+    for (std::size_t i = 0; i < size; i++) {
+      ASSERT_EQ(bytes[i + 1], 0xab);
+      ASSERT_EQ(shorts[i], -3);
+      ASSERT_EQ(floats[i], 1.5f);
+      ASSERT_EQ(longs[i], 0x0102030405060708ull);
+    }
+  }
+}
+
+TEST_P(Kernels, copy) {
+  for (std::size_t size : sizes()) {
+    std::vector<int32_t> values = random<int32_t>(size, 1000);
+    openlib::FlatArray<int32_t> src(size);
+    openlib::FlatArray<int32_t> dst(size);
+    std::copy(values.begin(), values.end(), src.begin());
+
+    openlib::copy(dst, src);
+    for (std::size_t i = 0; i < size; i++) {
+      ASSERT_EQ(dst[i], values[i]);
+    }
+  }
+}
+
+TEST_P(Kernels, equal) {
+  for (std::size_t size : sizes()) {
+    std::vector<uint8_t> values = random<uint8_t>(size, 127);
+    openlib::FlatArray<uint8_t> a(size);
+    openlib::FlatArray<uint8_t> b(size);
+    std::copy(values.begin(), values.end(), a.begin());
+    std::copy(values.begin(), values.end(), b.begin());
+
+    EXPECT_TRUE(openlib::equal(a, b));
+    for (std::size_t i : {std::size_t(0), size / 2, size - 1}) {
+      if (i < size) {
+        b[i] ^= 1;
+        EXPECT_FALSE(openlib::equal(a, b));
+        b[i] ^= 1;
+      }
+    }
+  }
+}
+
+TEST_P(Kernels, findAndCount) {
+  for (std::size_t size : sizes()) {
+    checkFindAndCount(random<uint8_t>(size, 20), uint8_t(3));
+    checkFindAndCount(random<int16_t>(size, 20), int16_t(-3));
+    checkFindAndCount(random<uint32_t>(size, 200), uint32_t(7));
+    checkFindAndCount(random<int64_t>(size, 200), int64_t(-7));
+    checkFindAndCount(random<int32_t>(size, 5), int32_t(1000));
+  }
+}
+
+TEST_P(Kernels, countManyMatches) {
+  // more matches than an 8-bit lane counter can hold
+  openlib::FlatArray<uint8_t> array(100000);
+  array.fill(5);
+  EXPECT_EQ(openlib::count(array, 5), 100000);
+}
+
+TEST_P(Kernels, reductions) {
+  for (std::size_t size : sizes()) {
+    if (size == 0) {
+      continue;
+    }
+    checkReductions(random<int32_t>(size, 1 << 20));
+    checkReductions(random<uint32_t>(size, 1 << 20));
+    checkReductions(random<int64_t>(size, 1 << 20));
+    checkReductions(random<uint64_t>(size, 1 << 20));
+    // small integers keep float sums exact regardless of order
+    checkReductions(random<float>(size, 100));
+    checkReductions(random<double>(size, 100));
+  }
+}
+
+TEST_P(Kernels, bitwise) {
+  std::uniform_int_distribution<uint64_t> distribution;
+  for (std::size_t size : sizes()) {
+    std::vector<uint64_t> a(size), b(size), dst(size);
+    for (std::size_t i = 0; i < size; i++) {
+      a[i] = distribution(engine);
+      b[i] = distribution(engine);
+    }
+
+    openlib::kernels::and64(dst.data(), a.data(), b.data(), size);
+    for (std::size_t i = 0; i < size; i++) {
+      ASSERT_EQ(dst[i], a[i] & b[i]);
+    }
+    openlib::kernels::or64(dst.data(), a.data(), b.data(), size);
+    for (std::size_t i = 0; i < size; i++) {
+      ASSERT_EQ(dst[i], a[i] | b[i]);
+    }
+    openlib::kernels::xor64(dst.data(), a.data(), b.data(), size);
+    for (std::size_t i = 0; i < size; i++) {
+      ASSERT_EQ(dst[i], a[i] ^ b[i]);
+    }
+    openlib::kernels::andNot64(dst.data(), a.data(), b.data(), size);
+    for (std::size_t i = 0; i < size; i++) {
+      ASSERT_EQ(dst[i], a[i] & ~b[i]);
+    }
+
+    // in place
+    std::vector<uint64_t> expected(a);
+    for (std::size_t i = 0; i < size; i++) {
+      expected[i] ^= b[i];
+    }
+    openlib::kernels::xor64(a.data(), a.data(), b.data(), size);
+    EXPECT_EQ(a, expected);
+  }
+}
+
+TEST_P(Kernels, popcount) {
+  std::uniform_int_distribution<uint64_t> distribution;
+  for (std::size_t size : sizes()) {
+    std::vector<uint64_t> words(size);
+    std::size_t expected = 0;
+    for (auto& word : words) {
+      word = distribution(engine);
+      for (uint64_t bits = word; bits; bits &= bits - 1) {
+        expected++;
+      }
+    }
+    EXPECT_EQ(openlib::kernels::popcount64(words.data(), size), expected);
+  }
+
+  // every bit set, enough words to fill the byte counters many times over
+  std::vector<uint64_t> ones(100003, ~uint64_t(0));
+  EXPECT_EQ(openlib::kernels::popcount64(ones.data(), ones.size()), ones.size() * 64);
+}
+
+TEST_P(Kernels, hash) {
+  std::vector<uint8_t> bytes = random<uint8_t>(5000, 127);
+
+  std::vector<std::size_t> lengths = sizes();
+  lengths.back() = bytes.size();
+  for (std::size_t length : lengths) {
+    if (length > bytes.size()) {
+      continue;
+    }
+    openlib::kernels::setIsa(Isa::Scalar);
+    const uint64_t expected = openlib::kernels::hash64(bytes.data(), length, 7);
+    openlib::kernels::setIsa(GetParam());
+    ASSERT_EQ(openlib::kernels::hash64(bytes.data(), length, 7), expected) << length;
+  }
+
+  // every byte of every length class affects the hash
+  for (std::size_t length : {1, 3, 4, 8, 9, 16, 17, 240, 241, 1024, 1087, 4999}) {
+    const uint64_t original = openlib::kernels::hash64(bytes.data(), length);
+    EXPECT_NE(openlib::kernels::hash64(bytes.data(), length, 1), original) << length;
+    for (std::size_t i = 0; i < length; i++) {
+      bytes[i] ^= 0x10;
+      ASSERT_NE(openlib::kernels::hash64(bytes.data(), length), original) << length << " " << i;
+      bytes[i] ^= 0x10;
+    }
+  }
+}
+
+TEST_P(Kernels, byteSwap) {
+  std::vector<uint8_t> bytes = random<uint8_t>(8 * 300 + 1, 255);
+  for (std::size_t size : sizes()) {
+    if (8 * size + 1 > bytes.size()) {
+      continue;
+    }
+    // offset by one byte, the kernels must not need aligned buffers
+    const uint8_t* src = bytes.data() + 1;
+    for (std::size_t width : {2, 4, 8}) {
+      std::vector<uint8_t> swapped(width * size + 1);
+      if (width == 2) {
+        openlib::kernels::byteSwap16(swapped.data() + 1, src, size);
+      } else if (width == 4) {
+        openlib::kernels::byteSwap32(swapped.data() + 1, src, size);
+      } else {
+        openlib::kernels::byteSwap64(swapped.data() + 1, src, size);
+      }
+      for (std::size_t i = 0; i < width * size; i++) {
+        const std::size_t word = i / width;
+        const std::size_t mirrored = word * width + width - 1 - i % width;
+        ASSERT_EQ(swapped[i + 1], src[mirrored]) << width << " " << size << " " << i;
+      }
+    }
+  }
+
+  // in place
+  std::vector<uint32_t> words = {0x01020304, 0x05060708, 0x090a0b0c, 0x0d0e0f10, 0x11121314,
+                                 0x15161718, 0x191a1b1c, 0x1d1e1f20, 0x21222324, 0x25262728,
+                                 0x292a2b2c, 0x2d2e2f30, 0x31323334, 0x35363738, 0x393a3b3c,
+                                 0x3d3e3f40, 0x41424344, 0x45464748};
+  std::vector<uint32_t> expected = words;
+  for (auto& word : expected) {
+    word = __builtin_bswap32(word);
+  }
+  openlib::kernels::byteSwap32(words.data(), words.data(), words.size());
+  EXPECT_EQ(words, expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(EveryIsa, Kernels, testing::ValuesIn(openlib::kernels::supportedIsas()),
+                         [](const testing::TestParamInfo<Isa>& info) {
+                           std::string name = openlib::kernels::isaName(info.param);
+                           return name == "AVX-512" ? std::string("AVX512") : name;
+                         });
+
+TEST(KernelsApi, minOfEmptyArrayThrows) {
+  openlib::FlatArray<int32_t> array(0);
+  EXPECT_THROW(openlib::min(array), std::length_error);
+  EXPECT_THROW(openlib::max(array), std::length_error);
+  EXPECT_EQ(openlib::sum(array), 0);
+}
+
+TEST(KernelsApi, worksWithArray) {
+  openlib::Array<int32_t> array = {4, -2, 9, 1};
+
+  EXPECT_EQ(openlib::min(array), -2);
+  EXPECT_EQ(openlib::max(array), 9);
+  EXPECT_EQ(openlib::sum(array), 12);
+  EXPECT_EQ(openlib::find(array, 9), 2);
+}
+
+TEST(KernelsApi, genericFallbackForOtherTypes) {
+  openlib::FlatArray<std::string> a = {"x", "y"};
+  openlib::FlatArray<std::string> b = {"x", "y"};
+  openlib::FlatArray<int16_t> shorts = {3, -1, 2};
+
+  EXPECT_TRUE(openlib::equal(a, b));
+  EXPECT_EQ(openlib::find(a, std::string("y")), 1);
+  EXPECT_EQ(openlib::min(shorts), -1);
+}
+
+TEST(KernelsApi, floatEqualityComparesValues) {
+  openlib::FlatArray<float> a = {0.0f};
+  openlib::FlatArray<float> b = {-0.0f};
+
+  EXPECT_TRUE(openlib::equal(a, b));
+}
+
+TEST(KernelsApi, copyIntoSmallerArrayThrows) {
+  openlib::FlatArray<int> src(4);
+  openlib::FlatArray<int> dst(3);
+  EXPECT_THROW(openlib::copy(dst, src), std::length_error);
+}
+
+TEST(KernelsApi, setUnsupportedIsaThrowsOrSucceeds) {
+  Isa previous = openlib::kernels::activeIsa();
+  for (Isa isa : {Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::AVX512}) {
+    bool supported = false;
+    for (Isa s : openlib::kernels::supportedIsas()) {
+      supported |= s == isa;
+    }
+    if (supported) {
+      EXPECT_NO_THROW(openlib::kernels::setIsa(isa));
+    } else {
+      EXPECT_THROW(openlib::kernels::setIsa(isa), std::invalid_argument);
+    }
+  }
+  openlib::kernels::setIsa(previous);
+}
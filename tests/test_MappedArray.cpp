@@ -0,0 +1,196 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Kernels.h>
+#include <openlib/MappedArray.h>
+
+namespace {
+
+/*
+ * Creates a temporary file holding the given values, removed on destruction
+ */
+class TempFile {
+public:
+  template <class type>
+  TempFile(std::initializer_list<type> values):
+      path("/tmp/openlib_mapped_" + std::to_string(getpid()) + "_" + std::to_string(counter++)) {
+    std::ofstream out(path, std::ios::binary);
+    for (const auto& value : values) {
+      out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+  }
+
+  ~TempFile() {
+    std::remove(path.c_str());
+  }
+
+  template <class type>
+  type read(std::size_t position) const {
+    std::ifstream in(path, std::ios::binary);
+    in.seekg(position * sizeof(type));
+    type value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+  }
+
+  const std::string path;
+
+private:
+  static int counter;
+};
+
+int TempFile::counter = 0;
+
+} // namespace
+
+TEST(MappedArray, readOnly) {
+  TempFile file({int32_t(1), int32_t(2), int32_t(3)});
+  openlib::MappedArray<const int32_t> array(file.path);
+
+  EXPECT_EQ(array.file().mode(), openlib::MappedFile::Mode::ReadOnly);
+
+  EXPECT_EQ(array.size(), 3);
+  EXPECT_EQ(array[0], 1);
+  EXPECT_EQ(array.back(), 3);
+  EXPECT_EQ(openlib::sum(array), 6);
+}
+
+TEST(MappedArray, rangeBasedForLoop) {
+  TempFile file({1.0, 2.0});
+  openlib::MappedArray<double> array(file.path);
+
+  double expected = 0;
+  for (const auto& value : array) {
+    EXPECT_EQ(value, ++expected);
+  }
+  EXPECT_EQ(expected, 2);
+}
+
+TEST(MappedArray, privateWritesDoNotReachFile) {
+  TempFile file({int32_t(1), int32_t(2)});
+  {
+    openlib::MappedArray<int32_t> array(file.path, openlib::MappedFile::Mode::Private);
+    array[0] = 99;
+    EXPECT_EQ(array[0], 99);
+  }
+  EXPECT_EQ(file.read<int32_t>(0), 1);
+}
+
+TEST(MappedArray, sharedWritesReachFile) {
+  TempFile file({int32_t(1), int32_t(2)});
+  {
+    openlib::MappedArray<int32_t> array(file.path, openlib::MappedFile::Mode::Shared);
+    array.fill(7);
+    array.sync();
+  }
+  EXPECT_EQ(file.read<int32_t>(0), 7);
+  EXPECT_EQ(file.read<int32_t>(1), 7);
+}
+
+TEST(MappedArray, createFile) {
+  TempFile file({uint8_t(0)});
+  {
+    openlib::MappedArray<uint64_t> array(file.path, std::size_t(1000));
+    EXPECT_EQ(array.size(), 1000);
+    array[999] = 42;
+  }
+  openlib::MappedArray<uint64_t> array(file.path);
+  EXPECT_EQ(array.size(), 1000);
+  EXPECT_EQ(array[999], 42);
+  EXPECT_EQ(array[0], 0);
+}
+
+TEST(MappedArray, advise) {
+  TempFile file({int32_t(1), int32_t(2), int32_t(3)});
+  openlib::MappedArray<int32_t> array(file.path);
+
+  EXPECT_NO_THROW(array.advise(openlib::MappedFile::Advice::Sequential));
+  EXPECT_NO_THROW(array.advise(openlib::MappedFile::Advice::Random, 1, 2));
+  EXPECT_NO_THROW(array.advise(openlib::MappedFile::Advice::WillNeed));
+}
+
+TEST(MappedArray, defaultsToPrivateForMutableElements) {
+  TempFile file({int32_t(1)});
+  openlib::MappedArray<int32_t> array(file.path);
+
+  EXPECT_EQ(array.file().mode(), openlib::MappedFile::Mode::Private);
+  array.fill(0);
+  EXPECT_EQ(array[0], 0);
+  EXPECT_EQ(file.read<int32_t>(0), 1);
+}
+
+TEST(MappedArray, readOnlyNeedsConstElements) {
+  TempFile file({int32_t(1)});
+  EXPECT_THROW(openlib::MappedArray<int32_t> array(file.path, openlib::MappedFile::Mode::ReadOnly),
+               std::invalid_argument);
+}
+
+TEST(MappedArray, constAccessors) {
+  TempFile file({int32_t(1), int32_t(2)});
+  const openlib::MappedArray<int32_t> array(file.path);
+
+  static_assert(std::is_same<decltype(array.data()), const int32_t*>::value, "");
+  static_assert(std::is_same<decltype(array[0]), const int32_t&>::value, "");
+  static_assert(std::is_same<decltype(array.front()), const int32_t&>::value, "");
+  EXPECT_EQ(array.front() + array.back(), 3);
+}
+
+TEST(MappedArray, emptyFile) {
+  TempFile file(std::initializer_list<int32_t>{});
+  openlib::MappedArray<int32_t> array(file.path);
+
+  EXPECT_EQ(array.size(), 0);
+  EXPECT_EQ(array.begin(), array.end());
+}
+
+TEST(MappedArray, missingFileThrows) {
+  EXPECT_THROW(openlib::MappedArray<int32_t> array("/nonexistent/openlib"), std::system_error);
+}
+
+TEST(MappedArray, sizeNotMultipleOfElementThrows) {
+  TempFile file({uint8_t(1), uint8_t(2), uint8_t(3)});
+  EXPECT_THROW(openlib::MappedArray<int32_t> array(file.path), std::length_error);
+}
+
+TEST(MappedArray, moveConstructor) {
+  TempFile file({int32_t(5)});
+  openlib::MappedArray<int32_t> array1(file.path);
+  openlib::MappedArray<int32_t> array2 = std::move(array1);
+
+  EXPECT_EQ(array2[0], 5);
+}
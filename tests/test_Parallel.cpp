@@ -0,0 +1,207 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Array.h>
+#include <openlib/FlatArray.h>
+#include <openlib/Parallel.h>
+
+namespace {
+
+// small grain so even short arrays are split across threads
+openlib::ParallelOptions options(openlib::ThreadPool& pool, std::size_t grain = 100) {
+  openlib::ParallelOptions result;
+  result.pool = &pool;
+  result.grain = grain;
+  return result;
+}
+
+} // namespace
+
+TEST(Parallel, forEach) {
+  openlib::ThreadPool pool(4);
+  openlib::FlatArray<int> array(10001);
+  for (std::size_t i = 0; i < array.size(); i++) {
+    array[i] = static_cast<int>(i);
+  }
+
+  openlib::parallelForEach(array, [](int& value) { value *= 2; }, options(pool));
+
+  for (std::size_t i = 0; i < array.size(); i++) {
+    ASSERT_EQ(array[i], static_cast<int>(2 * i));
+  }
+}
+
+TEST(Parallel, transform) {
+  openlib::ThreadPool pool(4);
+  openlib::Array<int> src(5000);
+  openlib::FlatArray<double> dst(5000);
+  for (std::size_t i = 0; i < src.size(); i++) {
+    src[i] = static_cast<int>(i);
+  }
+
+  openlib::parallelTransform(src, dst, [](int value) { return value * 0.5; }, options(pool));
+
+  for (std::size_t i = 0; i < dst.size(); i++) {
+    ASSERT_EQ(dst[i], i * 0.5);
+  }
+
+  openlib::FlatArray<double> small(10);
+  EXPECT_THROW(openlib::parallelTransform(src, small, [](int value) { return value * 1.0; }),
+               std::length_error);
+}
+
+TEST(Parallel, reduce) {
+  openlib::ThreadPool pool(4);
+  openlib::FlatArray<uint64_t> array(100000);
+  for (std::size_t i = 0; i < array.size(); i++) {
+    array[i] = i;
+  }
+
+  EXPECT_EQ(openlib::parallelReduce(array, uint64_t(7), options(pool)), 4999950000ull + 7);
+  EXPECT_EQ(openlib::parallelReduce(array, uint64_t(0), [](uint64_t a, uint64_t b) {
+    return std::max(a, b);
+  }, options(pool)), 99999);
+
+  openlib::FlatArray<uint64_t> empty(0);
+  EXPECT_EQ(openlib::parallelReduce(empty, uint64_t(3), options(pool)), 3);
+}
+
+TEST(Parallel, reduceKeepsOrder) {
+  openlib::ThreadPool pool(4);
+  openlib::FlatArray<std::string> array(1000);
+  for (std::size_t i = 0; i < array.size(); i++) {
+    array[i] = std::string(1, static_cast<char>('a' + i % 26));
+  }
+
+  std::string expected = ">";
+  for (std::size_t i = 0; i < array.size(); i++) {
+    expected += array[i];
+  }
+
+  EXPECT_EQ(openlib::parallelReduce(array, std::string(">"), std::plus<std::string>(),
+                                    options(pool, 7)), expected);
+}
+
+TEST(Parallel, fill) {
+  openlib::ThreadPool pool(4);
+  openlib::Array<float> array(12345);
+  openlib::parallelFill(array, 2.5f, options(pool));
+  for (std::size_t i = 0; i < array.size(); i++) {
+    ASSERT_EQ(array[i], 2.5f);
+  }
+}
+
+TEST(Parallel, sort) {
+  std::mt19937 random(42);
+  for (std::size_t threads : {1, 2, 3, 4, 8}) {
+    openlib::ThreadPool pool(threads);
+    for (std::size_t size : {0, 1, 99, 100, 101, 1000, 12345}) {
+      openlib::FlatArray<uint32_t> array(size);
+      std::vector<uint32_t> expected(size);
+      for (std::size_t i = 0; i < size; i++) {
+        array[i] = expected[i] = random();
+      }
+      std::sort(expected.begin(), expected.end());
+
+      openlib::parallelSort(array, options(pool));
+
+      ASSERT_TRUE(std::equal(expected.begin(), expected.end(), array.begin()))
+          << threads << " threads, " << size << " elements";
+    }
+  }
+}
+
+TEST(Parallel, sortFloats) {
+  openlib::ThreadPool pool(4);
+  std::mt19937 random(5);
+  std::normal_distribution<double> distribution(0, 1e6);
+  openlib::FlatArray<double> array(54321);
+  for (auto& value : array) {
+    value = distribution(random);
+  }
+
+  openlib::parallelSort(array, options(pool));
+
+  EXPECT_TRUE(std::is_sorted(array.begin(), array.end()));
+}
+
+TEST(Parallel, sortByKey) {
+  std::mt19937 random(6);
+  for (std::size_t threads : {1, 3, 8}) {
+    openlib::ThreadPool pool(threads);
+    const std::size_t size = 30011;
+    openlib::FlatArray<uint64_t> keys(size);
+    openlib::FlatArray<uint32_t> values(size);
+    std::vector<std::pair<uint64_t, uint32_t>> expected;
+    for (std::size_t i = 0; i < size; i++) {
+      keys[i] = random() % 5000;
+      values[i] = static_cast<uint32_t>(i);
+      expected.emplace_back(keys[i], values[i]);
+    }
+    // values are the original positions, so a stable sort is a plain sort
+    std::sort(expected.begin(), expected.end());
+
+    openlib::parallelSortByKey(keys, values, options(pool));
+
+    for (std::size_t i = 0; i < size; i++) {
+      ASSERT_EQ(keys[i], expected[i].first) << threads << " threads";
+      ASSERT_EQ(values[i], expected[i].second) << threads << " threads";
+    }
+  }
+
+  openlib::FlatArray<uint64_t> keys(2);
+  openlib::FlatArray<uint32_t> values(3);
+  EXPECT_THROW(openlib::parallelSortByKey(keys, values), std::length_error);
+}
+
+TEST(Parallel, sortWithComparator) {
+  openlib::ThreadPool pool(4);
+  openlib::FlatArray<std::string> array(3000);
+  for (std::size_t i = 0; i < array.size(); i++) {
+    array[i] = std::to_string(i);
+  }
+
+  openlib::parallelSort(array, std::greater<std::string>(), options(pool));
+
+  EXPECT_TRUE(std::is_sorted(array.begin(), array.end(), std::greater<std::string>()));
+  EXPECT_EQ(array.front(), "999");
+}
+
+TEST(Parallel, sharedPoolByDefault) {
+  openlib::FlatArray<int> array(1 << 20);
+  openlib::parallelFill(array, 1);
+  EXPECT_EQ(openlib::parallelReduce(array, 0), 1 << 20);
+}
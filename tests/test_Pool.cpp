@@ -0,0 +1,99 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/Pool.h>
+
+TEST(Pool, isConstructable) {
+  openlib::Pool pool;
+  // if the test gets this far it passe
+}
+
+TEST(Pool, sizeClassRoundsUpToPowerOfTwo) {
+  EXPECT_EQ(openlib::Pool::sizeClass(0), 0);
+  EXPECT_EQ(openlib::Pool::sizeClass(1), 0);
+  EXPECT_EQ(openlib::Pool::sizeClass(16), 0);
+  EXPECT_EQ(openlib::Pool::sizeClass(17), 1);
+  EXPECT_EQ(openlib::Pool::sizeClass(32), 1);
+  EXPECT_EQ(openlib::Pool::sizeClass(33), 2);
+  EXPECT_EQ(openlib::Pool::sizeClass(openlib::Pool::MAX_BLOCK_SIZE), 12);
+}
+
+TEST(Pool, deallocatedBlockIsReused) {
+  openlib::Pool pool;
+
+  void* first = pool.allocate(100, 8);
+  pool.deallocate(first, 100, 8);
+  void* second = pool.allocate(120, 8);
+
+  // 100 and 120 share the 128 byte size class
+  EXPECT_EQ(first, second);
+}
+
+TEST(Pool, allocationsDoNotOverlap) {
+  openlib::Pool pool;
+
+  uint8_t* a = static_cast<uint8_t*>(pool.allocate(64, 8));
+  uint8_t* b = static_cast<uint8_t*>(pool.allocate(64, 8));
+  EXPECT_TRUE(a + 64 <= b || b + 64 <= a);
+}
+
+TEST(Pool, largeAllocationBypassesSizeClasses) {
+  openlib::Pool pool;
+
+  std::size_t bytes = openlib::Pool::MAX_BLOCK_SIZE + 1;
+  uint8_t* p = static_cast<uint8_t*>(pool.allocate(bytes, 8));
+  p[0] = 1;
+  p[bytes - 1] = 2;
+  EXPECT_EQ(p[bytes - 1], 2);
+  pool.deallocate(p, bytes, 8);
+}
+
+TEST(Pool, overAlignedAllocation) {
+  openlib::Pool pool;
+
+  void* p = pool.allocate(64, 64);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 64, 0);
+  pool.deallocate(p, 64, 64);
+}
+
+TEST(Pool, flatArrayWithPoolAllocator) {
+  openlib::Pool pool;
+  openlib::PoolAllocator<int> allocator(pool);
+
+  int* first;
+  {
+    openlib::FlatArray<int, openlib::PoolAllocator<int>> array({1, 2, 3}, allocator);
+    EXPECT_EQ(array[1], 2);
+    first = array.data();
+  }
+  openlib::FlatArray<int, openlib::PoolAllocator<int>> array(3, allocator);
+  EXPECT_EQ(array.data(), first);
+}
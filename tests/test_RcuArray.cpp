@@ -0,0 +1,179 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Kernels.h>
+#include <openlib/RcuArray.h>
+
+#include "AllocationCounter.h"
+
+namespace {
+
+// counts live instances so tests can see when snapshots are freed
+struct Tracked {
+  static std::atomic<int> live;
+  int value;
+  Tracked(): value(0) { live++; }
+  Tracked(const Tracked& other): value(other.value) { live++; }
+  ~Tracked() { live--; }
+};
+
+std::atomic<int> Tracked::live(0);
+
+openlib::FlatArray<Tracked> tracked(std::size_t size, int value) {
+  openlib::FlatArray<Tracked> array(size);
+  for (auto& element : array) {
+    element.value = value;
+  }
+  return array;
+}
+
+} // namespace
+
+TEST(RcuArray, readsCurrentSnapshot) {
+  openlib::RcuArray<int> array(openlib::FlatArray<int>({1, 2, 3}));
+  auto reader = array.reader();
+
+  auto snapshot = reader.read();
+  EXPECT_EQ(snapshot.size(), 3);
+  EXPECT_EQ(snapshot[0], 1);
+  EXPECT_EQ(snapshot.at(1), 2);
+  EXPECT_EQ(snapshot.back(), 3);
+  EXPECT_EQ(openlib::sum(snapshot), 6);
+}
+
+TEST(RcuArray, publishReplaces) {
+  openlib::RcuArray<int> array(openlib::FlatArray<int>({1}));
+  auto reader = array.reader();
+
+  array.publish(openlib::FlatArray<int>({2, 2}));
+  auto snapshot = reader.read();
+  EXPECT_EQ(snapshot.size(), 2);
+  EXPECT_EQ(snapshot.front(), 2);
+}
+
+TEST(RcuArray, pinnedSnapshotSurvivesPublish) {
+  {
+    openlib::RcuArray<Tracked> array(tracked(10, 1));
+    auto reader = array.reader();
+
+    {
+      auto pinned = reader.read();
+      array.publish(tracked(10, 2));
+      array.publish(tracked(10, 3));
+      EXPECT_EQ(pinned[0].value, 1);
+      EXPECT_EQ(array.reclaim(), 2);
+      EXPECT_EQ(Tracked::live.load(), 30);
+
+      // a nested read sees the newest snapshot
+      auto inner = reader.read();
+      EXPECT_EQ(inner[0].value, 3);
+    }
+
+    EXPECT_EQ(array.reclaim(), 0);
+    EXPECT_EQ(Tracked::live.load(), 10);
+  }
+  EXPECT_EQ(Tracked::live.load(), 0);
+}
+
+TEST(RcuArray, failedPublishKeepsCurrentSnapshot) {
+  openlib::RcuArray<Tracked> array(tracked(4, 1));
+  auto reader = array.reader();
+  auto next = tracked(4, 2);
+
+  // the snapshot itself is allocated, queueing the old one is not
+  openlib::test::failAllocationAfter(1);
+  EXPECT_THROW(array.publish(std::move(next)), std::bad_alloc);
+  EXPECT_EQ(Tracked::live.load(), 4);
+  EXPECT_EQ(reader.read()[0].value, 1);
+
+  array.publish(tracked(4, 3));
+  EXPECT_EQ(reader.read()[0].value, 3);
+  array.synchronize();
+  EXPECT_EQ(array.reclaim(), 0);
+  EXPECT_EQ(Tracked::live.load(), 4);
+}
+
+TEST(RcuArray, publishFreesUnreadSnapshots) {
+  openlib::RcuArray<Tracked> array(tracked(4, 0));
+  for (int i = 1; i <= 100; i++) {
+    array.publish(tracked(4, i));
+  }
+  EXPECT_EQ(Tracked::live.load(), 4);
+  array.synchronize();
+  EXPECT_EQ(array.reclaim(), 0);
+}
+
+TEST(RcuArray, concurrentReadersAndWriters) {
+  const int VERSIONS = 200;
+  openlib::RcuArray<uint64_t> array(openlib::FlatArray<uint64_t>(64));
+  std::atomic<bool> done(false);
+  std::atomic<int> torn(0);
+
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++) {
+    readers.emplace_back([&]() {
+      auto reader = array.reader();
+      while (!done.load()) {
+        auto snapshot = reader.read();
+        // every published snapshot is filled with a single value
+        if (openlib::count(snapshot, snapshot[0]) != snapshot.size()) {
+          torn++;
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 2; t++) {
+    writers.emplace_back([&, t]() {
+      for (int i = t; i < VERSIONS; i += 2) {
+        openlib::FlatArray<uint64_t> next(64);
+        next.fill(i);
+        array.publish(std::move(next));
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(torn.load(), 0);
+  array.synchronize();
+  EXPECT_EQ(array.reclaim(), 0);
+}
@@ -0,0 +1,121 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/SearchIndex.h>
+
+TEST(SearchIndex, matchesStdBounds) {
+  std::mt19937 random(42);
+  for (std::size_t size : {0, 1, 2, 3, 7, 8, 15, 16, 17, 100, 1000, 4097}) {
+    openlib::FlatArray<int> sorted(size);
+    for (auto& value : sorted) {
+      // plenty of duplicates
+      value = static_cast<int>(random() % (size + 1)) * 2;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    openlib::SearchIndex<int> index(sorted);
+    ASSERT_EQ(index.size(), size);
+
+    std::vector<int> keys;
+    for (int key = -2; key <= static_cast<int>(2 * size + 3); key++) {
+      keys.push_back(key);
+    }
+    std::vector<std::size_t> lower(keys.size());
+    std::vector<std::size_t> upper(keys.size());
+    index.lowerBound(keys, lower);
+    index.upperBound(keys, upper);
+
+    for (std::size_t i = 0; i < keys.size(); i++) {
+      const int key = keys[i];
+      const std::size_t expectedLower = std::lower_bound(sorted.begin(), sorted.end(), key) -
+                                        sorted.begin();
+      const std::size_t expectedUpper = std::upper_bound(sorted.begin(), sorted.end(), key) -
+                                        sorted.begin();
+      ASSERT_EQ(index.lowerBound(key), expectedLower) << size << " " << key;
+      ASSERT_EQ(index.upperBound(key), expectedUpper) << size << " " << key;
+      ASSERT_EQ(lower[i], expectedLower) << size << " " << key;
+      ASSERT_EQ(upper[i], expectedUpper) << size << " " << key;
+      ASSERT_EQ(index.contains(key), expectedLower != expectedUpper);
+    }
+  }
+}
+
+TEST(SearchIndex, at) {
+  openlib::FlatArray<int> sorted = {1, 3, 5, 7, 9, 11};
+  openlib::SearchIndex<int> index(sorted);
+  for (std::size_t i = 0; i < sorted.size(); i++) {
+    EXPECT_EQ(index.at(i), sorted[i]);
+  }
+  EXPECT_THROW(index.at(6), std::out_of_range);
+}
+
+TEST(SearchIndex, atEveryTreeShape) {
+  // every fill of the last level, the positions come from the node index
+  for (std::size_t size = 1; size <= 130; size++) {
+    openlib::FlatArray<int> sorted(size);
+    for (std::size_t i = 0; i < size; i++) {
+      sorted[i] = static_cast<int>(2 * i);
+    }
+    openlib::SearchIndex<int> index(sorted);
+    for (std::size_t i = 0; i < size; i++) {
+      ASSERT_EQ(index.at(i), sorted[i]) << size << " " << i;
+      ASSERT_EQ(index.lowerBound(sorted[i]), i) << size << " " << i;
+      ASSERT_EQ(index.upperBound(sorted[i]), i + 1) << size << " " << i;
+    }
+  }
+}
+
+TEST(SearchIndex, customCompare) {
+  std::vector<std::string> sorted = {"pear", "kiwi", "fig", "apple"};
+  openlib::SearchIndex<std::string, std::greater<std::string>> index(sorted);
+  EXPECT_EQ(index.lowerBound("kiwi"), 1);
+  EXPECT_EQ(index.upperBound("kiwi"), 2);
+  EXPECT_EQ(index.lowerBound("banana"), 3);
+  EXPECT_TRUE(index.contains("apple"));
+  EXPECT_FALSE(index.contains("zucchini"));
+}
+
+TEST(SearchIndex, rejectsUnsortedInput) {
+  openlib::FlatArray<int> unsorted = {1, 3, 2};
+  EXPECT_THROW(openlib::SearchIndex<int> index(unsorted), std::invalid_argument);
+}
+
+TEST(SearchIndex, batchChecksSizes) {
+  openlib::FlatArray<int> sorted = {1, 2, 3};
+  openlib::SearchIndex<int> index(sorted);
+  std::vector<int> keys(4);
+  std::vector<std::size_t> results(3);
+  EXPECT_THROW(index.lowerBound(keys, results), std::length_error);
+}
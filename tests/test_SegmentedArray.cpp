@@ -0,0 +1,191 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Arena.h>
+#include <openlib/SegmentedArray.h>
+
+TEST(SegmentedArray, isConstructable) {
+  openlib::SegmentedArray<int> array;
+  EXPECT_EQ(array.size(), 0);
+  EXPECT_TRUE(array.empty());
+  EXPECT_EQ(array.capacity(), 0);
+}
+
+TEST(SegmentedArray, pushBackAndIndex) {
+  openlib::SegmentedArray<int> array;
+  for (int i = 0; i < 10000; i++) {
+    array.push_back(i);
+  }
+
+  EXPECT_EQ(array.size(), 10000);
+  for (int i = 0; i < 10000; i++) {
+    ASSERT_EQ(array[i], i);
+  }
+  EXPECT_EQ(array.front(), 0);
+  EXPECT_EQ(array.back(), 9999);
+}
+
+TEST(SegmentedArray, elementsNeverMove) {
+  openlib::SegmentedArray<int, std::allocator<int>, 4> array;
+  std::vector<int*> addresses;
+  for (int i = 0; i < 5000; i++) {
+    array.push_back(i);
+    addresses.push_back(&array.back());
+  }
+
+  for (int i = 0; i < 5000; i++) {
+    ASSERT_EQ(&array[i], addresses[i]);
+    ASSERT_EQ(*addresses[i], i);
+  }
+}
+
+TEST(SegmentedArray, chunksGrowGeometrically) {
+  openlib::SegmentedArray<int, std::allocator<int>, 16> array;
+
+  array.push_back(1);
+  EXPECT_EQ(array.chunkCount(), 1);
+  EXPECT_EQ(array.capacity(), 16);
+
+  for (int i = 0; i < 16; i++) {
+    array.push_back(i);
+  }
+  EXPECT_EQ(array.chunkCount(), 2);
+  EXPECT_EQ(array.capacity(), 16 + 32);
+}
+
+TEST(SegmentedArray, forEachChunkVisitsElementsInOrder) {
+  openlib::SegmentedArray<int, std::allocator<int>, 8> array;
+  for (int i = 0; i < 100; i++) {
+    array.push_back(i);
+  }
+
+  int expected = 0;
+  std::size_t chunks = 0;
+  array.forEachChunk([&](int* data, std::size_t count) {
+    chunks++;
+    for (std::size_t i = 0; i < count; i++) {
+      EXPECT_EQ(data[i], expected++);
+    }
+  });
+  EXPECT_EQ(expected, 100);
+  EXPECT_EQ(chunks, array.chunkCount());
+}
+
+TEST(SegmentedArray, rangeBasedForLoop) {
+  openlib::SegmentedArray<int, std::allocator<int>, 4> array;
+  for (int i = 0; i < 50; i++) {
+    array.push_back(i);
+  }
+
+  int expected = 0;
+  for (const auto& value : array) {
+    EXPECT_EQ(value, expected++);
+  }
+  EXPECT_EQ(expected, 50);
+}
+
+TEST(SegmentedArray, iterateEmpty) {
+  openlib::SegmentedArray<int> array;
+  EXPECT_TRUE(array.begin() == array.end());
+
+  array.reserve(100);
+  EXPECT_TRUE(array.begin() == array.end());
+}
+
+TEST(SegmentedArray, reserveAllocatesUpFront) {
+  openlib::SegmentedArray<int> array;
+  array.reserve(1000);
+
+  EXPECT_GE(array.capacity(), 1000);
+  std::size_t chunks = array.chunkCount();
+  for (int i = 0; i < 1000; i++) {
+    array.push_back(i);
+  }
+  EXPECT_EQ(array.chunkCount(), chunks);
+}
+
+TEST(SegmentedArray, clearKeepsChunks) {
+  openlib::SegmentedArray<int> array;
+  for (int i = 0; i < 100; i++) {
+    array.push_back(i);
+  }
+  int* first = &array[0];
+  array.clear();
+
+  EXPECT_TRUE(array.empty());
+  array.push_back(7);
+  EXPECT_EQ(&array[0], first);
+  EXPECT_EQ(array[0], 7);
+}
+
+TEST(SegmentedArray, clearReleasesElements) {
+  auto shared = std::make_shared<int>(1);
+  openlib::SegmentedArray<std::shared_ptr<int>> array;
+  for (int i = 0; i < 40; i++) {
+    array.push_back(shared);
+  }
+  EXPECT_EQ(shared.use_count(), 41);
+
+  array.clear();
+  EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(SegmentedArray, nonTrivialType) {
+  openlib::SegmentedArray<std::string> array;
+  for (int i = 0; i < 100; i++) {
+    array.push_back(std::to_string(i));
+  }
+
+  EXPECT_EQ(array[42], "42");
+  EXPECT_EQ(array.back(), "99");
+}
+
+TEST(SegmentedArray, withArenaAllocator) {
+  openlib::Arena arena;
+  openlib::SegmentedArray<int, openlib::ArenaAllocator<int>> array(arena);
+  for (int i = 0; i < 100; i++) {
+    array.push_back(i);
+  }
+
+  EXPECT_EQ(array[99], 99);
+  EXPECT_GT(arena.allocated(), 0);
+}
+
+TEST(SegmentedArray, moveConstructor) {
+  openlib::SegmentedArray<int> array1;
+  array1.push_back(3);
+  int* address = &array1[0];
+
+  openlib::SegmentedArray<int> array2 = std::move(array1);
+  EXPECT_EQ(&array2[0], address);
+  EXPECT_EQ(array1.size(), 0);
+}
@@ -0,0 +1,253 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Arena.h>
+#include <openlib/Deserializer.h>
+#include <openlib/SegmentedSerializer.h>
+#include <openlib/Serializer.h>
+
+TEST(SegmentedSerializer, startsEmpty) {
+  openlib::SegmentedSerializer serializer(16);
+
+  EXPECT_EQ(serializer.size(), 0);
+  EXPECT_EQ(serializer.segmentSize(), 16);
+  EXPECT_EQ(serializer.segmentCount(), 0);
+  EXPECT_TRUE(serializer.iovecs().empty());
+  EXPECT_EQ(serializer.flatten().size(), 0);
+}
+
+TEST(SegmentedSerializer, rejectsZeroSegmentSize) {
+  EXPECT_THROW(openlib::SegmentedSerializer(0), std::invalid_argument);
+}
+
+TEST(SegmentedSerializer, growsInsteadOfThrowing) {
+  openlib::SegmentedSerializer serializer(8);
+  for (uint32_t i = 0; i < 100; ++i) {
+    serializer.putUInt32(i);
+  }
+
+  EXPECT_EQ(serializer.size(), 400);
+  EXPECT_EQ(serializer.segmentCount(), 50);
+
+  openlib::Array<uint8_t> flat = serializer.flatten();
+  openlib::Deserializer deserializer(flat.data(), flat.size());
+  for (uint32_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(deserializer.getUInt32(), i);
+  }
+}
+
+TEST(SegmentedSerializer, matchesSerializer) {
+  openlib::SegmentedSerializer segmented(7);
+  openlib::Serializer serializer(256);
+  std::string text(100, 'q');
+
+  segmented.putChar('a');
+  segmented.putInt16(-2);
+  segmented.putUInt64(0x0102030405060708);
+  segmented.putDouble(1.25);
+  segmented.putString(text);
+  segmented.putFloat(-0.5f);
+  serializer.putChar('a');
+  serializer.putInt16(-2);
+  serializer.putUInt64(0x0102030405060708);
+  serializer.putDouble(1.25);
+  serializer.putString(text);
+  serializer.putFloat(-0.5f);
+
+  openlib::Array<uint8_t> flat = segmented.flatten();
+  ASSERT_EQ(flat.size(), serializer.size());
+  for (std::size_t i = 0; i < flat.size(); ++i) {
+    EXPECT_EQ(flat[i], serializer.data()[i]);
+  }
+}
+
+TEST(SegmentedSerializer, reserveKeepsRecordsContiguous) {
+  openlib::SegmentedSerializer serializer(10);
+  serializer.putUInt32(1);
+
+  serializer.reserve(8);
+  serializer.writeUInt32(2);
+  serializer.writeUInt32(3);
+
+  std::vector<struct iovec> iovecs = serializer.iovecs();
+  ASSERT_EQ(iovecs.size(), 2);
+  EXPECT_EQ(iovecs[0].iov_len, 4);
+  EXPECT_EQ(iovecs[1].iov_len, 8);
+}
+
+TEST(SegmentedSerializer, oversizedRecordGetsItsOwnSegment) {
+  openlib::SegmentedSerializer serializer(4);
+
+  serializer.reserve(16);
+  serializer.writeUInt64(1);
+  serializer.writeUInt64(2);
+  serializer.putUInt8(3);
+
+  std::vector<struct iovec> iovecs = serializer.iovecs();
+  ASSERT_EQ(iovecs.size(), 2);
+  EXPECT_EQ(iovecs[0].iov_len, 16);
+  EXPECT_EQ(iovecs[1].iov_len, 1);
+  EXPECT_EQ(serializer.size(), 17);
+}
+
+TEST(SegmentedSerializer, putSplitsAcrossSegments) {
+  openlib::SegmentedSerializer serializer(16);
+  std::vector<uint8_t> bytes(100);
+  for (std::size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<uint8_t>(i);
+  }
+
+  serializer.putUInt8(255);
+  serializer.put(bytes.data(), bytes.size());
+
+  std::vector<struct iovec> iovecs = serializer.iovecs();
+  EXPECT_EQ(iovecs.size(), 7);
+  for (const struct iovec& vector : iovecs) {
+    EXPECT_LE(vector.iov_len, 16);
+  }
+
+  openlib::Array<uint8_t> flat = serializer.flatten();
+  ASSERT_EQ(flat.size(), 101);
+  EXPECT_EQ(flat[0], 255);
+  for (std::size_t i = 0; i < bytes.size(); ++i) {
+    EXPECT_EQ(flat[i + 1], bytes[i]);
+  }
+}
+
+TEST(SegmentedSerializer, writevSendsEveryByte) {
+  openlib::SegmentedSerializer serializer(32);
+  for (uint16_t i = 0; i < 1000; ++i) {
+    serializer.putUInt16(i);
+  }
+
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  std::vector<struct iovec> iovecs = serializer.iovecs();
+  ssize_t written = 0;
+  for (std::size_t i = 0; i < iovecs.size(); i += IOV_MAX) {
+    int count = static_cast<int>(std::min<std::size_t>(IOV_MAX, iovecs.size() - i));
+    written += writev(fds[1], iovecs.data() + i, count);
+  }
+  close(fds[1]);
+
+  std::vector<uint8_t> received(serializer.size());
+  ssize_t read = 0;
+  while (read < static_cast<ssize_t>(received.size())) {
+    ssize_t bytes = ::read(fds[0], received.data() + read, received.size() - read);
+    ASSERT_GT(bytes, 0);
+    read += bytes;
+  }
+  close(fds[0]);
+
+  EXPECT_EQ(written, 2000);
+  openlib::Deserializer deserializer(received.data(), received.size());
+  for (uint16_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(deserializer.getUInt16(), i);
+  }
+}
+
+TEST(SegmentedSerializer, takesSegmentsFromResource) {
+  openlib::Arena arena;
+  {
+    openlib::SegmentedSerializer serializer(64, arena);
+    serializer.put(std::vector<uint8_t>(200).data(), 200);
+    EXPECT_EQ(serializer.segmentCount(), 4);
+  }
+  EXPECT_GE(arena.allocated(), 256);
+}
+
+TEST(SegmentedSerializer, clearKeepsFirstSegment) {
+  openlib::SegmentedSerializer serializer(8);
+  serializer.putUInt64(1);
+  serializer.putUInt64(2);
+
+  serializer.clear();
+  EXPECT_EQ(serializer.size(), 0);
+  EXPECT_EQ(serializer.segmentCount(), 1);
+
+  serializer.putUInt32(7);
+  std::vector<struct iovec> iovecs = serializer.iovecs();
+  ASSERT_EQ(iovecs.size(), 1);
+  EXPECT_EQ(iovecs[0].iov_len, 4);
+}
+
+TEST(SegmentedSerializer, moveLeavesSourceEmpty) {
+  openlib::SegmentedSerializer serializer(8);
+  serializer.putUInt64(1);
+  serializer.putUInt8(2);
+
+  openlib::SegmentedSerializer moved(std::move(serializer));
+  EXPECT_EQ(moved.size(), 9);
+  EXPECT_EQ(moved.segmentCount(), 2);
+  EXPECT_EQ(serializer.size(), 0);
+  EXPECT_EQ(serializer.segmentCount(), 0);
+  serializer.putUInt8(3);
+  EXPECT_EQ(serializer.size(), 1);
+}
+
+TEST(SegmentedSerializer, arraysSplitOnElementBoundaries) {
+  openlib::SegmentedSerializer serializer(10);
+  std::vector<uint32_t> values(25);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<uint32_t>(i * 0x01020304);
+  }
+
+  serializer.putUInt8(9);
+  serializer.putUInt32Array(values.data(), values.size());
+
+  std::vector<struct iovec> iovecs = serializer.iovecs();
+  for (std::size_t i = 1; i < iovecs.size(); ++i) {
+    EXPECT_EQ(iovecs[i].iov_len % sizeof(uint32_t), 0);
+  }
+
+  openlib::Array<uint8_t> flat = serializer.flatten();
+  openlib::Deserializer deserializer(flat.data(), flat.size());
+  EXPECT_EQ(deserializer.getUInt8(), 9);
+  std::vector<uint32_t> back(values.size());
+  deserializer.getUInt32Array(back.data(), back.size());
+  EXPECT_EQ(back, values);
+}
+
+TEST(SegmentedSerializer, arrayWiderThanSegment) {
+  openlib::SegmentedSerializer serializer(3);
+  uint64_t values[3] = {1, 2, 3};
+
+  serializer.putUInt64Array(values, 3);
+
+  EXPECT_EQ(serializer.size(), 24);
+  EXPECT_EQ(serializer.segmentCount(), 3);
+}
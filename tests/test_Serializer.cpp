@@ -28,8 +28,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <gtest/gtest.h>
 
+#include <openlib/Arena.h>
+#include <openlib/Pool.h>
 #include <openlib/Serializer.h>
 
+// existing code forward declares the class
+namespace openlib {
+class Serializer;
+}
+
 TEST(Serializer, isConstructable) {
   openlib::Serializer serializer(0);
   // if this test compiles it passe
@@ -257,3 +264,59 @@ TEST(Serializer, putTooLongStringThrows) {
   }
 }
 
+
+TEST(Serializer, uninitializedConstructor) {
+  openlib::Serializer serializer(10, openlib::uninitialized);
+
+  EXPECT_EQ(serializer.size(), 0);
+  EXPECT_EQ(serializer.capacity(), 10);
+
+  serializer.putUInt16(0x0102);
+  EXPECT_EQ(serializer.data()[0], 0x01);
+  EXPECT_EQ(serializer.data()[1], 0x02);
+}
+
+TEST(Serializer, takesStorageFromArena) {
+  openlib::Arena arena;
+  openlib::Serializer serializer(16, openlib::uninitialized, arena);
+
+  serializer.putUInt16(0x0102);
+  EXPECT_EQ(serializer.data()[0], 0x01);
+  EXPECT_EQ(serializer.data()[1], 0x02);
+  EXPECT_EQ(arena.allocated(), 16);
+}
+
+TEST(Serializer, takesStorageFromPool) {
+  openlib::Pool pool;
+  uint8_t* first;
+  {
+    openlib::Serializer serializer(100, pool);
+    first = serializer.data();
+  }
+  openlib::Serializer serializer(100, pool);
+
+  EXPECT_EQ(serializer.data(), first);
+  EXPECT_EQ(serializer.capacity(), 100);
+}
+
+TEST(Serializer, putView) {
+  openlib::FlatArray<uint16_t> array = {0x0102, 0x0304};
+  openlib::Serializer serializer(8);
+
+  serializer.put(openlib::asBytes(array).slice(2));
+  serializer.put(openlib::ArrayView<const uint8_t>());
+
+  EXPECT_EQ(serializer.size(), 2);
+  EXPECT_EQ(serializer.data()[0], 0x04);
+  EXPECT_EQ(serializer.data()[1], 0x03);
+}
+
+TEST(Serializer, viewsWrittenBytes) {
+  openlib::Serializer serializer(8);
+  serializer.putUInt16(0x0102);
+
+  openlib::ArrayView<const uint8_t> view = serializer.view();
+  EXPECT_EQ(view.data(), serializer.data());
+  EXPECT_EQ(view.size(), 2);
+  EXPECT_EQ(view[1], 0x02);
+}
@@ -0,0 +1,174 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Arena.h>
+#include <openlib/ArrayView.h>
+#include <openlib/Kernels.h>
+#include <openlib/SharedArray.h>
+
+TEST(SharedArray, isConstructable) {
+  openlib::SharedArray<int> array(3);
+  EXPECT_EQ(array.size(), 3);
+  EXPECT_EQ(array[2], 0);
+  EXPECT_TRUE(array.unique());
+
+  openlib::SharedArray<int> list = {1, 2, 3};
+  EXPECT_EQ(list.front(), 1);
+  EXPECT_EQ(list.back(), 3);
+  EXPECT_EQ(list.at(1), 2);
+}
+
+TEST(SharedArray, copyShares) {
+  openlib::SharedArray<int> array = {1, 2, 3};
+  openlib::SharedArray<int> copy = array;
+
+  EXPECT_EQ(copy.data(), array.data());
+  EXPECT_EQ(array.useCount(), 2);
+  EXPECT_TRUE(copy == array);
+
+  openlib::SharedArray<int> assigned(0);
+  assigned = copy;
+  EXPECT_EQ(array.useCount(), 3);
+  assigned = assigned;
+  EXPECT_EQ(array.useCount(), 3);
+  EXPECT_EQ(assigned.data(), array.data());
+}
+
+TEST(SharedArray, writeCopiesOnce) {
+  openlib::SharedArray<std::string> array = {"a", "b"};
+  openlib::SharedArray<std::string> copy = array;
+  const std::string* shared = array.data();
+
+  copy.set(0, "z");
+  EXPECT_NE(copy.data(), shared);
+  EXPECT_EQ(array.data(), shared);
+  EXPECT_EQ(array[0], "a");
+  EXPECT_EQ(copy[0], "z");
+  EXPECT_EQ(copy[1], "b");
+  EXPECT_TRUE(array.unique());
+  EXPECT_TRUE(copy.unique());
+
+  // already unique, no further copies
+  const std::string* owned = copy.data();
+  copy.set(1, "y");
+  EXPECT_EQ(copy.mutableData(), owned);
+}
+
+TEST(SharedArray, copiesDoNotShareMutableData) {
+  openlib::SharedArray<int> array = {1, 2, 3};
+  int* writable = array.mutableData();
+
+  openlib::SharedArray<int> copy = array;
+  openlib::SharedArray<int> assigned(1);
+  assigned = array;
+  writable[0] = 9;
+  EXPECT_EQ(array[0], 9);
+  EXPECT_EQ(copy[0], 1);
+  EXPECT_EQ(assigned[0], 1);
+  EXPECT_TRUE(array.unique());
+
+  // set() hands out no pointer, so copies keep sharing
+  openlib::SharedArray<int> other = {1, 2, 3};
+  other.set(0, 4);
+  openlib::SharedArray<int> shared = other;
+  EXPECT_EQ(shared.data(), other.data());
+}
+
+TEST(SharedArray, fillOnSharedDoesNotCopy) {
+  openlib::SharedArray<int> array(100);
+  openlib::SharedArray<int> copy = array;
+
+  copy.fill(5);
+  EXPECT_NE(copy.data(), array.data());
+  EXPECT_EQ(openlib::sum(copy), 500);
+  EXPECT_EQ(openlib::sum(array), 0);
+}
+
+TEST(SharedArray, moveEmptiesSource) {
+  openlib::SharedArray<int> array = {1, 2};
+  const int* data = array.data();
+
+  openlib::SharedArray<int> moved(std::move(array));
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(moved.useCount(), 1);
+  EXPECT_EQ(array.size(), 0);
+  EXPECT_EQ(array.useCount(), 0);
+
+  array = std::move(moved);
+  EXPECT_EQ(array.data(), data);
+}
+
+TEST(SharedArray, takesStorageFromAllocator) {
+  openlib::Arena arena;
+  openlib::SharedArray<int, openlib::ArenaAllocator<int>> array(16, arena);
+  EXPECT_GE(arena.allocated(), 16 * sizeof(int));
+
+  auto copy = array;
+  copy.set(0, 1);
+  EXPECT_GE(arena.allocated(), 32 * sizeof(int));
+}
+
+TEST(SharedArray, viewsAreReadOnly) {
+  openlib::SharedArray<int> array = {1, 2, 3};
+  openlib::ArraySlice<int> view = array;
+  EXPECT_EQ(view.data(), array.data());
+  EXPECT_EQ(openlib::max(array), 3);
+}
+
+TEST(SharedArray, copiesAcrossThreads) {
+  openlib::SharedArray<int> table(1000);
+  table.fill(1);
+
+  std::atomic<int> total(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&table, &total, t]() {
+      for (int i = 0; i < 1000; i++) {
+        openlib::SharedArray<int> copy = table;
+        if (i == t) {
+          copy.set(0, 2);
+          total += copy[0];
+        }
+      }
+      total += openlib::sum(table);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(total.load(), 8 * 2 + 8 * 1000);
+  EXPECT_TRUE(table.unique());
+  EXPECT_EQ(table[0], 1);
+}
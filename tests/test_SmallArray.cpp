@@ -0,0 +1,156 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+#include <openlib/SmallArray.h>
+#include <openlib/StaticArray.h>
+
+#include "AllocationCounter.h"
+
+namespace {
+
+// generic code written against the shared accessor interface
+template <class ArrayType>
+long total(const ArrayType& array) {
+  long result = 0;
+  for (std::size_t i = 0; i < array.size(); i++) {
+    result += array[i];
+  }
+  return result;
+}
+
+struct Throws {
+  static int live;
+  Throws() {
+    if (live == 3) {
+      throw std::runtime_error("construction failed");
+    }
+    live++;
+  }
+  ~Throws() {
+    live--;
+  }
+};
+
+int Throws::live = 0;
+
+} // namespace
+
+TEST(SmallArray, isConstructable) {
+  openlib::SmallArray<int, 8> empty(0);
+  EXPECT_EQ(empty.size(), 0);
+
+  openlib::SmallArray<int, 8> array(5);
+  EXPECT_EQ(array.size(), 5);
+  for (int value : array) {
+    EXPECT_EQ(value, 0);
+  }
+}
+
+TEST(SmallArray, inlineStaysInsideTheObject) {
+  openlib::SmallArray<int, 8> array = {1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_TRUE(array.isInline());
+  const char* object = reinterpret_cast<const char*>(&array);
+  const char* data = reinterpret_cast<const char*>(array.data());
+  EXPECT_GE(data, object);
+  EXPECT_LT(data, object + sizeof(array));
+}
+
+TEST(SmallArray, inlineNeverAllocates) {
+  const std::size_t before = openlib::test::allocationCount();
+  {
+    openlib::SmallArray<int, 32> array(32);
+    array.fill(2);
+    openlib::SmallArray<int, 32> copy(array);
+    openlib::SmallArray<int, 32> moved(std::move(copy));
+    openlib::SmallArray<int, 32> list = {1, 2, 3, 4};
+    EXPECT_EQ(openlib::sum(moved) + openlib::sum(list), 74);
+  }
+  EXPECT_EQ(openlib::test::allocationCount(), before);
+}
+
+TEST(SmallArray, spillsBeyondCapacity) {
+  const std::size_t before = openlib::test::allocationCount();
+  openlib::SmallArray<int, 4> array(5);
+  EXPECT_FALSE(array.isInline());
+  EXPECT_EQ(openlib::test::allocationCount(), before + 1);
+
+  array.fill(3);
+  EXPECT_EQ(total(array), 15);
+}
+
+TEST(SmallArray, moveTakesSpilledBuffer) {
+  openlib::SmallArray<std::string, 2> array = {"a", "b", "c"};
+  const std::string* data = array.data();
+
+  openlib::SmallArray<std::string, 2> moved(std::move(array));
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(moved[2], "c");
+}
+
+TEST(SmallArray, moveInlineMovesElements) {
+  openlib::SmallArray<std::string, 4> array = {"a", "b"};
+  openlib::SmallArray<std::string, 4> moved(std::move(array));
+  EXPECT_NE(moved.data(), array.data());
+  EXPECT_EQ(moved[0], "a");
+  EXPECT_EQ(moved[1], "b");
+}
+
+TEST(SmallArray, copyIsDeep) {
+  openlib::SmallArray<std::string, 1> array = {"x", "y"};
+  openlib::SmallArray<std::string, 1> copy(array);
+  copy[0] = "z";
+  EXPECT_EQ(array[0], "x");
+  EXPECT_EQ(copy[1], "y");
+}
+
+TEST(SmallArray, constructorCleansUpOnThrow) {
+  using Inline = openlib::SmallArray<Throws, 8>;
+  using Spilled = openlib::SmallArray<Throws, 2>;
+  EXPECT_THROW(Inline(5), std::runtime_error);
+  EXPECT_EQ(Throws::live, 0);
+  EXPECT_THROW(Spilled(5), std::runtime_error);
+  EXPECT_EQ(Throws::live, 0);
+}
+
+TEST(SmallArray, sharesInterfaceWithOtherArrays) {
+  openlib::StaticArray<int, 3> fixed = {1, 2, 3};
+  openlib::SmallArray<int, 4> small = {1, 2, 3};
+  openlib::FlatArray<int> flat = {1, 2, 3};
+  EXPECT_EQ(total(fixed), 6);
+  EXPECT_EQ(total(small), 6);
+  EXPECT_EQ(total(flat), 6);
+  EXPECT_EQ(openlib::max(small), 3);
+  EXPECT_EQ(openlib::min(fixed), 1);
+}
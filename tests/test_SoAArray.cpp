@@ -0,0 +1,128 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Deserializer.h>
+#include <openlib/Kernels.h>
+#include <openlib/Serializer.h>
+#include <openlib/SoAArray.h>
+
+namespace {
+
+using Trades = openlib::SoAArray<uint64_t, float, uint8_t>;
+
+} // namespace
+
+TEST(SoAArray, isConstructable) {
+  Trades trades(10);
+  EXPECT_EQ(trades.size(), 10);
+  EXPECT_EQ(Trades::columnCount, 3);
+  EXPECT_EQ(trades.column<0>().size(), 10);
+  EXPECT_EQ(trades.column<1>()[9], 0.0f);
+
+  Trades empty(0);
+  EXPECT_EQ(empty.size(), 0);
+}
+
+TEST(SoAArray, columnsAreAlignedAndSeparate) {
+  Trades trades(100, openlib::uninitialized);
+  static_assert(Trades::Column<1>::alignment == openlib::CACHE_LINE_BYTES, "aligned columns");
+  static_assert(std::is_same<Trades::Field<2>, uint8_t>::value, "field types");
+
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(trades.column<0>().data()) % openlib::CACHE_LINE_BYTES, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(trades.column<1>().data()) % openlib::CACHE_LINE_BYTES, 0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(trades.column<2>().data()) % openlib::CACHE_LINE_BYTES, 0);
+}
+
+TEST(SoAArray, rowProxy) {
+  Trades trades(4);
+  trades[1] = std::make_tuple(uint64_t(7), 2.5f, uint8_t(3));
+  trades[2].get<1>() = 1.5f;
+
+  EXPECT_EQ(trades.column<0>()[1], 7);
+  EXPECT_EQ(trades.column<1>()[1], 2.5f);
+  EXPECT_EQ(trades.column<2>()[1], 3);
+  EXPECT_EQ(trades.column<1>()[2], 1.5f);
+  EXPECT_EQ(trades.at(2).index(), 2);
+
+  Trades::Row row = trades[1];
+  EXPECT_EQ(row, std::make_tuple(uint64_t(7), 2.5f, uint8_t(3)));
+  EXPECT_EQ(trades.row(1), row);
+
+  const Trades& constant = trades;
+  EXPECT_EQ(constant[1].get<0>(), 7);
+  static_assert(std::is_same<decltype(constant[1].get<0>()), const uint64_t&>::value,
+                "const rows are read-only");
+}
+
+TEST(SoAArray, nonTrivialFields) {
+  openlib::SoAArray<std::string, int> array(3);
+  array.fill("name", 5);
+  array[0].get<0>() = "first";
+
+  EXPECT_EQ(array.row(0), std::make_tuple(std::string("first"), 5));
+  EXPECT_EQ(array.row(2), std::make_tuple(std::string("name"), 5));
+}
+
+TEST(SoAArray, columnScansUseKernels) {
+  Trades trades(1000);
+  trades.fill(1, 0.5f, 2);
+  trades[10].get<1>() = 4.0f;
+
+  EXPECT_EQ(openlib::sum(trades.column<1>()), 503.5f);
+  EXPECT_EQ(openlib::max(trades.column<1>()), 4.0f);
+  EXPECT_EQ(openlib::count(trades.column<2>(), uint8_t(2)), 1000);
+}
+
+TEST(SoAArray, serializeColumn) {
+  openlib::SoAArray<uint32_t, uint16_t> array(4);
+  for (std::size_t i = 0; i < array.size(); i++) {
+    array[i] = std::make_tuple(uint32_t(i), uint16_t(10 * i));
+  }
+
+  openlib::Serializer serializer(64);
+  serializer.putUInt16Array(array.column<1>());
+  EXPECT_EQ(serializer.size(), 4 * sizeof(uint16_t));
+
+  // big endian on the wire, like putUInt16
+  openlib::Serializer expected(64);
+  for (std::size_t i = 0; i < array.size(); i++) {
+    expected.putUInt16(array[i].get<1>());
+  }
+  EXPECT_EQ(std::memcmp(serializer.data(), expected.data(), serializer.size()), 0);
+
+  openlib::SoAArray<uint32_t, uint16_t> back(4);
+  openlib::Deserializer deserializer(serializer.view());
+  deserializer.getUInt16Array(back.column<1>());
+  EXPECT_TRUE(openlib::equal(back.column<1>(), array.column<1>()));
+}
@@ -0,0 +1,219 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/FlatArray.h>
+#include <openlib/Kernels.h>
+#include <openlib/Sort.h>
+
+#include "AllocationCounter.h"
+
+namespace {
+
+template <class type>
+void checkIntegers() {
+  std::mt19937_64 random(42);
+  for (std::size_t size : {0, 1, 2, 1000, 2047, 2048, 65537}) {
+    openlib::FlatArray<type> array(size);
+    std::vector<type> expected(size);
+    for (std::size_t i = 0; i < size; i++) {
+      array[i] = expected[i] = static_cast<type>(random());
+    }
+    std::sort(expected.begin(), expected.end());
+
+    openlib::sort(array);
+
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), array.begin())) << size;
+  }
+}
+
+template <class type>
+std::vector<type> specialValues() {
+  const type inf = std::numeric_limits<type>::infinity();
+  const type nan = std::numeric_limits<type>::quiet_NaN();
+  return {nan, inf, type(1.5), type(0), -type(0), type(-2), -inf, -nan,
+          std::numeric_limits<type>::denorm_min(), -std::numeric_limits<type>::max()};
+}
+
+// sorted order by bit pattern, so NaNs and signed zeros are checked exactly
+template <class type>
+void expectBitwiseEqual(const type* actual, const std::vector<type>& expected) {
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    ASSERT_EQ(std::memcmp(&actual[i], &expected[i], sizeof(type)), 0) << i;
+  }
+}
+
+template <class type>
+void checkFloats() {
+  const type inf = std::numeric_limits<type>::infinity();
+  const type nan = std::numeric_limits<type>::quiet_NaN();
+  const std::vector<type> expected = {-nan, -inf, -std::numeric_limits<type>::max(), type(-2),
+                                      -type(0), type(0), std::numeric_limits<type>::denorm_min(),
+                                      type(1.5), inf, nan};
+
+  // small arrays take the comparison path, large ones the radix sort
+  std::vector<type> values = specialValues<type>();
+  openlib::FlatArray<type> small(values.size());
+  std::copy(values.begin(), values.end(), small.begin());
+  openlib::sort(small);
+  expectBitwiseEqual(small.data(), expected);
+
+  const std::size_t copies = 300;
+  openlib::FlatArray<type> large(values.size() * copies);
+  std::vector<type> largeExpected;
+  for (std::size_t i = 0; i < large.size(); i++) {
+    large[i] = values[(i * 7) % values.size()];
+  }
+  for (type value : expected) {
+    largeExpected.insert(largeExpected.end(), copies, value);
+  }
+  openlib::sort(large);
+  expectBitwiseEqual(large.data(), largeExpected);
+
+  std::mt19937 random(7);
+  std::normal_distribution<type> distribution(0, 1000);
+  openlib::FlatArray<type> normal(50000);
+  for (auto& value : normal) {
+    value = distribution(random);
+  }
+  openlib::sort(normal);
+  EXPECT_TRUE(std::is_sorted(normal.begin(), normal.end()));
+}
+
+} // namespace
+
+TEST(Sort, integers) {
+  checkIntegers<uint8_t>();
+  checkIntegers<int8_t>();
+  checkIntegers<uint16_t>();
+  checkIntegers<int32_t>();
+  checkIntegers<uint32_t>();
+  checkIntegers<int64_t>();
+  checkIntegers<uint64_t>();
+}
+
+TEST(Sort, floats) {
+  checkFloats<float>();
+  checkFloats<double>();
+}
+
+TEST(Sort, otherTypesUseComparisons) {
+  openlib::FlatArray<std::string> array = {"pear", "apple", "fig"};
+  openlib::sort(array);
+  EXPECT_EQ(array[0], "apple");
+  EXPECT_EQ(array[1], "fig");
+  EXPECT_EQ(array[2], "pear");
+}
+
+TEST(Sort, byKeyIsStable) {
+  std::mt19937 random(3);
+  const std::size_t size = 20000;
+  openlib::FlatArray<int32_t> keys(size);
+  openlib::FlatArray<std::string> values(size);
+  std::vector<std::pair<int32_t, std::string>> expected;
+  for (std::size_t i = 0; i < size; i++) {
+    keys[i] = static_cast<int32_t>(random() % 1000) - 500;
+    values[i] = std::to_string(i);
+    expected.emplace_back(keys[i], values[i]);
+  }
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const std::pair<int32_t, std::string>& lhs,
+                      const std::pair<int32_t, std::string>& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+
+  openlib::sortByKey(keys, values);
+
+  for (std::size_t i = 0; i < size; i++) {
+    ASSERT_EQ(keys[i], expected[i].first);
+    ASSERT_EQ(values[i], expected[i].second);
+  }
+}
+
+TEST(Sort, byKeyOddNumberOfPasses) {
+  // only the low digit varies, one pass leaves the result in scratch
+  const std::size_t size = 5000;
+  openlib::FlatArray<uint32_t> keys(size);
+  openlib::FlatArray<std::string> values(size);
+  for (std::size_t i = 0; i < size; i++) {
+    keys[i] = static_cast<uint32_t>((size - i) % 200);
+    values[i] = std::to_string(i);
+  }
+
+  openlib::sortByKey(keys, values);
+
+  EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+  for (std::size_t i = 0; i < size; i++) {
+    ASSERT_EQ((size - std::stoul(values[i])) % 200, keys[i]) << i;
+  }
+}
+
+TEST(Sort, equalKeysAreDecoded) {
+  // no digit needs a pass, the keys encoded in place are decoded again
+  openlib::FlatArray<int64_t> ints(4096);
+  ints.fill(-3);
+  openlib::sort(ints);
+  EXPECT_EQ(openlib::count(ints, int64_t(-3)), ints.size());
+
+  openlib::FlatArray<double> doubles(4096);
+  doubles.fill(-0.25);
+  openlib::sort(doubles);
+  EXPECT_EQ(openlib::count(doubles, -0.25), doubles.size());
+}
+
+TEST(Sort, failedAllocationLeavesKeys) {
+  // the keys are encoded in place, none of the scratch may fail after that
+  openlib::FlatArray<int32_t> original(4096);
+  for (std::size_t i = 0; i < original.size(); i++) {
+    original[i] = static_cast<int32_t>(i * 7919 % 4096) - 2048;
+  }
+
+  for (std::size_t failure = 0; failure < 4; failure++) {
+    openlib::FlatArray<int32_t> keys(original);
+    openlib::FlatArray<uint64_t> values(keys.size());
+    openlib::test::failAllocationAfter(failure);
+    EXPECT_THROW(openlib::sortByKey(keys, values), std::bad_alloc) << failure;
+    EXPECT_TRUE(std::equal(keys.begin(), keys.end(), original.begin())) << failure;
+  }
+}
+
+TEST(Sort, byKeyChecksSizes) {
+  openlib::FlatArray<uint32_t> keys(3);
+  openlib::FlatArray<uint32_t> values(4);
+  EXPECT_THROW(openlib::sortByKey(keys, values), std::length_error);
+}
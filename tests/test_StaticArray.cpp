@@ -0,0 +1,109 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <string>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Kernels.h>
+#include <openlib/StaticArray.h>
+
+#include "AllocationCounter.h"
+
+namespace {
+
+constexpr openlib::StaticArray<int, 4> squares() {
+  openlib::StaticArray<int, 4> array = {};
+  for (std::size_t i = 0; i < array.size(); i++) {
+    array[i] = static_cast<int>(i * i);
+  }
+  return array;
+}
+
+} // namespace
+
+TEST(StaticArray, isConstexpr) {
+  constexpr openlib::StaticArray<int, 3> primes = {2, 3, 5};
+  static_assert(primes.size() == 3, "size is a constant expression");
+  static_assert(primes[0] == 2 && primes.back() == 5, "elements are constant expressions");
+  static_assert(squares()[3] == 9, "constexpr construction");
+  static_assert(openlib::StaticArray<double, 7>::size() == 7, "size without an object");
+  static_assert(sizeof(openlib::StaticArray<int, 8>) == 8 * sizeof(int), "no overhead");
+  static_assert(std::is_trivially_copyable<openlib::StaticArray<int, 8>>::value, "trivial");
+  EXPECT_EQ(primes.front(), 2);
+}
+
+TEST(StaticArray, accessors) {
+  openlib::StaticArray<int, 4> array = {1, 2, 3, 4};
+  EXPECT_EQ(array.size(), 4);
+  EXPECT_EQ(array.at(1), 2);
+  EXPECT_EQ(array[2], 3);
+  EXPECT_EQ(array.front(), 1);
+  EXPECT_EQ(array.back(), 4);
+  EXPECT_EQ(array.data(), &array.front());
+  EXPECT_EQ(array.end() - array.begin(), 4);
+
+  int* pointer = array;
+  EXPECT_EQ(pointer, array.data());
+
+  int total = 0;
+  for (int value : array) {
+    total += value;
+  }
+  EXPECT_EQ(total, 10);
+}
+
+TEST(StaticArray, fill) {
+  openlib::StaticArray<std::string, 5> strings;
+  strings.fill("openlib");
+  for (const auto& value : strings) {
+    EXPECT_EQ(value, "openlib");
+  }
+
+  openlib::StaticArray<uint8_t, 33> bytes;
+  bytes.fill(7);
+  EXPECT_EQ(openlib::sum(bytes), 33 * 7);
+}
+
+TEST(StaticArray, neverAllocates) {
+  const std::size_t before = openlib::test::allocationCount();
+  {
+    openlib::StaticArray<int, 32> array = {};
+    array.fill(3);
+    openlib::StaticArray<int, 32> copy = array;
+    EXPECT_EQ(openlib::sum(copy), 96);
+  }
+  EXPECT_EQ(openlib::test::allocationCount(), before);
+}
+
+TEST(StaticArray, comparisons) {
+  openlib::StaticArray<int, 2> a = {1, 2};
+  openlib::StaticArray<int, 2> b = {1, 2};
+  EXPECT_TRUE(a == a);
+  EXPECT_TRUE(a != b);
+  EXPECT_EQ(a < b, a.data() < b.data());
+}
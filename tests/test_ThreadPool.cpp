@@ -0,0 +1,125 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/ThreadPool.h>
+
+#include "AllocationCounter.h"
+
+TEST(ThreadPool, isConstructable) {
+  openlib::ThreadPool pool(4);
+  EXPECT_EQ(pool.size(), 4);
+
+  openlib::ThreadPool hardware;
+  EXPECT_GE(hardware.size(), 1);
+}
+
+TEST(ThreadPool, parallelForRunsEveryIndexOnce) {
+  openlib::ThreadPool pool(4);
+  std::vector<std::atomic<int>> hits(10000);
+  for (auto& hit : hits) {
+    hit = 0;
+  }
+
+  pool.parallelFor(hits.size(), [&](std::size_t i) {
+    hits[i]++;
+  });
+
+  for (auto& hit : hits) {
+    ASSERT_EQ(hit.load(), 1);
+  }
+}
+
+TEST(ThreadPool, singleThreadRunsOnCaller) {
+  openlib::ThreadPool pool(1);
+  std::atomic<int> total(0);
+  pool.parallelFor(100, [&](std::size_t i) {
+    total += static_cast<int>(i);
+  });
+  EXPECT_EQ(total.load(), 4950);
+}
+
+TEST(ThreadPool, nestedParallelFor) {
+  openlib::ThreadPool pool(3);
+  std::atomic<int> total(0);
+  pool.parallelFor(8, [&](std::size_t) {
+    pool.parallelFor(8, [&](std::size_t) {
+      total++;
+    });
+  });
+  EXPECT_EQ(total.load(), 64);
+}
+
+TEST(ThreadPool, parallelForRethrows) {
+  openlib::ThreadPool pool(4);
+  std::atomic<int> ran(0);
+  EXPECT_THROW(pool.parallelFor(100, [&](std::size_t i) {
+    ran++;
+    if (i == 42) {
+      throw std::runtime_error("task failed");
+    }
+  }), std::runtime_error);
+  EXPECT_EQ(ran.load(), 100);
+}
+
+TEST(ThreadPool, parallelForWaitsWhenQueueingFails) {
+  openlib::ThreadPool pool(2);
+  std::atomic<int> ran(0);
+  openlib::test::failAllocationAfter(10);
+  EXPECT_THROW(pool.parallelFor(10000, [&](std::size_t) {
+    ran++;
+  }), std::bad_alloc);
+  EXPECT_LT(ran.load(), 10000);
+
+  // every queued task has finished, the pool is still usable
+  ran = 0;
+  pool.parallelFor(100, [&](std::size_t) {
+    ran++;
+  });
+  EXPECT_EQ(ran.load(), 100);
+}
+
+TEST(ThreadPool, destructorRunsSubmittedTasks) {
+  std::atomic<int> total(0);
+  {
+    openlib::ThreadPool pool(2);
+    for (int i = 0; i < 1000; i++) {
+      pool.submit([&]() { total++; });
+    }
+  }
+  EXPECT_EQ(total.load(), 1000);
+}
+
+TEST(ThreadPool, sharedIsSingleton) {
+  EXPECT_EQ(&openlib::ThreadPool::shared(), &openlib::ThreadPool::shared());
+  EXPECT_GE(openlib::ThreadPool::shared().size(), 1);
+}
@@ -0,0 +1,185 @@
+/****************************************************************************
+Copyright (c) 2016, 2018, OpenLib Projec
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or withou
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, thi
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentatio
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, TH
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AR
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABL
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIA
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS O
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVE
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE US
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+****************************************************************************/
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <openlib/Deserializer.h>
+#include <openlib/Serializer.h>
+#include <openlib/Writer.h>
+
+TEST(Writer, sizeInitialized) {
+  uint8_t bytes[8];
+  openlib::Writer writer(bytes, sizeof(bytes));
+
+  EXPECT_EQ(writer.size(), 0);
+  EXPECT_EQ(writer.capacity(), 8);
+  EXPECT_EQ(writer.remaining(), 8);
+  EXPECT_EQ(writer.data(), bytes);
+}
+
+TEST(Writer, writesBigEndianIntegers) {
+  uint8_t bytes[14] = {};
+  openlib::Writer writer(bytes, sizeof(bytes));
+
+  writer.reserve(sizeof(bytes));
+  writer.writeUInt16(0x0102);
+  writer.writeUInt32(0x03040506);
+  writer.writeUInt64(0x0708090A0B0C0D0E);
+
+  EXPECT_EQ(writer.size(), 14);
+  for (uint8_t i = 0; i < 14; ++i) {
+    EXPECT_EQ(bytes[i], i + 1);
+  }
+}
+
+TEST(Writer, reserveThrowsWhenFull) {
+  uint8_t bytes[4];
+  openlib::Writer writer(bytes, sizeof(bytes));
+
+  writer.reserve(4);
+  EXPECT_THROW(writer.reserve(5), std::length_error);
+  writer.putUInt16(1);
+  EXPECT_THROW(writer.putUInt32(1), std::length_error);
+  EXPECT_EQ(writer.size(), 2);
+}
+
+TEST(Writer, putStringIsAllOrNothing) {
+  uint8_t bytes[6];
+  openlib::Writer writer(bytes, sizeof(bytes));
+
+  EXPECT_THROW(writer.putString("hello"), std::length_error);
+  EXPECT_EQ(writer.size(), 0);
+  EXPECT_THROW(writer.putString(std::string(openlib::Writer::MAX_STRING_LENGTH + 1, 'x')),
+               std::length_error);
+  writer.putString("abcd");
+  EXPECT_EQ(writer.size(), 6);
+}
+
+TEST(Writer, matchesSerializer) {
+  uint8_t bytes[64];
+  openlib::Writer writer(bytes, sizeof(bytes));
+  openlib::Serializer serializer(64);
+
+  writer.putInt8(-1);
+  writer.putInt16(-2);
+  writer.putInt32(-3);
+  writer.putInt64(-4);
+  writer.putFloat(0.5f);
+  writer.putDouble(0.25);
+  writer.putString("xyz");
+  serializer.putInt8(-1);
+  serializer.putInt16(-2);
+  serializer.putInt32(-3);
+  serializer.putInt64(-4);
+  serializer.putFloat(0.5f);
+  serializer.putDouble(0.25);
+  serializer.putString("xyz");
+
+  ASSERT_EQ(writer.size(), serializer.size());
+  for (std::size_t i = 0; i < writer.size(); ++i) {
+    EXPECT_EQ(bytes[i], serializer.data()[i]);
+  }
+
+  openlib::Deserializer deserializer(writer.view());
+  EXPECT_EQ(deserializer.getInt8(), -1);
+  EXPECT_EQ(deserializer.getInt16(), -2);
+  EXPECT_EQ(deserializer.getInt32(), -3);
+  EXPECT_EQ(deserializer.getInt64(), -4);
+  EXPECT_EQ(deserializer.getFloat(), 0.5f);
+  EXPECT_EQ(deserializer.getDouble(), 0.25);
+  EXPECT_EQ(deserializer.getString(), "xyz");
+}
+
+TEST(Writer, sharesPositionWithSerializer) {
+  openlib::Serializer serializer(8);
+  serializer.putUInt8(1);
+
+  openlib::Writer& writer = serializer.writer();
+  writer.reserve(2);
+  writer.writeUInt8(2);
+  writer.writeUInt8(3);
+  serializer.putUInt8(4);
+
+  EXPECT_EQ(serializer.size(), 4);
+  EXPECT_EQ(writer.size(), 4);
+  for (uint8_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(serializer.data()[i], i + 1);
+  }
+}
+
+TEST(Writer, arraysMatchElementwisePuts) {
+  std::vector<int16_t> shorts = {-1, 2, -3, 0x1234, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17};
+  std::vector<uint32_t> ints(37);
+  std::vector<int64_t> longs(19);
+  std::vector<double> doubles = {0.5, -1.5, 2.25};
+  for (std::size_t i = 0; i < ints.size(); ++i) {
+    ints[i] = static_cast<uint32_t>(i * 0x01010101);
+  }
+  for (std::size_t i = 0; i < longs.size(); ++i) {
+    longs[i] = -static_cast<int64_t>(i) * 0x0102030405;
+  }
+
+  std::vector<uint8_t> bulk(512), single(512);
+  openlib::Writer bulkWriter(bulk.data(), bulk.size());
+  openlib::Writer singleWriter(single.data(), single.size());
+  bulkWriter.putInt16Array(shorts.data(), shorts.size());
+  bulkWriter.putUInt32Array(openlib::ArrayView<const uint32_t>(ints.data(), ints.size()));
+  bulkWriter.putInt64Array(longs.data(), longs.size());
+  bulkWriter.putDoubleArray(doubles.data(), doubles.size());
+  for (int16_t value : shorts) {
+    singleWriter.putInt16(value);
+  }
+  for (uint32_t value : ints) {
+    singleWriter.putUInt32(value);
+  }
+  for (int64_t value : longs) {
+    singleWriter.putInt64(value);
+  }
+  for (double value : doubles) {
+    singleWriter.putDouble(value);
+  }
+
+  ASSERT_EQ(bulkWriter.size(), singleWriter.size());
+  EXPECT_EQ(bulk, single);
+}
+
+TEST(Writer, arrayIsAllOrNothing) {
+  uint8_t bytes[10];
+  openlib::Writer writer(bytes, sizeof(bytes));
+  uint32_t values[3] = {1, 2, 3};
+
+  EXPECT_THROW(writer.putUInt32Array(values, 3), std::length_error);
+  EXPECT_THROW(writer.putUInt32Array(values, SIZE_MAX / 2), std::length_error);
+  EXPECT_EQ(writer.size(), 0);
+  writer.putUInt32Array(values, 2);
+  writer.putUInt32Array(values, 0);
+  EXPECT_EQ(writer.size(), 8);
+}